@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""
+Control channel test for Raven (POSIX only)
+
+Runs a test case with :ControlChannel enabled, connects to the socket, sends a single
+command and immediately disconnects (as e.g. `printf ':Stop\\n' | socat - UNIX-CONNECT:<sock>`
+does), then checks that the command was processed. Tests:
+  - stop_then_close:           ":Stop\\n" then close -> run ends early with :Stop message
+  - stop_unterminated_close:   ":Stop" (no newline) then close -> same
+
+Typical use (see how_to_benchmark.txt):
+  python3 RavenControlChannelTest.py --exe _Executables/new/Raven.exe
+
+Exit status is 1 if any test fails, 2 on usage errors.
+Only the python standard library is required.
+"""
+import argparse
+import os
+import shutil
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+
+WORKING_DIR = os.path.dirname(os.path.abspath(__file__))
+
+# test case folder in _InputFiles, .rvi file base name (long enough that the run cannot finish first)
+TEST_CASE = ("Salmon_HBV", "raven-hbv-salmon")
+
+# test name, bytes sent before disconnecting
+TESTS = [
+    ("stop_then_close",         b":Stop\n"),
+    ("stop_unterminated_close", b":Stop"),
+]
+
+STOP_MESSAGE = "simulation interrupted by user using :Stop command"
+
+
+def run_test(exe, name, payload, workdir, timeout):
+    """runs test case, sends payload over control channel and disconnects; returns (passed, message)"""
+    case, rvi = TEST_CASE
+    case_dir = os.path.join(workdir, name)
+    shutil.copytree(os.path.join(WORKING_DIR, "_InputFiles", case), case_dir)
+    sock_path = os.path.join(case_dir, "raven.sock")
+    rvi_file = os.path.join(case_dir, rvi + ".rvi")
+    with open(rvi_file) as f:
+        text = f.read()
+    with open(rvi_file, "w") as f:
+        f.write(":ControlChannel " + sock_path + "\n" + text)
+    out_dir = os.path.join(case_dir, "out")
+    os.mkdir(out_dir)
+
+    log_file = os.path.join(case_dir, "stdout.log")
+    with open(log_file, "wb") as log:
+        proc = subprocess.Popen([exe, rvi, "-o", out_dir + os.sep], cwd=case_dir, stdout=log, stderr=subprocess.STDOUT)
+        start = time.time()
+        while not os.path.exists(sock_path):
+            if proc.poll() is not None or time.time() - start > timeout:
+                proc.kill()
+                return False, "control socket was never opened"
+            time.sleep(0.01)
+
+        client = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        client.connect(sock_path)
+        client.sendall(payload)
+        client.close()
+
+        try:
+            proc.wait(timeout=timeout)
+        except subprocess.TimeoutExpired:
+            proc.kill()
+            return False, "simulation did not end within %d s" % timeout
+
+    with open(log_file, "rb") as log:
+        stdout = log.read().decode(errors="replace")
+    if STOP_MESSAGE not in stdout:
+        return False, "command discarded: simulation was not stopped"
+    return True, ""
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Raven control channel test")
+    parser.add_argument("--exe", default=os.path.join(WORKING_DIR, "_Executables", "new", "Raven.exe"),
+                        help="Raven executable to test")
+    parser.add_argument("--timeout", type=int, default=120, help="maximum time per test [s] (default: 120)")
+    args = parser.parse_args()
+
+    if not hasattr(socket, "AF_UNIX"):
+        print("control channel is not supported on this platform. TEST SKIPPED.")
+        return 0
+    exe = os.path.abspath(args.exe)
+    if not os.path.exists(exe):
+        print("raven executable " + exe + " doesn't exist. TEST FAILED.")
+        return 2
+
+    nfail = 0
+    workdir = tempfile.mkdtemp(prefix="raven_ctrl_")
+    try:
+        for name, payload in TESTS:
+            print("%-26s ... " % name, end="", flush=True)
+            passed, message = run_test(exe, name, payload, workdir, args.timeout)
+            print("ok" if passed else "FAILED: " + message)
+            nfail += 0 if passed else 1
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    if nfail > 0:
+        print("%d CONTROL CHANNEL TEST(S) FAILED." % nfail)
+        return 1
+    print("... CONTROL CHANNEL TESTS DONE: all passed.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+"""
+Performance benchmarking script for Raven version evaluation
+
+Runs each benchmarking test case several times with :Profiling enabled and records
+  - wall time of the whole run, and of parsing, initialization and simulation
+    (from Raven_profile.csv), and CPU time of the whole run (POSIX only; less
+    sensitive to machine load than wall time)
+  - HRU-time steps/second (reported by :BenchmarkingMode)
+  - peak resident set size (POSIX only)
+  - the per-stage profile breakdown (median total seconds per profiler timer)
+to a JSON file, then compares the results against a stored baseline with a relative
+tolerance, so that performance regressions are caught like numerical ones.
+
+Typical use (see how_to_benchmark.txt):
+  python3 RavenPerfBenchmarking.py --exe _Executables/ref/Raven.exe --update-baseline
+  python3 RavenPerfBenchmarking.py --exe _Executables/new/Raven.exe
+
+Exit status is 1 if any regression beyond tolerance is found, 2 on usage errors.
+Only the python standard library is required.
+"""
+import argparse
+import datetime
+import json
+import os
+import platform
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+WORKING_DIR = os.path.dirname(os.path.abspath(__file__))
+
+# test case folder in _InputFiles, .rvi file base name
+TEST_CASES = [
+    ("Alouette",                     "Alouette_ws"),
+    ("Alouette2",                    "Alouette2"),
+    ("York",                         "York_gridded_m_daily_i_daily"),
+    ("Irondequoit",                  "Irondequoit"),
+    ("LOTW",                         "LOWRL"),
+    ("LaJoie",                       "La_Joie_ws"),
+    ("Nith",                         "Nith"),
+    ("Revelstoke",                   "Revelstoke_ws"),
+    ("Salmon_GR4J",                  "raven-gr4j-salmon"),
+    ("Salmon_HBV",                   "raven-hbv-salmon"),
+    ("Salmon_HMETS",                 "raven-hmets-salmon"),
+    ("Salmon_MOHYSE",                "raven-mohyse-salmon"),
+    ("Williston_Finlay",             "Williston_Finlay_ws"),
+]
+
+# metric name, True if larger is worse
+METRICS = [
+    ("wall_s",              True),
+    ("cpu_s",               True),
+    ("parse_s",             True),
+    ("initialize_s",        True),
+    ("simulate_s",          True),
+    ("hru_timesteps_per_s", False),
+    ("peak_rss_kb",         True),
+]
+TIME_METRICS = ("wall_s", "cpu_s", "parse_s", "initialize_s", "simulate_s")
+
+
+def run_raven(exe, case_dir, rvi, out_dir):
+    """runs Raven once; returns (exit code, stdout text, wall time [s], CPU time [s] or None, peak RSS [kB] or None)"""
+    log_file = os.path.join(out_dir, "stdout.log")
+    cpu, peak_rss = None, None
+    with open(log_file, "wb") as log:
+        start = time.perf_counter()
+        proc = subprocess.Popen([exe, rvi, "-o", out_dir + os.sep], cwd=case_dir, stdout=log, stderr=subprocess.STDOUT)
+        if hasattr(os, "wait4"):
+            # wait4 gives resource usage of this child only
+            _, status, usage = os.wait4(proc.pid, 0)
+            proc.returncode = os.waitstatus_to_exitcode(status) if hasattr(os, "waitstatus_to_exitcode") else (status >> 8)
+            cpu = usage.ru_utime + usage.ru_stime
+            peak_rss = usage.ru_maxrss
+            if sys.platform == "darwin":
+                peak_rss //= 1024  # bytes on macOS, kB elsewhere
+        else:
+            proc.wait()
+        wall = time.perf_counter() - start
+    with open(log_file, "rb") as log:
+        stdout = log.read().decode(errors="replace")
+    return proc.returncode, stdout, wall, cpu, peak_rss
+
+
+def read_profile(out_dir):
+    """returns dictionary of timer name -> total [s] from Raven_profile.csv (empty if not found)"""
+    prof = {}
+    for fname in os.listdir(out_dir):
+        if fname.endswith("Raven_profile.csv"):
+            with open(os.path.join(out_dir, fname)) as f:
+                f.readline()  # header
+                for line in f:
+                    cols = line.rstrip("\n").split(",")
+                    if len(cols) >= 3:
+                        prof[cols[0]] = float(cols[2])
+    return prof
+
+
+def benchmark_case(exe, case, rvi, nruns, workdir):
+    """runs single test case nruns times; returns dictionary of results"""
+    case_dir = os.path.join(workdir, case)
+    shutil.copytree(os.path.join(WORKING_DIR, "_InputFiles", case), case_dir)
+    rvi_file = os.path.join(case_dir, rvi + ".rvi")
+    with open(rvi_file) as f:
+        text = f.read()
+    with open(rvi_file, "w") as f:
+        f.write(":Profiling\n:BenchmarkingMode\n:SilentMode\n" + text)
+
+    samples = {m: [] for m, _ in METRICS}
+    stages = {}
+    for irun in range(nruns):
+        out_dir = os.path.join(case_dir, "out_%d" % irun)
+        os.mkdir(out_dir)
+        code, stdout, wall, cpu, peak_rss = run_raven(exe, case_dir, rvi, out_dir)
+        if code != 0 or "Successful Simulation" not in stdout:
+            last = [l for l in stdout.splitlines() if l.strip()][-3:]
+            return {"status": "failed", "message": " ".join(last)}
+
+        prof = read_profile(out_dir)
+        samples["wall_s"].append(wall)
+        if cpu is not None:
+            samples["cpu_s"].append(cpu)
+        if "Total" in prof:
+            samples["parse_s"].append(prof.get("ParseInputFiles", 0.0))
+            samples["initialize_s"].append(prof.get("InitializeModel", 0.0))
+            samples["simulate_s"].append(prof["Total"] - prof.get("WriteMajorOutput", 0.0))
+        m = re.search(r"([0-9.eE+-]+) HRU-time steps/second", stdout)
+        if m:
+            samples["hru_timesteps_per_s"].append(float(m.group(1)))
+        if peak_rss is not None:
+            samples["peak_rss_kb"].append(peak_rss)
+        for name, total in prof.items():
+            if name != "Total":
+                stages.setdefault(name, []).append(total)
+
+    result = {"status": "ok", "runs": nruns}
+    for m, _ in METRICS:
+        if samples[m]:
+            result[m] = {"median": statistics.median(samples[m]), "min": min(samples[m]), "max": max(samples[m])}
+    result["stages"] = {name: statistics.median(v) for name, v in stages.items()}
+    return result
+
+
+def compare(results, baseline, tol, mem_tol, min_time):
+    """prints comparison with baseline; returns number of regressions"""
+    nreg = 0
+    print("")
+    print("%-18s %-20s %14s %14s %9s" % ("case", "metric", "baseline", "new", "change"))
+    print("-" * 80)
+    for case, new in results["cases"].items():
+        base = baseline.get("cases", {}).get(case)
+        if base is None:
+            print("%-18s (not in baseline)" % case)
+            continue
+        if base["status"] == "ok" and new["status"] != "ok":
+            print("%-18s FAILED: %s" % (case, new.get("message", "")))
+            nreg += 1
+            continue
+        if new["status"] != "ok" or base["status"] != "ok":
+            continue
+        for m, larger_is_worse in METRICS:
+            if m not in new or m not in base:
+                continue
+            b, n = base[m]["median"], new[m]["median"]
+            change = (n - b) / b if b > 0 else 0.0
+            t = mem_tol if m == "peak_rss_kb" else tol
+            worse = change > t if larger_is_worse else change < -t
+            if m in TIME_METRICS and abs(n - b) < min_time:
+                worse = False  # below timing resolution
+            flag = "  REGRESSION" if worse else ""
+            nreg += 1 if worse else 0
+            print("%-18s %-20s %14.6g %14.6g %+8.1f%%%s" % (case, m, b, n, 100.0 * change, flag))
+    print("-" * 80)
+    return nreg
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Raven performance benchmarking")
+    parser.add_argument("--exe", default=os.path.join(WORKING_DIR, "_Executables", "new", "Raven.exe"),
+                        help="Raven executable to benchmark")
+    parser.add_argument("--runs", type=int, default=3, help="number of runs of each test case (default: 3)")
+    parser.add_argument("--cases", nargs="*", help="subset of test cases to run (default: all)")
+    parser.add_argument("--output", default=os.path.join(WORKING_DIR, "perf_results.json"),
+                        help="results file (default: perf_results.json)")
+    parser.add_argument("--baseline", default=os.path.join(WORKING_DIR, "perf_baseline.json"),
+                        help="baseline results file (default: perf_baseline.json)")
+    parser.add_argument("--tolerance", type=float, default=0.10,
+                        help="allowed relative slowdown of median times/throughput (default: 0.10)")
+    parser.add_argument("--mem-tolerance", type=float, default=0.10,
+                        help="allowed relative increase of peak memory (default: 0.10)")
+    parser.add_argument("--min-time", type=float, default=0.05,
+                        help="absolute time differences below this [s] are never regressions (default: 0.05)")
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="write results to baseline file instead of comparing")
+    args = parser.parse_args()
+
+    exe = os.path.abspath(args.exe)
+    if not os.path.exists(exe):
+        print("raven executable " + exe + " doesn't exist. BENCHMARKING FAILED.")
+        return 2
+    cases = [c for c in TEST_CASES if not args.cases or c[0] in args.cases]
+    if not cases:
+        print("no test cases selected. BENCHMARKING FAILED.")
+        return 2
+
+    version = subprocess.run([exe, "-v"], stdout=subprocess.PIPE, stderr=subprocess.STDOUT).stdout.decode(errors="replace")
+    version = [l.strip() for l in version.splitlines() if l.strip()]
+    results = {
+        "raven_version": version[0] if version else "",
+        "executable": exe,
+        "date": datetime.datetime.now().isoformat(timespec="seconds"),
+        "host": platform.node(),
+        "platform": platform.platform(),
+        "runs": args.runs,
+        "cases": {},
+    }
+
+    workdir = tempfile.mkdtemp(prefix="raven_perf_")
+    try:
+        for case, rvi in cases:
+            print("benchmarking " + case + " ... ", end="", flush=True)
+            res = benchmark_case(exe, case, rvi, args.runs, workdir)
+            results["cases"][case] = res
+            if res["status"] == "ok":
+                print("%.3f s (median wall time)" % res["wall_s"]["median"])
+            else:
+                print("FAILED: " + res["message"])
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    out_file = args.baseline if args.update_baseline else args.output
+    with open(out_file, "w") as f:
+        json.dump(results, f, indent=2)
+    print("results written to " + out_file)
+    if args.update_baseline:
+        return 0
+
+    if not os.path.exists(args.baseline):
+        print("no baseline " + args.baseline + " found; run with --update-baseline to create one.")
+        return 0
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    nreg = compare(results, baseline, args.tolerance, args.mem_tolerance, args.min_time)
+    if nreg > 0:
+        print("%d PERFORMANCE REGRESSION(S) FOUND." % nreg)
+        return 1
+    print("... PERFORMANCE BENCHMARKING DONE: no regressions.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+"""
+Plugin interface test for Raven (Linux/macOS)
+
+Builds RavenTestPlugin.c into a shared library, runs a test case with :PluginLibrary, and checks
+the log written by the plugin. Tests:
+  - full_run:        RavenPluginInit sees a valid host table (index functions return -1 for unknown
+                     IDs/names, ID<->index round trips), start/end callbacks are issued once per time
+                     step, and RavenPluginFinalize is called
+  - stopfile:        run stopped by :UseStopFile -> RavenPluginFinalize is still called
+  - control_stop:    run stopped by :Stop over :ControlChannel -> RavenPluginFinalize is still called
+
+Typical use (see how_to_benchmark.txt):
+  python3 RavenPluginTest.py --exe _Executables/new/Raven.exe
+
+Exit status is 1 if any test fails, 2 on usage errors.
+Only the python standard library and a C compiler (--cc, default: cc) are required.
+"""
+import argparse
+import os
+import shutil
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+
+WORKING_DIR = os.path.dirname(os.path.abspath(__file__))
+PLUGIN_SOURCE = os.path.join(WORKING_DIR, "RavenTestPlugin.c")
+INCLUDE_DIR = os.path.join(WORKING_DIR, os.pardir, "src")
+
+# test case folder in _InputFiles, .rvi file base name
+TEST_CASE = ("Salmon_HBV", "raven-hbv-salmon")
+
+
+def build_plugin(cc, workdir):
+    """compiles test plugin; returns library path, or None on failure"""
+    lib = os.path.join(workdir, "RavenTestPlugin.so")
+    cmd = [cc, "-shared", "-fPIC", "-O1", "-I" + INCLUDE_DIR, PLUGIN_SOURCE, "-o", lib]
+    res = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    if res.returncode != 0:
+        print(res.stdout.decode(errors="replace"))
+        return None
+    return lib
+
+
+def read_num_steps(rvi_file):
+    """returns number of time steps of simulation from :Duration and :TimeStep in .rvi file"""
+    duration, tstep = None, 1.0
+    with open(rvi_file) as f:
+        for line in f:
+            tok = line.split()
+            if len(tok) < 2:
+                continue
+            if tok[0] == ":Duration":
+                duration = float(tok[1])
+            elif tok[0] == ":TimeStep":
+                tstep = float(tok[1]) if ":" not in tok[1] else sum(float(x) / 60.0 ** i for i, x in enumerate(tok[1].split(":"))) / 24.0
+    return int(round(duration / tstep))
+
+
+def run_case(exe, lib, name, workdir, extra_rvi, timeout, before_run=None, during_run=None):
+    """runs test case with plugin; returns (plugin log lines, stdout, expected number of steps)"""
+    case, rvi = TEST_CASE
+    case_dir = os.path.join(workdir, name)
+    shutil.copytree(os.path.join(WORKING_DIR, "_InputFiles", case), case_dir)
+    rvi_file = os.path.join(case_dir, rvi + ".rvi")
+    plugin_log = os.path.join(case_dir, "plugin_log.txt")
+    with open(rvi_file) as f:
+        text = f.read()
+    with open(rvi_file, "w") as f:
+        f.write(":PluginLibrary " + lib + " " + plugin_log + "\n" + "".join(l + "\n" for l in extra_rvi) + text)
+    out_dir = os.path.join(case_dir, "out")
+    os.mkdir(out_dir)
+    if before_run is not None:
+        before_run(case_dir)
+
+    proc = subprocess.Popen([exe, rvi, "-o", out_dir + os.sep], cwd=case_dir, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    if during_run is not None:
+        during_run(case_dir, proc, timeout)
+    try:
+        stdout = proc.communicate(timeout=timeout)[0].decode(errors="replace")
+    except subprocess.TimeoutExpired:
+        proc.kill()
+        stdout = "simulation did not end within %d s" % timeout
+
+    lines = []
+    if os.path.exists(plugin_log):
+        with open(plugin_log) as f:
+            lines = [l.split() for l in f if l.strip()]
+    return lines, stdout, read_num_steps(rvi_file)
+
+
+def get_line(lines, key):
+    for l in lines:
+        if l[0] == key:
+            return l
+    return None
+
+
+def check_finalized(lines, stdout, nsteps, stop_message):
+    """checks that run was stopped early by stop_message (if not None) and that plugin was finalized"""
+    if get_line(lines, "init") is None:
+        return "RavenPluginInit was not called"
+    if (stop_message is not None) and (stop_message not in stdout):
+        return "simulation was not stopped (" + stop_message + " not reported)"
+    fin = get_line(lines, "finalize")
+    if fin is None:
+        return "RavenPluginFinalize was not called"
+    nstart, nend = int(fin[1]), int(fin[2])
+    if nstart != nend:
+        return "%d start-of-timestep but %d end-of-timestep callbacks" % (nstart, nend)
+    if (stop_message is None) and (nstart != nsteps):
+        return "%d timestep callbacks for %d time steps" % (nstart, nsteps)
+    if (stop_message is not None) and (nstart >= nsteps):
+        return "run was not stopped early"
+    return ""
+
+
+def test_full_run(exe, lib, workdir, timeout):
+    lines, stdout, nsteps = run_case(exe, lib, "full_run", workdir, [], timeout)
+    init = get_line(lines, "init")
+    if (init is None) or int(init[2]) <= 0 or int(init[3]) <= 0:
+        return "RavenPluginInit was not called with valid model"
+    if get_line(lines, "missing") != ["missing", "-1", "-1", "-1", "-1"]:
+        return "index functions do not return -1 for unknown IDs/names: " + " ".join(get_line(lines, "missing") or [])
+    bad = [" ".join(l) for l in lines if l[0] in ("roundtrip", "time")]
+    if bad:
+        return "; ".join(bad)
+    if int(get_line(lines, "surface_water")[1]) < 0:
+        return "GetStateVarIndex(SURFACE_WATER) failed"
+    return check_finalized(lines, stdout, nsteps, None)
+
+
+def test_stopfile(exe, lib, workdir, timeout):
+    def make_stopfile(case_dir):
+        open(os.path.join(case_dir, "stop"), "w").close()
+    lines, stdout, nsteps = run_case(exe, lib, "stopfile", workdir, [":UseStopFile"], timeout, before_run=make_stopfile)
+    return check_finalized(lines, stdout, nsteps, "interrupted by user using stopfile")
+
+
+def test_control_stop(exe, lib, workdir, timeout):
+    sock_name = "raven.sock"
+
+    def send_stop(case_dir, proc, timeout):
+        sock_path = os.path.join(case_dir, sock_name)
+        start = time.time()
+        while not os.path.exists(sock_path):
+            if proc.poll() is not None or time.time() - start > timeout:
+                return
+            time.sleep(0.01)
+        client = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        client.connect(sock_path)
+        client.sendall(b":Stop\n")
+        client.close()
+    lines, stdout, nsteps = run_case(exe, lib, "control_stop", workdir, [":ControlChannel " + sock_name], timeout, during_run=send_stop)
+    return check_finalized(lines, stdout, nsteps, "interrupted by user using :Stop command")
+
+
+TESTS = [
+    ("full_run",     test_full_run),
+    ("stopfile",     test_stopfile),
+    ("control_stop", test_control_stop),
+]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Raven plugin interface test")
+    parser.add_argument("--exe", default=os.path.join(WORKING_DIR, "_Executables", "new", "Raven.exe"),
+                        help="Raven executable to test")
+    parser.add_argument("--cc", default=os.environ.get("CC", "cc"), help="C compiler used to build test plugin (default: cc)")
+    parser.add_argument("--timeout", type=int, default=120, help="maximum time per test [s] (default: 120)")
+    args = parser.parse_args()
+
+    if os.name != "posix":
+        print("plugin test requires Linux/macOS. TEST SKIPPED.")
+        return 0
+    exe = os.path.abspath(args.exe)
+    if not os.path.exists(exe):
+        print("raven executable " + exe + " doesn't exist. TEST FAILED.")
+        return 2
+
+    nfail = 0
+    workdir = tempfile.mkdtemp(prefix="raven_plugin_")
+    try:
+        lib = build_plugin(args.cc, workdir)
+        if lib is None:
+            print("unable to build test plugin with " + args.cc + ". TEST FAILED.")
+            return 2
+        for name, test in TESTS:
+            print("%-14s ... " % name, end="", flush=True)
+            message = test(exe, lib, workdir, args.timeout)
+            print("ok" if message == "" else "FAILED: " + message)
+            nfail += 0 if message == "" else 1
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    if nfail > 0:
+        print("%d PLUGIN TEST(S) FAILED." % nfail)
+        return 1
+    print("... PLUGIN TESTS DONE: all passed.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
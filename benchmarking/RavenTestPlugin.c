@@ -0,0 +1,65 @@
+/*----------------------------------------------------------------
+  Raven test plugin (used by RavenPluginTest.py)
+
+  Exercises the plugin interface declared in src/RavenPlugin.h:
+  checks the host function table at initialization, counts timestep
+  callbacks, and writes a one-line-per-event log to the file passed as
+  plugin argument, e.g.
+     :PluginLibrary RavenTestPlugin.so plugin_log.txt
+  ----------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "RavenPlugin.h"
+
+static const raven_host_api *api=NULL;
+static FILE                 *LOG=NULL;
+static long                  nStart=0;
+static long                  nEnd  =0;
+static double                last_time=-1.0;
+
+RAVEN_PLUGIN_EXPORT int RavenPluginInit(const raven_host_api *host, const char *args)
+{
+  int k,p,i;
+  if ((host==NULL) || (args==NULL) || (strlen(args)==0)){return 1;}
+  LOG=fopen(args,"w");
+  if (LOG==NULL){return 2;}
+  api=host;
+
+  fprintf(LOG,"init %d %d %d %d\n",api->api_version,api->GetNumHRUs(api->ctx),api->GetNumSubBasins(api->ctx),api->GetNumStateVars(api->ctx));
+
+  /* index functions return -1 for IDs/names not in model */
+  fprintf(LOG,"missing %d %d %d %d\n",api->GetHRUIndex(api->ctx,999999999),api->GetSubBasinIndex(api->ctx,999999999),
+                                      api->GetStateVarIndex(api->ctx,"NOT_A_STATE_VAR"),api->GetForcingIndex(api->ctx,"NOT_A_FORCING"));
+
+  /* ID <-> index conversion round trips */
+  for (k=0;k<api->GetNumHRUs(api->ctx);k++){
+    if (api->GetHRUIndex(api->ctx,api->GetHRUID(api->ctx,k))!=k){fprintf(LOG,"roundtrip HRU %d failed\n",k);}
+  }
+  for (p=0;p<api->GetNumSubBasins(api->ctx);p++){
+    if (api->GetSubBasinIndex(api->ctx,api->GetSubBasinID(api->ctx,p))!=p){fprintf(LOG,"roundtrip subbasin %d failed\n",p);}
+  }
+  i=api->GetStateVarIndex(api->ctx,"SURFACE_WATER");
+  fprintf(LOG,"surface_water %d\n",i);
+  api->WriteWarning(api->ctx,"RavenTestPlugin initialized");
+  fflush(LOG);
+  return 0;
+}
+
+RAVEN_PLUGIN_EXPORT void RavenPluginStartTimeStep(const raven_time *t)
+{
+  if (t->model_time<=last_time){fprintf(LOG,"time out of order %g\n",t->model_time);}
+  last_time=t->model_time;
+  nStart++;
+}
+
+RAVEN_PLUGIN_EXPORT void RavenPluginEndTimeStep(const raven_time *t)
+{
+  nEnd++;
+}
+
+RAVEN_PLUGIN_EXPORT void RavenPluginFinalize(void)
+{
+  fprintf(LOG,"finalize %ld %ld\n",nStart,nEnd);
+  fclose(LOG);
+  LOG=NULL;
+}
@@ -305,3 +305,79 @@ void   CmvBaseflow::ApplyConstraints( const double     *storage,
   //cannot pull water from river
   rates[0]=max(rates[0],0.0);
 }
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns true if baseflow algorithm has a batched (multi-HRU) implementation
+//
+bool CmvBaseflow::SupportsBatchRates() const
+{
+  if (pModel->GetStateVarType(iFrom[0])!=SOIL){return false;}
+  return ((type==BASE_LINEAR) || (type==BASE_LINEAR_ANALYTIC) || (type==BASE_CONSTANT) ||
+          (type==BASE_POWER_LAW) || (type==BASE_VIC));
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns constrained baseflow rates for a block of HRUs [mm/d]
+/// \details identical to GetRatesOfChange()+ApplyConstraints() for each HRU; parameters and storage are
+/// gathered into contiguous arrays first so that rate calculations are performed in tight loops
+///
+/// \param nHRUs [in] number of HRUs in block (<=PROCESS_BATCH_SIZE)
+/// \param state_vars [in] array of pointers to state variable arrays of each HRU in block
+/// \param pHRUs [in] array of pointers to HRUs in block
+/// \param &Options [in] Global model options information
+/// \param &tt [in] Current input time structure
+/// \param *rates [out] baseflow rate of each HRU in block [mm/d] [size: nHRUs]
+//
+void CmvBaseflow::GetBatchRatesOfChange(const int          nHRUs,
+                                        const double      *const *state_vars,
+                                        const CHydroUnit  *const *pHRUs,
+                                        const optStruct   &Options,
+                                        const time_struct &tt,
+                                              double      *rates) const
+{
+  double stor    [PROCESS_BATCH_SIZE]; //raw storage [mm]
+  double max_stor[PROCESS_BATCH_SIZE]; //maximum storage of soil layer [mm]
+  double K       [PROCESS_BATCH_SIZE]; //baseflow coefficient [1/d] or maximum rate [mm/d]
+  double N       [PROCESS_BATCH_SIZE]; //baseflow exponent [-]
+  double S;
+  const soil_struct *pSoil;
+  int    n;
+  int    m=pModel->GetStateVarLayer(iFrom[0]);
+  double tstep   =Options.timestep;
+  double min_stor=g_min_storage;
+
+  //gather
+  for (n=0;n<nHRUs;n++)
+  {
+    pSoil      =pHRUs[n]->GetSoilProps(m);
+    stor    [n]=state_vars[n][iFrom[0]];
+    max_stor[n]=pHRUs[n]->GetSoilCapacity(m);
+    if ((type==BASE_CONSTANT) || (type==BASE_VIC)){K[n]=pSoil->max_baseflow_rate;}
+    else                                          {K[n]=pSoil->baseflow_coeff;}
+    N[n]=pSoil->baseflow_n;
+  }
+
+  //calculate rates
+  if (type==BASE_LINEAR){
+    for (n=0;n<nHRUs;n++){S=min(max(stor[n],0.0),max_stor[n]); rates[n]=K[n]*S;}
+  }
+  else if (type==BASE_LINEAR_ANALYTIC){
+    for (n=0;n<nHRUs;n++){S=min(max(stor[n],0.0),max_stor[n]); rates[n]=S*(1-exp(-K[n]*tstep))/tstep;}
+  }
+  else if (type==BASE_CONSTANT){
+    for (n=0;n<nHRUs;n++){rates[n]=K[n];}
+  }
+  else if (type==BASE_POWER_LAW){
+    for (n=0;n<nHRUs;n++){S=min(max(stor[n],0.0),max_stor[n]); rates[n]=K[n]*pow(S,N[n]);}
+  }
+  else if (type==BASE_VIC){
+    for (n=0;n<nHRUs;n++){S=min(max(stor[n],0.0),max_stor[n]); rates[n]=K[n]*pow(S/max_stor[n],N[n]);}
+  }
+
+  //apply constraints (as in ApplyConstraints)
+  for (n=0;n<nHRUs;n++)
+  {
+    rates[n]=threshMin(rates[n],max(stor[n],min_stor)/tstep,0.0);
+    rates[n]=max(rates[n],0.0);
+  }
+}
@@ -0,0 +1,365 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2024 the Raven Development Team
+  ----------------------------------------------------------------
+  Binary model checkpoint (.rvb) files
+  ----------------------------------------------------------------*/
+#include "Checkpoint.h"
+#include "Model.h"
+#include "Transport.h"
+
+void GetRandomState(unsigned int &seed, long long &nDraws); //defined in ModelEnsemble.cpp
+void SetRandomState(const unsigned int seed, const long long nDraws);
+
+const char CHECKPOINT_MAGIC[8]={'R','V','N','C','K','P','N','T'}; ///< identifies Raven binary checkpoint files
+const int  CHECKPOINT_VERSION =1;                                 ///< increment whenever binary layout changes
+
+//////////////////////////////////////////////////////////////////
+/// \brief 64-bit FNV-1a hash of memory block (integrity check of checkpoint contents)
+//
+static unsigned long long HashBuffer(const char *p, const size_t nbytes)
+{
+  unsigned long long hash=14695981039346656037ULL;
+  for (size_t i=0;i<nbytes;i++){
+    hash^=(unsigned char)(p[i]);
+    hash*=1099511628211ULL;
+  }
+  return hash;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Constructor - empty checkpoint buffer
+//
+CCheckpoint::CCheckpoint()
+{
+  _pos=0;
+  _filename="";
+}
+//////////////////////////////////////////////////////////////////
+/// \brief appends raw bytes to checkpoint buffer
+//
+void CCheckpoint::Put(const void *p, const size_t nbytes)
+{
+  if (nbytes==0){return;}
+  const char *c=(const char*)(p);
+  _buf.insert(_buf.end(),c,c+nbytes);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief reads raw bytes from checkpoint buffer at current read position
+//
+void CCheckpoint::Get(void *p, const size_t nbytes)
+{
+  if (nbytes==0){return;}
+  if (_pos+nbytes>_buf.size()){
+    ExitGracefully(("CCheckpoint::Get: checkpoint file "+_filename+" is truncated or inconsistent with model").c_str(),BAD_DATA);
+  }
+  memcpy(p,&_buf[_pos],nbytes);
+  _pos+=nbytes;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief reads array of doubles written by PutArray(), checking its size against expected size
+/// \param *a [out] array to fill [size: n]
+/// \param n [in] expected array size
+/// \param name [in] array description (for error messages)
+//
+void CCheckpoint::GetArray(double *a, const int n, const string name)
+{
+  CheckValue(GetInt(),n,name);
+  Get(a,sizeof(double)*n);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief exits gracefully if value read from checkpoint does not match model
+//
+void CCheckpoint::CheckValue(const long long val, const long long expected, const string name) const
+{
+  if (val!=expected){
+    string error="CCheckpoint: checkpoint file "+_filename+" is inconsistent with model ("+name+": "+to_string(val)+" in checkpoint, "+to_string(expected)+" in model)";
+    ExitGracefully(error.c_str(),BAD_DATA);
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief writes checkpoint buffer to file
+/// \details written to [filename].tmp, then renamed, so that an existing checkpoint is never left partially written
+/// \param filename [in] checkpoint file name
+/// \param compress [in] true if contents should be zlib-compressed (ignored if not compiled with zlib)
+/// \param &Options [in] Global model options information
+/// \returns true if file was successfully written
+//
+bool CCheckpoint::WriteFile(const string filename, const bool compress, const optStruct &Options) const
+{
+  unsigned long long raw_size   =(unsigned long long)(_buf.size());
+  unsigned long long stored_size=raw_size;
+  unsigned long long hash       =HashBuffer(_buf.data(),_buf.size());
+  int                compressed =0;
+  const char        *data       =_buf.data();
+#ifdef _ZLIB_
+  vector<char> zbuf;
+  if (compress)
+  {
+    uLongf zsize=compressBound((uLong)(raw_size));
+    zbuf.resize(zsize);
+    if (compress2((Bytef*)(zbuf.data()),&zsize,(const Bytef*)(_buf.data()),(uLong)(raw_size),Z_BEST_SPEED)==Z_OK){
+      data       =zbuf.data();
+      stored_size=(unsigned long long)(zsize);
+      compressed =1;
+    }
+    else{
+      WriteWarning("CCheckpoint::WriteFile: unable to compress checkpoint "+filename+"; writing uncompressed file",Options.noisy);
+    }
+  }
+#endif
+
+  string   tmpFilename=filename+".tmp";
+  ofstream OUT(tmpFilename.c_str(),ios::binary);
+  if (OUT.fail()){
+    WriteWarning("CCheckpoint::WriteFile: unable to open checkpoint file "+tmpFilename+" for writing",Options.noisy);
+    return false;
+  }
+  int version   =CHECKPOINT_VERSION;
+  int sizeof_dbl=(int)(sizeof(double));
+  OUT.write(CHECKPOINT_MAGIC,8);
+  OUT.write((const char*)(&version)    ,sizeof(int));
+  OUT.write((const char*)(&sizeof_dbl) ,sizeof(int));
+  OUT.write((const char*)(&compressed) ,sizeof(int));
+  OUT.write((const char*)(&raw_size)   ,sizeof(unsigned long long));
+  OUT.write((const char*)(&stored_size),sizeof(unsigned long long));
+  OUT.write((const char*)(&hash)       ,sizeof(unsigned long long));
+  OUT.write(data,(streamsize)(stored_size));
+  OUT.close();
+  if (OUT.fail()){
+    WriteWarning("CCheckpoint::WriteFile: unable to write checkpoint file "+tmpFilename,Options.noisy);
+    remove(tmpFilename.c_str());
+    return false;
+  }
+  remove(filename.c_str()); //required for rename() on Windows
+  if (rename(tmpFilename.c_str(),filename.c_str())!=0){
+    WriteWarning("CCheckpoint::WriteFile: unable to rename "+tmpFilename+" to checkpoint file "+filename,Options.noisy);
+    return false;
+  }
+  return true;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief reads checkpoint file into buffer, and resets read position to start of buffer
+/// \param filename [in] checkpoint file name
+/// \returns false if the file cannot be opened; exits gracefully if file is not a valid checkpoint
+//
+bool CCheckpoint::ReadFile(const string filename)
+{
+  _filename=filename;
+  _pos     =0;
+  _buf.clear();
+
+  ifstream IN(filename.c_str(),ios::binary);
+  if (IN.fail()){return false;}
+
+  char               magic[8];
+  int                version,sizeof_dbl,compressed;
+  unsigned long long raw_size,stored_size,hash;
+  IN.read(magic,8);
+  IN.read((char*)(&version)    ,sizeof(int));
+  IN.read((char*)(&sizeof_dbl) ,sizeof(int));
+  IN.read((char*)(&compressed) ,sizeof(int));
+  IN.read((char*)(&raw_size)   ,sizeof(unsigned long long));
+  IN.read((char*)(&stored_size),sizeof(unsigned long long));
+  IN.read((char*)(&hash)       ,sizeof(unsigned long long));
+  if ((IN.fail()) || (memcmp(magic,CHECKPOINT_MAGIC,8)!=0)){
+    ExitGracefully(("CCheckpoint::ReadFile: "+filename+" is not a Raven checkpoint file").c_str(),BAD_DATA);
+  }
+  if ((version!=CHECKPOINT_VERSION) || (sizeof_dbl!=(int)(sizeof(double)))){
+    ExitGracefully(("CCheckpoint::ReadFile: checkpoint file "+filename+" was written by an incompatible version of Raven").c_str(),BAD_DATA);
+  }
+
+  vector<char> stored(stored_size);
+  if (stored_size>0){IN.read(stored.data(),(streamsize)(stored_size));}
+  if (IN.fail()){
+    ExitGracefully(("CCheckpoint::ReadFile: checkpoint file "+filename+" is truncated").c_str(),BAD_DATA);
+  }
+  if (compressed)
+  {
+#ifdef _ZLIB_
+    uLongf size=(uLongf)(raw_size);
+    _buf.resize(raw_size);
+    if ((uncompress((Bytef*)(_buf.data()),&size,(const Bytef*)(stored.data()),(uLong)(stored_size))!=Z_OK) || (size!=raw_size)){
+      ExitGracefully(("CCheckpoint::ReadFile: unable to decompress checkpoint file "+filename).c_str(),BAD_DATA);
+    }
+#else
+    ExitGracefully(("CCheckpoint::ReadFile: checkpoint file "+filename+" is compressed; Raven must be compiled with zlib (_ZLIB_) to read it").c_str(),BAD_DATA);
+#endif
+  }
+  else{
+    _buf.swap(stored);
+  }
+  if ((_buf.size()!=raw_size) || (HashBuffer(_buf.data(),_buf.size())!=hash)){
+    ExitGracefully(("CCheckpoint::ReadFile: checkpoint file "+filename+" is corrupt").c_str(),BAD_DATA);
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Writes binary checkpoint of complete model state
+/// \details includes HRU state variables, cumulative mass balances, subbasin and reservoir routing states,
+/// constituent routing states, data assimilation states, forcing perturbations and random number generator state
+///
+/// \param &tt [in] current model time (at end of time step)
+/// \param filename [in] full name of checkpoint file
+//
+void CModel::WriteCheckpoint(const time_struct &tt, const string filename) const
+{
+  CCheckpoint C;
+  int i,k,p;
+
+  //Header---------------------------------------------------------
+  C.PutDouble(tt.julian_day);
+  C.PutInt   (tt.year);
+  C.PutInt   (_nHydroUnits);
+  C.PutInt   (_nStateVars);
+  C.PutInt   (_nSubBasins);
+  C.PutInt   (_nTotalConnections);
+  C.PutInt   (_nTotalLatConnections);
+  C.PutInt   (_pTransModel->GetNumConstituents());
+  C.PutInt   (_nPerturbations);
+  for (i=0;i<_nStateVars;i++){
+    C.PutInt((int)(_aStateVarType[i]));
+    C.PutInt(_aStateVarLayer[i]);
+  }
+  for (k=0;k<_nHydroUnits;k++){C.PutLong(_pHydroUnits[k]->GetHRUID());}
+  for (p=0;p<_nSubBasins; p++){C.PutLong(_pSubBasins [p]->GetID());}
+
+  //HRU state variables (contiguous HRU-major matrix)----------------
+  C.Put(_aStateMatrix,sizeof(double)*_nHydroUnits*_nStateVars);
+
+  //Cumulative mass/energy balances--------------------------------
+  for (k=0;k<_nHydroUnits;k++){C.Put(_aCumulativeBal[k],sizeof(double)*_nTotalConnections);}
+  C.Put(_aCumulativeLatBal,sizeof(double)*_nTotalLatConnections);
+  C.PutDouble(_CumulInput);
+  C.PutDouble(_CumulOutput);
+  C.PutDouble(_initWater);
+
+  //Subbasin and reservoir states-----------------------------------
+  for (p=0;p<_nSubBasins;p++){
+    _pSubBasins[p]->WriteToCheckpoint(C);
+  }
+
+  //Constituent states----------------------------------------------
+  _pTransModel->WriteToCheckpoint(C);
+
+  //Data assimilation states----------------------------------------
+  C.PutInt(_aDAscale!=NULL);
+  if (_aDAscale!=NULL){
+    C.PutArray(_aDAscale     ,_nSubBasins);
+    C.PutArray(_aDAscale_last,_nSubBasins);
+    C.PutArray(_aDAQadjust   ,_nSubBasins);
+    C.PutArray(_aDAtimesince ,_nSubBasins);
+    C.PutArray(_aDAobsQ      ,_nSubBasins);
+  }
+
+  //Forcing perturbations and random number generator---------------
+  int nStepsPerDay=(int)(rvn_round(1.0/_pOptStruct->timestep));
+  for (i=0;i<_nPerturbations;i++){
+    C.PutArray(_pPerturbations[i]->eps,nStepsPerDay);
+  }
+  unsigned int seed;
+  long long    nDraws;
+  GetRandomState(seed,nDraws);
+  C.PutInt ((int)(seed));
+  C.PutLong(nDraws);
+
+  C.WriteFile(filename,_pOptStruct->compress_checkpoints,*_pOptStruct);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Restores complete model state from binary checkpoint file
+/// \details called after initial conditions are read; overrides them. Class changes scheduled before the
+/// checkpoint time are re-applied, and :OutputDump times before the checkpoint time are skipped.
+///
+/// \param filename [in] full name of checkpoint file
+/// \param &Options [in] Global model options information
+/// \returns model time of checkpoint [d], from which simulation should resume
+//
+double CModel::ReadCheckpoint(const string filename, const optStruct &Options)
+{
+  CCheckpoint C;
+  int i,k,p;
+
+  if (!C.ReadFile(filename)){
+    ExitGracefully(("CModel::ReadCheckpoint: unable to open checkpoint file "+filename).c_str(),BAD_DATA);
+  }
+
+  //Header---------------------------------------------------------
+  double jul_day=C.GetDouble();
+  int    year   =C.GetInt();
+  double t      =TimeDifference(Options.julian_start_day,Options.julian_start_year,jul_day,year,Options.calendar);
+  t=rvn_round(t/Options.timestep)*Options.timestep;
+  ExitGracefullyIf(t<0.0,
+    "CModel::ReadCheckpoint: checkpoint time is before simulation start date",BAD_DATA);
+  ExitGracefullyIf(t>Options.duration+TIME_CORRECTION,
+    "CModel::ReadCheckpoint: checkpoint time is after simulation end date",BAD_DATA);
+
+  C.CheckValue(C.GetInt(),_nHydroUnits,         "number of HRUs");
+  C.CheckValue(C.GetInt(),_nStateVars,          "number of state variables");
+  C.CheckValue(C.GetInt(),_nSubBasins,          "number of subbasins");
+  C.CheckValue(C.GetInt(),_nTotalConnections,   "number of process connections");
+  C.CheckValue(C.GetInt(),_nTotalLatConnections,"number of lateral process connections");
+  C.CheckValue(C.GetInt(),_pTransModel->GetNumConstituents(),"number of constituents");
+  C.CheckValue(C.GetInt(),_nPerturbations,      "number of forcing perturbations");
+  for (i=0;i<_nStateVars;i++){
+    C.CheckValue(C.GetInt(),(int)(_aStateVarType[i]),"type of state variable "+to_string(i));
+    C.CheckValue(C.GetInt(),_aStateVarLayer[i],      "layer of state variable "+to_string(i));
+  }
+  for (k=0;k<_nHydroUnits;k++){C.CheckValue(C.GetLong(),_pHydroUnits[k]->GetHRUID(),"HRU ID");}
+  for (p=0;p<_nSubBasins; p++){C.CheckValue(C.GetLong(),_pSubBasins [p]->GetID()  ,"subbasin ID");}
+
+  //HRU state variables--------------------------------------------
+  C.Get(_aStateMatrix,sizeof(double)*_nHydroUnits*_nStateVars);
+
+  //Cumulative mass/energy balances--------------------------------
+  for (k=0;k<_nHydroUnits;k++){C.Get(_aCumulativeBal[k],sizeof(double)*_nTotalConnections);}
+  C.Get(_aCumulativeLatBal,sizeof(double)*_nTotalLatConnections);
+  _CumulInput =C.GetDouble();
+  _CumulOutput=C.GetDouble();
+  _initWater  =C.GetDouble();
+
+  //Subbasin and reservoir states-----------------------------------
+  for (p=0;p<_nSubBasins;p++){
+    _pSubBasins[p]->ReadFromCheckpoint(C);
+  }
+
+  //Constituent states----------------------------------------------
+  _pTransModel->ReadFromCheckpoint(C);
+
+  //Data assimilation states----------------------------------------
+  C.CheckValue(C.GetInt(),(_aDAscale!=NULL),"data assimilation");
+  if (_aDAscale!=NULL){
+    C.GetArray(_aDAscale     ,_nSubBasins,"data assimilation scale factors");
+    C.GetArray(_aDAscale_last,_nSubBasins,"data assimilation scale factors");
+    C.GetArray(_aDAQadjust   ,_nSubBasins,"data assimilation flow adjustments");
+    C.GetArray(_aDAtimesince ,_nSubBasins,"data assimilation time since observation");
+    C.GetArray(_aDAobsQ      ,_nSubBasins,"data assimilation observed flows");
+  }
+
+  //Forcing perturbations and random number generator---------------
+  int nStepsPerDay=(int)(rvn_round(1.0/Options.timestep));
+  for (i=0;i<_nPerturbations;i++){
+    C.GetArray(_pPerturbations[i]->eps,nStepsPerDay,"forcing perturbation time steps per day");
+  }
+  unsigned int seed  =(unsigned int)(C.GetInt());
+  long long    nDraws=C.GetLong();
+  SetRandomState(seed,nDraws);
+
+  if (Options.management_optimization){
+    WriteWarning("CModel::ReadCheckpoint: management optimization history (e.g., cumulative deliveries) is not stored in checkpoints and restarts from the checkpoint time",Options.noisy);
+  }
+
+  //Bring time-dependent model configuration up to checkpoint time---
+  for (int j=0;j<_nClassChanges;j++){
+    if (_pClassChanges[j]->modeltime<t-TIME_CORRECTION){ApplyClassChange(j);}
+  }
+  while ((_currOutputTimeInd<_nOutputTimes) && (_aOutputTimes[_currOutputTimeInd]<t-0.5*Options.timestep)){
+    _currOutputTimeInd++;
+  }
+
+  if (!Options.silent){
+    cout<<"  Model state restored from checkpoint "<<filename<<" (model time "<<t<<" d)"<<endl;
+  }
+  return t;
+}
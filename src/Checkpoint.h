@@ -0,0 +1,54 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2024 the Raven Development Team
+  ----------------------------------------------------------------
+  Class CCheckpoint
+  ----------------------------------------------------------------*/
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "RavenInclude.h"
+#include <vector>
+#ifdef _ZLIB_
+#include <zlib.h>
+#endif
+
+////////////////////////////////////////////////////////////////////
+/// \brief In-memory buffer for versioned binary model checkpoint (.rvb) files
+/// \details Model components append their state to the buffer in a fixed order with the Put*()
+/// routines, and restore it in the same order with the matching Get*() routines. The buffer is
+/// written to/read from file in a single block, optionally zlib-compressed (if compiled with _ZLIB_).
+/// Files are written to a temporary file and renamed, so that an interrupted write never
+/// corrupts an existing checkpoint.
+//
+class CCheckpoint
+{
+private:/*------------------------------------------------------*/
+  vector<char>  _buf;      ///< serialized model state
+  size_t        _pos;      ///< current read position in _buf
+  string        _filename; ///< name of file read (for error messages)
+
+public:/*-------------------------------------------------------*/
+  CCheckpoint();
+
+  void          Put       (const void *p, const size_t nbytes);
+  void          Get       (void       *p, const size_t nbytes);
+  void          PutInt    (const int        &i)          { Put(&i,sizeof(int)); }
+  void          PutLong   (const long long  &i)          { Put(&i,sizeof(long long)); }
+  void          PutDouble (const double     &v)          { Put(&v,sizeof(double)); }
+  void          PutArray  (const double *a, const int n) { PutInt(n); if (n>0){Put(a,sizeof(double)*n);} }
+
+  int           GetInt    ()                             { int       i; Get(&i,sizeof(int));       return i; }
+  long long     GetLong   ()                             { long long i; Get(&i,sizeof(long long)); return i; }
+  double        GetDouble ()                             { double    v; Get(&v,sizeof(double));    return v; }
+  void          GetArray  (double *a, const int n, const string name);
+
+  void          CheckValue(const long long val, const long long expected, const string name) const;
+
+  size_t        GetSize   () const { return _buf.size(); }
+
+  bool          WriteFile (const string filename, const bool compress, const optStruct &Options) const;
+  bool          ReadFile  (const string filename);
+};
+
+#endif
@@ -1260,6 +1260,15 @@ string StringToUppercase(const string &s)
 #define valid_digit(c) ((c) >= '0' && (c) <= '9')
 
 double fast_s_to_d (const char *p)
+{
+  return fast_s_to_d(p,NULL);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief as above, but also returns pointer to first character following number
+/// \param *p [in] string to be converted
+/// \param **end [out] if not NULL, set to first unparsed character in p
+//
+double fast_s_to_d (const char *p, const char **end)
 {
   int frac;
   double sign, value, scale;
@@ -1330,6 +1339,7 @@ double fast_s_to_d (const char *p)
     while (expon >=  8) { scale *= 1E8;  expon -=  8; }
     while (expon >   0) { scale *= 10.0; expon -=  1; }
   }
+  if (end!=NULL){*end=p;}
 
   // Return signed and scaled floating point result.
 
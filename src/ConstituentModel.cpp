@@ -11,6 +11,7 @@ coordinates information about constituent storage
 #include "HeatConduction.h"
 #include "Transport.h"
 #include "EnergyTransport.h"
+#include "Checkpoint.h"
 
 bool IsContinuousConcObs(const CTimeSeriesABC *pObs,const long long SBID,const int c); //Defined in StandardOutput.cpp
 void WriteNetCDFGlobalAttributes(const int out_ncid,const optStruct& Options,const string descript);
@@ -1727,6 +1728,62 @@ void CConstituentModel::WriteMajorOutput(ofstream &RVC) const
   RVC<<":EndBasinTransportVariables"<<endl;
 }
 //////////////////////////////////////////////////////////////////
+/// \brief Writes routing states and cumulative mass balance to binary checkpoint
+/// \param &C [out] checkpoint buffer
+//
+void CConstituentModel::WriteToCheckpoint(CCheckpoint &C) const
+{
+  for(int p=0;p<_pModel->GetNumSubBasins();p++)
+  {
+    C.PutDouble(_channel_storage[p]);
+    C.PutDouble(_rivulet_storage[p]);
+    C.PutArray (_aMout    [p],_pModel->GetSubBasin(p)->GetNumSegments());
+    C.PutArray (_aMlatHist[p],_nMlatHist[p]);
+    C.PutArray (_aMinHist [p],_nMinHist [p]);
+    C.PutDouble(_aMout_last    [p]);
+    C.PutDouble(_aMlat_last    [p]);
+    C.PutDouble(_aMlocal       [p]);
+    C.PutDouble(_aMlocLast     [p]);
+    C.PutDouble(_aMres         [p]);
+    C.PutDouble(_aMres_last    [p]);
+    C.PutDouble(_aMsed         [p]);
+    C.PutDouble(_aMsed_last    [p]);
+    C.PutDouble(_aMout_res     [p]);
+    C.PutDouble(_aMout_res_last[p]);
+  }
+  C.PutDouble(_cumul_input);
+  C.PutDouble(_cumul_output);
+  C.PutDouble(_initial_mass);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Reads routing states and cumulative mass balance from binary checkpoint
+/// \param &C [in] checkpoint buffer
+//
+void CConstituentModel::ReadFromCheckpoint(CCheckpoint &C)
+{
+  for(int p=0;p<_pModel->GetNumSubBasins();p++)
+  {
+    _channel_storage[p]=C.GetDouble();
+    _rivulet_storage[p]=C.GetDouble();
+    C.GetArray(_aMout    [p],_pModel->GetSubBasin(p)->GetNumSegments(),_name+" number of channel segments");
+    C.GetArray(_aMlatHist[p],_nMlatHist[p],_name+" lateral loading history size");
+    C.GetArray(_aMinHist [p],_nMinHist [p],_name+" upstream loading history size");
+    _aMout_last    [p]=C.GetDouble();
+    _aMlat_last    [p]=C.GetDouble();
+    _aMlocal       [p]=C.GetDouble();
+    _aMlocLast     [p]=C.GetDouble();
+    _aMres         [p]=C.GetDouble();
+    _aMres_last    [p]=C.GetDouble();
+    _aMsed         [p]=C.GetDouble();
+    _aMsed_last    [p]=C.GetDouble();
+    _aMout_res     [p]=C.GetDouble();
+    _aMout_res_last[p]=C.GetDouble();
+  }
+  _cumul_input =C.GetDouble();
+  _cumul_output=C.GetDouble();
+  _initial_mass=C.GetDouble();
+}
+//////////////////////////////////////////////////////////////////
 /// \brief clears all time series data for re-read of .rvt file
 /// \remark Called only in ensemble mode
 ///
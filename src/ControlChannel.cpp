@@ -0,0 +1,358 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2025 the Raven Development Team
+  ----------------------------------------------------------------
+  Class CControlChannel
+  ----------------------------------------------------------------*/
+#include "ControlChannel.h"
+#include "Model.h"
+#include "PluginHost.h"
+#include "RavenMain.h"
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#endif
+
+int                    CControlChannel::_listen_fd      =DOESNT_EXIST;
+string                 CControlChannel::_path           ="";
+vector<control_client> CControlChannel::_clients;
+bool                   CControlChannel::_paused         =false;
+bool                   CControlChannel::_stop           =false;
+double                 CControlChannel::_status_interval=0.0;
+
+const size_t MAX_CONTROL_QUEUE=1048576; ///< maximum queued output per client [bytes]; status messages dropped beyond this
+
+//////////////////////////////////////////////////////////////////
+/// \brief returns true if first token of line is a channel command rather than an .rvl command
+//
+static bool IsChannelCommand(const string &cmd)
+{
+  return ((cmd==":Stop") || (cmd==":Pause") || (cmd==":Resume") || (cmd==":Status") || (cmd==":WriteCheckpoint"));
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief returns number of lines of text beginning with command
+//
+static int CountCommands(const string &text, const string &cmd)
+{
+  int count=0;
+  istringstream IN(text);
+  string first,line;
+  while (getline(IN,line)){
+    first="";
+    istringstream(line)>>first;
+    if (first==cmd){count++;}
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief opens control channel socket specified by :ControlChannel command
+/// \details does nothing if no channel specified. Any existing file at the socket path is replaced
+/// \param &Options [in] global model options
+//
+void CControlChannel::Open(const optStruct &Options)
+{
+  if (Options.control_channel==""){return;}
+  _status_interval=max(Options.control_status_interval,Options.timestep);
+
+#ifdef _WIN32
+  WriteWarning("CControlChannel::Open: :ControlChannel is not supported on Windows; use .rvl live files instead",Options.noisy);
+#else
+  string warn;
+  struct sockaddr_un addr;
+  if (Options.control_channel.length()>=sizeof(addr.sun_path)){
+    warn="CControlChannel::Open: socket path is too long: "+Options.control_channel;
+    ExitGracefully(warn.c_str(),BAD_DATA);return;
+  }
+  memset(&addr,0,sizeof(addr));
+  addr.sun_family=AF_UNIX;
+  strncpy(addr.sun_path,Options.control_channel.c_str(),sizeof(addr.sun_path)-1);
+
+  unlink(Options.control_channel.c_str()); //stale socket from previous run
+
+  _listen_fd=socket(AF_UNIX,SOCK_STREAM,0);
+  if ((_listen_fd<0) ||
+      (bind  (_listen_fd,(struct sockaddr*)(&addr),sizeof(addr))<0) ||
+      (listen(_listen_fd,8)<0))
+  {
+    warn="CControlChannel::Open: unable to open control socket "+Options.control_channel+": "+string(strerror(errno));
+    if (_listen_fd>=0){close(_listen_fd);}
+    _listen_fd=DOESNT_EXIST;
+    ExitGracefully(warn.c_str(),BAD_DATA);return;
+  }
+  fcntl(_listen_fd,F_SETFL,fcntl(_listen_fd,F_GETFL,0) | O_NONBLOCK);
+  _path=Options.control_channel;
+
+  if (!Options.silent){
+    cout<<"Listening for control commands on "<<_path<<endl;
+  }
+#endif
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief accepts pending connections and reads all available client input, waiting up to timeout_ms for activity
+/// \param timeout_ms [in] maximum wait [ms] (0 to return immediately)
+//
+void CControlChannel::Poll(const int timeout_ms)
+{
+#ifndef _WIN32
+  int nc=(int)(_clients.size());
+  struct pollfd *aPoll=new struct pollfd [nc+1];
+  aPoll[0].fd=_listen_fd; aPoll[0].events=POLLIN; aPoll[0].revents=0;
+  for (int c=0;c<nc;c++){
+    aPoll[c+1].fd=_clients[c].fd; aPoll[c+1].events=POLLIN; aPoll[c+1].revents=0; //closed clients (fd<0) are ignored by poll
+  }
+  int nready=poll(aPoll,nc+1,timeout_ms);
+
+  if (nready>0)
+  {
+    char buf[4096];
+    vector<control_client> keep;
+    for (int c=0;c<nc;c++)
+    {
+      bool alive=(_clients[c].fd!=DOESNT_EXIST);
+      if (alive && (aPoll[c+1].revents & (POLLIN | POLLHUP | POLLERR)))
+      {
+        while (true){
+          ssize_t n=recv(_clients[c].fd,buf,sizeof(buf),0);
+          if      (n>0)                                       {_clients[c].in.append(buf,(size_t)(n));}
+          else if ((n<0) && ((errno==EAGAIN) || (errno==EWOULDBLOCK))){break;}
+          else if ((n<0) && (errno==EINTR))                   {continue;}
+          else                                                {alive=false; break;} //closed or failed
+        }
+      }
+      if ((!alive) && (_clients[c].fd!=DOESNT_EXIST)){
+        close(_clients[c].fd);
+        _clients[c].fd=DOESNT_EXIST;
+        _clients[c].out="";
+        string &in=_clients[c].in;
+        if ((in.length()>0) && (in[in.length()-1]!='\n')){in+="\n";} //peer closed: unterminated last line is complete
+      }
+      //closed clients are kept until commands sent before disconnecting are processed
+      if (alive || (_clients[c].in.find('\n')!=string::npos)){keep.push_back(_clients[c]);}
+    }
+    _clients=keep;
+
+    if (aPoll[0].revents & POLLIN)
+    {
+      int fd;
+      while ((fd=accept(_listen_fd,NULL,NULL))>=0){
+        fcntl(fd,F_SETFL,fcntl(fd,F_GETFL,0) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+        int one=1;
+        setsockopt(fd,SOL_SOCKET,SO_NOSIGPIPE,&one,sizeof(one));
+#endif
+        control_client C;
+        C.fd=fd;
+        _clients.push_back(C);
+      }
+    }
+  }
+  delete [] aPoll;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief sends as much queued output to client as socket accepts without blocking
+//
+void CControlChannel::Flush(control_client &C)
+{
+#ifndef _WIN32
+  if (C.fd==DOESNT_EXIST){return;} //client disconnected
+  int flags=0;
+#ifdef MSG_NOSIGNAL
+  flags=MSG_NOSIGNAL;
+#endif
+  while (C.out.length()>0){
+    ssize_t n=send(C.fd,C.out.data(),C.out.length(),flags);
+    if (n>0){C.out.erase(0,(size_t)(n));}
+    else    {break;} //full or disconnected; disconnect detected in Poll()
+  }
+#endif
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief queues message to single client and sends it
+//
+void CControlChannel::Send(control_client &C, const string &msg)
+{
+  if (C.fd==DOESNT_EXIST){return;} //client disconnected
+  if (C.out.length()+msg.length()>MAX_CONTROL_QUEUE){return;} //slow client: drop message
+  C.out+=msg;
+  Flush(C);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief queues message to all clients and sends it
+//
+void CControlChannel::SendAll(const string &msg)
+{
+  for (size_t c=0;c<_clients.size();c++){Send(_clients[c],msg);}
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief handles channel-specific command (:Stop, :Pause, :Resume, :WriteCheckpoint, :Status)
+/// \returns false if line is not a channel command (i.e., should be parsed as .rvl command)
+//
+bool CControlChannel::HandleCommand(control_client &C, const string &line, CModel *pModel, const optStruct &Options, const time_struct &tt)
+{
+  istringstream LINE(line);
+  string cmd,arg;
+  LINE>>cmd>>arg;
+
+  if      (cmd==":Stop")  {_stop=true;}
+  else if (cmd==":Pause") {_paused=true;}
+  else if (cmd==":Resume"){_paused=false;}
+  else if (cmd==":Status"){Send(C,GetStatus(pModel,Options,tt,DOESNT_EXIST));}
+  else if (cmd==":WriteCheckpoint")
+  {
+    string filename;
+    if (arg!=""){filename=CorrectForRelativePath(arg,Options.rvi_filename);}
+    else        {filename=FilenamePrepare("control_checkpoint.rvb",Options);}
+    pModel->WriteCheckpoint(tt,filename);
+    Send(C,"{\"type\":\"checkpoint\",\"model_time\":"+to_string(tt.model_time)+",\"file\":\""+filename+"\"}\n");
+  }
+  else {return false;}
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief processes all complete commands received from clients
+/// \details called at the start of each time step. .rvl-format commands are passed to ParseLiveCommands();
+/// while paused, blocks (processing commands) until :Resume or :Stop is received. On :Stop, writes
+/// solution files and ends the simulation as with a stopfile.
+/// \param pModel [in/out] model
+/// \param &Options [in] global model options
+/// \param &tt [in] current model time
+/// \param step [in] current time step index
+//
+void CControlChannel::ProcessCommands(CModel *pModel, const optStruct &Options, const time_struct &tt, const int step)
+{
+  if (_listen_fd==DOESNT_EXIST){return;}
+
+  bool was_paused=_paused;
+  do
+  {
+    Poll(_paused ? 200 : 0);
+
+    for (size_t c=0;c<_clients.size();c++)
+    {
+      control_client &C=_clients[c];
+      size_t last=C.in.rfind('\n');
+      if (last==string::npos){continue;}
+
+      //hold multi-line blocks until complete
+      string text=C.in.substr(0,last+1);
+      if (CountCommands(text,":RepopulateHRUGroup")>CountCommands(text,":EndRepopulateHRUGroup")){continue;}
+      C.in.erase(0,last+1);
+
+      istringstream IN(text);
+      string line,live="";
+      int nCommands=0;
+      while (getline(IN,line))
+      {
+        if ((line.length()>0) && (line[line.length()-1]=='\r')){line.erase(line.length()-1);}
+        string first;
+        istringstream(line)>>first;
+        if ((first=="") || (first[0]=='#')){continue;}
+        nCommands++;
+        if (!IsChannelCommand(first)){
+          live+=line+"\n";
+        }
+        else {
+          if (live!=""){istringstream LIVE(live); ParseLiveCommands(pModel,Options,LIVE,"control channel"); live="";}
+          HandleCommand(C,line,pModel,Options,tt);
+        }
+      }
+      if (live!=""){istringstream LIVE(live); ParseLiveCommands(pModel,Options,LIVE,"control channel");}
+      Send(C,"{\"type\":\"ack\",\"commands\":"+to_string(nCommands)+",\"model_time\":"+to_string(tt.model_time)+"}\n");
+    }
+    //drop disconnected clients once their commands are processed (an incomplete block can never complete)
+    vector<control_client> keep;
+    for (size_t c=0;c<_clients.size();c++){
+      if (_clients[c].fd!=DOESNT_EXIST){keep.push_back(_clients[c]);}
+    }
+    _clients=keep;
+    if (_paused!=was_paused){
+      SendAll(GetStatus(pModel,Options,tt,step));
+      was_paused=_paused;
+    }
+  } while ((_paused) && (!_stop) && (_listen_fd!=DOESNT_EXIST));
+
+  if (_stop)
+  {
+    SendAll("{\"type\":\"stopped\",\"model_time\":"+to_string(tt.model_time)+"}\n");
+    pModel->WriteMajorOutput(tt,"solution",true);
+    pModel->CloseOutputStreams();
+    WriteSolverStatistics(pModel,Options);
+    Close();
+    CPluginHost::Finalize();
+    ExitGracefully("CControlChannel: simulation interrupted by user using :Stop command",SIMULATION_DONE);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief returns JSON status line with simulation progress and gauged subbasin outflows
+/// \param step [in] current time step index (or DOESNT_EXIST if unknown)
+//
+string CControlChannel::GetStatus(const CModel *pModel, const optStruct &Options, const time_struct &tt, const int step)
+{
+  ostringstream S;
+  S<<"{\"type\":\"status\"";
+  if (step!=DOESNT_EXIST){S<<",\"step\":"<<step;}
+  S<<",\"nsteps\":"<<(int)(ceil(Options.duration/Options.timestep));
+  S<<",\"model_time\":"<<tt.model_time;
+  S<<",\"date\":\""<<tt.date_string<<"\"";
+  S<<",\"paused\":"<<(_paused ? "true" : "false");
+  S<<",\"flows\":{";
+  bool first=true;
+  for (int p=0;p<pModel->GetNumSubBasins();p++)
+  {
+    const CSubBasin *pSB=pModel->GetSubBasin(p);
+    if ((!pSB->IsGauged()) || (!pSB->IsEnabled())){continue;}
+    if (!first){S<<",";}
+    S<<"\""<<pSB->GetID()<<"\":"<<pSB->GetOutflowRate();
+    first=false;
+  }
+  S<<"}}\n";
+  return S.str();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief sends status line to all clients at end of time step, at status interval
+/// \param step [in] index of completed time step
+//
+void CControlChannel::SendStatus(const CModel *pModel, const optStruct &Options, const time_struct &tt, const int step)
+{
+  if ((_listen_fd==DOESNT_EXIST) || (_clients.size()==0)){return;}
+  if (fabs(ffmod(tt.model_time,_status_interval))>0.5*Options.timestep){return;}
+  for (size_t c=0;c<_clients.size();c++){Flush(_clients[c]);}
+  SendAll(GetStatus(pModel,Options,tt,step));
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief closes all client connections and removes socket
+//
+void CControlChannel::Close()
+{
+  if (_listen_fd==DOESNT_EXIST){return;}
+#ifndef _WIN32
+  for (size_t c=0;c<_clients.size();c++){
+    Flush(_clients[c]);
+    if (_clients[c].fd!=DOESNT_EXIST){close(_clients[c].fd);}
+  }
+  close(_listen_fd);
+  unlink(_path.c_str());
+#endif
+  _clients.clear();
+  _listen_fd=DOESNT_EXIST;
+  _paused   =false;
+  _stop     =false;
+}
@@ -0,0 +1,60 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2025 the Raven Development Team
+  ----------------------------------------------------------------
+  Class CControlChannel
+  ----------------------------------------------------------------*/
+#ifndef CONTROL_CHANNEL_H
+#define CONTROL_CHANNEL_H
+
+#include "RavenInclude.h"
+#include <vector>
+
+class CModel;  // defined in Model.h
+
+////////////////////////////////////////////////////////////////////
+/// \brief Connected client of the control channel
+//
+struct control_client
+{
+  int    fd;     ///< socket file descriptor (DOESNT_EXIST once peer has disconnected)
+  string in;     ///< received text not yet processed
+  string out;    ///< queued text not yet sent
+};
+
+////////////////////////////////////////////////////////////////////
+/// \brief Local IPC command channel for live control of a running simulation
+/// \details enabled with :ControlChannel [socket path] {status interval} in the .rvi file. Listens on a
+/// Unix domain socket; clients send newline-delimited commands in .rvl format (:SetStreamflow,
+/// :UpdateParameter, ...) plus the channel commands :Stop, :Pause, :Resume, :WriteCheckpoint {filename}
+/// and :Status. Commands are processed at the start of each time step; clients are sent an
+/// acknowledgement of every batch processed and a status line (JSON) with progress and gauged
+/// subbasin outflows at the requested interval. Not available on Windows builds.
+//
+class CControlChannel
+{
+private:/*------------------------------------------------------*/
+  static int                    _listen_fd;       ///< listening socket (DOESNT_EXIST if channel closed)
+  static string                 _path;            ///< socket path
+  static vector<control_client> _clients;         ///< connected clients
+  static bool                   _paused;          ///< true if simulation paused by :Pause command
+  static bool                   _stop;            ///< true if simulation stop requested by :Stop command
+  static double                 _status_interval; ///< interval between status messages [d]
+
+  static void   Poll           (const int timeout_ms);
+  static void   Flush          (control_client &C);
+  static void   Send           (control_client &C, const string &msg);
+  static void   SendAll        (const string &msg);
+  static bool   HandleCommand  (control_client &C, const string &line, CModel *pModel, const optStruct &Options, const time_struct &tt);
+  static string GetStatus      (const CModel *pModel, const optStruct &Options, const time_struct &tt, const int step);
+
+public:/*-------------------------------------------------------*/
+  static void        Open           (const optStruct &Options);
+  static void        ProcessCommands(CModel *pModel, const optStruct &Options, const time_struct &tt, const int step);
+  static void        SendStatus     (const CModel *pModel, const optStruct &Options, const time_struct &tt, const int step);
+  static void        Close          ();
+
+  static inline bool IsOpen         () { return (_listen_fd!=DOESNT_EXIST); }
+};
+
+#endif
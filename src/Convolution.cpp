@@ -57,12 +57,17 @@ CmvConvolution::CmvConvolution(convolution_type type,
   //updating total convolution storage
   iFrom[2*N-1] = pModel->GetStateVarIndex(CONVOLUTION, conv_index);
   iTo  [2*N-1] = pModel->GetStateVarIndex(CONVOLUTION, conv_index);
+
+  _UHtstep=0.0;
 }
 
 //////////////////////////////////////////////////////////////////
 /// \brief Implementation of the default destructor
 //
-CmvConvolution::~CmvConvolution(){}
+CmvConvolution::~CmvConvolution()
+{
+  ClearUHCache();
+}
 
 //////////////////////////////////////////////////////////////////
 /// \brief Initializes convolution object
@@ -100,10 +105,12 @@ double CmvConvolution::LocalCumulDist(const double& t, const CHydroUnit* pHRU) c
   return 1.0;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief generates unit hydrograph based upon HRU parameters
+/// \note only called by GetUnitHydrographIndex() when no unit hydrograph is cached for the HRU parameter set
+//
 void   CmvConvolution::GenerateUnitHydrograph(const CHydroUnit *pHRU, const optStruct &Options, double *aUnitHydro, int *aInterval, int &N) const
 {
-  //generates unit hydrograph based upon HRU parameters
-  //(called every timestep because it is potentially different in every HRU)
   double tstep=Options.timestep;
   double max_time(0);
 
@@ -214,6 +221,108 @@ void   CmvConvolution::GenerateUnitHydrograph(const CHydroUnit *pHRU, const optS
 
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief returns the HRU parameter values which fully determine the unit hydrograph
+/// \param *pHRU [in] Reference to pertinent HRU
+/// \param param [out] parameter values (unused entries are zero)
+//
+void CmvConvolution::GetUHParams(const CHydroUnit *pHRU, double param[2]) const
+{
+  param[0]=0.0;
+  param[1]=0.0;
+  if      ((_type==CONVOL_GR4J_1) || (_type==CONVOL_GR4J_2)){
+    param[0]=pHRU->GetSurfaceProps()->GR4J_x4;
+  }
+  else if (_type==CONVOL_GAMMA){
+    param[0]=pHRU->GetSurfaceProps()->gamma_shape;
+    param[1]=pHRU->GetSurfaceProps()->gamma_scale;
+  }
+  else if (_type==CONVOL_GAMMA_2){
+    param[0]=pHRU->GetSurfaceProps()->gamma_shape2;
+    param[1]=pHRU->GetSurfaceProps()->gamma_scale2;
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief updates unit hydrograph used by each HRU, generating and caching unit hydrographs for new parameter sets
+/// \details unit hydrographs are cached by parameter value rather than by HRU or class, so any change to
+/// the parameters (e.g., via :UpdateParameter, transient parameters, or calibration) automatically results
+/// in a new (or previously cached) unit hydrograph being used. HRUs sharing parameter values share a unit hydrograph.
+/// Called at the start of the time step, after all parameter updates, so that GetRatesOfChange() only reads the cache.
+///
+/// \param *pHRUs [in] array of all model HRUs [size: nHRUs]
+/// \param *aApplies [in] true if convolution applies to HRU k [size: nHRUs]
+/// \param nHRUs [in] number of HRUs in model
+/// \param &Options [in] Global model options information
+/// \param &tt [in] Current model time
+//
+void CmvConvolution::PrepareTimeStep(const CHydroUnit  *const *pHRUs,
+                                     const bool        *aApplies,
+                                     const int          nHRUs,
+                                     const optStruct   &Options,
+                                     const time_struct &tt)
+{
+  //unit hydrographs are time step-dependent; if parameters are continuously changing, start over
+  if ((Options.timestep!=_UHtstep) || ((int)(_aUHCache.size())>=MAX_CACHED_UH)){
+    ClearUHCache();
+    _UHtstep=Options.timestep;
+  }
+  _aHRUtoUH.resize(nHRUs,DOESNT_EXIST);
+
+  double param[2];
+  int    j;
+  for (int k=0;k<nHRUs;k++)
+  {
+    if (!aApplies[k]){continue;}
+    GetUHParams(pHRUs[k],param);
+
+    //most common case: same parameters as used by this HRU last time step
+    j=_aHRUtoUH[k];
+    if ((j!=DOESNT_EXIST) && (_aUHCache[j]->param[0]==param[0]) && (_aUHCache[j]->param[1]==param[1])){continue;}
+
+    _aHRUtoUH[k]=GetUnitHydrographIndex(pHRUs[k],param,Options);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief returns index of cached unit hydrograph for parameter set, generating and caching it if not yet generated
+///
+/// \param *pHRU [in] Reference to HRU with parameter set param
+/// \param param [in] parameter values which fully determine the unit hydrograph (from GetUHParams())
+/// \param &Options [in] Global model options information
+/// \returns index of unit hydrograph in _aUHCache
+//
+int CmvConvolution::GetUnitHydrographIndex(const CHydroUnit *pHRU, const double param[2], const optStruct &Options)
+{
+  pair<double,double> key(param[0],param[1]);
+  map<pair<double,double>,int>::iterator it=_mUHIndex.find(key);
+  if (it!=_mUHIndex.end()){
+    return it->second;
+  }
+
+  conv_UH *pUH=new conv_UH;
+  ExitGracefullyIf(pUH==NULL,"CmvConvolution::GetUnitHydrographIndex",OUT_OF_MEMORY);
+  pUH->param[0]=param[0];
+  pUH->param[1]=param[1];
+  pUH->N=0;
+  GenerateUnitHydrograph(pHRU,Options,pUH->aUnitHydro,pUH->aInterval,pUH->N);
+
+  _aUHCache.push_back(pUH);
+  _mUHIndex[key]=(int)(_aUHCache.size())-1;
+  return (int)(_aUHCache.size())-1;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief deletes all cached unit hydrographs
+//
+void CmvConvolution::ClearUHCache()
+{
+  for (int j=0;j<(int)(_aUHCache.size());j++){delete _aUHCache[j];}
+  _aUHCache.clear();
+  _mUHIndex.clear();
+  _aHRUtoUH.clear();
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Returns participating parameter list
 ///
@@ -286,12 +395,17 @@ void   CmvConvolution::GetRatesOfChange( const double      *state_vars,
   int i;
   double TS_old;
   double tstep=Options.timestep;
-  static double S         [MAX_CONVOL_STORES];
-  static double aUnitHydro[MAX_CONVOL_STORES];
-  static int    aInterval [MAX_CONVOL_STORES];
-
-  int N =0;
-  GenerateUnitHydrograph(pHRU,Options,&aUnitHydro[0],&aInterval[0],N); //THIS IS SLOW!! - create aUnitHydro as process array
+  double S[MAX_CONVOL_STORES]={0.0};
+
+  int k=pHRU->GetGlobalIndex();
+#ifdef _STRICTCHECK_
+  ExitGracefullyIf((k>=(int)(_aHRUtoUH.size())) || (_aHRUtoUH[k]==DOESNT_EXIST),
+                   "CmvConvolution::GetRatesOfChange: unit hydrograph not prepared for HRU (PrepareTimeStep not called)",RUNTIME_ERR);
+#endif
+  const conv_UH *pUH       =_aUHCache[_aHRUtoUH[k]]; //read-only: prepared in PrepareTimeStep()
+  const double  *aUnitHydro=pUH->aUnitHydro;
+  const int     *aInterval =pUH->aInterval;
+  int            N         =pUH->N;
 
   //Calculate S[0] as change in convolution total storage
   TS_old=state_vars[iFrom[2*_nStores-1]]; //total storage after water added to convol stores earlier in process list
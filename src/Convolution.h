@@ -11,8 +11,22 @@
 
 #include "RavenInclude.h"
 #include "HydroProcessABC.h"
+#include <map>
+#include <vector>
 
 const int MAX_CONVOL_STORES=50;
+const int MAX_CACHED_UH    =10000; ///< maximum number of distinct unit hydrographs cached by a convolution process
+
+///////////////////////////////////////////////////////////////////
+/// \brief unit hydrograph generated for one distinct set of convolution parameters
+//
+struct conv_UH
+{
+  double param[2];                      ///< parameter values used to generate unit hydrograph (e.g., GR4J_X4, or GAMMA_SHAPE, GAMMA_SCALE)
+  int    N;                             ///< number of active convolution stores
+  double aUnitHydro[MAX_CONVOL_STORES]; ///< unit hydrograph ordinates [N]
+  int    aInterval [MAX_CONVOL_STORES]; ///< number of time steps covered by each store [N]
+};
 
 ///////////////////////////////////////////////////////////////////
 /// \brief Methods for modelling a convolution
@@ -38,9 +52,17 @@ private:/*------------------------------------------------------*/
 
   int               _iTarget;     ///< state variable index of outflow target
 
+  vector<conv_UH *>              _aUHCache;   ///< cached unit hydrographs, one per distinct parameter set
+  map<pair<double,double>,int>   _mUHIndex;   ///< index of cached unit hydrograph in _aUHCache, by parameter set
+  vector<int>                    _aHRUtoUH;   ///< index of unit hydrograph used by HRU k this time step (or DOESNT_EXIST) [size: nHRUs]
+  double                         _UHtstep;    ///< model time step used to generate cached unit hydrographs
+
   double LocalCumulDist(const double &t, const CHydroUnit *pHRU) const;
 
   void GenerateUnitHydrograph(const CHydroUnit *pHRU, const optStruct &Options, double *aUnitHydro, int *aIntervals, int &N) const;
+  void GetUHParams           (const CHydroUnit *pHRU, double param[2]) const;
+  int  GetUnitHydrographIndex(const CHydroUnit *pHRU, const double param[2], const optStruct &Options);
+  void ClearUHCache          ();
 
 public:/*-------------------------------------------------------*/
   //Constructors/destructors:
@@ -52,6 +74,11 @@ public:/*-------------------------------------------------------*/
 
   //inherited functions
   void Initialize();
+  void PrepareTimeStep (const CHydroUnit  *const *pHRUs,
+                        const bool        *aApplies,
+                        const int          nHRUs,
+                        const optStruct   &Options,
+                        const time_struct &tt);
   void GetRatesOfChange(const double              *state_vars,
                         const CHydroUnit  *pHRU,
                         const optStruct   &Options,
@@ -20,6 +20,7 @@ CDDSEnsemble::CDDSEnsemble(const int num_members,const optStruct &Options)
   _type=ENSEMBLE_DDS;
   _nParamDists=0;
   _pParamDists=NULL;
+  _aParamHandles=NULL;
   _BestParams=NULL;
   _TestParams=NULL;
   _Fbest=ALMOST_INF;
@@ -39,6 +40,7 @@ CDDSEnsemble::~CDDSEnsemble()
     delete _pParamDists[i];
   }
   delete[] _pParamDists; _nParamDists=0;
+  delete[] _aParamHandles;
   delete[] _BestParams;
   delete[] _TestParams;
 }
@@ -186,12 +188,17 @@ void CDDSEnsemble::UpdateModel(CModel *pModel,optStruct &Options,const int e)
   }
 
   //- update parameters in model -----------------------------
+  if(_aParamHandles==NULL) {
+    _aParamHandles=new param_handle [_nParamDists];
+    for(int k=0;k<_nParamDists;k++) {
+      _aParamHandles[k]=pModel->GetParameterHandle(_pParamDists[k]->param_class,
+                                                   _pParamDists[k]->param_name,
+                                                   _pParamDists[k]->class_group);
+    }
+  }
   for(int k=0;k<_nParamDists;k++)
   {
-    pModel->UpdateParameter(_pParamDists[k]->param_class,
-                            _pParamDists[k]->param_name,
-                            _pParamDists[k]->class_group,
-                            _TestParams[k]);
+    pModel->UpdateParameter(_aParamHandles[k],_TestParams[k]);
   }
   //- Re-read initial conditions to update state variables----
   if(!ParseInitialConditions(pModel,Options)) {
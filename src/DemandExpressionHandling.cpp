@@ -42,6 +42,9 @@ expressionStruct::expressionStruct()
   nTermsPerGrp=NULL;
   nGroups=0;
   compare=COMPARE_IS_EQUAL;
+  aInstructions=NULL;
+  nInstructions=0;
+  aGroupStart=NULL;
 }
 expressionStruct::~expressionStruct()
 {
@@ -52,6 +55,8 @@ expressionStruct::~expressionStruct()
     delete [] pTerms[i]; pTerms[i]=NULL;
   }
   delete [] pTerms; pTerms=NULL;
+  delete [] aInstructions; aInstructions=NULL;
+  delete [] aGroupStart;   aGroupStart=NULL;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -1076,142 +1081,338 @@ void SummarizeExpression(const char **s, const int Len, expressionStruct* exp)
   cout<<"*"<<endl<<endl;
 }
 //////////////////////////////////////////////////////////////////
-/// \brief checks if conditions of operating regime k or goal ii are satisfied
-/// returns true if *all* conditions of operating regime k of goal ii are satisfied
-///
-bool CDemandOptimizer::CheckOpRegimeConditions(const op_regime *pOperRegime, const time_struct &tt, const optStruct &Options) const
+/// \brief appends compiled (postfix) form of term k of expression group to instruction list
+/// \params pTerms [in] - pointer to array of terms in expression group
+/// \param k [in] index of term to be compiled
+/// \param aInstr [out] instruction list
+///  called recursively for nested terms (function arguments), which are compiled before the function itself
+//
+void CDemandOptimizer::CompileTerm(expressionTerm **pTerms,const int k,vector<expInstruction> &aInstr) const
 {
-  double dv_value;
+  const expressionTerm *pT=pTerms[k];
+  int p=pT->p_index;
 
-  //Check if conditionals are satisfied
-  for (int j = 0; j < pOperRegime->nConditions; j++)
+  if      (pT->type == TERM_DV)
   {
-    exp_condition *pCond=pOperRegime->pConditions[j];
-    if (pCond->pExp != NULL) {
-      if(!EvaluateConditionExp(pCond->pExp,tt.model_time))
-      {
-        return false;
-      }
+    ExitGracefully("CDemandOptimizer::CompileTerm: decision variable cannot be nested within function",BAD_DATA);
+  }
+  else if (pT->type == TERM_TS)
+  {
+    expInstruction I(OPC_TS);
+    I.pTS  =pT->pTS;
+    I.value=(double)(pT->timeshift);
+    aInstr.push_back(I);
+  }
+  else if (pT->type == TERM_CUMUL_TS)
+  {
+    expInstruction I(OPC_CUMUL_TS);
+    I.pTS  =pT->pTS;
+    I.value=(double)(pT->timeshift); //duration, assumes daily timestep
+    aInstr.push_back(I);
+  }
+  else if (pT->type == TERM_LT)
+  {
+    CompileTerm(pTerms,pT->nested_ind1,aInstr);
+    expInstruction I(OPC_LOOKUP);
+    I.pLT=pT->pLT;
+    aInstr.push_back(I);
+  }
+  else if (pT->type == TERM_HRU)
+  {
+    expInstruction I(OPC_HRU_SV);
+    I.pHRU=_pModel->GetHydroUnit(pT->HRU_index);
+    I.ind =pT->SV_index;
+    aInstr.push_back(I);
+  }
+  else if (pT->type == TERM_SB)
+  {
+    expInstruction I(OPC_SB_SV);
+    I.pSB=_pModel->GetSubBasin(p);
+    I.ind=pT->SV_index;
+    aInstr.push_back(I);
+  }
+  else if (pT->type == TERM_CONST)
+  {
+    expInstruction I(OPC_CONST);
+    I.value=pT->value;
+    aInstr.push_back(I);
+  }
+  else if (pT->type == TERM_WORKFLOW)
+  {
+    expInstruction I(OPC_POINTER);
+    I.pVal=&(_pWorkflowVars[pT->DV_ind]->current_val);
+    aInstr.push_back(I);
+  }
+  else if (pT->type == TERM_CUMUL)  //!C123
+  {
+    expInstruction I(OPC_POINTER);
+    I.pVal=&(_aCumDelivery[p]); //p_index is demand index d
+    aInstr.push_back(I);
+  }
+  else if (pT->type == TERM_HISTORY) //e.g., !Q100[-3]
+  {
+    char tmp=pT->origexp[1];//e.g., Q
+    if ((tmp=='B') || (tmp=='E'))
+    {
+      expInstruction I((tmp=='B') ? OPC_SPEC_INFLOW : OPC_ENVIRO_MIN);
+      I.pSB  =_pModel->GetSubBasin(p);
+      I.value=(double)(pT->timeshift); //ASSUMES DAILY TIMESTEP!
+      aInstr.push_back(I);
     }
     else
     {
-      dv_value=0.0;
-      if      (pCond->dv_name == "DAY_OF_YEAR")
-      {
-        dv_value=tt.julian_day;
+      expInstruction I(OPC_HISTORY);
+      I.ind=pT->timeshift-1;
+      if (_aSBIndices[p]==DOESNT_EXIST){
+        string warn="CDemandOptimizer::CompileTerm: history variable "+pT->origexp+" refers to disabled subbasin";
+        ExitGracefully(warn.c_str(),BAD_DATA);return;
       }
-      else if (pCond->dv_name == "MONTH")
-      {
-        dv_value=(double)(tt.month);
+      if      (tmp=='Q'){I.pVal=_aQhist[_aSBIndices[p]]; }
+      else if (tmp=='h'){I.pVal=_ahhist[_aSBIndices[p]]; }
+      else if (tmp=='D'){I.pVal=_aDhist[_aSBIndices[p]]; }
+      else if (tmp=='I'){I.pVal=_aIhist[_aSBIndices[p]]; }
+      else {
+        ExitGracefully("CDemandOptimizer::CompileTerm: Invalid history variable ",BAD_DATA);return;
       }
-      else if (pCond->dv_name == "YEAR")
+      aInstr.push_back(I);
+    }
+  }
+  else if ((pT->type == TERM_MAX) || (pT->type == TERM_MIN))
+  {
+    CompileTerm(pTerms,pT->nested_ind1,aInstr);
+    CompileTerm(pTerms,pT->nested_ind2,aInstr);
+    aInstr.push_back(expInstruction((pT->type == TERM_MAX) ? OPC_MAX : OPC_MIN));
+  }
+  else if (pT->type == TERM_CONVERT)
+  {
+    CompileTerm(pTerms,pT->nested_ind1,aInstr);
+    expInstruction I(OPC_SCALE);
+    I.value=pT->value;
+    aInstr.push_back(I);
+  }
+  else
+  {
+    aInstr.push_back(expInstruction(OPC_CONST)); //unknown terms evaluate to zero
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief compiles expression into flat list of instructions with pre-resolved pointers to time series,
+/// lookup tables, subbasins, HRUs and history arrays
+/// \details populates pE->aInstructions and pE->aGroupStart. Must be called after history arrays and
+/// delivery arrays are allocated (i.e., from InitializePostRVMRead() or later); does nothing if already compiled
+/// \params pE [in/out] - expression
+//
+void CDemandOptimizer::CompileExpression(expressionStruct *pE) const
+{
+  if ((pE==NULL) || (pE->aInstructions!=NULL)){return;}
+
+  vector<expInstruction> aInstr;
+  pE->aGroupStart=new int [pE->nGroups+1];
+  for (int j = 0; j < pE->nGroups; j++)
+  {
+    pE->aGroupStart[j]=(int)(aInstr.size());
+    for (int k = 0; k < pE->nTermsPerGrp[j]; k++)
+    {
+      const expressionTerm *pT=pE->pTerms[j][k];
+      if (pT->type == TERM_DV)
       {
-        dv_value = (double)(tt.year);
+        expInstruction I(OPC_DV);
+        I.ind  =pT->DV_ind;
+        I.value=pT->mult;
+        aInstr.push_back(I);
       }
-      else if (pCond->dv_name == "DATE")
+      else if (!(pT->is_nested))
       {
-        dv_value=0;
-        //handled below
+        CompileTerm(pE->pTerms[j],k,aInstr);
+        expInstruction I(OPC_TERM);
+        I.value=pT->mult;
+        I.ind  =(pT->reciprocal) ? 1 : 0;
+        aInstr.push_back(I);
       }
-      else if (pCond->dv_name[0] == '!') //decision variable
-      {
-        char   tmp =pCond->dv_name[1];
+    }
+  }
+  pE->aGroupStart[pE->nGroups]=(int)(aInstr.size());
 
-        long   ind=pCond->p_index;
+  pE->nInstructions=(int)(aInstr.size());
+  pE->aInstructions=new expInstruction [pE->nInstructions+1]; //+1 so that array is never empty
+  for (int i = 0; i < pE->nInstructions; i++) {
+    pE->aInstructions[i]=aInstr[i];
+  }
+}
 
-        if      (tmp == 'Q') {
-          dv_value=_pModel->GetSubBasinByID(ind)->GetOutflowRate();
-        }
-        else if (tmp == 'h') {
-          dv_value=_pModel->GetSubBasinByID(ind)->GetReservoir()->GetResStage();
-        }
-        else if (tmp == 'I') {
-          dv_value=_pModel->GetSubBasinByID(ind)->GetOutflowArray()[_pModel->GetSubBasinByID(ind)->GetNumSegments()-1];
-        }
-        else if (tmp == 'C') {
-          dv_value=_aCumDelivery[ind];
-        }
-        else if (tmp == 'D') {
-          dv_value=_pModel->GetSubBasinByID(_pDemands[ind]->GetSubBasinID())->GetDemandDelivery(_pDemands[ind]->GetLocalIndex());
-        }
-        else if (tmp == 'R') {
-          dv_value=_pModel->GetSubBasinByID(_pDemands[ind]->GetSubBasinID())->GetReturnFlow(_pDemands[ind]->GetLocalIndex());
-        }
-        else if (tmp == 'd') {
-          dv_value=_pDemands[ind]->GetDemand();
-        }
-        else {
-          ExitGracefully("Invalid decision variable in condition statement (letter after ! not supported)",BAD_DATA);
-        }
-        //todo: support !q, !B, !E, !F, !T
-      }
-      else {//handle user specified DVs and workflow variables
-        int i=GetUserDVIndex(pCond->dv_name);
-        if (i != DOESNT_EXIST) //decision variable
-        {
-          dv_value =_pDecisionVars[i]->value;
-        }
-        else //workflow variable
-        {
-          bool found=false;
-          for (int j = 0; j < _nWorkflowVars; j++) {
-            if (_pWorkflowVars[j]->name == pCond->dv_name) {
-              dv_value =_pWorkflowVars[i]->current_val;
-              found=true;
-            }
-          }
+//////////////////////////////////////////////////////////////////
+/// \brief resolves left hand side of condition to variable type and direct pointers, parses dates
+/// \details expression conditions are compiled with CompileExpression()
+/// \params pCond [in/out] - condition
+/// \param Options [in] - model options structure
+//
+void CDemandOptimizer::CompileCondition(exp_condition *pCond,const optStruct &Options) const
+{
+  if (pCond->pExp != NULL) {
+    CompileExpression(pCond->pExp);
+    pCond->var=COND_EXPRESSION;
+    return;
+  }
 
-          if (!found){
-            ExitGracefully("CheckOpRegimeConditions: Unrecognized varible on left hand side of :Condition statement ",BAD_DATA_WARN);
-            return false;
-          }
+  string warn;
+  long   ind=pCond->p_index;
+
+  if      (pCond->dv_name == "DAY_OF_YEAR"){pCond->var=COND_DAY_OF_YEAR;}
+  else if (pCond->dv_name == "MONTH"      ){pCond->var=COND_MONTH;}
+  else if (pCond->dv_name == "YEAR"       ){pCond->var=COND_YEAR;}
+  else if (pCond->dv_name == "DATE"       )
+  {
+    pCond->var  =COND_DATE;
+    pCond->date1=DateStringToTimeStruct(pCond->date_string ,"00:00:00",Options.calendar);
+    if (pCond->compare == COMPARE_BETWEEN) {
+      pCond->date2=DateStringToTimeStruct(pCond->date_string2,"00:00:00",Options.calendar);
+    }
+  }
+  else if (pCond->dv_name[0] == '!') //decision variable
+  {
+    char tmp =pCond->dv_name[1];
+
+    if ((tmp == 'Q') || (tmp == 'h') || (tmp == 'I')) { //p_index is subbasin index p
+      pCond->pSB=_pModel->GetSubBasin(ind);
+      if      (tmp == 'Q') {pCond->var=COND_QOUT;}
+      else if (tmp == 'h') {pCond->var=COND_STAGE;}
+      else                 {pCond->var=COND_RES_INFLOW;}
+    }
+    else if (tmp == 'C') {
+      pCond->var =COND_POINTER;
+      pCond->pVal=&(_aCumDelivery[ind]);
+    }
+    else if ((tmp == 'D') || (tmp == 'R')) { //p_index is demand index d
+      pCond->var   =(tmp == 'D') ? COND_DELIVERY : COND_RETURN;
+      pCond->pSB   =_pModel->GetSubBasinByID(_pDemands[ind]->GetSubBasinID());
+      pCond->dem_ii=_pDemands[ind]->GetLocalIndex();
+    }
+    else if (tmp == 'd') {
+      pCond->var    =COND_DEMAND;
+      pCond->pDemand=_pDemands[ind];
+    }
+    else {
+      ExitGracefully("Invalid decision variable in condition statement (letter after ! not supported)",BAD_DATA);
+    }
+    //todo: support !q, !B, !E, !F, !T
+  }
+  else //handle user specified DVs and workflow variables
+  {
+    int i=GetUserDVIndex(pCond->dv_name);
+    if (i != DOESNT_EXIST) //decision variable
+    {
+      pCond->var =COND_POINTER;
+      pCond->pVal=&(_pUserDecisionVars[i]->value);
+    }
+    else //workflow variable
+    {
+      for (int j = 0; j < _nWorkflowVars; j++) {
+        if (_pWorkflowVars[j]->name == pCond->dv_name) {
+          pCond->var =COND_POINTER;
+          pCond->pVal=&(_pWorkflowVars[j]->current_val);
         }
       }
+      if (pCond->var==COND_UNCOMPILED){
+        warn="CompileCondition: Unrecognized variable on left hand side of :Condition statement: "+pCond->dv_name;
+        ExitGracefully(warn.c_str(),BAD_DATA_WARN);
+        pCond->var=COND_NEVER; //operating regime is never active
+      }
+    }
+  }
+}
 
-      comparison comp=pCond->compare;
-      double        v=pCond->value;
-      double       v2=pCond->value2;
+//////////////////////////////////////////////////////////////////
+/// \brief compiles expressions and conditions of all operating regimes in array
+//
+void CDemandOptimizer::CompileOpRegimes(op_regime **pOperRegimes,const int nOperRegimes,const optStruct &Options) const
+{
+  for (int k = 0; k < nOperRegimes; k++)
+  {
+    CompileExpression(pOperRegimes[k]->pExpression);
+    for (int j = 0; j < pOperRegimes[k]->nConditions; j++) {
+      CompileCondition(pOperRegimes[k]->pConditions[j],Options);
+    }
+  }
+}
 
-      if (pCond->dv_name == "DATE") //dates require special handling; remainder of values are just doubles
-      {
-        dv_value=0;
+//////////////////////////////////////////////////////////////////
+/// \brief checks if conditions of operating regime k or goal ii are satisfied
+/// returns true if *all* conditions of operating regime k of goal ii are satisfied
+/// conditions must be compiled (CompileCondition())
+///
+bool CDemandOptimizer::CheckOpRegimeConditions(const op_regime *pOperRegime, const time_struct &tt, const optStruct &Options) const
+{
+  double dv_value;
 
-        time_struct time1=DateStringToTimeStruct(pCond->date_string ,"00:00:00",Options.calendar);
-        v=-TimeDifference(time1.julian_day,time1.year,tt.julian_day,tt.year,Options.calendar);//v negative if day is after day1
+  //Check if conditionals are satisfied
+  for (int j = 0; j < pOperRegime->nConditions; j++)
+  {
+    const exp_condition *pCond=pOperRegime->pConditions[j];
+    comparison comp=pCond->compare;
+    double        v=pCond->value;
+    double       v2=pCond->value2;
 
-        if (comp == COMPARE_BETWEEN) {
-          time_struct time2=DateStringToTimeStruct(pCond->date_string2,"00:00:00",Options.calendar);
-          v2=-TimeDifference(time2.julian_day,time2.year,tt.julian_day,tt.year,Options.calendar);//v2 negative if day is after day2
-        }
+    switch(pCond->var)
+    {
+    case(COND_EXPRESSION):
+    {
+      if(!EvaluateConditionExp(pCond->pExp,tt.model_time)){return false;}
+      continue;
+    }
+    case(COND_DAY_OF_YEAR): {dv_value=tt.julian_day;                                            break;}
+    case(COND_MONTH):       {dv_value=(double)(tt.month);                                       break;}
+    case(COND_YEAR):        {dv_value=(double)(tt.year);                                        break;}
+    case(COND_POINTER):     {dv_value=*(pCond->pVal);                                           break;}
+    case(COND_QOUT):        {dv_value=pCond->pSB->GetOutflowRate();                             break;}
+    case(COND_STAGE):       {dv_value=pCond->pSB->GetReservoir()->GetResStage();                break;}
+    case(COND_RES_INFLOW):  {dv_value=pCond->pSB->GetOutflowArray()[pCond->pSB->GetNumSegments()-1]; break;}
+    case(COND_DELIVERY):    {dv_value=pCond->pSB->GetDemandDelivery(pCond->dem_ii);             break;}
+    case(COND_RETURN):      {dv_value=pCond->pSB->GetReturnFlow(pCond->dem_ii);                 break;}
+    case(COND_DEMAND):      {dv_value=pCond->pDemand->GetDemand();                              break;}
+    case(COND_NEVER):       {return false;}
+    case(COND_DATE): //dates require special handling; remainder of values are just doubles
+    {
+      dv_value=0;
+      v=-TimeDifference(pCond->date1.julian_day,pCond->date1.year,tt.julian_day,tt.year,Options.calendar);//v negative if day is after day1
+      if (comp == COMPARE_BETWEEN) {
+        v2=-TimeDifference(pCond->date2.julian_day,pCond->date2.year,tt.julian_day,tt.year,Options.calendar);//v2 negative if day is after day2
       }
+      break;
+    }
+    default:
+    {
+      ExitGracefully("CheckOpRegimeConditions: condition not compiled",RUNTIME_ERR);
+      return false;
+    }
+    }
 
-      if (comp == COMPARE_BETWEEN)
-      {
-        if ((pCond->dv_name == "DAY_OF_YEAR") || (pCond->dv_name =="MONTH") || (pCond->dv_name=="YEAR")) { //handles wraparound
-          if ( v2 < v ){ // wraparound
-            if ((dv_value < v ) && (dv_value > v2)){return false;} //integer values - this is inclusive of end dates
-          }
-          else { //regular
-            if ((dv_value > v2) || (dv_value < v )){return false;}
-          }
+    if (comp == COMPARE_BETWEEN)
+    {
+      if ((pCond->var == COND_DAY_OF_YEAR) || (pCond->var == COND_MONTH) || (pCond->var == COND_YEAR)) { //handles wraparound
+        if ( v2 < v ){ // wraparound
+          if ((dv_value < v ) && (dv_value > v2)){return false;} //integer values - this is inclusive of end dates
         }
-        else {
-          if ((dv_value > v2) || (dv_value< v)){return false;}//don't apply condition if ANY conditionals unmet
+        else { //regular
+          if ((dv_value > v2) || (dv_value < v )){return false;}
         }
       }
-      else if (comp == COMPARE_GREATERTHAN) {
-        if (dv_value < v){return false;}//don't apply condition
-      }
-      else if (comp == COMPARE_LESSTHAN) {
-        if (dv_value > v){return false;}//don't apply condition
-      }
-      else if (comp == COMPARE_IS_EQUAL) {
-        if (fabs(dv_value - v) > PRETTY_SMALL){return false;}//usually integer value (e.g., month)
-      }
-      else if (comp == COMPARE_NOT_EQUAL) {
-        if (fabs(dv_value - v) < PRETTY_SMALL){return false;}
+      else {
+        if ((dv_value > v2) || (dv_value< v)){return false;}//don't apply condition if ANY conditionals unmet
       }
     }
+    else if (comp == COMPARE_GREATERTHAN) {
+      if (dv_value < v){return false;}//don't apply condition
+    }
+    else if (comp == COMPARE_LESSTHAN) {
+      if (dv_value > v){return false;}//don't apply condition
+    }
+    else if (comp == COMPARE_IS_EQUAL) {
+      if (fabs(dv_value - v) > PRETTY_SMALL){return false;}//usually integer value (e.g., month)
+    }
+    else if (comp == COMPARE_NOT_EQUAL) {
+      if (fabs(dv_value - v) < PRETTY_SMALL){return false;}
+    }
   }
   return true; //all conditionals satisfied
 }
@@ -1231,8 +1432,7 @@ void CDemandOptimizer::AddConstraintToLP(const int ii, const int kk, lp_lib::lpr
   double coeff;
   int    i=0;
   int    retval;
-  double RHS,term;
-  bool   group_has_dv;
+  double RHS;
   int    DV_ind;
   bool   constraint_valid=true;
 
@@ -1246,35 +1446,9 @@ void CDemandOptimizer::AddConstraintToLP(const int ii, const int kk, lp_lib::lpr
     RHS=0.0;
     for (int j = 0; j < pE->nGroups; j++)
     {
-      coeff=1.0;
-      group_has_dv=false;
-      DV_ind=DOESNT_EXIST;
+      if (!EvaluateGroup(pE,j,tt.model_time,coeff,DV_ind)){constraint_valid=false;}
 
-      for (int k = 0; k < pE->nTermsPerGrp[j]; k++)
-      {
-        if (pE->pTerms[j][k]->type == TERM_DV)
-        {
-          DV_ind=pE->pTerms[j][k]->DV_ind;
-          group_has_dv=true;
-          coeff *= (pE->pTerms[j][k]->mult);
-        }
-        else if (!(pE->pTerms[j][k]->is_nested))
-        {
-          term=EvaluateTerm(pE->pTerms[j], k, tt.model_time);
-
-          if (term==RAV_BLANK_DATA){constraint_valid=false;}
-          if (pE->pTerms[j][k]->reciprocal == true)
-          {
-            coeff /= (pE->pTerms[j][k]->mult) * term;
-            ExitGracefullyIf(term==0.0, "AddConstraintToLP: Divide by zero error in evaluating :Expression with division term",BAD_DATA);
-          }
-          else {
-            coeff *= (pE->pTerms[j][k]->mult) * term;
-          }
-        }
-      }
-
-      if (!group_has_dv) {
+      if (DV_ind==DOESNT_EXIST) {
         RHS-=coeff; //term group goes on right hand side
       }
       else {        //term group multiplies decision variable
@@ -1328,45 +1502,27 @@ void CDemandOptimizer::AddConstraintToLP(const int ii, const int kk, lp_lib::lpr
 /// \params pE [in] - conditional expression
 /// \param t [in] - current model time
 /// \param RHS_only [in] - true if only Right hand side of expression is to be evaluated, else RHS-LHS is returned
-/// repeatedly calls EvaluateTerm()
+/// evaluates the compiled instruction list of each term group via EvaluateGroup()
 /// \returns RHS if RHS_only or RHS-LHS if !RHS_only; returns BLANK if any expression is blank (usually time series with blank value)
 //
 double CDemandOptimizer::EvaluateExpression(const expressionStruct* pE,const double &t,bool RHS_only) const
 {
   double coeff;
-  double term;
   double RHS=0.0;
-  bool constraint_valid=true;
+  int    DV_ind;
   for (int j = 0; j < pE->nGroups; j++)
   {
-    coeff=1.0;
     if (RHS_only && j==0) {
       //skip first term (assumes expression is of form  A = B + C - D /E, i.e., only one term on left
     }
     else{
-      for (int k = 0; k < pE->nTermsPerGrp[j]; k++)
-      {
-        if (pE->pTerms[j][k]->type == TERM_DV)
-        {
-          string warn="EvaluateConditionalExp: conditional expressions or demand/return expressions cannot contain decision variables. Problematic command: "+pE->origexp;
-          ExitGracefully(warn.c_str(), BAD_DATA);
-        }
-        else if (!(pE->pTerms[j][k]->is_nested))
-        {
-          term=EvaluateTerm(pE->pTerms[j], k, t);
+      if (!EvaluateGroup(pE,j,t,coeff,DV_ind)){return RAV_BLANK_DATA;} //returns blank if missing data in expression
 
-          if (term==RAV_BLANK_DATA){return RAV_BLANK_DATA;} //returns blank if missing data in expression
-          if (pE->pTerms[j][k]->reciprocal == true)
-          {
-            coeff /= (pE->pTerms[j][k]->mult) * term;
-            ExitGracefullyIf(term==0.0, "EvaluateConditionExp: Divide by zero error in evaluating :Condition or :DemandExpression expression with division term",BAD_DATA);
-          }
-          else {
-            coeff *= (pE->pTerms[j][k]->mult) * term;
-          }
-        }
+      if (DV_ind!=DOESNT_EXIST)
+      {
+        string warn="EvaluateConditionalExp: conditional expressions or demand/return expressions cannot contain decision variables. Problematic command: "+pE->origexp;
+        ExitGracefully(warn.c_str(), BAD_DATA);
       }
-
       RHS-=coeff; //term group goes on right hand side
     }
   }
@@ -1392,100 +1548,62 @@ bool CDemandOptimizer::EvaluateConditionExp(const expressionStruct* pE,const dou
 }
 
 //////////////////////////////////////////////////////////////////
-/// evaluates term in constraint/goal expression to numerical value (unless term is DV)
-/// \params pTerms [in] - pointer to array of terms in expression group (e.g., (A*B*C(D,E) stored as [A,B,C,D,E])
-/// \param k [in] index of term to be evaluated (e.g., 2 would correspond to C)
+/// evaluates group of terms in compiled constraint/goal expression, e.g., (A*B*C(D,E))
+/// \params pE [in] - compiled expression
+/// \param j [in] index of group to be evaluated
 /// \param t [in] current model time
-///  this is called recursively for nested terms in expression group
-/// returns RAV_BLANK_DATA if entire term should be invalidated / not applied
+/// \param coeff [out] product of group terms (excluding decision variable), including multipliers
+/// \param DV_ind [out] index of decision variable in group, or DOESNT_EXIST if group has no decision variable
+/// \returns false if any term evaluates to RAV_BLANK_DATA (entire expression should be invalidated / not applied)
 //
-double CDemandOptimizer::EvaluateTerm(expressionTerm **pTerms,const int k, const double &t) const
+bool CDemandOptimizer::EvaluateGroup(const expressionStruct *pE,const int j,const double &t,double &coeff,int &DV_ind) const
 {
-  int nshift;
-  double duration;
-  double x,y;
-  int kk;
-  int p;
-  const expressionTerm *pT=pTerms[k];
-
-  if      (pT->type == TERM_DV)
-  {
-    //do nothing - can't evaluate
-    ExitGracefully("CDemandOptimizer::EvaluateTerm: trying to expand out active decision variable",RUNTIME_ERR);
-    return -1;
-  }
-  else if (pT->type == TERM_TS)
-  {
-    nshift=pT->timeshift;
-    return pT->pTS->GetValue(t +(double)(nshift));
-  }
-  else if (pT->type == TERM_CUMUL_TS)
-  {
-    duration=(double)(pT->timeshift);
-    return pT->pTS->GetAvgValue(t-duration,duration)*(duration); //assumes daily timestep
-  }
-  else if (pT->type == TERM_LT)
-  {
-    kk=pT->nested_ind1;
-    x=EvaluateTerm(pTerms,kk,t);
-    return pT->pLT->GetValue(x); //decision variable can't be in lookup table
-  }
-  else if (pT->type == TERM_HRU)
-  {
-    int i=pT->SV_index;
-    int k=pT->HRU_index;
-    return _pModel->GetHydroUnit(k)->GetStateVarValue(i); //This will be start of timestep value
-  }
-  else if (pT->type == TERM_SB)
-  {
-    int i=pT->SV_index;
-    int p=pT->p_index;
-    return _pModel->GetSubBasin(p)->GetAvgStateVar(i);
-  }
-  else if (pT->type == TERM_CONST)
-  {
-    return pT->value;
-  }
-  else if (pT->type == TERM_WORKFLOW)
-  {
-    int i=pT->DV_ind;
-    return _pWorkflowVars[i]->current_val;
-  }
-  else if (pT->type == TERM_CUMUL)  //!C123
-  {
-    int d=pT->p_index; //todo - should probably use something else here - misleading code
-    return _aCumDelivery[d];
-  }
-  else if (pT->type == TERM_HISTORY) //e.g., !Q100[-3]
-  {
-    nshift=pT->timeshift-1;
-    char   tmp =pT->origexp[1];//e.g., Q
+  double stack[MAX_TERMS_PER_GROUP]; //each term pushes at most one value
+  int    top=-1;
+  double term;
 
-    p=pT->p_index;
+  ExitGracefullyIf(pE->aInstructions==NULL,"CDemandOptimizer::EvaluateGroup: expression not compiled",RUNTIME_ERR);
 
-    if      (tmp=='Q'){return _aQhist[_aSBIndices[p]][nshift]; }
-    else if (tmp=='h'){return _ahhist[_aSBIndices[p]][nshift]; }
-    else if (tmp=='D'){return _aDhist[_aSBIndices[p]][nshift]; }
-    else if (tmp=='I'){return _aIhist[_aSBIndices[p]][nshift]; }
-    else if (tmp=='B'){return _pModel->GetSubBasin(p)->GetSpecifiedInflow(t+pT->timeshift*1.0); } //ASSUMES DAILY TIMESTEP!
-    else if (tmp=='E'){return _pModel->GetSubBasin(p)->GetEnviroMinFlow  (t+pT->timeshift*1.0); } //ASSUMES DAILY TIMESTEP!
-    else {
-      ExitGracefully("CDemandOptimizer::EvaluateTerm: Invalid history variable ",BAD_DATA);
+  coeff=1.0;
+  DV_ind=DOESNT_EXIST;
+  const expInstruction *I   =pE->aInstructions+pE->aGroupStart[j];
+  const expInstruction *Iend=pE->aInstructions+pE->aGroupStart[j+1];
+  for (; I<Iend; I++)
+  {
+    switch(I->op)
+    {
+    case(OPC_CONST):      {stack[++top]=I->value;                                             break;}
+    case(OPC_POINTER):    {stack[++top]=*(I->pVal);                                           break;}
+    case(OPC_HISTORY):    {stack[++top]=I->pVal[I->ind];                                      break;}
+    case(OPC_TS):         {stack[++top]=I->pTS->GetValue(t+I->value);                         break;}
+    case(OPC_CUMUL_TS):   {stack[++top]=I->pTS->GetAvgValue(t-I->value,I->value)*(I->value);  break;}
+    case(OPC_LOOKUP):     {stack[top]  =I->pLT->GetValue(stack[top]);                         break;}
+    case(OPC_HRU_SV):     {stack[++top]=I->pHRU->GetStateVarValue(I->ind);                    break;} //start of timestep value
+    case(OPC_SB_SV):      {stack[++top]=I->pSB->GetAvgStateVar(I->ind);                       break;}
+    case(OPC_SPEC_INFLOW):{stack[++top]=I->pSB->GetSpecifiedInflow(t+I->value);               break;}
+    case(OPC_ENVIRO_MIN): {stack[++top]=I->pSB->GetEnviroMinFlow  (t+I->value);               break;}
+    case(OPC_MAX):        {top--; stack[top]=max(stack[top],stack[top+1]);                    break;}
+    case(OPC_MIN):        {top--; stack[top]=min(stack[top],stack[top+1]);                    break;}
+    case(OPC_SCALE):      {stack[top]*=I->value;                                              break;}
+    case(OPC_DV):         {DV_ind=I->ind; coeff*=I->value;                                    break;}
+    case(OPC_TERM):
+    {
+      term=stack[top--];
+      if (term==RAV_BLANK_DATA){return false;} //missing data - rest of group not evaluated
+      if (I->ind==1) //reciprocal
+      {
+        if (term==0.0){
+          string warn="CDemandOptimizer::EvaluateGroup: Divide by zero error in evaluating expression with division term: "+pE->origexp;
+          ExitGracefully(warn.c_str(),BAD_DATA);
+        }
+        coeff /= (I->value) * term;
+      }
+      else {
+        coeff *= (I->value) * term;
+      }
+      break;
+    }
     }
   }
-  else if (pT->type == TERM_MAX) {
-    x=EvaluateTerm(pTerms,pT->nested_ind1,t);
-    y=EvaluateTerm(pTerms,pT->nested_ind2,t);
-    return max(x,y);
-  }
-  else if (pT->type == TERM_MIN) {
-    x=EvaluateTerm(pTerms,pT->nested_ind1,t);
-    y=EvaluateTerm(pTerms,pT->nested_ind2,t);
-    return min(x,y);
-  }
-  else if (pT->type == TERM_CONVERT) {
-    x=EvaluateTerm(pTerms,pT->nested_ind1,t);
-    return x*pT->value;
-  }
-  return 0;
+  return true;
 }
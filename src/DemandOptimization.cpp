@@ -433,14 +433,12 @@ bool CDemandOptimizer::VariableNameExists(const string &name) const
 //////////////////////////////////////////////////////////////////
 /// \brief Initializes Demand optimization instance
 /// \notes to be called after .rvh file read and subbasin network initialization, but prior to reading .rvm file
+/// does not itself require lp_solve, so expressions may be parsed and evaluated without it (e.g., in unit tests)
 /// \params pModel [in] - pointer to model
 /// \params Options  [in] - model options structure
 //
 void CDemandOptimizer::Initialize(CModel* pModel, const optStruct& Options)
 {
-#ifndef _LPSOLVE_
-  ExitGracefully("Demand optimization requires compilation with lpsolve library.",RUNTIME_ERR);
-#endif
   int           p;
   string        name;
   CSubBasin    *pSB;
@@ -830,6 +828,16 @@ void CDemandOptimizer::InitializePostRVMRead(CModel* pModel, const optStruct& Op
                                     Options.timestep, true, Options.calendar); //is_observation=true allows for blanks in the time series
   }
 
+  // Compile goal/constraint and workflow variable expressions and conditions
+  //  (demand expressions are compiled in CDemand::Initialize())
+  //------------------------------------------------------------------
+  for (int j = 0; j < _nGoals; j++) {
+    CompileOpRegimes(_pGoals[j]->pOperRegimes,_pGoals[j]->nOperRegimes,Options);
+  }
+  for (int i = 0; i < _nWorkflowVars; i++) {
+    CompileOpRegimes(_pWorkflowVars[i]->pOperRegimes,_pWorkflowVars[i]->nOperRegimes,Options);
+  }
+
   // \todo[funct]: Need to evaluate ALL conditional statements in operating regimes so that issues may be flagged PRIOR to simulation
 
   // Print summary to screen
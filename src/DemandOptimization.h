@@ -9,6 +9,7 @@
 
 #include "RavenInclude.h"
 #include <stdio.h>
+#include <vector>
 #include "Model.h"
 #include "LookupTable.h"
 #include "Demands.h"
@@ -74,6 +75,27 @@ struct decision_var
     value=0.0;min=-ALMOST_INF;max=ALMOST_INF;dvar_type=typ;dem_index=DOESNT_EXIST;
   }
 };
+///////////////////////////////////////////////////////////////////
+/// \brief compiled condition left-hand-side variable types
+//
+enum cond_var
+{
+  COND_UNCOMPILED, //< not yet compiled
+  COND_EXPRESSION, //< conditional expression
+  COND_DAY_OF_YEAR,//< julian day
+  COND_MONTH,      //< month
+  COND_YEAR,       //< year
+  COND_DATE,       //< date
+  COND_POINTER,    //< value at pVal (cumulative delivery !C, user decision variable, workflow variable)
+  COND_QOUT,       //< subbasin outflow !Q
+  COND_STAGE,      //< reservoir stage !h
+  COND_RES_INFLOW, //< reservoir inflow !I
+  COND_DELIVERY,   //< demand delivery !D
+  COND_RETURN,     //< demand return flow !R
+  COND_DEMAND,     //< demand !d
+  COND_NEVER       //< unrecognized variable - condition is never satisfied
+};
+
 //////////////////////////////////////////////////////////////////
 // goal/constraint condition
 //
@@ -89,6 +111,14 @@ struct exp_condition
 
   expressionStruct *pExp;   //< condition expression (or NULL if not used)
 
+  cond_var          var;      //< compiled LHS variable type (set by CDemandOptimizer::CompileCondition())
+  const double     *pVal;     //< pointer to LHS value (if COND_POINTER)
+  const CSubBasin  *pSB;      //< LHS subbasin (if COND_QOUT, COND_STAGE, COND_RES_INFLOW, COND_DELIVERY, or COND_RETURN)
+  const CDemand    *pDemand;  //< LHS demand (if COND_DEMAND)
+  int               dem_ii;   //< local index of demand in pSB (if COND_DELIVERY or COND_RETURN)
+  time_struct       date1;    //< parsed date_string (if COND_DATE)
+  time_struct       date2;    //< parsed date_string2 (if COND_DATE)
+
   exp_condition(){
     dv_name="";
     value=value2=0.0;
@@ -96,6 +126,11 @@ struct exp_condition
     compare=COMPARE_IS_EQUAL;
     p_index=DOESNT_EXIST;
     pExp=NULL;
+    var=COND_UNCOMPILED;
+    pVal=NULL;
+    pSB=NULL;
+    pDemand=NULL;
+    dem_ii=DOESNT_EXIST;
   }
 };
 //////////////////////////////////////////////////////////////////
@@ -254,7 +289,7 @@ private: /*------------------------------------------------------*/
   void     UpdateWorkflowVariables(const time_struct &tt,const optStruct &Options);
   bool     ConvertToExpressionTerm(const string s, expressionTerm* term, const int lineno, const string filename)  const;
   int               GetDVColumnInd(const dv_type typ, const int counter) const;
-  double              EvaluateTerm(expressionTerm **pTerms,const int k, const double &t) const;
+  bool               EvaluateGroup(const expressionStruct *pE,const int j,const double &t,double &coeff,int &DV_ind) const;
   bool        EvaluateConditionExp(const expressionStruct* pE,const double &t) const;
 
   bool     CheckOpRegimeConditions(const op_regime *pOperRegime, const time_struct &tt, const optStruct &Options) const;
@@ -273,6 +308,9 @@ private: /*------------------------------------------------------*/
   void     AddReservoirConstraints(const optStruct &Options);
   void     IdentifyUpstreamDemands();
   bool          VariableNameExists(const string &name) const;
+  void                 CompileTerm(expressionTerm **pTerms,const int k,vector<expInstruction> &aInstr) const;
+  void            CompileCondition(exp_condition *pCond,const optStruct &Options) const;
+  void            CompileOpRegimes(op_regime **pOperRegimes,const int nOperRegimes,const optStruct &Options) const;
 
 public: /*------------------------------------------------------*/
   CDemandOptimizer(CModel *pMod);
@@ -321,6 +359,7 @@ public: /*------------------------------------------------------*/
   double     EvaluateExpression(const expressionStruct* pE,const double &t,bool RHS_only) const;
 
   expressionStruct *ParseExpression(const char **s, const int Len, const int lineno, const string filename) const;
+  void              CompileExpression(expressionStruct *pE) const;
   exp_condition    *ParseCondition (const char **s, const int Len, const int lineno, const string filename) const;
 
   void   Initialize            (CModel *pModel, const optStruct &Options);
@@ -5,6 +5,8 @@ Copyright (c) 2008-2024 the Raven Development Team
 
 #include "EnKF.h"
 #include "Matrix.h"
+#include <map>
+#include <vector>
 
 bool IsContinuousFlowObs(const CTimeSeriesABC* pObs,long long SBID);
 bool ParseInitialConditions(CModel*& pModel,const optStruct& Options);
@@ -68,6 +70,15 @@ CEnKFEnsemble::CEnKFEnsemble(const int num_members,const optStruct &Options)
 
   _window_size=1;
   _nTimeSteps =0;
+
+  _localization=ENKF_LOC_NONE;
+  _loc_radius  =0.0;
+  _aStateDomain=NULL;
+  _nLocDomains =0;
+  _aLocObsCount=NULL;
+  _aLocObsInd  =NULL;
+  _aLocObsWt   =NULL;
+  _aObsTaper   =NULL;
 }
 //////////////////////////////////////////////////////////////////
 /// \brief EnKF Ensemble Destrucutor
@@ -92,6 +103,13 @@ CEnKFEnsemble::~CEnKFEnsemble()
   delete [] _aAssimLayers;
   delete [] _aAssimGroupID;
   delete [] _aObsIndices;
+
+  for (int d=0;d<_nLocDomains;d++){delete [] _aLocObsInd[d]; delete [] _aLocObsWt[d];}
+  delete [] _aLocObsInd;
+  delete [] _aLocObsWt;
+  delete [] _aLocObsCount;
+  delete [] _aStateDomain;
+  delete [] _aObsTaper;
 }
 //////////////////////////////////////////////////////////////////
 /// \brief adds additional state observation perturbation - applied to ALL observations of this type
@@ -162,6 +180,13 @@ void CEnKFEnsemble::SetEnKFMode(EnKF_mode mode)
 //
 void CEnKFEnsemble::SetWindowSize(const int nTimesteps){ _window_size=nTimesteps;}
 
+//////////////////////////////////////////////////////////////////
+/// \brief sets covariance localization method
+/// \param loc [in] localization method
+/// \param radius [in] localization radius [km]
+//
+void CEnKFEnsemble::SetLocalization(EnKF_localization loc, const double &radius){ _localization=loc; _loc_radius=radius;}
+
 //////////////////////////////////////////////////////////////////
 /// \brief set extra RVT filename
 //
@@ -248,9 +273,10 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
     }
   }
 
-  // get names of state variables
+  // get names (and subbasin locations) of state variables
   //-----------------------------------------------
   _state_names=new string [ _nStateVars];
+  int *aStateSubBasin=new int [_nStateVars];
   for(int i=0;i<_nAssimStates;i++)
   {
     kk=_aAssimGroupID[i];
@@ -259,6 +285,7 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
       {
         CSubBasin* pBasin=pModel->GetSubBasinGroup(kk)->GetSubBasin(pp);
 
+        int ii0=ii;
         for (int n=0;n<pBasin->GetInflowHistorySize();n++){_state_names[ii]="inflow_" +to_string(pp)+"_"+to_string(n); ii++; }
         for (int n=0;n<pBasin->GetNumSegments();      n++){_state_names[ii]="outflow_"+to_string(pp)+"_"+to_string(n); ii++; }
         _state_names[ii]="outflowlast_"+to_string(pp); ii++;
@@ -268,6 +295,7 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
           _state_names[ii]="resflow_"    +to_string(pp); ii++;
           _state_names[ii]="resflowlast_"+to_string(pp); ii++;
         }
+        for (int n=ii0;n<ii;n++){aStateSubBasin[n]=pBasin->GetGlobalIndex();}
       }
     }
     else if(_aAssimStates[i]==RESERVOIR_STAGE) {
@@ -276,6 +304,7 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
         CSubBasin* pBasin=pModel->GetSubBasinGroup(kk)->GetSubBasin(pp);
         if (pBasin->GetReservoir() != NULL)
         {
+          aStateSubBasin[ii]=aStateSubBasin[ii+1]=pBasin->GetGlobalIndex();
           _state_names[ii]="resstage_"    +to_string(pp); ii++;
           _state_names[ii]="resstagelast_"+to_string(pp); ii++;
         }
@@ -286,6 +315,7 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
       {
         long long int k=pModel->GetHRUGroup(kk)->GetHRU(n)->GetHRUID();
         string svname = pModel->GetStateVarInfo()->SVTypeToString(_aAssimStates[i], _aAssimLayers[i]);
+        aStateSubBasin[ii]=pModel->GetHRUGroup(kk)->GetHRU(n)->GetSubBasinIndex();
         _state_names[ii]=svname+"_" +to_string(k); ii++;
       }
     }
@@ -317,6 +347,7 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
   _nObsDatapoints=0;
   _nObs=0;
   _aObsIndices=new int [pModel->GetNumObservedTS()];
+  int *aObsTSSubBasin=new int [pModel->GetNumObservedTS()];
   for(int i=0; i<pModel->GetNumObservedTS();i++)
   {
     const CTimeSeriesABC *pTSObs=pModel->GetObservedTS(i);
@@ -327,6 +358,7 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
     if ((good) && (IsContinuousFlowObs(pTSObs,SBID)))
     {
       _aObsIndices[_nObs]=i;
+      aObsTSSubBasin[_nObs]=pSB->GetGlobalIndex();
       _nObs++;
       for(int nn=_nTimeSteps-_window_size+1;nn<=_nTimeSteps;nn++) {
         obsval=pTSObs->GetSampledValue(nn);
@@ -362,6 +394,7 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
   //-----------------------------------------------
   int j;
   double eps;
+  int *aObsSubBasin=new int [_nObsDatapoints];
   for(int e=0;e<_nEnKFMembers;e++)
   {
     j=0;
@@ -391,6 +424,7 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
             else if (pPerturb->adj_type == ADJ_MULTIPLICATIVE){ _noise_matrix[e][j]=(eps*obsval)-obsval; }
           }
           _obs_matrix[e][j]=obsval+_noise_matrix[e][j];
+          aObsSubBasin[j]=aObsTSSubBasin[ii];
           j++;
         }
       }
@@ -401,6 +435,15 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
     }
   }
 
+  // build local analysis domains
+  //-----------------------------------------------
+  if ((_localization!=ENKF_LOC_NONE) && (_nObsDatapoints>0)) {
+    InitializeLocalization(pModel,aStateSubBasin,aObsSubBasin);
+  }
+  delete [] aStateSubBasin;
+  delete [] aObsTSSubBasin;
+  delete [] aObsSubBasin;
+
   // Create and open EnKFOutput file
   //-----------------------------------------------
   string filename= FilenamePrepare("EnKFOutput.csv",Options);
@@ -469,125 +512,433 @@ void CEnKFEnsemble::CloseTimeStepOps(CModel* pModel,optStruct& Options,const tim
 }
 //////////////////////////////////////////////////////////////////
 /// \brief the EnKF assimilation matrix calculations for updating states
-/// Based upon Mandel, J., Efficient Implementation of the Ensemble Kalman Filter, Report, Univ of Colorado, 2006.
 //
 void CEnKFEnsemble::AssimilationCalcs()
 {
   if (_nObsDatapoints==0){return; } //skips assimilation if no observations available
 
-  //return;
-  int i,j,k;
-
-  //some shorthand to clean up local variable names
-  int N       =_nEnKFMembers;   //# of enkf members
-  int M       =_nStateVars;     //# of assimilated state vars
-  int Nobs    =_nObsDatapoints; //# of observed state variables
-
-  double** X  =_state_matrix;   //state matrix is [NxM]
-  double** eQT=_noise_matrix; //outerr matrix is [NxNobs]
-
-  double** HA;   //output matrix difference from ensemble mean [NobsxN]
-  double** HAT;  //HA transpose [NxNobs]
-  double** A;    //prediction ensemble variation matrix [MxN]
-  double** P;    //inverted matrix term
-  double** eQ;
-  double** tmp;
-  double** MM;
-  double** Z;
-  double** X_deltaT;
-  double** X_delta;
-  double* ans =new double[Nobs];
-  double* diff=new double[Nobs];
-
-  AllocateMatrix(M,N,A);
-  AllocateMatrix(Nobs,N,HA);
-  AllocateMatrix(N,Nobs,HAT);
-  AllocateMatrix(Nobs,Nobs,P);
-  AllocateMatrix(Nobs,N,eQ);
-  AllocateMatrix(Nobs,Nobs,tmp);
-  AllocateMatrix(Nobs,N,MM);
-  AllocateMatrix(N,N,Z);
-  AllocateMatrix(M,N,X_deltaT);
-  AllocateMatrix(N,M,X_delta);
-
-  /*cout << "_output_matrix[][]:" << endl;
-  for(int i=0;i<N;i++) {
-    for(int j=0;j<Nobs;j++) {cout<<_output_matrix[i][j]<<"| ";}cout<<endl;
-  }
-  cout<<"_obs_matrix[][]:"<<endl;
-  for(int i=0;i<N;i++) {
-    for(int j=0;j<Nobs;j++) {cout<<_obs_matrix[i][j]<<"| ";}cout<<endl;
-  } */
+  if (_localization!=ENKF_LOC_NONE){
+    LocalizedAssimilationCalcs();
+    return;
+  }
+  EnKFAnalysis(_nEnKFMembers,_nStateVars,_nObsDatapoints,_state_matrix,_output_matrix,_obs_matrix,_noise_matrix);
+}
 
+//////////////////////////////////////////////////////////////////
+/// \brief EnKF analysis step: updates ensemble state matrix X using simulated outputs, perturbed observations and observation noise
+/// Based upon Mandel, J., Efficient Implementation of the Ensemble Kalman Filter, Report, Univ of Colorado, 2006.
+/// \details the innovation covariance P is factored once (Cholesky, with SVD pseudo-inverse fallback if P is not
+/// numerically positive definite) and all members' innovations are solved as a single multiple right-hand-side block.
+/// Work matrices are stored contiguously (row-major) and multiplied with cache-blocked kernels.
+///
+/// \param N [in] number of ensemble members
+/// \param M [in] number of assimilated state variables
+/// \param Nobs [in] number of observation datapoints
+/// \param X [in/out] state matrix [size: N x M]
+/// \param O_sim [in] simulated values corresponding to observations [size: N x Nobs]
+/// \param O_obs [in] perturbed observations [size: N x Nobs]
+/// \param eQT [in] observational noise [size: N x Nobs]
+//
+void CEnKFEnsemble::EnKFAnalysis(const int N, const int M, const int Nobs,
+                                 double **X,
+                                 const double* const* O_sim,
+                                 const double* const* O_obs,
+                                 const double* const* eQT)
+{
+  int i,j,k;
+  const double svd_tol =1e-8;  //relative singular value (and Cholesky pivot) tolerance
+
+  double *HA =new double[Nobs*N];    //output matrix difference from ensemble mean [Nobs x N]
+  double *HAT=new double[N*Nobs];    //HA transpose [N x Nobs]
+  double *A  =new double[M*N];       //prediction ensemble variation matrix [M x N]
+  double *P  =new double[Nobs*Nobs]; //innovation covariance [Nobs x Nobs]
+  double *R  =new double[Nobs*Nobs]; //measurement error covariance [Nobs x Nobs]
+  double *eQ =new double[Nobs*N];    //noise matrix transpose [Nobs x N]
+  double *E  =new double[N*Nobs];    //contiguous copy of noise matrix [N x Nobs]
+  double *MM =new double[Nobs*N];    //innovations, then inv(P)*innovations [Nobs x N]
+  double *Z  =new double[N*N];       //[N x N]
+  double *XdT=new double[M*N];       //X_delta transpose [M x N]
+  ExitGracefullyIf(XdT==NULL,"CEnKFEnsemble::EnKFAnalysis",OUT_OF_MEMORY);
 
   //HA=O_sim-1/N*(O_sim*e_N1)*e_1N
-  double outMean=0;
+  double outMean;
   for(j = 0; j < Nobs; j++) {
     outMean=0;
-    for(i = 0; i < N; i++) {outMean+=_output_matrix[i][j]/N;}
+    for(i = 0; i < N; i++) {outMean+=O_sim[i][j]/N;}
     for(i = 0; i < N; i++) {
-      HA[j][i]=_output_matrix[i][j]-outMean; // Nobs x N
+      HA[j*N+i]=O_sim[i][j]-outMean;
     }
   }
 
   //A =X -1/N*(X *e_N1)*e_1N
-  double Xmean=0;
+  double Xmean;
   for(k = 0; k < M; k++) {
     Xmean=0;
     for(i = 0; i < N; i++) {Xmean+=X[i][k]/N;}
     for(i = 0; i < N; i++) {
-      A[k][i]=X[i][k]-Xmean; // M x N
+      A[k*N+i]=X[i][k]-Xmean;
     }
   }
-  //cout<<"  -calculated HA, A matrices"<<endl;
 
   //P=1/(N-1)*HA*(HA)'+1/(N-1)*(eQ*eQ');
   // 1st term is covariance matrix of simulated output states
   // 2nd term is the covariance matrix (R) of ths measurement error
-  TransposeMat(HA,Nobs,N,HAT);
-  MatMult(HA,HAT,Nobs,N,Nobs,P);        //P is Nobs x Nobs
-  TransposeMat(eQT,N,Nobs,eQ);          //eQ is Nobs x N
-  MatMult(eQ,eQT,Nobs,N,Nobs,tmp);      //tmp is Nobs x Nobs
-  MatAdd(P,tmp,Nobs,Nobs,P);            //P is Nobs x Nobs
-  ScalarMatMult(P,1.0/(N-1),Nobs,Nobs,P);
-
-  //Z=HA'*(inv(P)*(O_obs-O_sim));
-  double svd_tol=1e-8;
-  for(i=0; i<N; i++)
+  for(i = 0; i < N; i++) {
+    for(j = 0; j < Nobs; j++) {E[i*Nobs+j]=eQT[i][j];}
+  }
+  TransposeBlocked(HA,Nobs,N,HAT);
+  MatMultBlocked  (HA,HAT,Nobs,N,Nobs,P);
+  TransposeBlocked(E,N,Nobs,eQ);
+  MatMultBlocked  (eQ,E,Nobs,N,Nobs,R);
+  for(j = 0; j < Nobs*Nobs; j++) {P[j]=(P[j]+R[j])/(N-1);}
+
+  //MM=inv(P)*(O_obs-O_sim), all members at once
+  for(i = 0; i < N; i++) {
+    for(j = 0; j < Nobs; j++) {MM[j*N+i]=O_obs[i][j]-O_sim[i][j];}
+  }
+  memcpy(R,P,Nobs*Nobs*sizeof(double)); //R reused as factorization workspace
+  if (CholeskyFactor(R,Nobs,svd_tol)){
+    CholeskySolve(R,Nobs,MM,N);
+  }
+  else{
+    SVDMultiSolve(P,Nobs,MM,N,svd_tol);
+  }
+
+  //Z=HA'*MM
+  MatMultBlocked(HAT,MM,N,Nobs,N,Z);
+
+  //X_delta = 1/(N-1)*A*Z; Xa=X+X_delta
+  MatMultBlocked(A,Z,M,N,N,XdT);
+  for(k = 0; k < M; k++) {
+    for(i = 0; i < N; i++) {X[i][k]+=XdT[k*N+i]/(N-1);}
+  }
+
+  delete [] HA;
+  delete [] HAT;
+  delete [] A;
+  delete [] P;
+  delete [] R;
+  delete [] eQ;
+  delete [] E;
+  delete [] MM;
+  delete [] Z;
+  delete [] XdT;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Gaspari-Cohn (1999) fifth-order compactly supported taper
+/// \param dist [in] distance [km]
+/// \param radius [in] support radius [km] (taper is zero beyond radius); if <=0, no tapering is applied
+/// \return localization weight [0..1]
+//
+static double GaspariCohnTaper(const double &dist,const double &radius)
+{
+  if (radius<=0.0){return 1.0;}
+  double z=2.0*dist/radius;
+  if      (z<=1.0){return -0.25*pow(z,5)+0.5*pow(z,4)+0.625*pow(z,3)-5.0/3.0*z*z+1.0;}
+  else if (z< 2.0){return pow(z,5)/12.0-0.5*pow(z,4)+0.625*pow(z,3)+5.0/3.0*z*z-5.0*z+4.0-2.0/(3.0*z);}
+  return 0.0;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief calculates along-channel distance [km] from outlet of subbasin p to outlets of all subbasins downstream
+/// \param pModel [in] model
+/// \param p [in] subbasin index
+/// \param maxdist [in] maximum distance of interest [km] (<=0 for entire flow path)
+/// \param aDist [out] distance to each downstream subbasin (including p itself, at distance 0) [size: nSubBasins]; unchanged for others
+/// \param path [out] indices of subbasins on flow path, in downstream order
+//
+static void DownstreamDistances(const CModel *pModel,const int p,const double &maxdist,double *aDist,vector<int> &path)
+{
+  path.clear();
+  int    q=p;
+  double d=0.0;
+  while ((q!=DOESNT_EXIST) && ((maxdist<=0.0) || (d<maxdist)))
   {
-    for(j=0;j<Nobs;j++) { diff[j]=_obs_matrix[i][j]-_output_matrix[i][j]; }
-    SVD(P,diff,ans,Nobs,svd_tol);
-    for(j=0;j<Nobs;j++) { MM[j][i]=ans[j]; } //MM is Nobs x N
-  }
-  MatMult(HAT,MM,N,Nobs,N,Z);           //Z is N x N
-
-  //X_delta = 1/(N-1)*A*Z;
-  MatMult(A,Z,M,N,N,X_deltaT);          //X_deltaT is M x N
-  ScalarMatMult(X_deltaT,1.0/(N-1),M,N,X_deltaT);
-  TransposeMat (X_deltaT,M,N,X_delta);  //X_delta is N x M
-
-  //update state matrix Xa=X+X_delta
-  MatAdd(_state_matrix,X_delta,N,M,_state_matrix);
-
-  /*cout << "X_delta[][]" << endl;
-  for(int i=0;i<N;i++) {
-    for(int j=0;j<M;j++) {cout<<X_delta[i][j]<<"| ";}cout<<endl;
-  }*/
-
-  //clean up
-  delete[] ans;
-  delete[] diff;
-  DeleteMatrix(M,N,A);
-  DeleteMatrix(Nobs,N,HA);
-  DeleteMatrix(N,Nobs,HAT);
-  DeleteMatrix(Nobs,Nobs,P);
-  DeleteMatrix(Nobs,N,eQ);
-  DeleteMatrix(Nobs,Nobs,tmp);
-  DeleteMatrix(Nobs,N,MM);
-  DeleteMatrix(N,N,Z);
-  DeleteMatrix(M,N,X_deltaT);
-  DeleteMatrix(N,M,X_delta);
+    aDist[q]=d;
+    path.push_back(q);
+    q=pModel->GetDownstreamBasin(q);
+    if (q!=DOESNT_EXIST){d+=max(pModel->GetSubBasin(q)->GetReachLength(),0.0)/M_PER_KM;}
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief great circle distance between two subbasin centroids [km]
+/// \param aLat, aLong [in] subbasin centroid latitudes and longitudes [rad]
+/// \param p1, p2 [in] subbasin indices
+//
+static double CentroidDistance(const double *aLat,const double *aLong,const int p1,const int p2)
+{
+  double s1=sin(0.5*(aLat [p2]-aLat [p1]));
+  double s2=sin(0.5*(aLong[p2]-aLong[p1]));
+  double a=s1*s1+cos(aLat[p1])*cos(aLat[p2])*s2*s2;
+  return 2.0*EARTH_RADIUS/M_PER_KM*asin(min(sqrt(a),1.0)); //haversine formula
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief builds local analysis domains (one per subbasin containing assimilated states) and localization weights
+/// \param pModel [in] model
+/// \param aStateSubBasin [in] subbasin index of each assimilated state variable [size: _nStateVars]
+/// \param aObsSubBasin [in] subbasin index of each observation datapoint [size: _nObsDatapoints]
+//
+void CEnKFEnsemble::InitializeLocalization(const CModel *pModel,const int *aStateSubBasin,const int *aObsSubBasin)
+{
+  int p,j,l,d;
+  int nSB =pModel->GetNumSubBasins();
+  int Nobs=_nObsDatapoints;
+
+  ExitGracefullyIf((_localization==ENKF_LOC_DISTANCE) && (_loc_radius<=0.0),
+    "CEnKFEnsemble::InitializeLocalization: a positive localization radius is required for DISTANCE localization",BAD_DATA);
+
+  //one local domain per subbasin with assimilated states
+  int *aSBDomain =new int [nSB];
+  int *aDomainSB =new int [nSB];
+  for (p=0;p<nSB;p++){aSBDomain[p]=DOESNT_EXIST;}
+  _aStateDomain=new int [_nStateVars];
+  _nLocDomains=0;
+  for (int m=0;m<_nStateVars;m++)
+  {
+    p=aStateSubBasin[m];
+    if (aSBDomain[p]==DOESNT_EXIST){
+      aDomainSB[_nLocDomains]=p;
+      aSBDomain[p]=_nLocDomains;
+      _nLocDomains++;
+    }
+    _aStateDomain[m]=aSBDomain[p];
+  }
+
+  //subbasin centroids (area-weighted HRU centroids) [rad]
+  double *aLat=NULL,*aLong=NULL;
+  if (_localization==ENKF_LOC_DISTANCE)
+  {
+    aLat =new double [nSB];
+    aLong=new double [nSB];
+    for (p=0;p<nSB;p++)
+    {
+      const CSubBasin *pBasin=pModel->GetSubBasin(p);
+      double area=0.0;
+      aLat[p]=aLong[p]=0.0;
+      for (int k=0;k<pBasin->GetNumHRUs();k++){
+        const CHydroUnit *pHRU=pBasin->GetHRU(k);
+        aLat [p]+=pHRU->GetArea()*pHRU->GetCentroid().latitude;
+        aLong[p]+=pHRU->GetArea()*pHRU->GetCentroid().longitude;
+        area    +=pHRU->GetArea();
+      }
+      if (area>0.0){aLat[p]*=DEGREES_TO_RADIANS/area; aLong[p]*=DEGREES_TO_RADIANS/area;}
+    }
+  }
+  double *aDist=new double [nSB];
+  for (p=0;p<nSB;p++){aDist[p]=-1.0;}
+  vector<int> path;
+  double dist;
+
+  //localization weights of observations for each domain
+  _aLocObsCount=new int     [_nLocDomains];
+  _aLocObsInd  =new int    *[_nLocDomains];
+  _aLocObsWt   =new double *[_nLocDomains];
+  int    *ind=new int    [Nobs];
+  double *wt =new double [Nobs];
+  for (d=0;d<_nLocDomains;d++)
+  {
+    p=aDomainSB[d];
+    if (_localization==ENKF_LOC_UPSTREAM){DownstreamDistances(pModel,p,_loc_radius,aDist,path);}
+    int n=0;
+    for (j=0;j<Nobs;j++)
+    {
+      if (_localization==ENKF_LOC_DISTANCE){dist=CentroidDistance(aLat,aLong,p,aObsSubBasin[j]);}
+      else                                 {dist=aDist[aObsSubBasin[j]];} //<0 if gauge not downstream
+      if (dist<0.0){continue;}
+      double w=GaspariCohnTaper(dist,_loc_radius);
+      if (w>0.0){ind[n]=j; wt[n]=w; n++;}
+    }
+    _aLocObsCount[d]=n;
+    _aLocObsInd  [d]=new int    [n];
+    _aLocObsWt   [d]=new double [n];
+    for (j=0;j<n;j++){_aLocObsInd[d][j]=ind[j]; _aLocObsWt[d][j]=wt[j];}
+    for (unsigned int i=0;i<path.size();i++){aDist[path[i]]=-1.0;}
+  }
+
+  //observation-observation taper
+  _aObsTaper=new double [Nobs*Nobs];
+  for (j=0;j<Nobs;j++)
+  {
+    if (_localization==ENKF_LOC_UPSTREAM){DownstreamDistances(pModel,aObsSubBasin[j],_loc_radius,aDist,path);}
+    for (l=0;l<Nobs;l++)
+    {
+      if (_localization==ENKF_LOC_DISTANCE){dist=CentroidDistance(aLat,aLong,aObsSubBasin[j],aObsSubBasin[l]);}
+      else                                 {dist=aDist[aObsSubBasin[l]];}
+      _aObsTaper[j*Nobs+l]=(dist<0.0) ? 0.0 : GaspariCohnTaper(dist,_loc_radius);
+    }
+    for (unsigned int i=0;i<path.size();i++){aDist[path[i]]=-1.0;}
+  }
+  for (j=0;j<Nobs;j++){ //symmetrize (upstream/downstream connection is one-directional)
+    for (l=0;l<j;l++){
+      double w=max(_aObsTaper[j*Nobs+l],_aObsTaper[l*Nobs+j]);
+      _aObsTaper[j*Nobs+l]=_aObsTaper[l*Nobs+j]=w;
+    }
+  }
+  cout<<"ENKF: Localized analysis over "<<_nLocDomains<<" local subbasin domains."<<endl;
+
+  delete [] aSBDomain;
+  delete [] aDomainSB;
+  delete [] aLat;
+  delete [] aLong;
+  delete [] aDist;
+  delete [] ind;
+  delete [] wt;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief localized EnKF analysis: states of each local (subbasin) domain are updated independently from the
+/// observations within its localization radius, with tapered cross covariances
+/// \details covariance localization after Houtekamer and Mitchell (2001): K_d=(w_d o A*HA')*inv(rho o P) with
+/// P as in EnKFAnalysis(). Domains sharing the same set of influential observations share a single factorization
+/// of the (small) local P; local analyses are independent and run in parallel if compiled with OpenMP.
+//
+void CEnKFEnsemble::LocalizedAssimilationCalcs()
+{
+  const int N   =_nEnKFMembers;
+  const int Nobs=_nObsDatapoints;
+  const double svd_tol=1e-8;
+  double **X=_state_matrix;
+  int i,j,d;
+
+  //observation-space anomalies, noise and innovations [Nobs x N]
+  double *HA=new double [Nobs*N];
+  double *eQ=new double [Nobs*N];
+  double *D =new double [Nobs*N];
+  for (j=0;j<Nobs;j++)
+  {
+    double outMean=0;
+    for (i=0;i<N;i++){outMean+=_output_matrix[i][j]/N;}
+    for (i=0;i<N;i++){
+      HA[j*N+i]=_output_matrix[i][j]-outMean;
+      eQ[j*N+i]=_noise_matrix[i][j];
+      D [j*N+i]=_obs_matrix[i][j]-_output_matrix[i][j];
+    }
+  }
+
+  //group domains by set of influential observations
+  map<vector<int>,int> subset_index;
+  vector<const int *> aSubsetInd;
+  vector<int>         aSubsetSize;
+  int *aDomainSubset=new int [_nLocDomains];
+  for (d=0;d<_nLocDomains;d++)
+  {
+    vector<int> key(_aLocObsInd[d],_aLocObsInd[d]+_aLocObsCount[d]);
+    map<vector<int>,int>::iterator it=subset_index.find(key);
+    if (it==subset_index.end()){
+      aDomainSubset[d]=(int)(aSubsetInd.size());
+      subset_index[key]=aDomainSubset[d];
+      aSubsetInd .push_back(_aLocObsInd[d]);
+      aSubsetSize.push_back(_aLocObsCount[d]);
+    }
+    else{
+      aDomainSubset[d]=it->second;
+    }
+  }
+  int nSubsets=(int)(aSubsetInd.size());
+
+  //states in each domain
+  int *aDomainStart =new int [_nLocDomains+1];
+  int *aDomainStates=new int [_nStateVars];
+  for (d=0;d<=_nLocDomains;d++){aDomainStart[d]=0;}
+  for (int m=0;m<_nStateVars;m++){aDomainStart[_aStateDomain[m]+1]++;}
+  for (d=0;d<_nLocDomains;d++){aDomainStart[d+1]+=aDomainStart[d];}
+  int *aFill=new int [_nLocDomains];
+  for (d=0;d<_nLocDomains;d++){aFill[d]=aDomainStart[d];}
+  for (int m=0;m<_nStateVars;m++){aDomainStates[aFill[_aStateDomain[m]]++]=m;}
+  delete [] aFill;
+
+  //factor local innovation covariance of each observation subset, solve for MM_s=inv(P_s)*D_s [ns x N]
+  double **aMM =new double *[nSubsets];
+  double **aHAT=new double *[nSubsets];
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (int s=0;s<nSubsets;s++)
+  {
+    const int  ns =aSubsetSize[s];
+    const int *ind=aSubsetInd [s];
+    aMM [s]=new double [ns*N];
+    aHAT[s]=new double [N*ns];
+    if (ns==0){continue;}
+    double *HAs=new double [ns*N];
+    double *eQs=new double [ns*N];
+    double *T  =new double [N*ns];
+    double *P  =new double [ns*ns];
+    double *R  =new double [ns*ns];
+    for (int a=0;a<ns;a++){
+      memcpy(HAs    +a*N,HA+ind[a]*N,N*sizeof(double));
+      memcpy(eQs    +a*N,eQ+ind[a]*N,N*sizeof(double));
+      memcpy(aMM[s] +a*N,D +ind[a]*N,N*sizeof(double));
+    }
+    TransposeBlocked(HAs,ns,N,aHAT[s]);
+    MatMultBlocked  (HAs,aHAT[s],ns,N,ns,P);
+    TransposeBlocked(eQs,ns,N,T);
+    MatMultBlocked  (eQs,T,ns,N,ns,R);
+    for (int a=0;a<ns;a++){
+      for (int b=0;b<ns;b++){
+        P[a*ns+b]=(P[a*ns+b]+R[a*ns+b])/(N-1)*_aObsTaper[ind[a]*Nobs+ind[b]];
+      }
+    }
+    memcpy(R,P,ns*ns*sizeof(double));
+    if (CholeskyFactor(R,ns,svd_tol)){CholeskySolve(R,ns,aMM[s],N);}
+    else                             {SVDMultiSolve(P,ns,aMM[s],N,svd_tol);}
+    delete [] HAs;
+    delete [] eQs;
+    delete [] T;
+    delete [] P;
+    delete [] R;
+  }
+
+  //update states of each domain: X_d+=1/(N-1)*A_d*HA_s'*(w_d o MM_s)
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+  for (int dd=0;dd<_nLocDomains;dd++)
+  {
+    const int s =aDomainSubset[dd];
+    const int ns=aSubsetSize[s];
+    const int m0=aDomainStart[dd];
+    const int nm=aDomainStart[dd+1]-m0;
+    if (ns==0){continue;}
+    double *A =new double [nm*N];
+    double *C =new double [ns*N];
+    double *G =new double [nm*ns];
+    double *dX=new double [nm*N];
+    for (int r=0;r<nm;r++)
+    {
+      int k=aDomainStates[m0+r];
+      double Xmean=0;
+      for (int ii=0;ii<N;ii++){Xmean+=X[ii][k]/N;}
+      for (int ii=0;ii<N;ii++){A[r*N+ii]=X[ii][k]-Xmean;}
+    }
+    for (int a=0;a<ns;a++){
+      for (int ii=0;ii<N;ii++){C[a*N+ii]=_aLocObsWt[dd][a]*aMM[s][a*N+ii];}
+    }
+    MatMultBlocked(A,aHAT[s],nm,N,ns,G);
+    MatMultBlocked(G,C,nm,ns,N,dX);
+    for (int r=0;r<nm;r++)
+    {
+      int k=aDomainStates[m0+r];
+      for (int ii=0;ii<N;ii++){X[ii][k]+=dX[r*N+ii]/(N-1);}
+    }
+    delete [] A;
+    delete [] C;
+    delete [] G;
+    delete [] dX;
+  }
 
+  for (int s=0;s<nSubsets;s++){delete [] aMM[s]; delete [] aHAT[s];}
+  delete [] aMM;
+  delete [] aHAT;
+  delete [] aDomainSubset;
+  delete [] aDomainStart;
+  delete [] aDomainStates;
+  delete [] HA;
+  delete [] eQ;
+  delete [] D;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -25,6 +25,15 @@ enum EnKF_mode
   ENKF_UNSPECIFIED
 };
 ////////////////////////////////////////////////////////////////////
+/// \brief EnKF covariance localization method
+//
+enum EnKF_localization
+{
+  ENKF_LOC_NONE,     ///< global analysis: all states updated from all observations
+  ENKF_LOC_UPSTREAM, ///< states updated only from gauges downstream (i.e., observations of their drainage), tapered by channel distance
+  ENKF_LOC_DISTANCE  ///< states updated from gauges within localization radius, tapered by distance between subbasin centroids
+};
+////////////////////////////////////////////////////////////////////
 /// \brief Data abstraction for EnKF model ensemble run
 //
 class CEnKFEnsemble : public CEnsemble
@@ -64,7 +73,18 @@ private:
 
   ofstream      _ENKFOUT;           ///< output file stream
 
+  EnKF_localization _localization;  ///< covariance localization method
+  double         _loc_radius;       ///< localization radius [km] (support of Gaspari-Cohn taper; <=0 for no taper in ENKF_LOC_UPSTREAM mode)
+  int           *_aStateDomain;     ///< index of local analysis domain of each state variable [size: _nStateVars]
+  int            _nLocDomains;      ///< number of local analysis domains (subbasins containing assimilated states)
+  int           *_aLocObsCount;     ///< number of observation datapoints influencing each local domain [size: _nLocDomains]
+  int          **_aLocObsInd;       ///< indices of observation datapoints influencing each local domain [size: _nLocDomains x _aLocObsCount[d]]
+  double       **_aLocObsWt;        ///< localization weights of observation datapoints for each local domain [size: _nLocDomains x _aLocObsCount[d]]
+  double        *_aObsTaper;        ///< observation-observation localization taper [size: _nObsDatapoints x _nObsDatapoints, row-major]
+
   void AssimilationCalcs();         //< determines the final state matrix after assimilation
+  void LocalizedAssimilationCalcs();//< localized version of AssimilationCalcs
+  void InitializeLocalization(const CModel *pModel,const int *aStateSubBasin,const int *aObsSubBasin);
   void UpdateFromStateMatrix(CModel *pModel,optStruct& Options,const int e);
   void AddToStateMatrix     (CModel* pModel,optStruct& Options,const int e);
 public:
@@ -74,9 +94,16 @@ public:
   double GetStartTime(const int e) const;
   EnKF_mode GetEnKFMode() const;
 
+  static void EnKFAnalysis(const int N, const int M, const int Nobs,
+                           double **X,
+                           const double* const* O_sim,
+                           const double* const* O_obs,
+                           const double* const* eQT);
+
   void SetEnKFMode           (EnKF_mode mode);
   void SetWarmRunname        (string runname);
   void SetWindowSize         (const int nTimesteps);
+  void SetLocalization       (EnKF_localization loc, const double &radius);
   void SetExtraRVTFile       (string filename);
   void AddObsPerturbation    (sv_type      type, disttype distrib, double *distpars, adjustment adj);
   void AddAssimilationState  (sv_type sv, int layer, int assim_groupID);
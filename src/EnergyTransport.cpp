@@ -6,6 +6,7 @@ CEnthalpyModel routines related to energy/enthalpy transport
 ----------------------------------------------------------------*/
 #include "RavenInclude.h"
 #include "EnergyTransport.h"
+#include "Checkpoint.h"
 
 //////////////////////////////////////////////////////////////////
 /// \brief enthalpy model constructor
@@ -1241,6 +1242,36 @@ void CEnthalpyModel::CloseOutputFiles()
   CConstituentModel::CloseOutputFiles();
   _STREAMOUT.close();
 }
+//////////////////////////////////////////////////////////////////
+/// \brief Writes enthalpy routing states (including riverbed temperatures and source term histories) to binary checkpoint
+/// \param &C [out] checkpoint buffer
+//
+void CEnthalpyModel::WriteToCheckpoint(CCheckpoint &C) const
+{
+  CConstituentModel::WriteToCheckpoint(C);
+  for(int p=0;p<_pModel->GetNumSubBasins();p++)
+  {
+    C.PutDouble(_aBedTemp   [p]);
+    C.PutDouble(_aTave_reach[p]);
+    C.PutArray (_aEnthalpySource [p],_nMinHist [p]);
+    C.PutArray (_aEnthalpySource2[p],_nMlatHist[p]);
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Reads enthalpy routing states from binary checkpoint
+/// \param &C [in] checkpoint buffer
+//
+void CEnthalpyModel::ReadFromCheckpoint(CCheckpoint &C)
+{
+  CConstituentModel::ReadFromCheckpoint(C);
+  for(int p=0;p<_pModel->GetNumSubBasins();p++)
+  {
+    _aBedTemp   [p]=C.GetDouble();
+    _aTave_reach[p]=C.GetDouble();
+    C.GetArray(_aEnthalpySource [p],_nMinHist [p],"enthalpy source history size");
+    C.GetArray(_aEnthalpySource2[p],_nMlatHist[p],"enthalpy source history size");
+  }
+}
 
 //////////////////////////////////////////////////////////////////
 /// \brief for unit testing
@@ -99,6 +99,8 @@ public:/*-------------------------------------------------------*/
   void   WriteMinorOutput            (const optStruct& Options,const time_struct& tt);
   void   WriteEnsimOutputFileHeaders (const optStruct &Options);
   void   WriteEnsimMinorOutput       (const optStruct &Options,const time_struct &tt);
+  void   WriteToCheckpoint           (CCheckpoint &C) const;
+  void   ReadFromCheckpoint          (CCheckpoint &C);
   void   CloseOutputFiles            ();
 };
 #endif
@@ -333,9 +333,12 @@ double CModel::EstimatePET(const force_struct &F,
     ExitGracefullyIf(_PETBlends_N==0,
       "EstimatePET: PET_BLENDED specified, but no weights were provided using :BlendedPETWeights command",BAD_DATA);
 
+    const double *wts=_PETBlends_wts;
+    if (pHRU->GetPETBlendWeights()!=NULL){wts=pHRU->GetPETBlendWeights();} //local override
+
     for(int i=0; i<_PETBlends_N;i++) {
       evap_method etyp=_PETBlends_type[i];
-      double        wt=_PETBlends_wts[i];
+      double        wt=wts[i];
       PET+=wt*EstimatePET(F,pHRU,wind_measurement_ht,ref_elevation,etyp,Options,tt,open_water);
 
       if(rvn_isnan(PET)) {
@@ -484,7 +487,7 @@ double CModel::EstimatePET(const force_struct &F,
   {
     double lat_rad=pHRU->GetLatRad();
     double declin=CRadiation::SolarDeclination(F.day_angle);
-    double cpet = this->_pGlobalParams->GetParams()->MOHYSE_PET_coeff;
+    double cpet = pHRU->GetGlobalParams()->MOHYSE_PET_coeff;
 
     PET = cpet/PI*acos(-tan(lat_rad)*tan(declin))*exp((17.3*F.temp_ave)/(238+F.temp_ave));
     PET=max(PET,0.0);
@@ -3,6 +3,10 @@
 #include "LookupTable.h"
 
 #pragma once
+
+class CHydroUnit;
+class CSubBasin;
+
 ///////////////////////////////////////////////////////////////////
 /// \brief different expression term types
 //
@@ -24,6 +28,49 @@ enum termtype
   TERM_UNKNOWN    //< unknown
 };
 
+///////////////////////////////////////////////////////////////////
+/// \brief compiled expression instruction codes
+/// \details instructions operate on a small value stack; leaf terms push a value, functions replace their arguments
+//
+enum exp_opcode
+{
+  OPC_CONST,       //< push constant
+  OPC_POINTER,     //< push *pVal (workflow variable, cumulative delivery)
+  OPC_HISTORY,     //< push pVal[ind] (flow, stage, delivery or inflow history)
+  OPC_TS,          //< push time series value at t+value
+  OPC_CUMUL_TS,    //< push time series total over previous value days
+  OPC_LOOKUP,      //< replace x with lookup table value
+  OPC_HRU_SV,      //< push state variable ind of HRU
+  OPC_SB_SV,       //< push average state variable ind of subbasin
+  OPC_SPEC_INFLOW, //< push specified inflow of subbasin at t+value
+  OPC_ENVIRO_MIN,  //< push environmental minimum flow of subbasin at t+value
+  OPC_MAX,         //< replace x,y with max(x,y)
+  OPC_MIN,         //< replace x,y with min(x,y)
+  OPC_SCALE,       //< replace x with x*value (unit conversion)
+  OPC_DV,          //< decision variable ind; multiplies group coefficient by value
+  OPC_TERM         //< pops term; multiplies group coefficient by value*term (or divides, if ind==1)
+};
+
+//////////////////////////////////////////////////////////////////
+/// compiled expression instruction
+///    expression terms with all names, indices and nested arguments resolved to direct pointers
+//
+struct expInstruction
+{
+  exp_opcode          op;     //< instruction code
+  double              value;  //< constant, multiplier, conversion factor or time shift/duration [d]
+  int                 ind;    //< history offset, state variable index, decision variable index or reciprocal flag
+  const double       *pVal;   //< pointer to value or history array (OPC_POINTER, OPC_HISTORY)
+  const CTimeSeries  *pTS;    //< time series (OPC_TS, OPC_CUMUL_TS)
+  const CLookupTable *pLT;    //< lookup table (OPC_LOOKUP)
+  const CHydroUnit   *pHRU;   //< HRU (OPC_HRU_SV)
+  const CSubBasin    *pSB;    //< subbasin (OPC_SB_SV, OPC_SPEC_INFLOW, OPC_ENVIRO_MIN)
+
+  expInstruction(const exp_opcode code=OPC_CONST) {
+    op=code; value=0.0; ind=0; pVal=NULL; pTS=NULL; pLT=NULL; pHRU=NULL; pSB=NULL;
+  }
+};
+
 // -------------------------------------------------------------------
 // data structures used by CDemandOptimizer class:
 //   -expressionTerm
@@ -78,6 +125,10 @@ struct expressionStruct //full expression
 
   string             origexp;     //< original string expression
 
+  expInstruction    *aInstructions;//< compiled expression (NULL until CDemandOptimizer::CompileExpression() called) [size: nInstructions]
+  int                nInstructions;//< number of compiled instructions
+  int               *aGroupStart;  //< index of first compiled instruction of each group [size: nGroups+1]
+
   expressionStruct();
   ~expressionStruct();
 };
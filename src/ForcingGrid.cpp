@@ -8,6 +8,12 @@
 #include "Forcings.h"
 #include <string.h>
 
+const double READ_BLOCK_MIN_FILL  =0.5; ///< minimum fraction of non-zero weighted cells in a read block before it is split
+const int    READ_BLOCK_MIN_CELLS =64;  ///< read blocks this small are never split (per-call overhead dominates)
+const int    MAX_READ_BLOCKS      =64;  ///< maximum number of read blocks (hyperslabs) per forcing grid
+
+map<string,nc_shared_file> CForcingGrid::_mOpenFiles;
+
 /*****************************************************************
    Constructor/Destructor
 ------------------------------------------------------------------
@@ -80,6 +86,16 @@ CForcingGrid::CForcingGrid(string       ForcingType,
   _IdxNonZeroGridCells = NULL;
   _nNonZeroWeightedGridCells=0;
 
+  //initialized in PlanReadBlocks()
+  _nReadBlocks         =0;
+  _aBlockStart [0]     =NULL; _aBlockStart [1]=NULL;
+  _aBlockLength[0]     =NULL; _aBlockLength[1]=NULL;
+  _aBlockFirstCell     =NULL;
+  _aBlockCells         =NULL;
+  _maxBlockCells       =0;
+  _nReadCells          =0;
+  _open_ncfile         ="";
+
   //initialized in CalculateChunkSize()
   _ChunkSize           =0;
   _nChunk              =1;
@@ -175,6 +191,29 @@ CForcingGrid::CForcingGrid( const CForcingGrid &grid )
     _IdxNonZeroGridCells[ic]=grid._IdxNonZeroGridCells[ic];
   }
 
+  _nReadBlocks  =grid._nReadBlocks;
+  _maxBlockCells=grid._maxBlockCells;
+  _nReadCells   =grid._nReadCells;
+  _open_ncfile  ="";  //derived grids are never read from file
+  _aBlockStart [0]=NULL; _aBlockStart [1]=NULL;
+  _aBlockLength[0]=NULL; _aBlockLength[1]=NULL;
+  _aBlockFirstCell=NULL; _aBlockCells    =NULL;
+  if(grid._aBlockFirstCell!=NULL) {
+    for(int d=0;d<2;d++) {
+      _aBlockStart [d]=new int[_nReadBlocks];
+      _aBlockLength[d]=new int[_nReadBlocks];
+      for(int b=0; b<_nReadBlocks; b++) {
+        _aBlockStart [d][b]=grid._aBlockStart [d][b];
+        _aBlockLength[d][b]=grid._aBlockLength[d][b];
+      }
+    }
+    _aBlockFirstCell=new int[_nReadBlocks+1];
+    _aBlockCells    =new int[_nNonZeroWeightedGridCells];
+    ExitGracefullyIf(_aBlockCells==NULL,"CForcingGrid::Copy Constructor(9)",OUT_OF_MEMORY);
+    for(int b=0; b<=_nReadBlocks; b++)               {_aBlockFirstCell[b]=grid._aBlockFirstCell[b];}
+    for(int ic=0; ic<_nNonZeroWeightedGridCells; ic++){_aBlockCells[ic]   =grid._aBlockCells[ic];}
+  }
+
   _aLatitude=NULL;_aLongitude=NULL;_aElevation=NULL;_aStationIDs=NULL;
   if(grid._aLatitude!=NULL) {
     _aLatitude=new double [_nNonZeroWeightedGridCells];
@@ -222,6 +261,14 @@ CForcingGrid::~CForcingGrid()
   delete [] _aLongitude;            _aLongitude          = NULL;
   delete [] _aElevation;            _aElevation          = NULL;
   delete [] _aStationIDs;           _aStationIDs         = NULL;
+  for(int d=0;d<2;d++) {
+    delete [] _aBlockStart [d];     _aBlockStart [d]     = NULL;
+    delete [] _aBlockLength[d];     _aBlockLength[d]     = NULL;
+  }
+  delete [] _aBlockFirstCell;       _aBlockFirstCell     = NULL;
+  delete [] _aBlockCells;           _aBlockCells         = NULL;
+
+  if(_open_ncfile!="") { ReleaseNetCDFFile(_open_ncfile); _open_ncfile=""; }
 }
 
 
@@ -294,7 +341,7 @@ void CForcingGrid::ForcingGridInit(const optStruct   &Options)
   string filename_e=_filename;
   SubstringReplace(filename_e,"*",to_string(g_current_e+1)); //replaces wildcard for ensemble runs
 
-  retval = nc_open(filename_e.c_str(),NC_NOWRITE,&ncid);          HandleNetCDFErrors(retval);
+  ncid = AcquireNetCDFFile(filename_e);
 
 
   // Get the id of dimensions based on its name; dimid will be set
@@ -526,10 +573,10 @@ void CForcingGrid::ForcingGridInit(const optStruct   &Options)
                    "CForcingGrid: ForcingGridInit: no time point entries in forcing grid",BAD_DATA);
 
   // -------------------------------
-  // Close the file. This frees up any internal NetCDF resources
-  // associated with the file, and flushes any buffers.
+  // Release the file. This closes it (freeing up any internal NetCDF resources)
+  // unless another forcing grid is currently reading from it
   // -------------------------------
-  retval = nc_close(ncid);         HandleNetCDFErrors(retval);
+  ReleaseNetCDFFile(filename_e);
 
   _is_derived = false;
 
@@ -603,7 +650,7 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
 
 #ifdef _RVNETCDF_
 
-  int     ir,ic,it;
+  int     ic,it;
   int     iChunk_new;    // chunk in which current model time step falls
 
   // check if chunk id is valid
@@ -648,9 +695,8 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
     // local variables
 
     int     ncid;          // file unit
-    int     dim1;          // length of 1st dimension in NetCDF data
-    int     dim2;          // length of 2nd dimension in NetCDF data
-    int     dim3;          // length of 3rd dimension in NetCDF data
+    int     dim1;          // length of 1st dimension of attribute grids in NetCDF data
+    int     dim2;          // length of 2nd dimension of attribute grids in NetCDF data
 
     int     varid_f;       // id of forcing variable read
     double  missval;       // value of "missing_value" attribute of forcing variable
@@ -686,12 +732,20 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
     string filename_e=_filename;
     SubstringReplace(filename_e,"*",to_string(g_current_e+1)); //replaces wildcard for ensemble runs
 
-    retval = nc_open(filename_e.c_str(),NC_NOWRITE,&ncid);      HandleNetCDFErrors(retval);
+    // the file handle is shared with all other forcing grids reading from the same file and
+    // held open between chunks; switches files if the ensemble member has changed
+    if (filename_e!=_open_ncfile) {
+      if (_open_ncfile!="") { ReleaseNetCDFFile(_open_ncfile); }
+      AcquireNetCDFFile(filename_e);
+      _open_ncfile=filename_e;
+    }
+    ncid=_mOpenFiles[_open_ncfile].ncid;
 
     string varname_e=_varname;
     SubstringReplace(varname_e,"*",to_string(g_current_e+1)); //replaces wildcard for ensemble runs
 
     retval = nc_inq_varid(ncid,varname_e.c_str(),&varid_f);     HandleNetCDFErrors(retval);
+    SetVarChunkCache(_open_ncfile,ncid,varid_f,Options);
 
     // find "_FillValue" of forcing data
     // -------------------------------
@@ -734,279 +788,91 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
       cout << "scale_factor = " << scale_factor << endl;
     }
 
-    // allocate aTmp matrix
+    // Read chunk of data, one dense hyperslab (read block) at a time
     // -------------------------------
-    dim1 = 1; dim2 = 1; dim3 = 1;
-
-    if ( _is_3D ) {
-      switch(_dim_order)
-      {
-      case(1):
-        dim1 = _WinLength[0]; dim2 = _WinLength[1]; dim3 = iChunkSize;    break; // dimensions are (x,y,t)
-      case(2):
-        dim1 = _WinLength[1]; dim2 = _WinLength[0]; dim3 = iChunkSize;    break; // dimensions are (y,x,t)
-      case(3):
-        dim1 = _WinLength[0]; dim2 = iChunkSize;    dim3 = _WinLength[1]; break; // dimensions are (x,t,y)
-      case(4):
-        dim1 = iChunkSize;    dim2 = _WinLength[0]; dim3 = _WinLength[1]; break; // dimensions are (t,x,y)
-      case(5):
-        dim1 = _WinLength[1]; dim2 = iChunkSize;    dim3 = _WinLength[0]; break; // dimensions are (y,t,x)
-      case(6):
-        dim1 = iChunkSize;    dim2 = _WinLength[1]; dim3 = _WinLength[0]; break; // dimensions are (t,y,x)
-      }
-    }
-    else {
-      switch(_dim_order)
-      {
-      case(1):
-        dim1 = _GridDims[0]; dim2 = iChunkSize;   dim3 = 1; break; // dimensions are (station,t)
-      case(2):
-        dim1 = iChunkSize;   dim2 = _GridDims[0]; dim3 = 1; break; // dimensions are (t, station)
-      }
-    }
+    // each read block covers a rectangle of cells (3D) or a range of stations (2D) containing
+    // non-zero weighted cells; cells outside all blocks are never read
+    int       axes[3];        // axis (0=x,1=y,2=t) corresponding to each NetCDF dimension
+    int       nDims=(_is_3D) ? 3 : 2;
+    int       start_point = _ChunkSize * _iChunk+(int)(_t_corr/_interval);//JRC_TIME_FIX:
+    size_t    nc_start [3];
+    size_t    nc_length[3];
+    int       axStart  [3];   // start of read block along each axis (x,y,t)
+    int       axLength [3];   // length of read block along each axis (x,y,t)
+    int       axStride [3];   // stride of each axis (x,y,t) within aVec
+    int       irow,icol,idx;
+    double    val;
+
+    GetDimAxes(axes);
 
-    // -------------------------------
-    // emulate VLA 3D array storage - store 3D array as vector using Row Major Order
-    // -------------------------------
     double *aVec=NULL;
-    aVec=new double[dim1*dim2*dim3];//stores actual data
+    aVec=new double[_maxBlockCells*iChunkSize];//stores actual data of one read block, in NetCDF dimension order
     ExitGracefullyIf(aVec==NULL,"CForcingGrid::ReadData : aVec",OUT_OF_MEMORY);
-    for(int i=0; i<dim1*dim2*dim3; i++) {
-      aVec[i]=NETCDF_BLANK_VALUE;
-    }
 
-    double ***aTmp3D=NULL; //stores pointers to rows/columns of 3D data
-    double  **aTmp2D=NULL; //stores pointers to rows/columns of 2D data
-    if ( _is_3D ) {
-      aTmp3D=new double **[dim1];
-      ExitGracefullyIf(aTmp3D==NULL,"CForcingGrid::ReadData : aTmp3D(0)",OUT_OF_MEMORY);
-      for(it=0;it<dim1;it++){
-        aTmp3D[it]=NULL;
-        aTmp3D[it]=new double *[dim2];
-        ExitGracefullyIf(aTmp3D[it]==NULL,"CForcingGrid::ReadData : aTmp3D(1)",OUT_OF_MEMORY);
-        for(ir=0;ir<dim2;ir++){
-          aTmp3D[it][ir]=&aVec[it*dim2*dim3+ir*dim3]; //points to correct location in aVec data storage
-        }
-      }
-    }
-    else {
-      aTmp2D=new double *[dim1];
-      ExitGracefullyIf(aTmp2D==NULL,"CForcingGrid::ReadData : aTmp2D(0)",OUT_OF_MEMORY);
-      for(it=0;it<dim1;it++){
-        aTmp2D[it]=&aVec[it*dim2]; //points to correct location in aVec data storage
-      }
+    if (Options.noisy) {
+      cout<<" CForcingGrid::ReadData - "<<_nReadBlocks<<" read block(s), "<<_nReadCells<<" cells per time step"<<endl;
     }
 
-    // Read chunk of data.
-    // -------------------------------
-    if ( _is_3D )
+    for (int b=0; b<_nReadBlocks; b++)
     {
-      int       start_point = _ChunkSize * _iChunk+(int)(_t_corr/_interval);;//JRC_TIME_FIX:
-      size_t    nc_start [3];
-      size_t    nc_length[3];
-      ptrdiff_t nc_stride[3];
-
-      nc_length[0] = (size_t)(dim1); nc_stride[0] = 1;
-      nc_length[1] = (size_t)(dim2); nc_stride[1] = 1;
-      nc_length[2] = (size_t)(dim3); nc_stride[2] = 1;
-
-      switch(_dim_order) {
-      case(1): // dimensions are (x,y,t)
-        nc_start[0]  = (size_t)(_WinStart[0]);  nc_start[1]  = (size_t)(_WinStart[1]);  nc_start[2]  = (size_t)(start_point);
-        break;
-      case(2): // dimensions are (y,x,t)
-        nc_start[0]  = (size_t)(_WinStart[1]);  nc_start[1]  = (size_t)(_WinStart[0]);  nc_start[2]  = (size_t)(start_point);
-        break;
-      case(3): // dimensions are (x,t,y)
-        nc_start[0]  = (size_t)(_WinStart[0]);  nc_start[1]  = (size_t)(start_point);   nc_start[2]  = (size_t)(_WinStart[1]);
-        break;
-      case(4): // dimensions are (t,x,y)
-        nc_start[0]  = (size_t)(start_point);   nc_start[1]  = (size_t)(_WinStart[0]);  nc_start[2]  = (size_t)(_WinStart[1]);
-        break;
-      case(5): // dimensions are (y,t,x)
-        nc_start[0]  = (size_t)(_WinStart[1]);  nc_start[1]  = (size_t)(start_point);   nc_start[2]  = (size_t)(_WinStart[0]);
-        break;
-      case(6): // dimensions are (t,y,x)
-        nc_start[0]  = (size_t)(start_point);   nc_start[1]  = (size_t)(_WinStart[1]);  nc_start[2]  = (size_t)(_WinStart[0]);
-        break;
+      axStart [0]=_aBlockStart [0][b]; axStart [1]=_aBlockStart [1][b]; axStart [2]=start_point;
+      axLength[0]=_aBlockLength[0][b]; axLength[1]=_aBlockLength[1][b]; axLength[2]=iChunkSize;
+      axStride[1]=0; //unused for 2D (stations, time) data
+
+      int stride=1;
+      for (int i=nDims-1; i>=0; i--) { //row major order
+        nc_start [i]=(size_t)(axStart [axes[i]]);
+        nc_length[i]=(size_t)(axLength[axes[i]]);
+        axStride[axes[i]]=stride;
+        stride*=axLength[axes[i]];
       }
 
-      //Read giant chunk of data from NetCDF (this is the bottleneck of this code)
-      retval=nc_get_vars_double(ncid,varid_f,nc_start,nc_length,nc_stride,&aTmp3D[0][0][0]);   HandleNetCDFErrors(retval);
-      new_chunk_read = true;
+      //Read hyperslab from NetCDF (this is the bottleneck of this code)
+      retval=nc_get_vara_double(ncid,varid_f,nc_start,nc_length,aVec);   HandleNetCDFErrors(retval);
 
       if (Options.noisy) {
-        cout<<" CForcingGrid::ReadData - is3D"<<endl;
-        cout<<"  Dim of chunk read: dim3 = "<<dim3<<"   dim2 = "<<dim2<<"   dim1 = "<<dim1<<endl;
-        cout<<"  start  chunk: ("<<nc_start[0]<<","<<nc_start[1]<<","<<nc_start[2]<<")"<<endl;
-        cout<<"  length  chunk: ("<<nc_length[0]<<","<<nc_length[1]<<","<<nc_length[2]<<")"<<endl;
-        cout<<"  stride  chunk: ("<<nc_stride[0]<<","<<nc_stride[1]<<","<<nc_stride[2]<<")"<<endl;
-      }
-    }
-    else //2D
-    {
-      int       start_point = _ChunkSize * _iChunk+(int)(_t_corr/_interval);//JRC_TIME_FIX:
-      size_t    nc_start[2];
-      size_t    nc_length[2];
-      ptrdiff_t nc_stride[2];
-
-      nc_length[0] = (size_t)(dim1); nc_stride[0] = 1;
-      nc_length[1] = (size_t)(dim2); nc_stride[1] = 1;
-
-      switch(_dim_order) {
-        case(1): // dimensions are (station,t)
-          nc_start[0]  = 0;
-          nc_start[1]  = (size_t)(start_point);
-          break;
-        case(2): // dimensions are (t,station)
-          nc_start[0]  = (size_t)(start_point);
-          nc_start[1]  = 0;
-          break;
+        cout<<"  block "<<b<<" start: ("<<nc_start [0]<<","<<nc_start [1]; if(_is_3D){cout<<","<<nc_start [2];} cout<<")";
+        cout<<       " length: ("<<nc_length[0]<<","<<nc_length[1]; if(_is_3D){cout<<","<<nc_length[2];} cout<<")"<<endl;
       }
 
-      //Read from NetCDF (this is the bottleneck of this code)
-      retval=nc_get_vars_double(ncid,varid_f,nc_start,nc_length,nc_stride,&aTmp2D[0][0]);
-      HandleNetCDFErrors(retval);
-      new_chunk_read = true;
-
-      if (Options.noisy) {
-        cout<<" CForcingGrid::ReadData - !is3D"<<endl;
-        cout<<"  Dim of chunk read: dim2 = "<<dim2<<"   dim1 = "<<dim1<<endl;
-        cout<<"  start  chunk: (" <<nc_start [0]<<","<<nc_start [1]<<")"<<endl;
-        cout<<"  length  chunk: ("<<nc_length[0]<<","<<nc_length[1]<<")"<<endl;
-        cout<<"  stride  chunk: ("<<nc_stride[0]<<","<<nc_stride[1]<<")"<<endl;
+      // Re-scale NetCDF variables based on their internal add-offset and scale_factor
+      // MANDATORY to do before any value of these data are used
+      // -------------------------------
+      for (int i=0;i<stride;i++){
+        aVec[i] = aVec[i] * scale_factor + add_offset;
       }
-    }
 
-    // Re-scale NetCDF variables based on their internal add-offset and scale_factor
-    // MANDATORY to do before any value of these data are used
-    // -------------------------------
-    if ( _is_3D ) {
-      for (it=0;it<dim1;it++){
-        for (ir=0;ir<dim2;ir++){
-	        for (ic=0;ic<dim3;ic++){
-	          aTmp3D[it][ir][ic] = aTmp3D[it][ir][ic] * scale_factor + add_offset;
-            //if  ((it==0) || (it==dim1-1)) {cout<<setprecision(4)<<setw(9)<<aTmp3D[it][ir][ic]<<" ";}
-	        }
-        //if ((it==0) || (it==dim1-1)) { cout << endl; }
-        }
-       //if  ((it==0) || (it==dim1-1)) {cout<<endl<<endl;}
-      }
-    }
-    else {
-      for (it=0;it<dim1;it++){
-	      for (ir=0;ir<dim2;ir++){
-	        aTmp2D[it][ir] = aTmp2D[it][ir] * scale_factor + add_offset;
-	      }
-      }
-    }
-
-
-    // Copy all data from aTmp array to member array _aVal.
-    // -------------------------------
-    double val;
-    if ( _is_3D )
-    {
-      int irow,icol;
-      if (_dim_order == 1) {
-        for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
-          for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
-            CellIdxToRowCol(_IdxNonZeroGridCells[ic],irow,icol);
-            val=aTmp3D[icol-_WinStart[0]][irow-_WinStart[1]][it];
-            if(val==missval) { CheckValue3D(val,missval,it,irow,icol); }
-            if(val==fillval) { CheckValue3D(val,fillval,it,irow,icol); }
-            _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
-
-          }
-        }
-      }
-      else if (_dim_order == 2) {
-        for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
-          for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
-		        CellIdxToRowCol(_IdxNonZeroGridCells[ic],irow,icol);
-		        val=aTmp3D[irow-_WinStart[1]][icol-_WinStart[0]][it];
-            if(val==missval) { CheckValue3D(val,missval,it,irow,icol); }
-            if(val==fillval) { CheckValue3D(val,fillval,it,irow,icol); }
-            _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
-		      }
-		    }
-      }
-      else if (_dim_order == 3) {
-        for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
-          for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
-            CellIdxToRowCol(_IdxNonZeroGridCells[ic],irow,icol);
-            val=aTmp3D[icol-_WinStart[0]][it][irow-_WinStart[1]];
-            if(val==missval) { CheckValue3D(val,missval,it,irow,icol); }
-            if(val==fillval) { CheckValue3D(val,fillval,it,irow,icol); }
-            _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
-          }
-        }
-      }
-      else if (_dim_order == 4) {
-        for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
-          for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
-            CellIdxToRowCol(_IdxNonZeroGridCells[ic],irow,icol);
-            val=aTmp3D[it][icol-_WinStart[0]][irow-_WinStart[1]];
-            if(!((Options.deltaresFEWS) && (it==0))) {
+      // Copy data of cells in this block from aVec to member array _aVal.
+      // -------------------------------
+      for (it=0; it<iChunkSize; it++){                       // loop over time points in buffer
+        for (int j=_aBlockFirstCell[b]; j<_aBlockFirstCell[b+1]; j++){ // loop over non-zero weighted grid cells in block
+          ic=_aBlockCells[j];
+          idx=_IdxNonZeroGridCells[ic];
+          CellIdxToRowCol(idx,irow,icol);
+          val=aVec[(icol-axStart[0])*axStride[0]+(irow-axStart[1])*axStride[1]+it*axStride[2]];
+          if ( _is_3D ) {
+            if(!((Options.deltaresFEWS) && (it==0) && (_dim_order==4))) {
               if(val==missval) { CheckValue3D(val,missval,it,irow,icol); }
               if(val==fillval) { CheckValue3D(val,fillval,it,irow,icol); }
             }
-            _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
           }
-        }
-      }
-      else if (_dim_order == 5) {
-        for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
-          for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
-            CellIdxToRowCol(_IdxNonZeroGridCells[ic],irow,icol);
-            val=aTmp3D[irow-_WinStart[1]][it][icol-_WinStart[0]];
-            if(val==missval) { CheckValue3D(val,missval,it,irow,icol); }
-            if(val==fillval) { CheckValue3D(val,fillval,it,irow,icol); }
-            _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
+          else if (_dim_order == 1) {
+            if(val==missval) { CheckValue2D(val,missval,idx,it); }   // throw error  if value to read in equals "missing_value"
+            if(val==fillval) { CheckValue2D(val,fillval,idx,it); }   // throw error  if value to read in equals "_FillValue"
           }
-        }
-      }
-      else if (_dim_order == 6) {
-        for (it=0; it<iChunkSize; it++){                      // loop over time points in buffer
-          for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){    // loop over non-zero weighted grid cells
-            CellIdxToRowCol(_IdxNonZeroGridCells[ic],irow,icol);
-            val=aTmp3D[it][irow-_WinStart[1]][icol-_WinStart[0]];
-            if(val==missval) { CheckValue3D(val,missval,it,irow,icol);}
-            if(val==fillval) { CheckValue3D(val,fillval,it,irow,icol); }
-            _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
-          }
-        }
-      }
-    }
-    else // 2D
-    {
-      if (_dim_order == 1) {
-        for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
-          for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
-            val=aTmp2D[_IdxNonZeroGridCells[ic]][it];
-            if(val==missval) { CheckValue2D(val,missval,_IdxNonZeroGridCells[ic],it); }   // throw error  if value to read in equals "missing_value"
-            if(val==fillval) { CheckValue2D(val,fillval,_IdxNonZeroGridCells[ic],it); }   // throw error  if value to read in equals "_FillValue"
-            _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
-          }
-        }
-      }
-      else if (_dim_order == 2) {
-        for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
-          for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
-            val=aTmp2D[it][_IdxNonZeroGridCells[ic]];
-            if(val==missval)  { CheckValue2D(val,missval,it,_IdxNonZeroGridCells[ic]); }  // throw error if value to read in equals "missing_value"
-            if(val==fillval)  { CheckValue2D(val,fillval,it,_IdxNonZeroGridCells[ic]); }  // throw error if value to read in equals "_FillValue"
-            if(rvn_isnan(val)){ CheckValue2D(val,NAN,    it,_IdxNonZeroGridCells[ic]); }
-            _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
+          else {
+            if(val==missval)  { CheckValue2D(val,missval,it,idx); }  // throw error if value to read in equals "missing_value"
+            if(val==fillval)  { CheckValue2D(val,fillval,it,idx); }  // throw error if value to read in equals "_FillValue"
+            if(rvn_isnan(val)){ CheckValue2D(val,NAN,    it,idx); }
           }
+          _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
         }
       }
     }
+    new_chunk_read = true;
 
     //delete dynamic arrays
     // -------------------------------
-    if ( _is_3D ) {for (it=0;it<dim1;it++){delete [] aTmp3D[it];} delete [] aTmp3D;}
-    else          {delete [] aTmp2D;}
     delete [] aVec;
 
     // read attribute grids - lat, long, elevation of grid cells
@@ -1044,10 +910,7 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
       }
     }
 
-    // -------------------------------
-    // Close NetCDF file
-    // -------------------------------
-    retval = nc_close(ncid);       HandleNetCDFErrors(retval);
+    // NetCDF file is not closed here - shared handle is released in destructor
 
   }// end if(_iChunk != iChunk_new)
 
@@ -1307,6 +1170,7 @@ void CForcingGrid::SetIdxNonZeroGridCells(const int nHydroUnits, const int nGrid
       ic++;
     }
   }
+  PlanReadBlocks(nonzero,Options);
   delete[] nonzero;
 
   if (Options.noisy){
@@ -1314,9 +1178,249 @@ void CForcingGrid::SetIdxNonZeroGridCells(const int nHydroUnits, const int nGrid
   }
 }
 
+///////////////////////////////////////////////////////////////////
+/// \brief plans dense hyperslab reads covering all non-zero weighted grid cells
+/// \details the bounding window of non-zero weighted cells is recursively split into rectangular
+/// read blocks (ranges of stations for 2D data) until each block is mostly (>=READ_BLOCK_MIN_FILL)
+/// populated by non-zero weighted cells, is small, or MAX_READ_BLOCKS is reached. Each block is
+/// read with a single contiguous hyperslab call in ReadData(). Called from SetIdxNonZeroGridCells().
+///
+/// \param nonzero [in] array of flags indicating non-zero weighted cells [size: _nCells]
+/// \param &Options [in] Global model options information
+//
+void CForcingGrid::PlanReadBlocks(const bool *nonzero, const optStruct &Options)
+{
+  for(int d=0;d<2;d++) {
+    delete [] _aBlockStart [d]; _aBlockStart [d]=NULL;
+    delete [] _aBlockLength[d]; _aBlockLength[d]=NULL;
+  }
+  delete [] _aBlockFirstCell; _aBlockFirstCell=NULL;
+  delete [] _aBlockCells;     _aBlockCells    =NULL;
+  _nReadBlocks=0;_maxBlockCells=0;_nReadCells=0;
+
+  if(_nNonZeroWeightedGridCells==0) { return; }
+
+  // summed area table of non-zero weighted cells within window
+  // -------------------------------
+  int W=_WinLength[0]+1;
+  int H=_WinLength[1]+1;
+  int *SAT=new int [W*H];
+  ExitGracefullyIf(SAT==NULL,"CForcingGrid::PlanReadBlocks",OUT_OF_MEMORY);
+  for(int x=0;x<W;x++) { SAT[x]  =0; }
+  for(int y=0;y<H;y++) { SAT[y*W]=0; }
+  for(int y=1;y<H;y++) {
+    for(int x=1;x<W;x++) {
+      int cellid=(y-1+_WinStart[1])*GetCols()+(x-1+_WinStart[0]);
+      SAT[y*W+x]=(int)(nonzero[cellid])+SAT[(y-1)*W+x]+SAT[y*W+x-1]-SAT[(y-1)*W+x-1];
+    }
+  }
+
+  vector<int> blocks; //(col start, # cols, row start, # rows) of each block
+  int pending=0;
+  SplitReadBlock(SAT,0,_WinLength[0],0,_WinLength[1],pending,blocks);
+  delete [] SAT;
+
+  _nReadBlocks=(int)(blocks.size()/4);
+  for(int d=0;d<2;d++) {
+    _aBlockStart [d]=new int[_nReadBlocks];
+    _aBlockLength[d]=new int[_nReadBlocks];
+  }
+  for(int b=0;b<_nReadBlocks;b++) {
+    _aBlockStart[0][b]=blocks[4*b  ]; _aBlockLength[0][b]=blocks[4*b+1];
+    _aBlockStart[1][b]=blocks[4*b+2]; _aBlockLength[1][b]=blocks[4*b+3];
+    _maxBlockCells=max(_maxBlockCells,_aBlockLength[0][b]*_aBlockLength[1][b]);
+    _nReadCells  +=_aBlockLength[0][b]*_aBlockLength[1][b];
+  }
+
+  // group local cell indices by read block
+  // -------------------------------
+  int row,col;
+  int *aCellBlock=new int[_nNonZeroWeightedGridCells];
+  _aBlockFirstCell=new int[_nReadBlocks+1];
+  _aBlockCells    =new int[_nNonZeroWeightedGridCells];
+  ExitGracefullyIf(_aBlockCells==NULL,"CForcingGrid::PlanReadBlocks",OUT_OF_MEMORY);
+  for(int b=0;b<=_nReadBlocks;b++) { _aBlockFirstCell[b]=0; }
+  for(int ic=0;ic<_nNonZeroWeightedGridCells;ic++) {
+    CellIdxToRowCol(_IdxNonZeroGridCells[ic],row,col);
+    aCellBlock[ic]=DOESNT_EXIST;
+    for(int b=0;b<_nReadBlocks;b++) {
+      if((col>=_aBlockStart[0][b]) && (col<_aBlockStart[0][b]+_aBlockLength[0][b]) &&
+         (row>=_aBlockStart[1][b]) && (row<_aBlockStart[1][b]+_aBlockLength[1][b])) {
+        aCellBlock[ic]=b; break;
+      }
+    }
+    ExitGracefullyIf(aCellBlock[ic]==DOESNT_EXIST,"CForcingGrid::PlanReadBlocks: cell not covered by read block",RUNTIME_ERR);
+    _aBlockFirstCell[aCellBlock[ic]+1]++;
+  }
+  for(int b=0;b<_nReadBlocks;b++) { _aBlockFirstCell[b+1]+=_aBlockFirstCell[b]; }
+  int *fill=new int[_nReadBlocks];
+  for(int b=0;b<_nReadBlocks;b++) { fill[b]=_aBlockFirstCell[b]; }
+  for(int ic=0;ic<_nNonZeroWeightedGridCells;ic++) {
+    _aBlockCells[fill[aCellBlock[ic]]++]=ic;
+  }
+  delete [] fill;
+  delete [] aCellBlock;
+
+  if(Options.noisy) {
+    cout<<"Finished PlanReadBlocks routine,         # of read blocks: "<<_nReadBlocks<<" ("<<_nReadCells<<" of ";
+    cout<<_WinLength[0]*_WinLength[1]<<" window cells read per time step)"<<endl;
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief recursively shrinks block to bounding box of its non-zero weighted cells and splits it if sparse
+///
+/// \param SAT [in] summed area table of non-zero weighted cells in window [size: (_WinLength[0]+1)*(_WinLength[1]+1)]
+/// \param x0,nx,y0,ny [in] window-relative starting column, # of columns, starting row, # of rows of block
+/// \param pending [in/out] number of sibling blocks still to be processed (used to cap number of blocks)
+/// \param blocks [out] absolute (col start, # cols, row start, # rows) of each final block
+//
+void CForcingGrid::SplitReadBlock(const int *SAT, int x0, int nx, int y0, int ny, int &pending,
+                                  vector<int> &blocks) const
+{
+  const int W=_WinLength[0]+1;
+  auto count=[SAT,W](int X0,int NX,int Y0,int NY){
+    return SAT[(Y0+NY)*W+X0+NX]-SAT[Y0*W+X0+NX]-SAT[(Y0+NY)*W+X0]+SAT[Y0*W+X0];
+  };
+
+  int n=count(x0,nx,y0,ny);
+  if(n==0) { return; }
+
+  //shrink to bounding box of non-zero weighted cells
+  while(count(x0     ,1 ,y0,ny)==0) { x0++; nx--; }
+  while(count(x0+nx-1,1 ,y0,ny)==0) { nx--; }
+  while(count(x0,nx,y0     ,1 )==0) { y0++; ny--; }
+  while(count(x0,nx,y0+ny-1,1 )==0) { ny--; }
+
+  int  area =nx*ny;
+  bool split=((n<READ_BLOCK_MIN_FILL*area) && (area>READ_BLOCK_MIN_CELLS) &&
+              ((int)(blocks.size()/4)+pending+2<=MAX_READ_BLOCKS));
+  if(!split) {
+    blocks.push_back(x0+_WinStart[0]); blocks.push_back(nx);
+    blocks.push_back(y0+_WinStart[1]); blocks.push_back(ny);
+    return;
+  }
+
+  //split along longer axis, at widest empty gap if any, otherwise at midpoint
+  bool alongx=(nx>=ny);
+  int  len   =(alongx) ? nx : ny;
+  int  cut   =len/2;
+  int  gap=0,widest=0;
+  for(int i=1;i<len-1;i++) {
+    int c=(alongx) ? count(x0+i,1,y0,ny) : count(x0,nx,y0+i,1);
+    if(c==0) { gap++; if(gap>widest) { widest=gap; cut=i; } }
+    else     { gap=0; }
+  }
+
+  pending++;
+  if(alongx) { SplitReadBlock(SAT,x0,cut,y0,ny,pending,blocks); }
+  else       { SplitReadBlock(SAT,x0,nx,y0,cut,pending,blocks); }
+  pending--;
+  if(alongx) { SplitReadBlock(SAT,x0+cut,nx-cut,y0,ny,pending,blocks); }
+  else       { SplitReadBlock(SAT,x0,nx,y0+cut,ny-cut,pending,blocks); }
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief returns axis (0=x/column or station, 1=y/row, 2=time) of each NetCDF dimension of forcing variable
+///
+/// \param axes [out] axis of 1st, 2nd (and 3rd, if 3D) dimension
+//
+void CForcingGrid::GetDimAxes(int axes[3]) const
+{
+  const int X=0,Y=1,T=2;
+  axes[0]=X; axes[1]=Y; axes[2]=T;
+  if(_is_3D) {
+    switch(_dim_order)
+    {
+      case(1): axes[0]=X; axes[1]=Y; axes[2]=T; break; // dimensions are (x,y,t)
+      case(2): axes[0]=Y; axes[1]=X; axes[2]=T; break; // dimensions are (y,x,t)
+      case(3): axes[0]=X; axes[1]=T; axes[2]=Y; break; // dimensions are (x,t,y)
+      case(4): axes[0]=T; axes[1]=X; axes[2]=Y; break; // dimensions are (t,x,y)
+      case(5): axes[0]=Y; axes[1]=T; axes[2]=X; break; // dimensions are (y,t,x)
+      case(6): axes[0]=T; axes[1]=Y; axes[2]=X; break; // dimensions are (t,y,x)
+    }
+  }
+  else {
+    switch(_dim_order)
+    {
+      case(1): axes[0]=X; axes[1]=T; break; // dimensions are (station,t)
+      case(2): axes[0]=T; axes[1]=X; break; // dimensions are (t,station)
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief returns handle to NetCDF file, opening it if it is not already open by another forcing grid
+/// \note each call must be matched by a call to ReleaseNetCDFFile()
+///
+/// \param filename [in] NetCDF filename (with ensemble wildcards replaced)
+/// \return NetCDF file unit
+//
+int CForcingGrid::AcquireNetCDFFile(const string filename)
+{
+#ifdef _RVNETCDF_
+  map<string,nc_shared_file>::iterator it=_mOpenFiles.find(filename);
+  if(it!=_mOpenFiles.end()) {
+    it->second.nUsers++;
+    return it->second.ncid;
+  }
+  nc_shared_file F;
+  int retval=nc_open(filename.c_str(),NC_NOWRITE,&F.ncid);  HandleNetCDFErrors(retval);
+  F.nUsers=1;
+  _mOpenFiles[filename]=F;
+  return F.ncid;
+#else
+  return DOESNT_EXIST;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief releases handle to NetCDF file; file is closed once no forcing grid holds it
+///
+/// \param filename [in] NetCDF filename (with ensemble wildcards replaced)
+//
+void CForcingGrid::ReleaseNetCDFFile(const string filename)
+{
+#ifdef _RVNETCDF_
+  map<string,nc_shared_file>::iterator it=_mOpenFiles.find(filename);
+  if(it==_mOpenFiles.end()) { return; }
+  it->second.nUsers--;
+  if(it->second.nUsers<=0) {
+    int retval=nc_close(it->second.ncid);  HandleNetCDFErrors(retval);
+    _mOpenFiles.erase(it);
+  }
+#endif
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief sizes per-variable chunk (decompression) cache of shared NetCDF file to :NetCDFChunkMemory, once per variable
+/// \details decompressed NetCDF-4 chunks are then retained between the hyperslab reads of
+/// neighbouring read blocks and successive time chunks, rather than being re-inflated
+///
+/// \param filename [in] NetCDF filename (with ensemble wildcards replaced)
+/// \param ncid [in] NetCDF file unit
+/// \param varid [in] NetCDF variable id
+/// \param &Options [in] Global model options information
+//
+void CForcingGrid::SetVarChunkCache(const string filename, const int ncid, const int varid, const optStruct &Options)
+{
+#ifdef _RVNETCDF_
+  const size_t CACHE_NELEMS    =1009;  //NetCDF default (prime) number of chunk slots
+  const float  CACHE_PREEMPTION=0.75f; //NetCDF default
+
+  nc_shared_file &F=_mOpenFiles[filename];
+  if(find(F.cachedVars.begin(),F.cachedVars.end(),varid)!=F.cachedVars.end()) { return; }
+  F.cachedVars.push_back(varid);
+
+  size_t cache_size=(size_t)(Options.NetCDF_chunk_mem)*1024*1024;
+  int retval=nc_set_var_chunk_cache(ncid,varid,cache_size,CACHE_NELEMS,CACHE_PREEMPTION);
+  if(retval!=NC_ENOTNC4) { HandleNetCDFErrors(retval); } //classic format files have no chunk cache
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////
 /// \brief calculates _ChunkSize and total number of chunks to read _nChunks, sets the id of the current chunk
-/// depending upon size of grid (_nNonZeroWeightedGridCells*buffersize*8byte <=  10 MB=10*1024*1024 byte)
+/// depending upon number of cells used ((_nNonZeroWeightedGridCells+_maxBlockCells)*buffersize*8byte <=  10 MB=10*1024*1024 byte)
 /// needs to be called after SetIdxNonZeroGridCells()
 ///
 /// \param nHydroUnits number of HRUs
@@ -1333,10 +1437,8 @@ void CForcingGrid::CalculateChunkSize(const optStruct& Options)
   else       { ntime = _GridDims[1]; }
 
   int    BytesPerTimestep;      // Memory requirement for one timestep of gridded forcing file [Bytes]
-  if(_is_3D) { BytesPerTimestep = 8 * _WinLength[0] * _WinLength[1]; }
-  else       { BytesPerTimestep = 8 * _WinLength[0]; }
-
-  //BytesPerTimestep = 8 * _nNonZeroWeightedGridCells; //?? amount actually stored in memory?
+  //amount actually stored in memory: retained non-zero weighted cells plus buffer for largest read block
+  BytesPerTimestep = 8 * (_nNonZeroWeightedGridCells + _maxBlockCells);
 
   int CHUNK_MEMORY=Options.NetCDF_chunk_mem*1024 * 1024;
 
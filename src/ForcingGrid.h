@@ -9,11 +9,23 @@
 #include "ParseLib.h"
 #include "Forcings.h"
 #include "Model.h"
+#include <map>
+#include <vector>
 
 #ifdef _RVNETCDF_
 #include <netcdf.h>
 #endif
 
+///////////////////////////////////////////////////////////////////
+/// \brief NetCDF file handle shared by all forcing grids reading from the same file
+//
+struct nc_shared_file
+{
+  int          ncid;        ///< NetCDF file unit
+  int          nUsers;      ///< number of forcing grids currently holding this handle
+  vector<int>  cachedVars;  ///< ids of variables for which the chunk (decompression) cache has been sized
+};
+
 ///////////////////////////////////////////////////////////////////
 /// \brief   Data abstraction for gridded, 3D forcings
 /// \details Data Abstraction for gridded, 3D forcing data.
@@ -78,6 +90,17 @@ private:/*------------------------------------------------------*/
   int          _WinLength[3];                ///< length of data grid window in each dimension (x,y,t - defaults to _GridDims)
   int          _WinStart [3];                ///< data grid window starting point (x,y,t - defaults to 0, 0, chunksize)
 
+  int          _nReadBlocks;                 ///< number of dense hyperslabs (rectangular blocks of cells) read per chunk
+  int         *_aBlockStart [2];             ///< starting column [0] and row [1] of each read block [size: _nReadBlocks]
+  int         *_aBlockLength[2];             ///< number of columns [0] and rows [1] of each read block [size: _nReadBlocks]
+  int         *_aBlockFirstCell;             ///< index into _aBlockCells of first cell of each read block [size: _nReadBlocks+1]
+  int         *_aBlockCells;                 ///< local cell indices ic, grouped by read block [size: _nNonZeroWeightedGridCells]
+  int          _maxBlockCells;               ///< number of cells in largest read block
+  int          _nReadCells;                  ///< total number of cells read per time step (all read blocks)
+
+  string       _open_ncfile;                 ///< name of shared NetCDF file currently held open by this grid ("" if none)
+  static map<string,nc_shared_file> _mOpenFiles; ///< registry of open NetCDF files shared across forcing grids, by filename
+
   int          _nPulses;                     ///< number of pulses (total duration=(nPulses-1)*_interval)
   bool         _pulse;                       ///< flag determining whether this is a pulse-based or
   ///                                        ///< piecewise-linear time series
@@ -110,6 +133,15 @@ private:/*------------------------------------------------------*/
                          int              &row,
                          int              &column) const;             ///< returns row and column index of cell ID
 
+  void   PlanReadBlocks(const bool *nonzero, const optStruct &Options);
+  void   SplitReadBlock(const int *SAT, int x0, int nx, int y0, int ny, int &pending,
+                        vector<int> &blocks) const;
+  void   GetDimAxes    (int axes[3]) const;
+
+  static int  AcquireNetCDFFile(const string filename);
+  static void ReleaseNetCDFFile(const string filename);
+  static void SetVarChunkCache (const string filename, const int ncid, const int varid, const optStruct &Options);
+
   void   ReadAttGridFromNetCDF (const int ncid,const string varname,const int nrows,const int ncols,double *&values);
   void   ReadAttGridFromNetCDF2(const int ncid,const string varname,const int nrows,const int ncols,string *values);
 
@@ -192,10 +192,10 @@ void CGWRecharge::GetRatesOfChange(const double		   *state_vars,
 void CGWRecharge::calcGWBudget(const CModel *pModel, int *nodes, double *rates)
 {
 #ifdef _MODFLOW_USG_
-  int n, topnode;
-  double weight, area;
-  vector<int> nodeHRUs;
-  CHydroUnit  *pHRU;
+  int n, topnode, nHRUs;
+  double area;
+  const int    *aHRUs;
+  const double *aWeights;
 
   //-- Loop over all recharge nodes
   for (int i = 0; i < _nnodes; i++)
@@ -208,12 +208,10 @@ void CGWRecharge::calcGWBudget(const CModel *pModel, int *nodes, double *rates)
 
     //-- Recharge via DATA is by HRU
     if (_recharge_type == RECHARGE_HRU_DATA) {
-      nodeHRUs = pGWModel->GetHRUsByNode(n);
+      nHRUs = pGWModel->GetNodeOverlaps(n, aHRUs, aWeights);
 
-      for (auto HRUid : nodeHRUs) {
-        pHRU = pModel->GetHRUByID(HRUid);
-        weight = pGWModel->GetOverlapWeight(HRUid, n);
-        rates[i] += (pHRU->GetForcingFunctions()->recharge/MM_PER_METER * area * weight); // mm/d to m3/d
+      for (int j = 0; j < nHRUs; j++) {
+        rates[i] += (pModel->GetHydroUnit(aHRUs[j])->GetForcingFunctions()->recharge/MM_PER_METER * area * aWeights[j]); // mm/d to m3/d
       }
     }
 
@@ -27,6 +27,7 @@ CGWRiverConnection::CGWRiverConnection(CGroundwaterModel* pGWModel)
   _aElevs    = NULL;
   _aCond     = NULL;
   _aGWFlux   = NULL;
+  _aGWFluxBySB    = NULL;
   _anSegmentsBySB = NULL;
   _aSegmentsBySB  = NULL;
 
@@ -47,6 +48,7 @@ CGWRiverConnection::~CGWRiverConnection()
     for (int i = 0; i < _nSeg; i++) { delete[] _aElevs[i]; delete[] _aCond[i]; } delete[] _aElevs; delete[] _aCond;
   }
   delete [] _aGWFlux  ;
+  delete [] _aGWFluxBySB;
   delete [] _anSegmentsBySB;
   delete [] _aSegmentsBySB;
 }
@@ -73,10 +75,12 @@ void CGWRiverConnection::Initialize(int nSegments, int NB)
   }
   _anSegmentsBySB = new int  [NB];
   _aSegmentsBySB  = new int* [NB];
+  _aGWFluxBySB    = new double[NB];
 
   //-- Set segments in basin counter to zero
   for (int i=0; i<NB; i++){
     _anSegmentsBySB[i] = 0;
+    _aGWFluxBySB   [i] = 0.0;
   }
 }
 
@@ -159,33 +163,31 @@ void CGWRiverConnection::UpdateRiverLevelsBySB(const int p, const CSubBasin *pBa
 
 //////////////////////////////////////////////////////////////////
 /// \brief Updates _aGWFlux array with latest fluxes from MODFLOW
+/// \details also aggregates segment fluxes by subbasin in a single sweep over segments
 //
 void CGWRiverConnection::UpdateRiverFlux() const
 {
 #ifdef _MODFLOW_USG_
   MFUSG::get_pbj_segment_flows(_aGWFlux);
+
+  for (int p=0; p < _NB; p++) { _aGWFluxBySB[p] = 0.0; }
+  for (int iseg=0; iseg < _nSeg; iseg++)
+  {
+    _aGWFluxBySB[_aSubBasin[iseg]] += _aGWFlux[iseg];
+  }
 #endif
 }
 
 //////////////////////////////////////////////////////////////////
-/// \brief Updates _aGWFlux array with latest fluxes from MODFLOW
+/// \brief Returns total GW flux to river in subbasin, as aggregated by UpdateRiverFlux()
 ///
 /// \param p [in] SubBasin global index
 //
 double CGWRiverConnection::CalcRiverFlowBySB(const int p) const
 {
-  int    iseg;
-  double sumflux = 0.0;
-
   if (_nSeg == 0) {return 0.0; }
 
-  for (int i=0; i < _anSegmentsBySB[p]; i++)
-  {
-    iseg = _aSegmentsBySB[p][i];
-    sumflux += _aGWFlux[iseg];
-  }
-
-  return(sumflux);
+  return(_aGWFluxBySB[p]);
 }
 
 //////////////////////////////////////////////////////////////////
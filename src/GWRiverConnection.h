@@ -29,6 +29,7 @@ protected:/*-------------------------------------------------------*/
   double      **_aElevs;                    ///< 2D array of elevations (segment start, end)
   double      **_aCond;                     ///< 2D array of conductances (start, end)
   double       *_aGWFlux;                   ///< array of GW fluxes to river, by segment
+  double       *_aGWFluxBySB;               ///< array of GW fluxes to river, aggregated by subbasin [NB]
 
   int           _NB;                        ///< Local storage of subbasin count
   int*          _anSegmentsBySB;            ///< Number of segments in each subbasin [NB] (SB index, not SBID)
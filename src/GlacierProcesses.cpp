@@ -461,7 +461,7 @@ void CmvGlacierInfil::GetRatesOfChange ( const double      *state_vars,
     double rain_and_melt=ponded/Options.timestep;
 
     double max_perc_rate = pHRU->GetSoilProps(1)->max_perc_rate;
-    double P0DSH         = pModel->GetGlobalParams()->GetParams()->UBC_GW_split;
+    double P0DSH         = pHRU->GetGlobalParams()->UBC_GW_split;
 
     //.NET
     //to_GW=0;
@@ -478,6 +478,15 @@ void CmvGlacierInfil::GetRatesOfChange ( const double      *state_vars,
   }
 };
 
+//////////////////////////////////////////////////////////////////
+/// \brief Returns true if glacial infiltration depends upon order in which HRUs are processed
+/// \details GINFIL_UBCWM uses b2 calculated for the previously processed (adjacent) soil HRU
+//
+bool CmvGlacierInfil::DependsOnHRUOrder() const
+{
+  return (type==GINFIL_UBCWM);
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Corrects rates of change (*rates) returned from RatesOfChange function
 /// \details Ensures that the rate of flow cannot drain glacier over timestep
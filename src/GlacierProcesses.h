@@ -130,6 +130,7 @@ public:/*-------------------------------------------------------*/
                         const optStruct   &Options,
                         const time_struct &tt,
                         double      *rates) const;
+  bool DependsOnHRUOrder() const;
 
   void        GetParticipatingParamList   (string  *aP, class_type *aPC, int &nP) const;
   static void GetParticipatingStateVarList(glacial_infil_type   mtype,
@@ -34,6 +34,16 @@ CGroundwaterModel::CGroundwaterModel(CModel *pModel)
   _aProcessesAMAT = NULL;
   _aProcessesRHS = NULL;
   _aGWSWFluxes = NULL;
+
+  _nOverlaps       = 0;
+  _aNodeStartByHRU = NULL;
+  _aNodeByHRU      = NULL;
+  _aWeightByHRU    = NULL;
+  _aNodeAreaByHRU  = NULL;
+  _aHRUStartByNode = NULL;
+  _aHRUByNode      = NULL;
+  _aHRUIDByNode    = NULL;
+  _aWeightByNode   = NULL;
 }
 
 // Destructor
@@ -45,6 +55,14 @@ CGroundwaterModel::~CGroundwaterModel()
   delete [] _aProcessesAMAT;
   delete [] _aProcessesRHS;
   delete [] _aGWSWFluxes;
+  delete [] _aNodeStartByHRU;
+  delete [] _aNodeByHRU;
+  delete [] _aWeightByHRU;
+  delete [] _aNodeAreaByHRU;
+  delete [] _aHRUStartByNode;
+  delete [] _aHRUByNode;
+  delete [] _aHRUIDByNode;
+  delete [] _aWeightByNode;
   // Shut down Modflow-USG, if active (necessary check?)
 #ifdef _MODFLOW_USG_
   if (_nNodes > 0) { MFUSG::mf_shutdown(); }
@@ -335,13 +353,12 @@ void CGroundwaterModel::UpdateProcessBudgets(const double &timestep)
 {
 #ifdef _MODFLOW_USG_
   // Initialize variables to be filled by processes in loop
-  int     HRUID, ibound, proc_nnodes, topnode, n;
+  int     proc_nnodes, topnode;
   int    *proc_nodes;
   double *rates;
-  double  hru_overlap_area, flow = 0.0;
+  double  hru_overlap_area;
   char   *procname;
   char    fluxname[16] = "RAVEN FLUX";
-  vector<int> HRUnodes;
 
   // First, the Raven Groundwater Compartment Flux (non-GWSW process) volume
   proc_nodes  = new int   [_nNodes];
@@ -351,19 +368,14 @@ void CGroundwaterModel::UpdateProcessBudgets(const double &timestep)
     proc_nodes[i] = i+1;  //MFUSG uses 1-index
     rates     [i] = 0.0;  //initialize
   }
-  // Loop over HRUs, fill/update arrays
+  // Loop over HRUs (CSR rows), fill/update arrays
   for (int k = 0; k < _pModel->GetNumHRUs(); k++)
   {
-    HRUID = _pModel->GetHydroUnit(k)->GetID();
-    HRUnodes = GetNodesByHRU(HRUID);
-    hru_overlap_area = 0;
-
-    for (int j=0; j < HRUnodes.size(); j++) {
-      n = HRUnodes[j];
+    for (int i = _aNodeStartByHRU[k]; i < _aNodeStartByHRU[k + 1]; i++) {
       // Get top active node - Raven Flux (recharge) is delivered to water table
-      topnode = GetTopActiveNode(n);
+      topnode = GetTopActiveNode(_aNodeByHRU[i]);
 
-      hru_overlap_area = GetNodeArea(n) * GetOverlapWeight(HRUID, n); // Get overlap weight only defined for top layer
+      hru_overlap_area = _aNodeAreaByHRU[i] * _aWeightByHRU[i];      // overlap weight only defined for top layer
       rates[topnode-1] += hru_overlap_area * _aGWSWFluxes[k];          // Rates is one off - node 1 is at rates[0]
     }
   }
@@ -556,18 +568,94 @@ void CGroundwaterModel::SetOverlapWeight(const int HRUID, const int node, const
     string warn = "GroundwaterModel: Overlap Weight for Cell " + to_string(node) + " with HRU " + to_string(HRUID) + "defined multiple times.";
     WriteWarning(warn, Options.noisy);
   }
-  //-- Overlap Weight Matrix currently implemented using maps(!)
+  //-- Parse-time weights stored in map; compressed in BuildOverlapMatrices()
   _mOverlapWeights[p] = weight;
 
-  //-- Also add to HRUsByNode and NodeByHRU maps (if new!)
+  //-- Also record order of definition (if new!)
   if (newConnection)
   {
-    _mHRUsByNode[node].push_back(HRUID);
-    _mNodesByHRU[HRUID].push_back(node);
+    _vOverlapOrder.push_back(p);
   }
 #endif
 };
 
+//////////////////////////////////////////////////////////////////
+/// \brief Compresses parsed overlap weights into HRU->node (CSR) and node->HRU (CSC) sparse matrices
+/// \details Called once after the .rvg file is parsed. Within each HRU row/node column, connections
+/// are stored in the order they were defined. Node areas are cached alongside the HRU rows so that
+/// per-timestep recharge distribution requires no lookups.
+//
+void CGroundwaterModel::BuildOverlapMatrices()
+{
+  int i,k,n,nHRUs=_pModel->GetNumHRUs();
+  int nNodesLayOne=0;
+  if (_aNodesPerLayer!=NULL){nNodesLayOne=_aNodesPerLayer[0];}
+
+  //-- HRUID -> global index lookup
+  map<long long int,int> HRUIndex;
+  for (k=0; k<nHRUs; k++) {HRUIndex[_pModel->GetHydroUnit(k)->GetHRUID()]=k;}
+
+  _nOverlaps=(int)(_vOverlapOrder.size());
+  _aNodeStartByHRU = new int   [nHRUs+1];
+  _aHRUStartByNode = new int   [nNodesLayOne+2];
+  _aNodeByHRU      = new int   [_nOverlaps];
+  _aWeightByHRU    = new double[_nOverlaps];
+  _aNodeAreaByHRU  = new double[_nOverlaps];
+  _aHRUByNode      = new int   [_nOverlaps];
+  _aHRUIDByNode    = new int   [_nOverlaps];
+  _aWeightByNode   = new double[_nOverlaps];
+  ExitGracefullyIf(_aWeightByNode==NULL,"CGroundwaterModel::BuildOverlapMatrices",OUT_OF_MEMORY);
+
+  //-- count entries per row/column
+  int *aK=new int[_nOverlaps];
+  for (k=0; k<=nHRUs;        k++) {_aNodeStartByHRU[k]=0;}
+  for (n=0; n<=nNodesLayOne+1;n++){_aHRUStartByNode[n]=0;}
+  map<long long int,int>::const_iterator it;
+  for (i=0; i<_nOverlaps; i++) {
+    it=HRUIndex.find(_vOverlapOrder[i].first);
+    if (it==HRUIndex.end()){
+      string warn="CGroundwaterModel::BuildOverlapMatrices: overlap weight refers to HRU ID "+to_string(_vOverlapOrder[i].first)+" which is not in model";
+      ExitGracefully(warn.c_str(),BAD_DATA);
+      delete [] aK; return;
+    }
+    aK[i]=it->second;
+    _aNodeStartByHRU[aK[i]+1]++;
+    _aHRUStartByNode[_vOverlapOrder[i].second+1]++;
+  }
+  for (k=0; k<nHRUs;        k++) {_aNodeStartByHRU[k+1]+=_aNodeStartByHRU[k];}
+  for (n=0; n<=nNodesLayOne; n++) {_aHRUStartByNode[n+1]+=_aHRUStartByNode[n];}
+
+  //-- fill (stable, preserving order of definition)
+  int *rowpos=new int[nHRUs];
+  int *colpos=new int[nNodesLayOne+1];
+  for (k=0; k<nHRUs;        k++) {rowpos[k]=_aNodeStartByHRU[k];}
+  for (n=0; n<=nNodesLayOne; n++) {colpos[n]=_aHRUStartByNode[n];}
+  for (i=0; i<_nOverlaps; i++)
+  {
+    int    HRUID =_vOverlapOrder[i].first;
+    int    node  =_vOverlapOrder[i].second;
+    double weight=_mOverlapWeights[_vOverlapOrder[i]];
+    k=aK[i];
+
+    _aNodeByHRU    [rowpos[k]]=node;
+    _aWeightByHRU  [rowpos[k]]=weight;
+    _aNodeAreaByHRU[rowpos[k]]=GetNodeArea(node);
+    rowpos[k]++;
+
+    _aHRUByNode   [colpos[node]]=k;
+    _aHRUIDByNode [colpos[node]]=HRUID;
+    _aWeightByNode[colpos[node]]=weight;
+    colpos[node]++;
+  }
+  delete [] aK;
+  delete [] rowpos;
+  delete [] colpos;
+
+  //-- parse-time structures no longer needed
+  _mOverlapWeights.clear();
+  _vOverlapOrder.clear();
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Gets the weight value for the OverlapWeight sparse matrix.
 /// \details Returns 0.0 if no weight was exists. Only contains nodes
@@ -586,30 +674,31 @@ double CGroundwaterModel::GetOverlapWeight(const int HRUID, const int node)
     ExitGracefully("CGroundwaterModel::GetOverlapWeight: node-HRU overlap requested outside of the top layer (layer 1)", RUNTIME_ERR);
   }
 
-  //-- Overlap Weight Matrix currently implemented using maps(!)
-  map<pair<int, int>, double>::iterator weight_iter;    // <HRUid, node>, weight
-  double weight = 0.0;
-
-  //-- Use map.find() to get iterator to the element
-  pair<int,int> p(HRUID,node);
-  weight_iter = _mOverlapWeights.find(p);
-
-  //-- Get weight if exists, otherwise return default (0.0)
-  if (weight_iter != _mOverlapWeights.end()) {
-    weight = weight_iter->second;
+  //-- Scan (short) column of HRUs connected to node
+  if (_aHRUStartByNode == NULL) { return 0.0; }
+  for (int i = _aHRUStartByNode[node]; i < _aHRUStartByNode[node + 1]; i++) {
+    if (_aHRUIDByNode[i] == HRUID) { return _aWeightByNode[i]; }
   }
 
-  //-- Return weight (double)
-  return weight;
+  //-- Return default if no overlap
+  return 0.0;
 };
 
 //////////////////////////////////////////////////////////////////
-/// \brief Returns a pointer to the Overlap Weight "matrix"
-/// \return OverlapWeights pointer
+/// \brief Returns the HRUs connected to a layer 1 node and their overlap weights
+/// \return number of HRUs connected to node
+///
+/// \param node      [in]  node id (1 to _aNodesPerLayer[0])
+/// \param aHRUs     [out] pointer to array of HRU global indices connected to node
+/// \param aWeights  [out] pointer to array of corresponding overlap weights
 ///
-map<pair<int, int>, double> *CGroundwaterModel::GetOverlapWeights()
+int CGroundwaterModel::GetNodeOverlaps(const int node, const int *&aHRUs, const double *&aWeights) const
 {
-  return &_mOverlapWeights;
+  aHRUs = NULL; aWeights = NULL;
+  if (_aHRUStartByNode == NULL) { return 0; }
+  aHRUs    = &_aHRUByNode   [_aHRUStartByNode[node]];
+  aWeights = &_aWeightByNode[_aHRUStartByNode[node]];
+  return _aHRUStartByNode[node + 1] - _aHRUStartByNode[node];
 }
 
 //////////////////////////////////////////////////////////////////
@@ -622,14 +711,11 @@ vector<int> CGroundwaterModel::GetHRUsByNode(const int node)
 {
   vector<int> HRUs;
   //-- Obtain vector of HRUIDs for given cell
-  map<int, vector<int> >::iterator map_query;
-  map_query = _mHRUsByNode.find(node);
-
-  //-- If not empty set to the return value
-  if (map_query != _mHRUsByNode.end()) {
-    HRUs = map_query->second;
+  if (_aHRUStartByNode != NULL) {
+    for (int i = _aHRUStartByNode[node]; i < _aHRUStartByNode[node + 1]; i++) {
+      HRUs.push_back(_aHRUIDByNode[i]);
+    }
   }
-
   return HRUs;
 }
 
@@ -643,14 +729,13 @@ vector<int> CGroundwaterModel::GetNodesByHRU(const int HRUID)
 {
   vector<int> Cells;
   //-- Obtain vector of nodes given HRU
-  map<int, vector<int> >::iterator map_query;
-  map_query = _mNodesByHRU.find(HRUID);
-
-  //-- If not empty set to the return value
-  if (map_query != _mNodesByHRU.end()) {
-    Cells = map_query->second;
+  CHydroUnit *pHRU = _pModel->GetHRUByID(HRUID);
+  if ((_aNodeStartByHRU != NULL) && (pHRU != NULL)) {
+    int k = pHRU->GetGlobalIndex();
+    for (int i = _aNodeStartByHRU[k]; i < _aNodeStartByHRU[k + 1]; i++) {
+      Cells.push_back(_aNodeByHRU[i]);
+    }
   }
-
   return Cells;
 }
 
@@ -715,29 +800,22 @@ void CGroundwaterModel::AddFlux(const int k, const double moved)
 ///
 void CGroundwaterModel::FluxToGWEquation(const CHydroUnit *pHRU, double GWVal)
 {
-  long long int HRUID;
-  int k;
-  double      flux, weight, area, node_rech;
-  int         n,active_node;
-  vector<int> HRUnodes;
+  int         k;
+  double      flux, node_rech;
+  int         active_node;
 
   k               = pHRU->GetGlobalIndex();
-  HRUID           = pHRU->GetHRUID();
-  HRUnodes        = GetNodesByHRU((int)(HRUID)); //\todo[funct] - support long
 
   //-- Calc Non-GWSW Process contribution    //testing flux = 9.027605E-04;
   flux = (GWVal - _aGWSWFluxes[k]) / MM_PER_METER; // [mm/T] to [m/T]
 
   //-- This flux should never be below zero, right? Something to think about [checking for]
-  //-- Distribute flow among HRU cells
-  for (unsigned int j=0; j< HRUnodes.size(); j++)
+  //-- Distribute flow among HRU cells (CSR row of HRU k)
+  for (int i=_aNodeStartByHRU[k]; i<_aNodeStartByHRU[k+1]; i++)
   {
     // Correct to topmost active node
-    n           = HRUnodes[j];
-    active_node = GetTopActiveNode(n);
-    weight      = GetOverlapWeight((int)(HRUID), n); //todo[funct] - support long long int
-    area        = GetNodeArea(n);
-    node_rech   = flux * area * weight; // [m3/d] * overlap weight-corrected
+    active_node = GetTopActiveNode(_aNodeByHRU[i]);
+    node_rech   = flux * _aNodeAreaByHRU[i] * _aWeightByHRU[i]; // [m3/d] * overlap weight-corrected
     // GW Rate
     AddToGWEquation(active_node, 0.0, node_rech);
   }
@@ -24,8 +24,8 @@ class CGWRiverConnection;
 /// A note about HRU-node connections:
 /// It is assumed, primarily, Raven will be interacting with the top layer of
 /// the groundwater model. For this reason, the Node-HRU maps only define the
-/// the connections to nodes in the first layer (_mNodesByHRU, _mHRUsByNode)
-/// This is also true for _mOverlapWeights. The assumption is that any process
+/// the connections to nodes in the first layer (_aNodeByHRU, _aHRUByNode)
+/// This is also true for the overlap weights. The assumption is that any process
 /// connected to lower nodes shouldn't be needing weights (e.g., all the water
 /// goes to a specific node). This could change in the future.
 /// For consistency with MODFLOW, processes moving water to the groundwater
@@ -70,12 +70,22 @@ private:/*----------------------------------------------------*/
   double                        *_aGWSWFluxes;  ///< Sum of fluxes (one for each HRU) to/from the GW compartment.
                                                 ///  Used to determine non-GWSW process flux to GW model
 
-  map<pair<int,int>, double> _mOverlapWeights;  ///< 2D "matrix" of weights relating which HRUs are connected to which GW cells
+  map<pair<int,int>, double> _mOverlapWeights;  ///< 2D "matrix" of weights relating which HRUs are connected to which GW cells, keyed by <HRUID,node>
                                                 ///  =A_ki/A_i where A_ki is area of overlap between HRU k and node i and A_i is area of node i
                                                 ///  Only contains weights for layer 1 (see HRU-node comment at top)
-                                                ///  Dimensions : [_nHydroUnits][_aNodesPerLayer[0]] (variable)
-  map<int,vector<int> >          _mNodesByHRU;  ///< Map of length _nNodes with vectors of the HRUs connected to that node
-  map<int,vector<int> >          _mHRUsByNode;  ///< Map of length _nHRU with vectors of the nodes connected to that HRU
+                                                ///  Only used during parsing; emptied once compressed by BuildOverlapMatrices()
+  vector<pair<int,int> >    _vOverlapOrder;     ///< <HRUID,node> connections in order of definition (parse-time only)
+
+  //-- Compressed sparse overlap matrices, built once by BuildOverlapMatrices()
+  int                             _nOverlaps;  ///< number of non-zero HRU-node overlap weights
+  int                       *_aNodeStartByHRU; ///< CSR row pointers, by HRU global index [size:_nHydroUnits+1]
+  int                            *_aNodeByHRU; ///< CSR layer 1 node ids connected to each HRU [size:_nOverlaps]
+  double                       *_aWeightByHRU; ///< CSR overlap weights w_ki corresponding to _aNodeByHRU [size:_nOverlaps]
+  double                     *_aNodeAreaByHRU; ///< areas of nodes in _aNodeByHRU [m2] [size:_nOverlaps]
+  int                       *_aHRUStartByNode; ///< CSC column pointers, by layer 1 node id (indexed from 1) [size:_aNodesPerLayer[0]+2]
+  int                            *_aHRUByNode; ///< CSC HRU global indices connected to each node [size:_nOverlaps]
+  int                          *_aHRUIDByNode; ///< CSC HRU identifiers connected to each node [size:_nOverlaps]
+  double                       *_aWeightByNode; ///< CSC overlap weights corresponding to _aHRUByNode [size:_nOverlaps]
 
   void                   UpdateTStep         (const double &t);
   void                   UpdateProcessBudgets(const double& timestep);
@@ -108,6 +118,7 @@ public:/*-------------------------------------------------------*/
                                            const int        node,
                                            const double     weight,
                                            const optStruct &Options);
+  void                   BuildOverlapMatrices();
   void                   AddFlux          (const int k, const double moved);
   void                   FluxToGWEquation (const CHydroUnit *pHRU, double GWVal);
   void                   SetCBCUnitNo     (int unit_no);
@@ -120,6 +131,7 @@ public:/*-------------------------------------------------------*/
   double                 GetNodeArea      (int n);
   int                    GetTotalTSteps   ();
   double                 GetOverlapWeight (int HRUID, int node);
+  int                    GetNodeOverlaps  (const int node, const int *&aHRUs, const double *&aWeights) const;
   int                    GetNumProcesses  () const;
   CGWSWProcessABC*       GetProcess       (process_type ptype);
   map<process_type,
@@ -127,8 +139,6 @@ public:/*-------------------------------------------------------*/
   CGWRiverConnection*    GetRiverConnection ();
   CGWDrain*              GetDrainProcess  ();
   CGWRecharge*           GetRechProcess   ();
-  map<pair<int,int>,
-    double>             *GetOverlapWeights();
   vector<int>            GetHRUsByNode    (const int cellid);
   vector<int>            GetNodesByHRU    (const int HRUID);
 };
@@ -243,6 +243,71 @@ void CHydroProcessABC::ApplyConstraints(const double *state_vars,
   return;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Prepares process for time step; by default, does nothing
+/// \details called by CModel::PrepareProcesses() at the start of each time step
+/// \param *pHRUs [in] array of all model HRUs [size: nHRUs]
+/// \param *aApplies [in] true if process applies to HRU k [size: nHRUs]
+/// \param nHRUs [in] number of HRUs in model
+/// \param &Options [in] Global model options information
+/// \param &tt [in] Current model time
+//
+void CHydroProcessABC::PrepareTimeStep(const CHydroUnit  *const *pHRUs,
+                                       const bool        *aApplies,
+                                       const int          nHRUs,
+                                       const optStruct   &Options,
+                                       const time_struct &tt)
+{
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns true if process rates depend upon the order in which HRUs are processed
+/// \details if any process in the model returns true, the ordered series solver processes HRUs strictly one at a time
+//
+bool CHydroProcessABC::DependsOnHRUOrder() const
+{
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns true if process implements GetBatchRatesOfChange() more efficiently than per-HRU evaluation
+/// \note default is false; child classes return true only for algorithm types with a batched implementation
+//
+bool CHydroProcessABC::SupportsBatchRates() const
+{
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns constrained rates of change for a block of HRUs
+/// \details Equivalent to calling GetRatesOfChange() then ApplyConstraints() for each HRU in block.
+/// Default implementation does exactly that; child classes may override to evaluate rates over
+/// structure-of-arrays inputs gathered once for the block, so that rate calculations may be vectorized
+///
+/// \param nHRUs [in] number of HRUs in block (<=PROCESS_BATCH_SIZE)
+/// \param state_vars [in] array of pointers to state variable arrays of each HRU in block [size: nHRUs]
+/// \param pHRUs [in] array of pointers to HRUs in block [size: nHRUs]
+/// \param &Options [in] Global model option information
+/// \param &tt [in] Current model time
+/// \param *rates [out] rates of change, connection-major: rates[q*nHRUs+n] [size: _nConnections*nHRUs]
+//
+void CHydroProcessABC::GetBatchRatesOfChange(const int          nHRUs,
+                                             const double      *const *state_vars,
+                                             const CHydroUnit  *const *pHRUs,
+                                             const optStruct   &Options,
+                                             const time_struct &tt,
+                                                   double      *rates) const
+{
+  double rates_n[MAX_CONNECTIONS];
+  for (int n=0;n<nHRUs;n++)
+  {
+    for (int q=0;q<_nConnections;q++){rates_n[q]=0.0;}
+    GetRatesOfChange(state_vars[n],pHRUs[n],Options,tt,rates_n);
+    ApplyConstraints(state_vars[n],pHRUs[n],Options,tt,rates_n);
+    for (int q=0;q<_nConnections;q++){rates[q*nHRUs+n]=rates_n[q];}
+  }
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Adds conditional statement required for hydrological process to be applied
 ///
@@ -92,6 +92,14 @@ public:/*-------------------------------------------------------*/
   void                 Redirect(const int toSVindex, const int newToSVindex);
 
   virtual void Initialize();
+
+  //called at start of each time step, before any rates are calculated, to update internal data which depend upon
+  //parameters or time step, so that GetRatesOfChange() need only read it. aApplies[k] is true if process applies to HRU k
+  virtual void PrepareTimeStep(const CHydroUnit  *const *pHRUs,
+                               const bool        *aApplies,
+                               const int          nHRUs,
+                               const optStruct   &Options,
+                               const time_struct &tt);
   virtual void GetParticipatingParamList(string *aP, class_type *aPC, int &nP) const=0;
 
   //calculates and returns rates of water/energy LOSS of "iFrom" Storage Units/state variables (e.g., [mm/d] or [MJ/m2/d])
@@ -109,6 +117,19 @@ public:/*-------------------------------------------------------*/
                                 const optStruct   &Options,
                                 const time_struct &tt,
                                       double      *rates) const=0;
+
+  //true if rates depend upon the order in which HRUs are processed (e.g., use values from previously processed HRU)
+  virtual bool DependsOnHRUOrder    () const;
+
+  //optional batched interface: calculates constrained rates for a block of HRUs at once
+  //rates are stored connection-major (rates[q*nHRUs+n]) so that per-connection loops are contiguous
+  virtual bool SupportsBatchRates   () const;
+  virtual void GetBatchRatesOfChange(const int          nHRUs,
+                                     const double      *const *state_vars,
+                                     const CHydroUnit  *const *pHRUs,
+                                     const optStruct   &Options,
+                                     const time_struct &tt,
+                                           double      *rates) const;
 };
 
 ///////////////////////////////////////////////////////////////////
@@ -86,6 +86,7 @@ CHydroUnit::CHydroUnit(const CModelABC        *pMod,
   for (i=0;i<_pModel->GetNumStateVars();i++){
     _aStateVar[i]=0.0;
   }
+  _ownsStateVars=true;
 
   ZeroOutForcings(_Forcings);
 
@@ -105,6 +106,11 @@ CHydroUnit::CHydroUnit(const CModelABC        *pMod,
   else                    { _pTerrain=NULL;}
   _PrecipMult = 1.0;
   _SpecifiedGaugeIdx=DOESNT_EXIST;
+  _derivedParamVersion=DOESNT_EXIST;
+
+  _pLocalGlobals   =NULL;
+  _aPETBlendWts    =NULL;
+  _aPotMeltBlendWts=NULL;
 
   soil_profile->AllocateSoilLayers(_pModel->GetNumSoilLayers(),_pSoil,aThickness);
 }
@@ -115,7 +121,10 @@ CHydroUnit::CHydroUnit(const CModelABC        *pMod,
 CHydroUnit::~CHydroUnit()
 {
   if (DESTRUCTOR_DEBUG){cout<<"    DELETING HYDROUNIT"<<endl;}
-  delete [] _aStateVar; _aStateVar=NULL;
+  if (_ownsStateVars){delete [] _aStateVar;} _aStateVar=NULL;
+  delete _pLocalGlobals;        _pLocalGlobals   =NULL;
+  delete [] _aPETBlendWts;      _aPETBlendWts    =NULL;
+  delete [] _aPotMeltBlendWts;  _aPotMeltBlendWts=NULL;
 }
 /*****************************************************************
    Accessors
@@ -186,6 +195,13 @@ double    CHydroUnit::GetPrecipMultiplier               () const {return _Precip
 //
 int       CHydroUnit::GetSpecifiedGaugeIndex            () const {return _SpecifiedGaugeIdx;}
 
+//////////////////////////////////////////////////////////////////
+/// \brief Returns version of class-based derived parameters last copied into HRU
+///
+/// \return version number (or DOESNT_EXIST, if outdated)
+//
+int       CHydroUnit::GetDerivedParamVersion            () const {return _derivedParamVersion;}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Checks if HRU is linked to reservoir
 ///
@@ -221,6 +237,32 @@ surface_struct  const *CHydroUnit::GetSurfaceProps      () const {return _pSurfa
 //
 terrain_struct  const *CHydroUnit::GetTerrainProps      () const {return _pTerrain;}
 
+//////////////////////////////////////////////////////////////////
+/// \brief Returns global parameters effective in this HRU
+/// \details returns HRU-specific copy if one or more global parameters are locally overridden in this HRU
+///
+/// \return Pointer to structure containing global parameters
+//
+global_struct   const *CHydroUnit::GetGlobalParams      () const
+{
+  if (_pLocalGlobals!=NULL){return _pLocalGlobals;}
+  return _pModel->GetGlobalParams()->GetParams();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns HRU-specific PET blend weights
+///
+/// \return array of blend weights, or NULL if model-wide weights apply
+//
+double          const *CHydroUnit::GetPETBlendWeights   () const {return _aPETBlendWts;}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns HRU-specific potential melt blend weights
+///
+/// \return array of blend weights, or NULL if model-wide weights apply
+//
+double          const *CHydroUnit::GetPotMeltBlendWeights() const {return _aPotMeltBlendWts;}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Returns soil properties of a layer of soil in HRU
 ///
@@ -334,6 +376,23 @@ double CHydroUnit::GetCumulFluxBet(const int iFrom, const int iTo) const
    Manipulators
 *****************************************************************/
 
+//////////////////////////////////////////////////////////////////
+/// \brief Moves HRU state variables into externally owned storage (row of model state matrix)
+/// \details current state variable values are copied to new storage, which HRU thereafter references
+///
+/// \param aStateVar [in] pointer to storage for CModel::nStateVars values, owned by model
+//
+void    CHydroUnit::SetStateVarStorage(double *aStateVar)
+{
+  ExitGracefullyIf(aStateVar==NULL,"CHydroUnit::SetStateVarStorage: NULL storage",RUNTIME_ERR);
+  for (int i=0;i<_pModel->GetNumStateVars();i++){
+    aStateVar[i]=_aStateVar[i];
+  }
+  if (_ownsStateVars){delete [] _aStateVar;}
+  _aStateVar    =aStateVar;
+  _ownsStateVars=false;
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Sets state variable value
 /// \remarks should only be called from within MassEnergyBalance routine at end of timestep!!!
@@ -379,11 +438,44 @@ void    CHydroUnit::Initialize      (const int UTM_zone)
                 _Centroid.UTM_x,   _Centroid.UTM_y);
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Sets derived parameters which rely only upon vegetation/land use class and time of year
+/// \details copies canopy parameters shared by all HRUs with same vegetation and land use classes,
+/// then recalculates HRU-specific root parameters. Called (at most) daily by CModel::RecalculateHRUDerivedParams()
+///
+/// \param &VV [in] class-based canopy parameters from CVegetationClass::RecalculateCanopyParams()
+/// \param version [in] version of class-based derived parameters
+/// \param &Options [in] Global model options information
+/// \param &tt [in] current time
+//
+void CHydroUnit::SetClassDerivedParams(const veg_var_struct &VV,
+                                       const int             version,
+                                       const optStruct      &Options,
+                                       const time_struct    &tt)
+{
+  _VegVar.shelter_factor  =VV.shelter_factor;
+  _VegVar.height          =VV.height;
+  _VegVar.LAI             =VV.LAI;
+  _VegVar.SAI             =VV.SAI;
+  _VegVar.capacity        =VV.capacity;
+  _VegVar.snow_capacity   =VV.snow_capacity;
+  _VegVar.skyview_fact    =VV.skyview_fact;
+  _VegVar.rain_icept_pct  =VV.rain_icept_pct;
+  _VegVar.snow_icept_pct  =VV.snow_icept_pct;
+  _VegVar.roughness       =VV.roughness;
+  _VegVar.zero_pln_disp   =VV.zero_pln_disp;
+  _VegVar.reference_height=VV.reference_height;
+
+  CVegetationClass::RecalculateRootParams(_VegVar,this,_pModel,tt,Options);
+
+  _derivedParamVersion=version;
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Recalculates derived parameters
-/// \details Recalculates parameters that rely on time of year or forcing functons,
-/// which have been updated since most recent calculation. Called from MassEnergyBalance() method
-/// \note May wish to only recalculate daily or otherwise intermittently
+/// \details Recalculates parameters that rely on forcing functions or state variables,
+/// which have been updated since most recent calculation. Called at start of each time step,
+/// after SetClassDerivedParams()
 ///
 /// \param &Options [in] Global model options information
 /// \param &tt [in] current time
@@ -391,8 +483,7 @@ void    CHydroUnit::Initialize      (const int UTM_zone)
 void CHydroUnit::RecalculateDerivedParams(const optStruct &Options,
                                           const time_struct &tt)
 {
-  CVegetationClass::RecalculateCanopyParams(_VegVar,this,_pModel,tt,Options);
-  CVegetationClass::RecalculateRootParams  (_VegVar,this,_pModel,tt,Options);
+  CVegetationClass::UpdateCanopyStateParams(_VegVar,this,_pModel,Options);
 }
 
 //////////////////////////////////////////////////////////////////
@@ -434,11 +525,40 @@ void     CHydroUnit::SetSpecifiedGaugeIndex(const int g)
   _SpecifiedGaugeIdx=g;
  }
 //////////////////////////////////////////////////////////////////
+/// \brief Sets global parameters effective in this HRU (copy of model globals with local overrides applied)
+///
+/// \param G [in] global parameter structure
+//
+void     CHydroUnit::SetLocalGlobalParams(const global_struct &G)
+{
+  if (_pLocalGlobals==NULL){
+    _pLocalGlobals=new global_struct;
+    ExitGracefullyIf(_pLocalGlobals==NULL,"CHydroUnit::SetLocalGlobalParams",OUT_OF_MEMORY);
+  }
+  *_pLocalGlobals=G;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Sets blend weights effective in this HRU
+///
+/// \param pname [in] blend weight parameter name (PET_BLEND_WTS or POTMELT_BLEND_WTS)
+/// \param wts [in] array of weights [size: N]
+/// \param N [in] number of weights
+//
+void     CHydroUnit::SetLocalBlendWeights(const string pname, const double *wts, const int N)
+{
+  double *&aWts=(pname=="PET_BLEND_WTS") ? _aPETBlendWts : _aPotMeltBlendWts;
+  delete [] aWts;
+  aWts=new double [N];
+  ExitGracefullyIf(aWts==NULL,"CHydroUnit::SetLocalBlendWeights",OUT_OF_MEMORY);
+  for (int i=0;i<N;i++){aWts[i]=wts[i];}
+}
+//////////////////////////////////////////////////////////////////
 /// \brief Changes the land use class mid-simulation
 //
 void CHydroUnit::ChangeLandUse(const CLandUseClass    *lult_class)
 {
   _pSurface=lult_class->GetSurfaceStruct();
+  _derivedParamVersion=DOESNT_EXIST;
 }
 //////////////////////////////////////////////////////////////////
 /// \brief Changes the vegetation class mid-simulation
@@ -446,6 +566,7 @@ void CHydroUnit::ChangeLandUse(const CLandUseClass    *lult_class)
 void CHydroUnit::ChangeVegetation(const CVegetationClass *veg_class)
 {
   _pVeg = veg_class->GetVegetationStruct();
+  _derivedParamVersion=DOESNT_EXIST;
 }
 //////////////////////////////////////////////////////////////////
 /// \brief Changes the HRU Type mid-simulation
@@ -578,7 +699,7 @@ double        CHydroUnit::GetStateVarMax(const int      i,
       if(!ignorevar) {
         int iSNO  =_pModel->GetStateVarIndex(SNOW);
         double SWE = curr_state_var[iSNO];
-        max_var = CalculateSnowLiquidCapacity(SWE, GetSnowDepth(), _pModel);
+        max_var = CalculateSnowLiquidCapacity(SWE, GetSnowDepth(), this);
       }
       break;
     }
@@ -628,7 +749,7 @@ double CHydroUnit::GetSnowTemperature() const
 {
   int iSnTemp = _pModel->GetStateVarIndex(SNOW_TEMP);
   if (iSnTemp == DOESNT_EXIST){
-    double sntmp = _pModel->GetGlobalParams()->GetParams()->snow_temperature;
+    double sntmp = GetGlobalParams()->snow_temperature;
     if (sntmp == NOT_NEEDED_AUTO){
       return 0.0;
     }
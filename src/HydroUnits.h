@@ -35,6 +35,7 @@ private:/*------------------------------------------------------*/
 
   //Model State variables:
   double                  *_aStateVar;  ///< Array of *current value* of state variable i with size CModel::nStateVars [mm] for water storage, permafrost depth, snow depth, [MJ/m^2] for energy storage
+  bool               _ownsStateVars;  ///< true if _aStateVar is owned by HRU; false once it references row of model state matrix
 
   //Model Forcing functions:
   force_struct              _Forcings;  ///< *current values* of forcing functions for time step (precip, temp, etc.)
@@ -63,6 +64,12 @@ private:/*------------------------------------------------------*/
 
   /// /todo allow for variable aquifer properties in each HRU (see above)
   veg_var_struct              _VegVar;  ///< Points to derived vegetation properties
+  int            _derivedParamVersion;  ///< version of class-based derived parameters copied into _VegVar (DOESNT_EXIST if outdated)
+
+  //effective parameters with local overrides applied (HRU-specific, NULL if no overrides apply to this HRU)
+  global_struct      *_pLocalGlobals;  ///< copy of global parameters with :GlobalParameterOverride values applied
+  double             *_aPETBlendWts;   ///< PET blend weights from :SBGroupOverrideWeights
+  double         *_aPotMeltBlendWts;   ///< potential melt blend weights from :SBGroupOverrideWeights
 
 public:/*-------------------------------------------------------*/
   //Constructors:
@@ -110,6 +117,7 @@ public:/*-------------------------------------------------------*/
 
   double                 GetPrecipMultiplier() const;
   int                    GetSpecifiedGaugeIndex() const;
+  int                    GetDerivedParamVersion() const;
 
   soil_struct     const *GetSoilProps       (const int m) const;
   double                 GetSoilThickness   (const int m) const;//[mm]
@@ -122,6 +130,9 @@ public:/*-------------------------------------------------------*/
   veg_var_struct  const *GetVegVarProps     () const;
   surface_struct  const *GetSurfaceProps    () const;
   terrain_struct  const *GetTerrainProps    () const;
+  global_struct   const *GetGlobalParams    () const;
+  double          const *GetPETBlendWeights () const;
+  double          const *GetPotMeltBlendWeights() const;
 
   force_struct    const *GetForcingFunctions() const;
   double                 GetForcing         (const forcing_type &ftype) const;
@@ -150,6 +161,7 @@ public:/*-------------------------------------------------------*/
 
   //Manipulator functions (used in initialization)
   void          Initialize              (const int UTM_zone);
+  void          SetStateVarStorage      (double *aStateVar);
 
   //Manipulator functions (used in solution method)
   void          SetStateVarValue        (const int           i,
@@ -158,6 +170,8 @@ public:/*-------------------------------------------------------*/
   void          CopyDailyForcings       (force_struct &F);
   void          SetPrecipMultiplier     (const double factor);
   void          SetSpecifiedGaugeIndex  (const int g);
+  void          SetLocalGlobalParams    (const global_struct &G);
+  void          SetLocalBlendWeights    (const string pname, const double *wts, const int N);
   void          ChangeLandUse           (const CLandUseClass    *lult_class);
   void          ChangeVegetation        (const CVegetationClass *veg_class);
   void          ChangeHRUType           (const HRU_type typ);
@@ -166,6 +180,10 @@ public:/*-------------------------------------------------------*/
   void          AdjustDailyHRUForcings  (const forcing_type Ftyp,force_struct &F,const double* epsilon, const adjustment adj, const int nStepsPerDay);
 
   //will be removed with landscape elements:
+  void          SetClassDerivedParams   (const veg_var_struct &VV,
+                                         const int           version,
+                                         const optStruct    &Options,
+                                         const time_struct  &tt);
   void          RecalculateDerivedParams(const optStruct    &Options,
                                          const time_struct  &tt);
 };
@@ -715,8 +715,8 @@ void CmvInfiltration::GetUBCWMRunoff    (const double             *state_vars,
   double Fimp          = pHRU->GetSurfaceProps()->impermeable_frac;
   double max_perc_rate = pHRU->GetSoilProps(1)->max_perc_rate;
   double P0AGEN        = pHRU->GetSoilProps(0)->UBC_infil_soil_def;
-  double P0DSH         = pModel->GetGlobalParams()->GetParams()->UBC_GW_split;
-  double V0FLAS        = pModel->GetGlobalParams()->GetParams()->UBC_flash_ponding;  //[mm]
+  double P0DSH         = pHRU->GetGlobalParams()->UBC_GW_split;
+  double V0FLAS        = pHRU->GetGlobalParams()->UBC_flash_ponding;  //[mm]
 
   //calculate b1 parameter (effective permeable area without flash factor)
   b1=1.0;
@@ -136,16 +136,12 @@ inline double    pythag(const double a,const double b) {
 	else { return (absb==0.0 ? 0.0 : absb*sqrt(1.0+(absa/absb)*(absa/absb))); }
 }
 /************************************************************************
- Singular Value Decomposition:
-Returns solution, x and rank
-	this operation destroys the A matrix
+ SVDDecompose:
+	Singular value decomposition A=U*W*V' of square nxn matrix A
+	A is overwritten by U; w (size n) and v (nxn) must be preallocated; tmp is workspace of size n
 	from Numerical Recipes (Press et al)
 -----------------------------------------------------------------------*/
-bool SVD(Ironclad2DArray AA,
-				 Ironclad1DArray b,
-				 Writeable1DArray x,
-				 const int size,
-				 const double SVTolerance)
+static void SVDDecompose(double **A,double *w,double **v,double *tmp,const int size)
 {
 	bool flag;
 	int i,its,j,jj,k,l,nm;
@@ -153,21 +149,6 @@ bool SVD(Ironclad2DArray AA,
 
 	int m=size;
 	int n=size;
-	double* tmp=new double[n];
-	double* w  =new double[n];
-	double** v=NULL;
-	AllocateMatrix(n,n,v);
-	double **A=NULL;
-	AllocateMatrix(n,n,A);
-	CopyMatrix(AA,n,n,A);
-	/*	cout <<endl;
-		for (j=0;j<size;j++){
-			for (i=0;i<size;i++){
-				cout << A[i][j] <<" ";
-			}
-			cout << "| "<<b[j]<<" | "<<endl;
-		}
-		cout <<endl;*/
 
 	g=scale=anorm=0.0;
 	for(i=0; i<n; i++) {
@@ -347,6 +328,33 @@ bool SVD(Ironclad2DArray AA,
 		}//end for its
 	}
 	//end sub svdcmp (Press et al)
+}
+/************************************************************************
+ Singular Value Decomposition:
+Returns solution, x and rank
+	this operation destroys the A matrix
+	from Numerical Recipes (Press et al)
+-----------------------------------------------------------------------*/
+bool SVD(Ironclad2DArray AA,
+				 Ironclad1DArray b,
+				 Writeable1DArray x,
+				 const int size,
+				 const double SVTolerance)
+{
+	int i,j,jj;
+	double s;
+
+	int m=size;
+	int n=size;
+	double* tmp=new double[n];
+	double* w  =new double[n];
+	double** v=NULL;
+	AllocateMatrix(n,n,v);
+	double **A=NULL;
+	AllocateMatrix(n,n,A);
+	CopyMatrix(AA,n,n,A);
+
+	SVDDecompose(A,w,v,tmp,n);
 
 	double maxw(-ALMOST_INF);
 	double minw(ALMOST_INF);
@@ -388,3 +396,248 @@ bool SVD(Ironclad2DArray AA,
 	//cout <<"SVD CONDITION #: " <<maxw/minw<<endl;
 	return true; //should be dependent upon condition number (max wj/minwj) should be low
 }
+
+/************************************************************************
+ SVDMultiSolve:
+	Solves A*X=B for nRHS right hand sides using a single singular value decomposition of
+	square nxn matrix A (stored contiguously, row-major); singular values below SVTolerance*max are
+	zeroed (pseudo-inverse). B is nxnRHS (contiguous, row-major) and is overwritten by solution X
+-----------------------------------------------------------------------*/
+void SVDMultiSolve(const double *AA,const int n,double *B,const int nRHS,const double SVTolerance)
+{
+	int i,j,r;
+	double *tmp=new double[n];
+	double *w  =new double[n];
+	double *s  =new double[nRHS];
+	double **v=NULL;
+	double **A=NULL;
+	AllocateMatrix(n,n,v);
+	AllocateMatrix(n,n,A);
+	for(i=0;i<n;i++) {
+		for(j=0;j<n;j++) { A[i][j]=AA[i*n+j]; }
+	}
+
+	SVDDecompose(A,w,v,tmp,n);
+
+	double maxw(-ALMOST_INF);
+	for(j=0; j<n; j++) { upperswap(maxw,w[j]); }
+	for(j=0; j<n; j++) {
+		if(fabs(w[j]/maxw)<SVTolerance) { w[j]=0.0; }
+	}
+
+	//T=inv(W)*U'*B (nxnRHS), computed row by row into workspace T
+	double *T=new double[n*nRHS];
+	for(j=0; j<n; j++) {
+		for(r=0;r<nRHS;r++) { s[r]=0.0; }
+		if(w[j]!=0.0) {
+			for(i=0; i<n; i++) {
+				const double  Aij=A[i][j];
+				const double *Bi =B+i*nRHS;
+				for(r=0;r<nRHS;r++) { s[r]+=Aij*Bi[r]; }
+			}
+			for(r=0;r<nRHS;r++) { s[r]/=w[j]; }
+		}
+		for(r=0;r<nRHS;r++) { T[j*nRHS+r]=s[r]; }
+	}
+	//X=V*T
+	for(j=0; j<n; j++) {
+		double *Xj=B+j*nRHS;
+		for(r=0;r<nRHS;r++) { Xj[r]=0.0; }
+		for(i=0; i<n; i++) {
+			const double  vji=v[j][i];
+			const double *Ti =T+i*nRHS;
+			for(r=0;r<nRHS;r++) { Xj[r]+=vji*Ti[r]; }
+		}
+	}
+	delete[] T;
+	delete[] tmp;
+	delete[] w;
+	delete[] s;
+	DeleteMatrix(n,n,v);
+	DeleteMatrix(n,n,A);
+}
+
+/************************************************************************
+ CholeskyFactor:
+	In-place Cholesky factorization A=L*L' of symmetric positive definite nxn matrix A
+	(contiguous, row-major). On return, lower triangle of A holds L; upper triangle is zeroed.
+	Returns false (A partially overwritten) if any pivot is not greater than
+	tolerance*max(diag(A)), i.e., A is not numerically positive definite
+-----------------------------------------------------------------------*/
+bool CholeskyFactor(double *A,const int n,const double tolerance)
+{
+	int i,j,k;
+	double maxdiag=0.0;
+	for(i=0;i<n;i++) { upperswap(maxdiag,A[i*n+i]); }
+	if(maxdiag<=0.0) { return false; }
+
+	for(j=0;j<n;j++)
+	{
+		double *Lj=A+j*n;
+		double d=Lj[j];
+		for(k=0;k<j;k++) { d-=Lj[k]*Lj[k]; }
+		if(d<=tolerance*maxdiag) { return false; }
+		d=sqrt(d);
+		Lj[j]=d;
+		for(i=j+1;i<n;i++)
+		{
+			double *Li=A+i*n;
+			double s=Li[j];
+			for(k=0;k<j;k++) { s-=Li[k]*Lj[k]; }
+			Li[j]=s/d;
+		}
+		for(k=j+1;k<n;k++) { Lj[k]=0.0; }
+	}
+	return true;
+}
+
+/************************************************************************
+ CholeskySolve:
+	Solves L*L'*X=B for nRHS right hand sides given Cholesky factor L (nxn, contiguous, row-major,
+	from CholeskyFactor). B is nxnRHS (contiguous, row-major) and is overwritten by solution X.
+	All updates are row operations over the right hand sides, which are contiguous in memory
+-----------------------------------------------------------------------*/
+void CholeskySolve(const double *L,const int n,double *B,const int nRHS)
+{
+	int i,k,r;
+	//forward substitution L*Y=B
+	for(i=0;i<n;i++)
+	{
+		double *Bi=B+i*nRHS;
+		for(k=0;k<i;k++) {
+			const double  Lik=L[i*n+k];
+			const double *Bk =B+k*nRHS;
+			for(r=0;r<nRHS;r++) { Bi[r]-=Lik*Bk[r]; }
+		}
+		const double inv=1.0/L[i*n+i];
+		for(r=0;r<nRHS;r++) { Bi[r]*=inv; }
+	}
+	//back substitution L'*X=Y
+	for(i=n-1;i>=0;i--)
+	{
+		double *Bi=B+i*nRHS;
+		for(k=i+1;k<n;k++) {
+			const double  Lki=L[k*n+i];
+			const double *Bk =B+k*nRHS;
+			for(r=0;r<nRHS;r++) { Bi[r]-=Lki*Bk[r]; }
+		}
+		const double inv=1.0/L[i*n+i];
+		for(r=0;r<nRHS;r++) { Bi[r]*=inv; }
+	}
+}
+
+/************************************************************************
+ LUFactor:
+	In-place LU factorization P*A=L*U of general nxn matrix A (contiguous, row-major)
+	with partial pivoting. On return, A holds U in its upper triangle and the unit lower
+	triangular L below the diagonal; piv[i] is the original row stored in row i.
+	Returns false (A partially overwritten) if any pivot is not greater than
+	tolerance*max(|A|), i.e., A is numerically singular
+-----------------------------------------------------------------------*/
+bool LUFactor(double *A,const int n,int *piv,const double tolerance)
+{
+	int i,j,k,imax;
+	double amax=0.0;
+	for(i=0;i<n*n;i++) { upperswap(amax,fabs(A[i])); }
+	if(amax==0.0) { return false; }
+	for(i=0;i<n;i++) { piv[i]=i; }
+
+	for(k=0;k<n;k++)
+	{
+		imax=k;
+		for(i=k+1;i<n;i++) {
+			if(fabs(A[i*n+k])>fabs(A[imax*n+k])) { imax=i; }
+		}
+		if(fabs(A[imax*n+k])<=tolerance*amax) { return false; }
+		if(imax!=k) {
+			for(j=0;j<n;j++) { double tmp=A[k*n+j]; A[k*n+j]=A[imax*n+j]; A[imax*n+j]=tmp; }
+			int itmp=piv[k]; piv[k]=piv[imax]; piv[imax]=itmp;
+		}
+		const double *Ak=A+k*n;
+		const double inv=1.0/Ak[k];
+		for(i=k+1;i<n;i++)
+		{
+			double *Ai=A+i*n;
+			const double m=Ai[k]*inv;
+			Ai[k]=m;
+			if(m==0.0) { continue; } //common for sparse systems
+			for(j=k+1;j<n;j++) { Ai[j]-=m*Ak[j]; }
+		}
+	}
+	return true;
+}
+
+/************************************************************************
+ LUSolve:
+	Solves A*x=b given LU factorization and row permutation of A (from LUFactor).
+	b is overwritten by solution x; work is scratch space of size n
+-----------------------------------------------------------------------*/
+void LUSolve(const double *LU,const int n,const int *piv,double *b,double *work)
+{
+	int i,k;
+	for(i=0;i<n;i++) { work[i]=b[piv[i]]; }
+	//forward substitution L*y=Pb (unit diagonal)
+	for(i=0;i<n;i++) {
+		const double *LUi=LU+i*n;
+		double s=work[i];
+		for(k=0;k<i;k++) { s-=LUi[k]*work[k]; }
+		work[i]=s;
+	}
+	//back substitution U*x=y
+	for(i=n-1;i>=0;i--) {
+		const double *LUi=LU+i*n;
+		double s=work[i];
+		for(k=i+1;k<n;k++) { s-=LUi[k]*work[k]; }
+		work[i]=s/LUi[i];
+	}
+	for(i=0;i<n;i++) { b[i]=work[i]; }
+}
+
+/************************************************************************
+ MatMultBlocked:
+	Multiplies NxM matrix A times MxP matrix B. Returns C (NxP)
+	all matrices stored contiguously, row-major; cache-blocked i-k-j ordering
+	so that the innermost loop streams contiguous rows of B and C
+-----------------------------------------------------------------------*/
+void MatMultBlocked(const double *A,const double *B,const int N,const int M,const int P,double *C)
+{
+	int i,k,p,i0,k0,p0,imax,kmax,pmax;
+	for(i=0;i<N*P;i++) { C[i]=0.0; }
+
+	for(i0=0;i0<N;i0+=MATRIX_BLOCK_SIZE) {
+		imax=min(i0+MATRIX_BLOCK_SIZE,N);
+		for(k0=0;k0<M;k0+=MATRIX_BLOCK_SIZE) {
+			kmax=min(k0+MATRIX_BLOCK_SIZE,M);
+			for(p0=0;p0<P;p0+=MATRIX_BLOCK_SIZE) {
+				pmax=min(p0+MATRIX_BLOCK_SIZE,P);
+				for(i=i0;i<imax;i++) {
+					double *Ci=C+i*P;
+					for(k=k0;k<kmax;k++) {
+						const double  Aik=A[i*M+k];
+						const double *Bk =B+k*P;
+						for(p=p0;p<pmax;p++) { Ci[p]+=Aik*Bk[p]; }
+					}
+				}
+			}
+		}
+	}
+}
+
+/************************************************************************
+ TransposeBlocked:
+	Transposes NxM matrix A to MxN matrix AT
+	both stored contiguously, row-major; cache-blocked
+-----------------------------------------------------------------------*/
+void TransposeBlocked(const double *A,const int N,const int M,double *AT)
+{
+	int i,j,i0,j0,imax,jmax;
+	for(i0=0;i0<N;i0+=MATRIX_BLOCK_SIZE) {
+		imax=min(i0+MATRIX_BLOCK_SIZE,N);
+		for(j0=0;j0<M;j0+=MATRIX_BLOCK_SIZE) {
+			jmax=min(j0+MATRIX_BLOCK_SIZE,M);
+			for(i=i0;i<imax;i++) {
+				for(j=j0;j<jmax;j++) { AT[j*N+i]=A[i*M+j]; }
+			}
+		}
+	}
+}
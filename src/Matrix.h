@@ -15,6 +15,8 @@ typedef const double* const* Unchangeable2DArray;
 typedef       double** const Writeable2DArray;
 typedef const double* const* const Ironclad2DArray;
 
+const int MATRIX_BLOCK_SIZE=64; ///< block size (rows/columns) of cache-blocked contiguous matrix kernels
+
 void   MatVectMult    (Ironclad2DArray  A,
 											 Ironclad1DArray  x,
 											 const int N,
@@ -56,4 +58,13 @@ bool						  SVD(Ironclad2DArray A,
 											Writeable1DArray x,
 											const int        size,
 											const double     SVTolerance);
+
+//contiguous (row-major) matrix routines
+void SVDMultiSolve    (const double *A,const int n,double *B,const int nRHS,const double SVTolerance);
+bool CholeskyFactor   (double *A,const int n,const double tolerance);
+void CholeskySolve    (const double *L,const int n,double *B,const int nRHS);
+bool LUFactor         (double *A,const int n,int *piv,const double tolerance);
+void LUSolve          (const double *LU,const int n,const int *piv,double *b,double *work);
+void MatMultBlocked   (const double *A,const double *B,const int N,const int M,const int P,double *C);
+void TransposeBlocked (const double *A,const int N,const int M,double *AT);
 #endif
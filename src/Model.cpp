@@ -3,6 +3,7 @@
   Copyright (c) 2008-2024 the Raven Development Team
   ----------------------------------------------------------------*/
 #include "Model.h"
+#include "Profiler.h"
 #include "EnergyTransport.h"
 
 /*****************************************************************
@@ -28,9 +29,14 @@ CModel::CModel(const int        nsoillayers,
   _nForcingGrids=0;   _pForcingGrids=NULL;
   _nProcesses=0;      _pProcesses=NULL;
   _nCustomOutputs=0;  _pCustomOutputs=NULL;
-  _nTransParams=0;    _pTransParams=NULL;
+  _nTransParams=0;    _pTransParams=NULL;  _aTransParamHandles=NULL;
   _nClassChanges=0;   _pClassChanges=NULL;
   _nParamOverrides=0; _pParamOverrides=NULL;
+  _derivedParamDay=DOESNT_EXIST; _derivedParamVersion=0;
+  _nClassVegCalcs=0;             _nHRUVegUpdates=0;
+  _aStateMatrix=NULL; _aStateMatrixMem=NULL;
+  _nTerrainSigs=0;    _aTerrainSig=NULL; _aSigLatRad=NULL; _aSigSlope=NULL; _aSigAspect=NULL; _aSigDayLength=NULL;
+  _sigDayAngle=RAV_BLANK_DATA; _aClearSkyTerms=NULL; _clearSkyTime=RAV_BLANK_DATA;
   _nObservedTS=0;     _pObservedTS=NULL; _pModeledTS=NULL; _aObsIndex=NULL;
   _nObsWeightTS =0;   _pObsWeightTS=NULL;
   _nDiagnostics=0;    _pDiagnostics=NULL;
@@ -156,6 +162,13 @@ CModel::~CModel()
   CloseOutputStreams();
 
   for (p=0;p<_nSubBasins;    p++){delete _pSubBasins    [p];} delete [] _pSubBasins;    _pSubBasins=NULL;
+  delete [] _aStateMatrixMem;_aStateMatrixMem=NULL; _aStateMatrix=NULL;
+  delete [] _aTerrainSig;    _aTerrainSig=NULL;
+  delete [] _aSigLatRad;     _aSigLatRad=NULL;
+  delete [] _aSigSlope;      _aSigSlope=NULL;
+  delete [] _aSigAspect;     _aSigAspect=NULL;
+  delete [] _aSigDayLength;  _aSigDayLength=NULL;
+  delete [] _aClearSkyTerms; _aClearSkyTerms=NULL;
   for (k=0;k<_nHydroUnits;   k++){delete _pHydroUnits   [k];} delete [] _pHydroUnits;   _pHydroUnits=NULL;
   for (g=0;g<_nGauges;       g++){delete _pGauges       [g];} delete [] _pGauges;       _pGauges=NULL;
   for (f=0;f<_nForcingGrids; f++){delete _pForcingGrids [f];} delete [] _pForcingGrids; _pForcingGrids=NULL;
@@ -193,6 +206,7 @@ CModel::~CModel()
   for (kk=0;kk<_nHRUGroups;kk++)  {delete _pHRUGroups[kk];    } delete [] _pHRUGroups;      _pHRUGroups  =NULL;
   for (kk=0;kk<_nSBGroups;kk++ )  {delete _pSBGroups[kk];     } delete [] _pSBGroups;       _pSBGroups  =NULL;
   for (j=0;j<_nTransParams;j++)   {delete _pTransParams[j];   } delete [] _pTransParams;    _pTransParams=NULL;
+  delete [] _aTransParamHandles; _aTransParamHandles=NULL;
   for (j=0;j<_nClassChanges;j++)  {delete _pClassChanges[j];  } delete [] _pClassChanges;   _pClassChanges=NULL;
   for (j=0;j<_nParamOverrides;j++){delete _pParamOverrides[j];} delete [] _pParamOverrides; _pParamOverrides=NULL;
 
@@ -275,6 +289,46 @@ int CModel::GetNumSubBasinGroups() const { return _nSBGroups; }
 //
 int CModel::GetNumHRUs        () const{return _nHydroUnits;}
 
+//////////////////////////////////////////////////////////////////
+/// \brief Returns counts of class-based derived parameter calculations (for benchmarking)
+/// \param nClassCalcs [out] number of canopy parameter calculations for unique vegetation/land use class combinations
+/// \param nHRUUpdates [out] number of HRU updates from these shared calculations
+//
+void CModel::GetDerivedParamStats(long long &nClassCalcs, long long &nHRUUpdates) const
+{
+  nClassCalcs=_nClassVegCalcs;
+  nHRUUpdates=_nHRUVegUpdates;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns contiguous HRU-major state variable matrix
+/// \details value of state variable i in HRU k is at [k*nStateVars+i]; NULL prior to model initialization
+//
+const double *CModel::GetStateMatrix() const
+{
+  return _aStateMatrix;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns number of unique HRU terrain signatures (latitude, slope, aspect)
+//
+int CModel::GetNumTerrainSignatures() const
+{
+  return _nTerrainSigs;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns clear sky radiation terms shared by all HRUs with the same terrain signature as HRU k
+/// \param k [in] global HRU index
+/// \param t [in] model time
+/// \return pointer to clear sky terms, or NULL if these have not been calculated for time t
+//
+const clear_sky_terms *CModel::GetClearSkyTerms(const int k, const double &t) const
+{
+  if ((_aClearSkyTerms==NULL) || (_clearSkyTime!=t)){return NULL;}
+  return &_aClearSkyTerms[_aTerrainSig[k]];
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Returns number of HRU groups
 ///
@@ -2487,55 +2541,68 @@ void CModel::UpdateTransientParams(const optStruct   &Options,
 {
   //--update parameters linked to time series-----------------------------------------------
   int nn=(int)((tt.model_time+REAL_SMALL)/Options.timestep);//current timestep index
+  if ((_aTransParamHandles==NULL) && (_nTransParams>0))
+  {
+    _aTransParamHandles=new param_handle [_nTransParams];
+    ExitGracefullyIf(_aTransParamHandles==NULL,"CModel::UpdateTransientParams",OUT_OF_MEMORY);
+    for (int j=0;j<_nTransParams;j++)
+    {
+      _aTransParamHandles[j]=GetParameterHandle(_pTransParams[j]->GetParameterClassType(),
+                                                _pTransParams[j]->GetParameterName(),
+                                                _pTransParams[j]->GetParameterClass());
+    }
+  }
   for (int j=0;j<_nTransParams;j++)
   {
-    class_type ctype=_pTransParams[j]->GetParameterClassType();
-    string     pname=_pTransParams[j]->GetParameterName();
-    string     cname=_pTransParams[j]->GetParameterClass();
-    double     value=_pTransParams[j]->GetTimeSeries()->GetSampledValue(nn);
-
-    UpdateParameter(ctype,pname,cname,value);
+    UpdateParameter(_aTransParamHandles[j],_pTransParams[j]->GetTimeSeries()->GetSampledValue(nn));
   }
 
   //--update land use and HRU types-----------------------------------------------
-  int k;
   for (int j = 0; j<_nClassChanges; j++)
   {
     if( ((_pClassChanges[j]->modeltime > tt.model_time - TIME_CORRECTION) &&
          (_pClassChanges[j]->modeltime < tt.model_time + Options.timestep)) ||
 	    ((tt.model_time == 0.0) && (_pClassChanges[j]->modeltime < 0.0)) )
     {//change happens this time step
-
       //cout<<"updating classes on "<<tt.date_string<< endl;
-      int kk   =_pClassChanges[j]->HRU_groupID;
-      for(int k_loc = 0; k_loc <_pHRUGroups[kk]->GetNumHRUs();k_loc++)
-      {
-        k=_pHRUGroups[kk]->GetHRU(k_loc)->GetGlobalIndex();
+      ApplyClassChange(j);
+    }
+  }
 
-        if      (_pClassChanges[j]->tclass == CLASS_LANDUSE)
-        {
-          CLandUseClass *lult_class = StringToLUClass(_pClassChanges[j]->newclass);
-          _pHydroUnits[k]->ChangeLandUse(lult_class);
-        }
-        else if (_pClassChanges[j]->tclass == CLASS_VEGETATION)
-        {
-          CVegetationClass *veg_class = StringToVegClass(_pClassChanges[j]->newclass);
-          _pHydroUnits[k]->ChangeVegetation(veg_class);
-        }
-        else if (_pClassChanges[j]->tclass == CLASS_HRUTYPE)
-        {
-          HRU_type typ=StringToHRUType(_pClassChanges[j]->newclass);
-          _pHydroUnits[k]->ChangeHRUType(typ);
-        }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Applies HRU class change j to all HRUs in its HRU group
+/// \param j [in] index of class change
+//
+void CModel::ApplyClassChange(const int j)
+{
+  int k;
+  int kk   =_pClassChanges[j]->HRU_groupID;
+  for(int k_loc = 0; k_loc <_pHRUGroups[kk]->GetNumHRUs();k_loc++)
+  {
+    k=_pHRUGroups[kk]->GetHRU(k_loc)->GetGlobalIndex();
 
-        for(int jj=0; jj<_nProcesses;jj++)// kt
-        {
-          _aShouldApplyProcess[jj][k] = _pProcesses[jj]->ShouldApply(_pHydroUnits[k]);
-        }
-      }
+    if      (_pClassChanges[j]->tclass == CLASS_LANDUSE)
+    {
+      CLandUseClass *lult_class = StringToLUClass(_pClassChanges[j]->newclass);
+      _pHydroUnits[k]->ChangeLandUse(lult_class);
+    }
+    else if (_pClassChanges[j]->tclass == CLASS_VEGETATION)
+    {
+      CVegetationClass *veg_class = StringToVegClass(_pClassChanges[j]->newclass);
+      _pHydroUnits[k]->ChangeVegetation(veg_class);
+    }
+    else if (_pClassChanges[j]->tclass == CLASS_HRUTYPE)
+    {
+      HRU_type typ=StringToHRUType(_pClassChanges[j]->newclass);
+      _pHydroUnits[k]->ChangeHRUType(typ);
     }
-  }
 
+    for(int jj=0; jj<_nProcesses;jj++)// kt
+    {
+      _aShouldApplyProcess[jj][k] = _pProcesses[jj]->ShouldApply(_pHydroUnits[k]);
+    }
+  }
 }
 //////////////////////////////////////////////////////////////////
 /// \brief Determines parameter class (e.g., CLASS_GLOBAL or CLASS_SOIL) from parameter name and class name through slow search
@@ -2620,6 +2687,20 @@ int CModel::GetNumLanduseClasses() const {
   return _nLandUseClasses;
 }
 //////////////////////////////////////////////////////////////////
+/// \brief returns true if class parameter may be used by class-based derived parameters (see RecalculateHRUDerivedParams())
+/// \details canopy parameters use vegetation and land use class parameters; of the soil parameters, only
+/// stone fraction is used (by root parameters)
+///
+/// \param &ctype [in] parameter class type
+/// \param &pname [in] parameter name
+//
+bool AffectsClassDerivedParams(const class_type &ctype,const string &pname)
+{
+  if ((ctype==CLASS_VEGETATION) || (ctype==CLASS_LANDUSE)){return true;}
+  if  (ctype==CLASS_SOIL){return (StringToUppercase(pname)=="STONE_FRAC");}
+  return false;
+}
+//////////////////////////////////////////////////////////////////
 /// \brief Updates model parameter during course of simulation
 ///
 /// \param &ctype [in] parameter class type
@@ -2631,6 +2712,13 @@ void CModel::UpdateParameter(const class_type &ctype,const string pname,const st
 {
   if (value==RAV_BLANK_DATA) { return; }
 
+  if (AffectsClassDerivedParams(ctype,pname)){
+    double *pxAddress=GetParameterHandle(ctype,pname,cname).pxAddress;
+    if ((pxAddress==NULL) || (*pxAddress!=value)){
+      _derivedParamDay=DOESNT_EXIST; //forces recalculation of class-based derived parameters
+    }
+  }
+
   if (ctype==CLASS_SOIL)
   {
     StringToSoilClass(cname)->SetSoilProperty(pname, value);
@@ -2654,7 +2742,10 @@ void CModel::UpdateParameter(const class_type &ctype,const string pname,const st
   }
   else if(ctype==CLASS_GLOBAL)
   {
+    double *pxAddress=_pGlobalParams->GetAddress(pname);
+    if ((pxAddress!=NULL) && (*pxAddress==value)){return;} //unchanged - avoids refreshing local parameter views
     _pGlobalParams->SetGlobalProperty(pname, value);
+    UpdateLocalParamViews();
   }
   else if(ctype==CLASS_GAUGE)
   {
@@ -2687,29 +2778,95 @@ void CModel::UpdateParameter(const class_type &ctype,const string pname,const st
   }
 }
 //////////////////////////////////////////////////////////////////
-/// \brief overrides global parameters in subbasin groups
-/// \notes called only from solver within HRU loop
+/// \brief Resolves parameter class and name once so that parameter may be repeatedly updated quickly
+/// \details parameters of soil, vegetation, land use, terrain classes and global parameters set by simple
+/// assignment are resolved to the address of the parameter value; all others (gauge, subbasin,
+/// and special-case parameters) are updated by name through UpdateParameter(ctype,pname,cname,value)
 ///
-/// \param k [in] global HRU index
-/// \param revert [in] true if reverting to base value, false if changing to overridden value
+/// \param &ctype [in] parameter class type
+/// \param &pname [in] valid parameter name
+/// \param &cname [in] valid parameter class name (or SBID as string for CLASS_SUBBASIN or gauge ID as string for CLASS_GAUGE)
+/// \returns parameter handle
 //
-void CModel::ApplyLocalParamOverrrides(const int k, const bool revert)
+param_handle CModel::GetParameterHandle(const class_type &ctype,const string pname,const string cname)
 {
-  for (int i=0;i<_nParamOverrides;i++)
+  param_handle h;
+  h.ctype    =ctype;
+  h.pname    =pname;
+  h.cname    =cname;
+  h.pxAddress=NULL;
+
+  if (ctype==CLASS_SOIL)
+  {
+    CSoilClass *pClass=StringToSoilClass(cname);
+    if (pClass!=NULL){h.pxAddress=pClass->GetSoilPropertyAddress(pname);}
+  }
+  else if(ctype==CLASS_VEGETATION)
+  {
+    CVegetationClass *pClass=StringToVegClass(cname);
+    if (pClass!=NULL){h.pxAddress=pClass->GetVegetationPropertyAddress(pname);}
+  }
+  else if(ctype==CLASS_TERRAIN)
+  {
+    CTerrainClass *pClass=StringToTerrainClass(cname);
+    if (pClass!=NULL){h.pxAddress=pClass->GetTerrainPropertyAddress(pname);}
+  }
+  else if(ctype==CLASS_LANDUSE)
   {
-    if (_pParamOverrides[i]->aHRUIsOverridden[k]) {
-      if (!revert){
-        for (int j=0; j<_pParamOverrides[i]->nVals; j++){
-          _pParamOverrides[i]->pxAddress[j] = _pParamOverrides[i]->aValues[j];
+    CLandUseClass *pClass=StringToLUClass(cname);
+    if (pClass!=NULL){h.pxAddress=pClass->GetSurfacePropertyAddress(pname);}
+  }
+  else if(ctype==CLASS_GLOBAL)
+  {
+    h.pxAddress=_pGlobalParams->GetAddress(pname);
+  }
+  return h;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Updates model parameter during course of simulation using pre-resolved parameter handle
+///
+/// \param &handle [in] parameter handle from GetParameterHandle()
+/// \param &value [in] updated parameter value (or -1.2345, which is ignored)
+//
+void CModel::UpdateParameter(const param_handle &handle,const double &value)
+{
+  if (value==RAV_BLANK_DATA) { return; }
 
-        }
-      }
-      else{
-        for (int j=0; j<_pParamOverrides[i]->nVals; j++){
-          _pParamOverrides[i]->pxAddress[j] = _pParamOverrides[i]->aRevertValues[j];
-        }
+  if (handle.pxAddress!=NULL){
+    if (*(handle.pxAddress)==value){return;} //unchanged (e.g., transient parameter held constant) - nothing to refresh
+    *(handle.pxAddress)=value;
+    if      (handle.ctype==CLASS_GLOBAL)                            {UpdateLocalParamViews();}
+    else if (AffectsClassDerivedParams(handle.ctype,handle.pname)){_derivedParamDay=DOESNT_EXIST;}
+  }
+  else {
+    UpdateParameter(handle.ctype,handle.pname,handle.cname,value);
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief refreshes HRU-specific copies of global parameters in HRUs with local global parameter overrides
+/// \details must be called whenever model-wide global parameters change so that overridden HRUs
+/// see the updated values of all non-overridden parameters. Processes read these through CHydroUnit::GetGlobalParams()
+//
+void CModel::UpdateLocalParamViews()
+{
+  if (_nParamOverrides==0){return;}
+
+  const global_struct *pG=_pGlobalParams->GetParams();
+  global_struct        Gk;
+  for (int k=0;k<_nHydroUnits;k++)
+  {
+    bool overridden=false;
+    for (int i=0;i<_nParamOverrides;i++)
+    {
+      const param_override *pPO=_pParamOverrides[i];
+      if (pPO->aHRUIsOverridden==NULL){return;} //not yet initialized
+      if ((pPO->aHRUIsOverridden[k]) && (pPO->param_name!="PET_BLEND_WTS") && (pPO->param_name!="POTMELT_BLEND_WTS"))
+      {
+        if (!overridden){Gk=*pG; overridden=true;}
+        *((double*)((char*)(&Gk)+pPO->offset))=pPO->aValues[0];
       }
     }
+    if (overridden){_pHydroUnits[k]->SetLocalGlobalParams(Gk);}
   }
 }
 
@@ -2724,15 +2881,56 @@ void CModel::ApplyLocalParamOverrrides(const int k, const bool revert)
 void CModel::RecalculateHRUDerivedParams(const optStruct    &Options,
                                          const time_struct  &tt)
 {
+  //class-based parameters change (at most) daily, or when class parameters are updated
+  int day=tt.year*10000+tt.month*100+tt.day_of_month;
+  if (day!=_derivedParamDay)
+  {
+    _derivedParamDay=day;
+    _derivedParamVersion++;
+    _mClassVegVars.clear();
+  }
+
+  CHydroUnit *pHRU;
   for (int k=0;k<_nHydroUnits;k++)
   {
-    if(_pHydroUnits[k]->IsEnabled())
+    pHRU=_pHydroUnits[k];
+    if(pHRU->IsEnabled())
     {
-      _pHydroUnits[k]->RecalculateDerivedParams(Options,tt);
+      if (pHRU->GetDerivedParamVersion()!=_derivedParamVersion)
+      {
+        pair<const veg_struct *,const surface_struct *> key(pHRU->GetVegetationProps(),pHRU->GetSurfaceProps());
+        map<pair<const veg_struct *,const surface_struct *>,veg_var_struct>::iterator it=_mClassVegVars.find(key);
+        if (it==_mClassVegVars.end())
+        {
+          veg_var_struct VV;
+          CVegetationClass::RecalculateCanopyParams(VV,pHRU,this,tt,Options);
+          it=_mClassVegVars.insert(make_pair(key,VV)).first;
+          _nClassVegCalcs++;
+        }
+        pHRU->SetClassDerivedParams(it->second,_derivedParamVersion,Options,tt);
+        _nHRUVegUpdates++;
+      }
+      pHRU->RecalculateDerivedParams(Options,tt);
     }
   }
 }
 //////////////////////////////////////////////////////////////////
+/// \brief Prepares hydrological processes for the time step
+/// \details called at the start of MassEnergyBalance(), after all parameter updates for the time step, so that
+/// processes can update internal data derived from parameters or time step (see CHydroProcessABC::PrepareTimeStep())
+///
+/// \param &Options [in] Global model options information
+/// \param &tt [in] Current time structure
+//
+void CModel::PrepareProcesses(const optStruct    &Options,
+                              const time_struct  &tt)
+{
+  for (int j=0;j<_nProcesses;j++)
+  {
+    _pProcesses[j]->PrepareTimeStep(_pHydroUnits,_aShouldApplyProcess[j],_nHydroUnits,Options,tt);
+  }
+}
+//////////////////////////////////////////////////////////////////
 /// \brief called at start of time step if needed - generates random values for perturbation of forcings
 /// \param &Options [out] Global model options information
 /// \params tt [in] time structure
@@ -2945,6 +3143,8 @@ bool CModel::ApplyProcess ( const int          j,                    //process i
   int k=pHRU->GetGlobalIndex();
   if (!_aShouldApplyProcess[j][k]){return false;}
 
+  CProfileScope P(NUM_PROFILE_STAGES+j);
+
   for (int q=0;q<nConnections;q++)
   {
     iFrom[q]=pProc->GetFromIndices()[q];
@@ -2985,6 +3185,51 @@ bool CModel::ApplyProcess ( const int          j,                    //process i
 
   return true;
 }
+
+//////////////////////////////////////////////////////////////////
+/// \brief Apply hydrological process to a contiguous block of HRUs at once
+/// \details Equivalent to calling ApplyProcess() for each HRU k0..k0+nBlock-1, but uses the (optional)
+/// batched rate evaluation of the process. Connection indices are the process' own GetFromIndices()/GetToIndices()
+///
+/// \param j        [in] Integer process indentifier
+/// \param k0       [in] global index of first HRU in block
+/// \param nBlock   [in] number of HRUs in block (<=PROCESS_BATCH_SIZE)
+/// \param **state_vars [in] Array of state variables for all HRUs (size: [nHRUs][nStateVars])
+/// \param &Options [in] Global model options information
+/// \param &tt      [in] Time structure
+/// \param *kApplied [out] global indices of HRUs in block to which process applies, in increasing order (size: nBlock)
+/// \param *rates_of_change [out] rates for HRUs in kApplied, connection-major: rates_of_change[q*nApplied+n] (size: nConnections*nBlock)
+/// \return number of HRUs in block to which process applies (nApplied)
+//
+int CModel::ApplyProcessBatch(const int          j,
+                              const int          k0,
+                              const int          nBlock,
+                              const double* const* state_vars,
+                              const optStruct   &Options,
+                              const time_struct &tt,
+                                    int         *kApplied,
+                                    double      *rates_of_change) const
+{
+  const double     *aSV  [PROCESS_BATCH_SIZE];
+  const CHydroUnit *aHRUs[PROCESS_BATCH_SIZE];
+  CHydroProcessABC *pProc=_pProcesses[j];
+  int nApplied=0;
+
+  for (int k=k0;k<k0+nBlock;k++)
+  {
+    if (_aShouldApplyProcess[j][k]){
+      kApplied[nApplied]=k;
+      aSV     [nApplied]=state_vars[k];
+      aHRUs   [nApplied]=_pHydroUnits[k];
+      nApplied++;
+    }
+  }
+  if (nApplied>0){
+    CProfileScope P(NUM_PROFILE_STAGES+j);
+    pProc->GetBatchRatesOfChange(nApplied,aSV,aHRUs,Options,tt,rates_of_change);
+  }
+  return nApplied;
+}
 //////////////////////////////////////////////////////////////////
 /// \brief Apply lateral exchange hydrological process to model
 /// \details Method returns rate of mass/energy transfers rates_of_change [mm/d, mg/m2/d, or MJ/m2/d] from a set
@@ -3041,6 +3286,7 @@ bool CModel::ApplyLateralProcess( const int          j,
     if(!_pHydroUnits[kFrom[q]]->IsEnabled()) { return false; }
     if(!_pHydroUnits[kTo  [q]]->IsEnabled()) { return false; } //ALL participating HRUs must be enabled to apply
   }
+  CProfileScope P(NUM_PROFILE_STAGES+j);
   pLatProc->GetLateralExchange(state_vars,_pHydroUnits,Options,tt,exchange_rates);
 
   return true;
@@ -6,12 +6,14 @@
 #define MODEL_H
 
 #include "RavenInclude.h"
+#include <map>
 #include "ModelABC.h"
 #include "StateVariables.h"
 #include "HydroProcessABC.h"
 #include "LateralExchangeABC.h"
 #include "SubBasin.h"
 #include "HydroUnits.h"
+#include "Radiation.h"
 #include "TimeSeries.h"
 #include "Gauge.h"
 #include "CustomOutput.h"
@@ -104,11 +106,32 @@ private:/*------------------------------------------------------*/
 
   int                 _nTransParams;  ///< number of transient parameters
   CTransientParam   **_pTransParams;  ///< array of pointers to transient parameters with time series
+  param_handle      *_aTransParamHandles; ///< resolved parameter handles for transient parameters [size: _nTransParams] (NULL until first update)
   int                _nClassChanges;  ///< number of HRU Group class changes
   class_change     **_pClassChanges;  ///< array of pointers to class_changes
   int              _nParamOverrides;  ///< number of local parameter overrides
   param_override **_pParamOverrides;  ///< array of pointers to local parameter overrides
 
+  int              _derivedParamDay;  ///< date (yyyymmdd) of last class-based derived parameter update (DOESNT_EXIST forces update)
+  int          _derivedParamVersion;  ///< incremented whenever class-based derived parameters are recalculated
+  map<pair<const veg_struct *,const surface_struct *>,veg_var_struct>
+                     _mClassVegVars;  ///< class-based canopy parameters, by unique vegetation/land use class combination
+  long long        _nClassVegCalcs;   ///< number of class-based canopy parameter calculations (for benchmarking)
+  long long        _nHRUVegUpdates;   ///< number of HRU updates from class-based canopy parameters (for benchmarking)
+
+  double            *_aStateMatrix;   ///< contiguous HRU-major state variable matrix; row k (of size _nStateVars) is referenced by HRU k [size: _nHydroUnits*_nStateVars]
+  double            *_aStateMatrixMem;///< allocated memory for _aStateMatrix (_aStateMatrix is aligned within)
+
+  int                _nTerrainSigs;   ///< number of unique HRU terrain signatures (latitude, slope, aspect)
+  int               *_aTerrainSig;    ///< index of terrain signature of each HRU [size: _nHydroUnits]
+  double            *_aSigLatRad;     ///< latitude of each terrain signature [rad] [size: _nTerrainSigs]
+  double            *_aSigSlope;      ///< slope of each terrain signature [rad] [size: _nTerrainSigs]
+  double            *_aSigAspect;     ///< aspect of each terrain signature [rad] [size: _nTerrainSigs]
+  double            *_aSigDayLength;  ///< day length of each terrain signature, current day [d] [size: _nTerrainSigs]
+  double             _sigDayAngle;    ///< day angle of current day [rad] (RAV_BLANK_DATA until first day is started)
+  clear_sky_terms   *_aClearSkyTerms; ///< clear sky radiation terms of each terrain signature, current time step [size: _nTerrainSigs]
+  double             _clearSkyTime;   ///< model time for which _aClearSkyTerms were calculated (RAV_BLANK_DATA if not valid)
+
   CGroundwaterModel  *_pGWModel;  ///< pointer to corresponding groundwater model
   CTransportModel *_pTransModel;  ///< pointer to corresponding transport model
   CEnsemble         *_pEnsemble;  ///< pointer to model ensemble
@@ -217,8 +240,11 @@ private:/*------------------------------------------------------*/
   void         WriteNetcdfMinorOutput (const optStruct   &Options,
                                        const time_struct &tt);
   void    InitializeParameterOverrides();
+  void    InitializeTerrainSignatures();
+  void    InitializeStateMatrix();
 
   //private routines used during simulation:
+  void               ApplyClassChange(const int j);
   force_struct      GetAverageForcings() const;
   double       GetTotalChannelStorage () const;
   double      GetTotalReservoirStorage() const;
@@ -240,6 +266,7 @@ private:/*------------------------------------------------------*/
                                       force_struct &F,
                                       const double elev,
                                       const double ref_elev_temp,
+                                      const int    k,
                                       const time_struct &tt);
   double                  EstimatePET(const force_struct &F,
                                       const CHydroUnit   *pHRU,
@@ -395,6 +422,10 @@ public:/*-------------------------------------------------------*/
   /*--below are only available to global routines--*/
   //Accessor functions
   int               GetNumHRUs                        () const;
+  void              GetDerivedParamStats              (long long &nClassCalcs, long long &nHRUUpdates) const;
+  int               GetNumTerrainSignatures           () const;
+  const double     *GetStateMatrix                    () const;
+  const clear_sky_terms *GetClearSkyTerms             (const int k, const double &t) const;
   int               GetNumHRUGroups                   () const;
   int               GetNumSubBasins                   () const;
   int               GetNumSubBasinGroups              () const;
@@ -499,6 +530,7 @@ public:/*-------------------------------------------------------*/
   void        Initialize                 (const optStruct &Options);
   void        InitializeBasins           (const optStruct &Options,const bool re_init);
   void        InitializePostRVM          (const optStruct &Options);
+  double      ReadCheckpoint             (const string filename, const optStruct &Options);
   void        WriteOutputFileHeaders     (const optStruct &Options);
   void        GenerateGriddedPrecipVars  (const optStruct &Options);
   void        GenerateGriddedTempVars    (const optStruct &Options);
@@ -509,8 +541,12 @@ public:/*-------------------------------------------------------*/
                                           const string      pname,
                                           const string      cname,
                                           const double      &value);
-  void        ApplyLocalParamOverrrides  (const int         k,
-                                          const bool        revert);
+  param_handle GetParameterHandle        (const class_type  &ctype,
+                                          const string      pname,
+                                          const string      cname);
+  void        UpdateParameter            (const param_handle &handle,
+                                          const double      &value);
+  void        UpdateLocalParamViews      ();
 
   //called during simulation:
   //critical simulation routines (called once during each timestep):
@@ -522,6 +558,8 @@ public:/*-------------------------------------------------------*/
                                           const time_struct &tt);
   void        RecalculateHRUDerivedParams(const optStruct   &Options,
                                           const time_struct &tt);
+  void        PrepareProcesses           (const optStruct   &Options,
+                                          const time_struct &tt);
   bool        ApplyProcess               (const int          j,
                                           const double      *state_var,
                                           const CHydroUnit  *pHRU,
@@ -531,6 +569,14 @@ public:/*-------------------------------------------------------*/
                                                 int         *iTo,
                                                 int         &nConnections,
                                                 double      *rates_of_change) const;
+  int         ApplyProcessBatch          (const int          j,
+                                          const int          k0,
+                                          const int          nBlock,
+                                          const double* const* state_vars,
+                                          const optStruct   &Options,
+                                          const time_struct &tt,
+                                                int         *kApplied,
+                                                double      *rates_of_change) const;
   bool        ApplyLateralProcess        (const int          j,
                                           const double* const* state_vars,
                                           const optStruct   &Options,
@@ -562,6 +608,7 @@ public:/*-------------------------------------------------------*/
   void        WriteSimpleOutput       (const optStruct &Options, const time_struct &tt);
   void        WriteMajorOutput        (const time_struct &tt,string solfile,bool final) const;
   void        WriteMajorOutput        (const optStruct &Options, const time_struct &tt,string solfile,bool final) const;
+  void        WriteCheckpoint         (const time_struct &tt,const string filename) const;
   void        WriteProgressOutput     (const optStruct &Options, clock_t elapsed_time, int elapsed_steps, int total_steps);
   void        CloseOutputStreams      ();
   void        SummarizeToScreen       (const optStruct &Options) const;
@@ -8,13 +8,47 @@ Copyright (c) 2008-2023 the Raven Development Team
 
 bool ParseInitialConditions(CModel *&pModel,const optStruct &Options);
 
+static unsigned int g_random_seed =1; ///< seed of random number sequence (1 is C library default)
+static long long    g_random_draws=0; ///< number of random numbers drawn from sequence since seeding
+
+//////////////////////////////////////////////////////////////////
+/// \brief returns next number of random number sequence, tracking sequence position (so that it can be checkpointed)
+/// \return random integer between 0 and RAND_MAX
+//
+static int RandomDraw()
+{
+  g_random_draws++;
+  return rand();
+}
+//////////////////////////////////////////////////////////////////
+/// \brief returns state of random number sequence
+/// \param &seed [out] random seed
+/// \param &nDraws [out] number of random numbers drawn since seeding
+//
+void GetRandomState(unsigned int &seed, long long &nDraws)
+{
+  seed  =g_random_seed;
+  nDraws=g_random_draws;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief restores state of random number sequence by reseeding and replaying draws
+/// \param seed [in] random seed
+/// \param nDraws [in] number of random numbers drawn since seeding
+//
+void SetRandomState(const unsigned int seed, const long long nDraws)
+{
+  srand(seed);
+  for (long long n=0;n<nDraws;n++){rand();}
+  g_random_seed =seed;
+  g_random_draws=nDraws;
+}
 //////////////////////////////////////////////////////////////////
 /// \brief returns uniformly distributed random variable between 0 and 1
 /// \return uniformly distributed random variable between 0 and 1
 //
 double UniformRandom()
 {
-  return (double)(rand())/RAND_MAX;
+  return (double)(RandomDraw())/RAND_MAX;
 }
 //////////////////////////////////////////////////////////////////
 /// \brief returns normally distributed random variable with mean of 0, variance=1
@@ -23,8 +57,8 @@ double UniformRandom()
 //
 double GaussRandom()
 {
-  double u1=(double)(rand())/RAND_MAX;
-  double u2=(double)(rand())/RAND_MAX;
+  double u1=(double)(RandomDraw())/RAND_MAX;
+  double u2=(double)(RandomDraw())/RAND_MAX;
   return sqrt(-2.0*log(u1))*cos(2.0*PI*u2);
 }
 
@@ -106,7 +140,7 @@ bool   CEnsemble::DontWriteOutput() const {
 //
 void CEnsemble::SetRandomSeed(const unsigned int seed)
 {
-  srand(seed);
+  SetRandomState(seed,0);
 }
 //////////////////////////////////////////////////////////////////
 /// \brief sets output directory for ensemble member output
@@ -182,6 +216,7 @@ CMonteCarloEnsemble::CMonteCarloEnsemble(const int num_members,const optStruct &
   _type=ENSEMBLE_MONTECARLO;
   _nParamDists=0;
   _pParamDists=NULL;
+  _aParamHandles=NULL;
 }
 //////////////////////////////////////////////////////////////////
 /// \brief Monte Carlo Ensemble Destrucutor
@@ -192,6 +227,7 @@ CMonteCarloEnsemble::~CMonteCarloEnsemble()
     delete _pParamDists[i];
   }
   delete [] _pParamDists; _nParamDists=0;
+  delete [] _aParamHandles;
 }
 //////////////////////////////////////////////////////////////////
 /// \brief Adds parameter distribution to MC setup
@@ -242,14 +278,19 @@ void CMonteCarloEnsemble::UpdateModel(CModel *pModel,optStruct &Options, const i
   MCOUT.open(filename.c_str(),ios::app);
   MCOUT<<e+1<<", ";
 
+  if (_aParamHandles==NULL) {
+    _aParamHandles=new param_handle [_nParamDists];
+    for(int i=0;i<_nParamDists;i++) {
+      _aParamHandles[i]=pModel->GetParameterHandle(_pParamDists[i]->param_class,
+                                                   _pParamDists[i]->param_name,
+                                                   _pParamDists[i]->class_group);
+    }
+  }
   double val;
   for(int i=0;i<_nParamDists;i++)
   {
     val=SampleFromDistribution(_pParamDists[i]->distribution,_pParamDists[i]->distpar);
-    pModel->UpdateParameter(_pParamDists[i]->param_class,
-                            _pParamDists[i]->param_name,
-                            _pParamDists[i]->class_group,
-                            val);
+    pModel->UpdateParameter(_aParamHandles[i],val);
     MCOUT<<to_string(val)<<", ";
   //  cout<<"RAND PARAM: "<<val<<" between "<<_pParamDists[i]->distpar[0]<<" and "<< _pParamDists[i]->distpar[1]<<endl;
   }
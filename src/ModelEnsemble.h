@@ -81,6 +81,7 @@ private:
 
   int          _nParamDists; ///< number of parameter distributions for sampling
   param_dist **_pParamDists; ///< array of pointers to parameter distributions
+  param_handle *_aParamHandles; ///< resolved handles of sampled parameters [size: _nParamDists] (NULL until first update)
 
 
 public:
@@ -106,6 +107,7 @@ private:
 
   int          _nParamDists; ///< number of parameter distributions for sampling
   param_dist **_pParamDists; ///< array of pointers to parameter distributions
+  param_handle *_aParamHandles; ///< resolved handles of calibrated parameters [size: _nParamDists] (NULL until first update)
 
   long long    _calib_SBID;  ///< observation hydrograph subbasin ID
   diag_type    _calib_Obj;   ///< diagnostic used as objective function (e.g., DIAG_NASH_SUTCLIFFE)
@@ -5,6 +5,7 @@
 #include "Model.h"
 #include "IrregularTimeSeries.h"
 #include "HeatConduction.h"
+#include "SpatialIndex.h"
 
 /*****************************************************************
    Model Initialization Routines
@@ -119,7 +120,9 @@ void CModel::Initialize(const optStruct &Options)
 
   // Initialize HRUs, gauges and transient parameters
   //--------------------------------------------------------------
+  CTimeSeries::SetResampleOnDemand(Options.resample_on_demand);
   for (k=0;k<_nHydroUnits; k++ ){_pHydroUnits [k ]->Initialize(_UTM_zone);}
+  InitializeStateMatrix();
   for (g=0;g<_nGauges;     g++ ){_pGauges     [g ]->Initialize(Options,_UTM_zone);}
   for (j=0;j<_nTransParams;j++ ){_pTransParams[j ]->Initialize(this,Options);}
   for (kk=0;kk<_nHRUGroups;kk++){_pHRUGroups  [kk]->Initialize(); } //disables HRUs
@@ -127,6 +130,8 @@ void CModel::Initialize(const optStruct &Options)
 
   InitializeParameterOverrides();
 
+  InitializeTerrainSignatures();
+
   // Forcing grids are not "Initialized" here because the derived data have to be populated everytime a new chunk is read
 
   // QA/QC Check for partial or full disabling of basin HRUs (after HRU group initialize, must be before area calculation)
@@ -198,9 +203,11 @@ void CModel::Initialize(const optStruct &Options)
       WTS.close();
     }
 
+    clock_t t_wts=clock();
     GenerateGaugeWeights(_aGaugeWeights ,f_gauge   ,Options);//'other' forcings
     GenerateGaugeWeights(_aGaugeWtPrecip,F_PRECIP  ,Options);
     GenerateGaugeWeights(_aGaugeWtTemp  ,F_TEMP_AVE,Options);
+    if (!Options.silent){cout <<"    ...gauge weights generated in "<<float(clock()-t_wts)/CLOCKS_PER_SEC<<" seconds"<<endl;}
 
   }
 
@@ -278,6 +285,10 @@ void CModel::Initialize(const optStruct &Options)
   //--------------------------------------------------------------
   InitializeObservations(Options);
 
+  if (!Options.silent){
+    cout<<"  Time series memory usage: "<<(double)(CTimeSeries::GetTotalMemoryUsage())/1024.0/1024.0<<" MB"<<endl;
+  }
+
   // Generate default diagnostic period - entire simulation
   //--------------------------------------------------------------
   CDiagPeriod *pDP=new CDiagPeriod("ALL","0001-01-01","9999-12-31",COMPARE_GREATERTHAN,-ALMOST_INF,Options);
@@ -745,6 +756,66 @@ void CModel::ClearTimeSeriesData(const optStruct& Options)
   }
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief moves all HRU state variables into a single contiguous, HRU-major state matrix owned by the model
+/// \details HRU k thereafter references row k of the matrix; matrix is aligned to a cache line
+//
+void CModel::InitializeStateMatrix()
+{
+  const int ALIGN_DOUBLES=8; //64 bytes
+  long long N=(long long)(_nHydroUnits)*_nStateVars;
+
+  _aStateMatrixMem=new double [N+ALIGN_DOUBLES];
+  ExitGracefullyIf(_aStateMatrixMem==NULL,"CModel::InitializeStateMatrix",OUT_OF_MEMORY);
+  size_t misalign=((size_t)(_aStateMatrixMem)/sizeof(double))%ALIGN_DOUBLES;
+  _aStateMatrix=_aStateMatrixMem+((ALIGN_DOUBLES-misalign)%ALIGN_DOUBLES);
+
+  for (int k=0;k<_nHydroUnits;k++){
+    _pHydroUnits[k]->SetStateVarStorage(_aStateMatrix+(long long)(k)*_nStateVars);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief groups HRUs by unique terrain signature (latitude, slope, aspect)
+/// \details radiation terms which depend only upon this signature and time are calculated once per signature rather than once per HRU.
+/// Signatures are exact matches and are ordered by latitude, so that signatures with the same latitude are adjacent
+//
+void CModel::InitializeTerrainSignatures()
+{
+  typedef pair<double,pair<double,double> > terrain_key;
+  map<terrain_key,int> sigs;
+  int k,s;
+
+  for (k=0;k<_nHydroUnits;k++){
+    terrain_key key=make_pair(_pHydroUnits[k]->GetLatRad(),make_pair(_pHydroUnits[k]->GetSlope(),_pHydroUnits[k]->GetAspect()));
+    sigs.insert(make_pair(key,0));
+  }
+  _nTerrainSigs=(int)(sigs.size());
+
+  _aTerrainSig   =new int             [_nHydroUnits];
+  _aSigLatRad    =new double          [_nTerrainSigs];
+  _aSigSlope     =new double          [_nTerrainSigs];
+  _aSigAspect    =new double          [_nTerrainSigs];
+  _aSigDayLength =new double          [_nTerrainSigs];
+  _aClearSkyTerms=new clear_sky_terms [_nTerrainSigs];
+  ExitGracefullyIf(_aClearSkyTerms==NULL,"CModel::InitializeTerrainSignatures",OUT_OF_MEMORY);
+
+  s=0;
+  for (map<terrain_key,int>::iterator it=sigs.begin();it!=sigs.end();it++,s++){
+    it->second    =s;
+    _aSigLatRad[s]=it->first.first;
+    _aSigSlope [s]=it->first.second.first;
+    _aSigAspect[s]=it->first.second.second;
+    _aSigDayLength[s]=0.0;
+  }
+  for (k=0;k<_nHydroUnits;k++){
+    terrain_key key=make_pair(_pHydroUnits[k]->GetLatRad(),make_pair(_pHydroUnits[k]->GetSlope(),_pHydroUnits[k]->GetAspect()));
+    _aTerrainSig[k]=sigs[key];
+  }
+  _sigDayAngle =RAV_BLANK_DATA;
+  _clearSkyTime=RAV_BLANK_DATA;
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief initializes all paramter override structures
 ///
@@ -753,30 +824,16 @@ void CModel::InitializeParameterOverrides()
 {
   for (int i=0;i<_nParamOverrides;i++)
   {
-    //determines memory address location of the appropriate global variable
+    //determines location of the appropriate global variable within global parameter structure
     // this is the only time we mess with addresses like this in the code - merely for speed
     string name=_pParamOverrides[i]->param_name;
-    if      (name == "PET_BLEND_WTS") { //special case
-      _pParamOverrides[i]->pxAddress=_PETBlends_wts;
-      for (int j=0;j<_PETBlends_N;j++){
-        _pParamOverrides[i]->aRevertValues[j] =_PETBlends_wts[j];
-      }
-    }
-    else if (name == "POTMELT_BLEND_WTS") {
-      _pParamOverrides[i]->pxAddress=_PotMeltBlends_wts;
-      for (int j=0;j<_PotMeltBlends_N;j++){
-        _pParamOverrides[i]->aRevertValues[j] =_PotMeltBlends_wts[j];
-      }
-    }
-    else
+    if ((name != "PET_BLEND_WTS") && (name != "POTMELT_BLEND_WTS"))
     {
       double *address = this->_pGlobalParams->GetAddress(name);
       if (address==NULL){
         ExitGracefully("CModel::InitializeParameterOverrides() : Invalid or unsupported global parameter name in :LocalParameterOverride command",BAD_DATA);
       }
-      _pParamOverrides[i]->pxAddress=address;
-
-      _pParamOverrides[i]->aRevertValues[0] = this->_pGlobalParams->GetParameter(name);
+      _pParamOverrides[i]->offset=(long)((char*)(address)-(char*)(this->_pGlobalParams->GetParams()));
     }
 
     _pParamOverrides[i]->aHRUIsOverridden=new bool [_nHydroUnits];
@@ -797,17 +854,64 @@ void CModel::InitializeParameterOverrides()
       long long SBID=_pSubBasins[_pHydroUnits[k]->GetSubBasinIndex()]->GetID();
        _pParamOverrides[i]->aHRUIsOverridden[k]=(_pSBGroups[pp]->IsInGroup(SBID));
     }
+
+    // blend weights are not subject to change during simulation - set HRU-specific weights once
+    if ((name == "PET_BLEND_WTS") || (name == "POTMELT_BLEND_WTS"))
+    {
+      for (int k=0;k<_nHydroUnits;k++){
+        if (_pParamOverrides[i]->aHRUIsOverridden[k]){
+          _pHydroUnits[k]->SetLocalBlendWeights(name,_pParamOverrides[i]->aValues,_pParamOverrides[i]->nVals);
+        }
+      }
+    }
   }
-  if (_nParamOverrides > 0) {
-    string warn="One or more global parameter overrides are used in this model. These can have high computational overhead and should be used sparingly";
-    WriteWarning(warn.c_str(),true);
-  }
+  UpdateLocalParamViews();
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief builds k-d tree search index over UTM locations of gauges with data
+/// \note caller is responsible for deleting returned tree
+//
+CKDTree2D *BuildGaugeSearchTree(CGauge **pGauges, const int nGauges, const bool *has_data)
+{
+  location xyg;
+  double *x  =new double [nGauges];
+  double *y  =new double [nGauges];
+  int    *ind=new int    [nGauges];
+  int     N=0;
+  for (int g=0;g<nGauges;g++){
+    if (has_data[g]){
+      xyg=pGauges[g]->GetLocation();
+      x[N]=xyg.UTM_x; y[N]=xyg.UTM_y; ind[N]=g; N++;
+    }
+  }
+  CKDTree2D *pTree=new CKDTree2D(x,y,ind,N);
+  delete [] x;
+  delete [] y;
+  delete [] ind;
+  return pTree;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief sorts neighbour list (gauge indices and distances) by increasing gauge index
+//
+void SortGaugeNeighbours(int *nbrs, double *dist, const int N)
+{
+  int    itmp;
+  double dtmp;
+  for (int i=1;i<N;i++){ //insertion sort; lists are short
+    itmp=nbrs[i]; dtmp=dist[i];
+    int j=i-1;
+    while ((j>=0) && (nbrs[j]>itmp)){nbrs[j+1]=nbrs[j]; dist[j+1]=dist[j]; j--;}
+    nbrs[j+1]=itmp; dist[j+1]=dtmp;
+  }
+}
 //////////////////////////////////////////////////////////////////
 /// \brief Generates gauge weights
 /// \details Populates an array aWts with interpolation weightings for distribution of gauge station data to HRUs
 /// \remark Called after initialize routing orders
+/// \remark Nearest neighbour and inverse distance searches use a k-d tree over gauge UTM coordinates;
+/// inverse distance may be limited to the Options.interp_max_gauges nearest gauges within Options.interp_search_radius,
+/// producing sparse weights
 ///
 /// \param aWts [out] weights matrix [nHRUs][nGauges]
 /// \param forcing [int] forcing type (F_PRECIP or F_TEMP)
@@ -817,7 +921,7 @@ void CModel::GenerateGaugeWeights(double **&aWts, const forcing_type forcing, co
 {
   int k,g;
   bool *has_data=NULL;
-  location xyh,xyg;
+  location xyh;
 
   //allocate memory
   aWts=NULL;
@@ -856,25 +960,16 @@ void CModel::GenerateGaugeWeights(double **&aWts, const forcing_type forcing, co
   case(INTERP_NEAREST_NEIGHBOR)://---------------------------------------------
   {
     //w=1.0 for nearest gauge, 0.0 for all others
-    double distmin,dist;
+    CKDTree2D *pTree=BuildGaugeSearchTree(_pGauges,_nGauges,has_data);
     int    g_min=0;
     for (k=0;k<_nHydroUnits;k++)
     {
       xyh=_pHydroUnits[k]->GetCentroid();
-      g_min=0;
-      distmin=ALMOST_INF;
-      for (g=0;g<_nGauges;g++)
-      {
-        if(has_data[g]){
-          xyg=_pGauges[g]->GetLocation();
-          dist=pow(xyh.UTM_x-xyg.UTM_x,2)+pow(xyh.UTM_y-xyg.UTM_y,2);
-          if(dist<distmin){ distmin=dist;g_min=g; }
-        }
-        aWts[k][g]=0.0;
-      }
+      g_min=pTree->GetNearest(xyh.UTM_x,xyh.UTM_y);
+      if (g_min==DOESNT_EXIST){g_min=0;} //no gauges with data (tree is empty) - first gauge, as in brute-force search
       aWts[k][g_min]=1.0;
-
     }
+    delete pTree;
     break;
   }
   case(INTERP_AVERAGE_ALL):                   //---------------------------------------------
@@ -889,39 +984,43 @@ void CModel::GenerateGaugeWeights(double **&aWts, const forcing_type forcing, co
   }
   case(INTERP_INVERSE_DISTANCE):                      //---------------------------------------------
   {
-    //wt_i = (1/r_i^2) / (sum{1/r_j^2})
-    double dist;
+    //wt_i = (1/r_i^2) / (sum{1/r_j^2}), summed over (optionally) the nearest N gauges within search radius
     double denomsum;
     const double IDW_POWER=2.0;
     int atop_gauge(DOESNT_EXIST);
+    int nNear;
+    int kmax=nGaugesWithData;
+    if ((Options.interp_max_gauges!=DOESNT_EXIST) && (Options.interp_max_gauges<nGaugesWithData)){kmax=Options.interp_max_gauges;}
+
+    CKDTree2D *pTree=BuildGaugeSearchTree(_pGauges,_nGauges,has_data);
+    int    *nbrs=new int   [kmax];
+    double *dist=new double[kmax];
+    ExitGracefullyIf(dist==NULL,"GenerateGaugeWeights(4)",OUT_OF_MEMORY);
     for (k=0;k<_nHydroUnits;k++)
     {
       xyh=_pHydroUnits[k]->GetCentroid();
+      nNear=pTree->GetKNearest(xyh.UTM_x,xyh.UTM_y,kmax,Options.interp_search_radius,nbrs,dist);
+      if (nNear==0){ //no gauges within search radius - revert to nearest gauge
+        nNear=pTree->GetKNearest(xyh.UTM_x,xyh.UTM_y,1,ALMOST_INF,nbrs,dist);
+      }
+      SortGaugeNeighbours(nbrs,dist,nNear); //sum in gauge order, as if all gauges were visited
+
       atop_gauge=DOESNT_EXIST;
       denomsum=0;
-      for (g=0;g<_nGauges;g++)
+      for (int i=0;i<nNear;i++)
       {
-        if(has_data[g]){
-          xyg=_pGauges[g]->GetLocation();
-          dist=sqrt(pow(xyh.UTM_x-xyg.UTM_x,2)+pow(xyh.UTM_y-xyg.UTM_y,2));
-          denomsum+=pow(dist,-IDW_POWER);
-          if(dist<REAL_SMALL){ atop_gauge=g; }//handles limiting case where weight= large number/large number
-        }
+        denomsum+=pow(dist[i],-IDW_POWER);
+        if(dist[i]<REAL_SMALL){ atop_gauge=nbrs[i]; }//handles limiting case where weight= large number/large number
       }
-
-      for (g=0;g<_nGauges;g++)
+      for (int i=0;i<nNear;i++)
       {
-        aWts[k][g]=0.0;
-        if(has_data[g]){
-          xyg=_pGauges[g]->GetLocation();
-          dist=sqrt(pow(xyh.UTM_x-xyg.UTM_x,2)+pow(xyh.UTM_y-xyg.UTM_y,2));
-
-          if(atop_gauge!=DOESNT_EXIST){ aWts[k][g]=0.0;aWts[k][atop_gauge]=1.0; }
-          else                        { aWts[k][g]=pow(dist,-IDW_POWER)/denomsum;         }
-        }
+        if(atop_gauge!=DOESNT_EXIST){ aWts[k][atop_gauge]=1.0; }
+        else                        { aWts[k][nbrs[i]]=pow(dist[i],-IDW_POWER)/denomsum; }
       }
     }
-
+    delete [] nbrs;
+    delete [] dist;
+    delete pTree;
     break;
   }
   case(INTERP_INVERSE_DISTANCE_ELEVATION):                    //---------------------------------------------
@@ -19,12 +19,14 @@ double UBCPreciptiationByElev(const double temp,
 /// \param &F [out] Forcing functions for HRU
 /// \param elev [in] elevation of this HRU
 /// \param ref_elev [in] Reference temperature elevation (usually met station elevation)
+/// \param k [in] global HRU index
 /// \param &tt [in] current time strucure
 //
 void   CModel::CorrectTemp(const optStruct   &Options,
                            force_struct      &F,
                            const double       elev,
                            const double       ref_elev,
+                           const int          k,
                            const time_struct &tt)
 {
 
@@ -32,7 +34,7 @@ void   CModel::CorrectTemp(const optStruct   &Options,
   if ((Options.orocorr_temp==OROCORR_SIMPLELAPSE) ||
       (Options.orocorr_temp==OROCORR_HBV        ))
   {
-    double lapse=this->_pGlobalParams->GetParams()->adiabatic_lapse;//[C/km]
+    double lapse=_pHydroUnits[k]->GetGlobalParams()->adiabatic_lapse;//[C/km]
     lapse/=1000.0;//convert to C/m
     F.temp_ave-=lapse*(elev-ref_elev);
 
@@ -58,7 +60,7 @@ void   CModel::CorrectTemp(const optStruct   &Options,
 
     //calculate temperature lapse rates
     //--------------------------------------------------------------------
-    const global_struct *globals= this->_pGlobalParams->GetParams();
+    const global_struct *globals= _pHydroUnits[k]->GetGlobalParams();
     UBC_lapse lapse_params=globals->UBC_lapse_params;
 
     if (lapse_params.A0PPTP > 0){
@@ -201,7 +203,7 @@ void CModel::CorrectPrecip(const optStruct     &Options,
   //---------------------------------------------------------------------------
   if (Options.orocorr_precip==OROCORR_SIMPLELAPSE)
   {
-    double lapse = this->_pGlobalParams->GetParams()->precip_lapse;
+    double lapse = _pHydroUnits[k]->GetGlobalParams()->precip_lapse;
     lapse/=1000; //[mm/d/km]->[mm/d/m]
     if (F.precip > REAL_SMALL){
       F.precip           = max(F.precip           + lapse*(elev - ref_elev), 0.0);
@@ -212,9 +214,9 @@ void CModel::CorrectPrecip(const optStruct     &Options,
   //---------------------------------------------------------------------------
   else if (Options.orocorr_precip==OROCORR_HBV)
   {
-    double corr_upper = this->_pGlobalParams->GetParams()->HBVEC_lapse_upper/M_PER_KM;
-    double corr       = this->_pGlobalParams->GetParams()->HBVEC_lapse_rate/M_PER_KM;
-    double lapse_elev = this->_pGlobalParams->GetParams()->HBVEC_lapse_elev;
+    double corr_upper = _pHydroUnits[k]->GetGlobalParams()->HBVEC_lapse_upper/M_PER_KM;
+    double corr       = _pHydroUnits[k]->GetGlobalParams()->HBVEC_lapse_rate/M_PER_KM;
+    double lapse_elev = _pHydroUnits[k]->GetGlobalParams()->HBVEC_lapse_elev;
     double add=0.0;
     if (elev>lapse_elev){
       add=(corr_upper-corr)*(elev-lapse_elev);
@@ -236,7 +238,7 @@ void CModel::CorrectPrecip(const optStruct     &Options,
       /// \todo [bug] temp should not be the temp at band 1!! (this is really unacceptable, but part of UBCWM)
 
       //orographic corrections
-      _pHydroUnits[k]->SetPrecipMultiplier(UBCPreciptiationByElev(band1_temp,ref_elev,elev,this->_pGlobalParams->GetParams()->UBC_lapse_params));
+      _pHydroUnits[k]->SetPrecipMultiplier(UBCPreciptiationByElev(band1_temp,ref_elev,elev,_pHydroUnits[k]->GetGlobalParams()->UBC_lapse_params));
     }
     F.precip           *= _pHydroUnits[k]->GetPrecipMultiplier();
     F.precip_daily_ave *= _pHydroUnits[k]->GetPrecipMultiplier();
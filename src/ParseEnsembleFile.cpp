@@ -82,6 +82,7 @@ bool ParseEnsembleFile(CModel *&pModel,const optStruct &Options)
     else if(!strcmp(s[0],":ObservationErrorModel"))       { code=16; }
     else if(!strcmp(s[0],":EnKFMode"))                    { code=18; }
     else if(!strcmp(s[0],":ExtraRVTFilename"))            { code=19; }
+    else if(!strcmp(s[0],":EnKFLocalization"))            { code=20; }
     else if(!strcmp(s[0],":AssimilateStreamflow"))        { code=101;}
 
     switch(code)
@@ -466,6 +467,30 @@ bool ParseEnsembleFile(CModel *&pModel,const optStruct &Options)
       }
       break;
     }
+    case(20):  //----------------------------------------------
+    {/*:EnKFLocalization [NONE|UPSTREAM|DISTANCE] {radius [km]}*/
+      if(Options.noisy) { cout <<":EnKFLocalization"<<endl; }
+      if(pEnsemble->GetType()==ENSEMBLE_ENKF) {
+        CEnKFEnsemble* pEnKF=((CEnKFEnsemble*)(pEnsemble));
+        EnKF_localization loc=ENKF_LOC_NONE;
+        double radius=0.0;
+        if      (!strcmp(s[1],"NONE"    )){loc=ENKF_LOC_NONE;}
+        else if (!strcmp(s[1],"UPSTREAM")){loc=ENKF_LOC_UPSTREAM;}
+        else if (!strcmp(s[1],"DISTANCE")){loc=ENKF_LOC_DISTANCE;}
+        else {
+          ExitGracefully("ParseEnsembleFile: :EnKFLocalization - invalid localization method specified",BAD_DATA_WARN);
+        }
+        if (Len>=3){radius=s_to_d(s[2]);}
+        if ((loc==ENKF_LOC_DISTANCE) && (radius<=0.0)){
+          ExitGracefully("ParseEnsembleFile: :EnKFLocalization DISTANCE requires a positive localization radius [km]",BAD_DATA);
+        }
+        pEnKF->SetLocalization(loc,radius);
+      }
+      else {
+        WriteWarning(":EnKFLocalization command will be ignored; only valid for EnKF ensemble simulation.",Options.noisy);
+      }
+      break;
+    }
     case(101)://----------------------------------------------
     {/*:AssimilateStreamflow  [SBID]*/
       if(Options.noisy) { cout <<"Assimilate streamflow"<<endl; }
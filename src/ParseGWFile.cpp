@@ -571,6 +571,9 @@ bool ParseGWFile(CModel*& pModel, const optStruct& Options)
 
   delete p; p = NULL;
 
+  //-- Compress HRU-node overlap weights into sparse matrices
+  pGWModel->BuildOverlapMatrices();
+
   return true;
 
 }
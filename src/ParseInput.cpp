@@ -237,8 +237,14 @@ bool ParseMainInputFile (CModel     *&pModel,
   Options.sol_method              =ORDERED_SERIES;
   Options.convergence_crit        =0.01;
   Options.max_iterations          =30;
+  Options.substep_tolerance       =0.0;
+  Options.max_substeps            =64;
   Options.ensemble                =ENSEMBLE_NONE;
   Options.external_script         ="";
+  Options.plugin_filename         ="";
+  Options.plugin_args             ="";
+  Options.control_channel         ="";
+  Options.control_status_interval =0.0;
 
   Options.routing                 =ROUTE_STORAGECOEFF;
   Options.catchment_routing       =ROUTE_DUMP;
@@ -246,6 +252,8 @@ bool ParseMainInputFile (CModel     *&pModel,
 
   Options.interpolation           =INTERP_NEAREST_NEIGHBOR;
   Options.interp_file             ="";
+  Options.interp_max_gauges       =DOESNT_EXIST;
+  Options.interp_search_radius    =ALMOST_INF;
 
   Options.num_soillayers          =-1;//used to check if SoilModel command is used
   Options.soil_representation     =BROOKS_COREY;
@@ -300,6 +308,13 @@ bool ParseMainInputFile (CModel     *&pModel,
   Options.write_channels          =false;
   Options.write_watershed_storage =true;
   Options.benchmarking            =false;
+  Options.use_input_cache         =false;
+  Options.resample_on_demand      =false;
+  Options.profiling               =false;
+  Options.state_file_format       =STATE_RVC;
+  Options.checkpoint_interval     =0.0;
+  Options.compress_checkpoints    =false;
+  Options.resume_filename         ="";
   Options.pause                   =false;
   Options.debug_mode              =false;
   Options.ave_hydrograph          =true;
@@ -394,6 +409,7 @@ bool ParseMainInputFile (CModel     *&pModel,
     else if  (!strcmp(s[0],":Calendar"                  )){code=12; }
     else if  (!strcmp(s[0],":Evaporation"               )){code=13; }
     else if  (!strcmp(s[0],":OW_Evaporation"            )){code=14; }
+    else if  (!strcmp(s[0],":AdaptiveSubstepping"       )){code=15; }
     else if  (!strcmp(s[0],":CatchmentRouting"          )){code=16; }
     else if  (!strcmp(s[0],":CatchmentRoute"            )){code=16; }
     else if  (!strcmp(s[0],":OroPETCorrect"             )){code=18; }
@@ -516,8 +532,17 @@ bool ParseMainInputFile (CModel     *&pModel,
     else if  (!strcmp(s[0],":WriteMassLoadings"         )){code=183;}
     else if  (!strcmp(s[0],":WriteLocalFlows"           )){code=184;}
     else if  (!strcmp(s[0],":WriteNetReservoirInflows"  )){code=185;}
+    else if  (!strcmp(s[0],":StateFileFormat"           )){code=186;}
+    else if  (!strcmp(s[0],":CheckpointInterval"        )){code=187;}
+    else if  (!strcmp(s[0],":CompressCheckpoints"       )){code=188;}
+    else if  (!strcmp(s[0],":ResumeFromCheckpoint"      )){code=189;}
+    else if  (!strcmp(s[0],":PluginLibrary"             )){code=190;}
+    else if  (!strcmp(s[0],":ControlChannel"            )){code=191;}
     //...
     //--------------------SYSTEM OPTIONS -----------------------
+    else if  (!strcmp(s[0],":Profiling"                 )){code=195;}
+    else if  (!strcmp(s[0],":ResampleOnDemand"          )){code=196;}
+    else if  (!strcmp(s[0],":UseInputCache"             )){code=197;}
     else if  (!strcmp(s[0],":HyporheicLayer"            )){code=198;}
     else if  (!strcmp(s[0],":AggregatedVariable"        )){code=199;}//After corresponding DefineHRUGroup(s) command
 
@@ -716,6 +741,11 @@ bool ParseMainInputFile (CModel     *&pModel,
         Options.convergence_crit = s_to_d(s[2]);  // take in convergence criteria
         Options.max_iterations   = s_to_d(s[3]);  // maximum number of iterations allowed
       }
+      else if  ((!strcmp(s[1],"IMPLICIT_EULER")) || (!strcmp(s[1],"BACKWARD_EULER"))){
+        Options.sol_method =IMPLICIT_EULER;
+        if (Len>=3){Options.convergence_crit = s_to_d(s[2]);} // Newton convergence criteria [mm or MJ/m2]
+        if (Len>=4){Options.max_iterations   = s_to_d(s[3]);} // maximum number of Newton iterations
+      }
       //else if  (!strcmp(s[1],"RUNGE_KUTTA"      )){Options.sol_method =RUNGE_KUTTA_4;}
 
       //...
@@ -874,6 +904,17 @@ bool ParseMainInputFile (CModel     *&pModel,
       }
       break;
     }
+    case(15): //----------------------------------------------
+    {/*:AdaptiveSubstepping [tolerance, mm] {max substeps per time step}
+       error-controlled sub-stepping of HRU processes (ordered series method only) */
+      if (Options.noisy) {cout <<"Adaptive HRU sub-stepping"<<endl;}
+      if (Len<2){ImproperFormatWarning(":AdaptiveSubstepping",p,Options.noisy); break;}
+      Options.substep_tolerance=s_to_d(s[1]);
+      if (Len>=3){Options.max_substeps=s_to_i(s[2]);}
+      ExitGracefullyIf(Options.substep_tolerance<=0.0,"ParseMainInputFile: :AdaptiveSubstepping tolerance must be positive",BAD_DATA_WARN);
+      ExitGracefullyIf(Options.max_substeps<1,"ParseMainInputFile: :AdaptiveSubstepping maximum number of substeps must be at least 1",BAD_DATA_WARN);
+      break;
+    }
     case(16): //----------------------------------------------
     {/*Catchment Routing Method
        string ":CatchmentRoute" string method */
@@ -1010,7 +1051,9 @@ bool ParseMainInputFile (CModel     *&pModel,
     }
     case(27):  //----------------------------------------------
     {/*Interpolation Method
-     string ":Interpolation" string method */
+     string ":Interpolation" string method
+     or
+     string ":Interpolation" INTERP_INVERSE_DISTANCE [int max_gauges] {double search_radius [km]} */
       if(Options.noisy) { cout <<"Interpolation Method"<<endl; }
       if(Len<2) { ImproperFormatWarning(":Interpolation",p,Options.noisy); break; }
       if(!strcmp(s[1],"NEAREST_NEIGHBOR")) { Options.interpolation=INTERP_NEAREST_NEIGHBOR; }
@@ -1036,6 +1079,15 @@ bool ParseMainInputFile (CModel     *&pModel,
 
         Options.interp_file =CorrectForRelativePath(Options.interp_file,Options.rvi_filename);
       }
+      if((Options.interpolation==INTERP_INVERSE_DISTANCE) && (Len>2))
+      {
+        Options.interp_max_gauges=s_to_i(s[2]);
+        if (Options.interp_max_gauges<=0){Options.interp_max_gauges=DOESNT_EXIST;}
+        if (Len>3){
+          Options.interp_search_radius=s_to_d(s[3])*M_PER_KM;
+          ExitGracefullyIf(Options.interp_search_radius<=0.0,"ParseMainInputFile: :Interpolation search radius must be positive",BAD_DATA_WARN);
+        }
+      }
       break;
     }
 
@@ -2084,6 +2136,81 @@ bool ParseMainInputFile (CModel     *&pModel,
       Options.write_netresinflow=true;
       break;
     }
+    case(186):  //--------------------------------------------
+    {/*:StateFileFormat [RVC|RVB|RVC_AND_RVB]*/
+      if(Options.noisy) { cout << "State file format" << endl; }
+      if (Len<2){ImproperFormatWarning(":StateFileFormat",p,Options.noisy); break;}
+      if      (!strcmp(s[1],"RVC"        )){Options.state_file_format=STATE_RVC;}
+      else if (!strcmp(s[1],"RVB"        )){Options.state_file_format=STATE_RVB;}
+      else if (!strcmp(s[1],"RVC_AND_RVB")){Options.state_file_format=STATE_RVC_AND_RVB;}
+      else {
+        ExitGracefully("ParseMainInputFile: Unrecognized :StateFileFormat (should be RVC, RVB, or RVC_AND_RVB)",BAD_DATA_WARN);
+      }
+      break;
+    }
+    case(187):  //--------------------------------------------
+    {/*:CheckpointInterval [interval, in days]*/
+      if(Options.noisy) { cout << "Periodic binary checkpoint interval" << endl; }
+      if (Len<2){ImproperFormatWarning(":CheckpointInterval",p,Options.noisy); break;}
+      Options.checkpoint_interval=s_to_d(s[1]);
+      ExitGracefullyIf(Options.checkpoint_interval<=0.0,"ParseMainInputFile: :CheckpointInterval must be positive",BAD_DATA_WARN);
+      break;
+    }
+    case(188):  //--------------------------------------------
+    {/*:CompressCheckpoints*/
+      if(Options.noisy) { cout << "Compress binary checkpoints" << endl; }
+#ifdef _ZLIB_
+      Options.compress_checkpoints=true;
+#else
+      WriteWarning("ParseMainInputFile: :CompressCheckpoints requires Raven to be compiled with zlib (_ZLIB_); binary checkpoints will not be compressed",Options.noisy);
+#endif
+      break;
+    }
+    case(189):  //--------------------------------------------
+    {/*:ResumeFromCheckpoint [filename]*/
+      if (Len<2){ImproperFormatWarning(":ResumeFromCheckpoint",p,Options.noisy); break;}
+      if(Options.noisy) { cout << "Resume simulation from binary checkpoint: "<<s[1]<<endl; }
+      Options.resume_filename=CorrectForRelativePath(s[1],Options.rvi_filename);//with .rvb extension!
+      break;
+    }
+    case(190):  //--------------------------------------------
+    {/*:PluginLibrary [filename] {plugin arguments}*/
+      if (Len<2){ImproperFormatWarning(":PluginLibrary",p,Options.noisy); break;}
+      if(Options.noisy) { cout << "Load plugin library: "<<s[1]<<endl; }
+      Options.plugin_filename=CorrectForRelativePath(s[1],Options.rvi_filename);
+      Options.plugin_args="";
+      for(int i=2;i<Len;i++) {
+        Options.plugin_args+=s[i];
+        if(i!=Len-1) { Options.plugin_args+=" "; }
+      }
+      break;
+    }
+    case(191):  //--------------------------------------------
+    {/*:ControlChannel [socket path] {status interval [d]}*/
+      if (Len<2){ImproperFormatWarning(":ControlChannel",p,Options.noisy); break;}
+      if(Options.noisy) { cout << "Control channel: "<<s[1]<<endl; }
+      Options.control_channel=CorrectForRelativePath(s[1],Options.rvi_filename);
+      if (Len>=3){Options.control_status_interval=s_to_d(s[2]);}
+      break;
+    }
+    case(195):  //--------------------------------------------
+    {/*:Profiling*/
+      if(Options.noisy) { cout << "Profile simulation run time" << endl; }
+      Options.profiling=true;
+      break;
+    }
+    case(196):  //--------------------------------------------
+    {/*:ResampleOnDemand*/
+      if(Options.noisy) { cout << "Resample forcing time series on demand" << endl; }
+      Options.resample_on_demand=true;
+      break;
+    }
+    case(197):  //--------------------------------------------
+    {/*:UseInputCache*/
+      if(Options.noisy) { cout << "Use binary cache of parsed time series data" << endl; }
+      Options.use_input_cache=true;
+      break;
+    }
     case(198):  //--------------------------------------------
     {/*:HyporheicLayer*/
       if(Options.noisy) { cout << "HyporheicLayer" << endl; }
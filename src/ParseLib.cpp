@@ -14,7 +14,7 @@ inline long long int s_to_ll(char *s1)       {return (long long int)atoll(s1);}
 /*----------------------------------------------------------------
   Constructor
   -----------------------------------------------------------------------*/
-CParser::CParser(ifstream &FILE, const int i)
+CParser::CParser(istream &FILE, const int i)
 {
   _filename="";
   _INPUT =&FILE;
@@ -23,7 +23,7 @@ CParser::CParser(ifstream &FILE, const int i)
   _parsing_math_exp=false;
 }
 //-----------------------------------------------------------------------
-CParser::CParser(ifstream &FILE, string filename, const int i)
+CParser::CParser(istream &FILE, string filename, const int i)
 {
   _filename=filename;
   _INPUT =&FILE;
@@ -103,6 +103,29 @@ string CParser::AddSpacesBeforeOps(string line) const
 bool CParser::Tokenize(char **out, int &numwords){
 
   static char wholeline     [MAXCHARINLINE];
+
+  (*wholeline)=0;
+  if (_INPUT->eof()){return true;}
+  _INPUT->getline(wholeline,MAXCHARINLINE);            //get entire line as 1 string
+  if (_INPUT->fail()){
+    return true; //handles blank line peeked at end of file (for some reason)
+    //cout<<"failed: "<<filename<<" line "<<l<<"|"<<wholeline<<"|"<<INPUT->ios::eofbit<<endl;
+    //ExitGracefully("Too many characters in line or (maybe) using Mac-style carriage return line endings.",BAD_DATA);
+  }
+
+  _lineno++;
+  if ((parserdebug) && ((*wholeline)!=0)){cout <<wholeline<<endl;}
+
+  return TokenizeLine(wholeline,out,numwords);
+}
+/*----------------------------------------------------------------
+  TokenizeLine
+  ----------------------------------------------------------------
+  tokenizes a line already read from file (modifies wholeline)
+  returns true if line could not be tokenized
+  -------------------------------------------------------------------------*/
+bool CParser::TokenizeLine(char *wholeline, char **out, int &numwords){
+
   static char *tempwordarray[MAXINPUTITEMS];
   char *p;
   int ct(0),w;
@@ -119,17 +142,6 @@ bool CParser::Tokenize(char **out, int &numwords){
   if (_parsing_math_exp) {
      delimiters[2]=' ';//don't use commas
   }
-  (*wholeline)=0;
-  if (_INPUT->eof()){return true;}
-  _INPUT->getline(wholeline,MAXCHARINLINE);            //get entire line as 1 string
-  if (_INPUT->fail()){
-    return true; //handles blank line peeked at end of file (for some reason)
-    //cout<<"failed: "<<filename<<" line "<<l<<"|"<<wholeline<<"|"<<INPUT->ios::eofbit<<endl;
-    //ExitGracefully("Too many characters in line or (maybe) using Mac-style carriage return line endings.",BAD_DATA);
-  }
-
-  _lineno++;
-  if ((parserdebug) && ((*wholeline)!=0)){cout <<wholeline<<endl;}
 
   if ((*wholeline) == 0) {
     numwords=0;
@@ -164,6 +176,58 @@ bool CParser::Tokenize(char **out, int &numwords){
   numwords=ct;
   return false;
 }
+/*----------------------------------------------------------------
+  ParseNumericRow
+  ----------------------------------------------------------------
+  fast path for reading rows of numeric tabular data (e.g., time series)
+  reads next line; if it consists solely of delimited numbers, they are
+  parsed directly into aVal in a single pass without tokenizing.
+  Otherwise (comments, commands, NaN, etc.) the line is tokenized as in
+  Tokenize() so the caller can handle it.
+
+  parameters:
+  aVal is the array of values in the line [maxVals]
+  nVals is the number of values parsed
+  out/numwords are the tokenized line (if non-numeric)
+  returns PARSE_GOOD if numeric row parsed, PARSE_BAD if line is
+  non-numeric (and was tokenized), PARSE_EOF if file has ended
+  -------------------------------------------------------------------------*/
+parse_error CParser::ParseNumericRow(double *aVal, const int maxVals, int &nVals, char **out, int &numwords)
+{
+  static char wholeline[MAXCHARINLINE];
+
+  nVals=0;
+  numwords=0;
+  (*wholeline)=0;
+  if (_INPUT->eof()){return PARSE_EOF;}
+  _INPUT->getline(wholeline,MAXCHARINLINE);
+  if (_INPUT->fail()){return PARSE_EOF;}
+
+  _lineno++;
+  if ((parserdebug) && ((*wholeline)!=0)){cout <<wholeline<<endl;}
+
+  if ((!_comma_only) && (!_parsing_math_exp))
+  {
+    const char *c=wholeline;
+    const char *end;
+    bool numeric=true;
+    while (true)
+    {
+      while ((*c==' ') || (*c=='\t') || (*c==',') || (*c=='\r') || (*c=='\n')){c++;}
+      if (*c=='\0'){break;}
+      if (nVals>=maxVals){numeric=false;break;}
+      aVal[nVals]=fast_s_to_d(c,&end);
+      if ((end==c) || ((aVal[nVals]==0.0) && (*c!='0'))){numeric=false;break;} //same criterion as is_numeric()
+      if ((*end!=' ') && (*end!='\t') && (*end!=',') && (*end!='\r') && (*end!='\n') && (*end!='\0')){numeric=false;break;}
+      nVals++;
+      c=end;
+    }
+    if ((numeric) && (nVals>0)){return PARSE_GOOD;}
+  }
+  nVals=0;
+  TokenizeLine(wholeline,out,numwords);
+  return PARSE_BAD;
+}
 /*----------------------------------------------------------------*/
 void   CParser::ImproperFormat(char **s)
 {
@@ -49,7 +49,7 @@ class CParser
 {
 private:
 
-  ifstream *_INPUT;            //< current input file
+  istream  *_INPUT;            //< current input file (or in-memory stream)
   int       _lineno;           //< current line in input file
   string    _filename;         //< current input filename
 
@@ -57,11 +57,12 @@ private:
   bool      _parsing_math_exp; //< true if currently parsing math exp (commas not ignored)
 
   string AddSpacesBeforeOps(string line) const;
+  bool   TokenizeLine      (char *wholeline, char **out, int &numwords);
 
 public:
 
-  CParser(ifstream &FILE, const int init_line_num);
-  CParser(ifstream &FILE, string filename, const int init_line_num);
+  CParser(istream &FILE, const int init_line_num);
+  CParser(istream &FILE, string filename, const int init_line_num);
   ~CParser(){}
 
   void   SetLineCounter(int i);
@@ -75,6 +76,8 @@ public:
 
   bool   Tokenize(char **tokens, int &numwords);
 
+  parse_error ParseNumericRow(double *aVal, const int maxVals, int &nVals, char **tokens, int &numwords);
+
   string Peek();
 
   void NextIsMathExp();
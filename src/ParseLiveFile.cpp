@@ -7,6 +7,7 @@ Copyright (c) 2008-2024 the Raven Development Team
 #include "StateVariables.h"
 #include "HydroUnits.h"
 #include "ParseLib.h"
+#include "RavenMain.h"
 
 //////////////////////////////////////////////////////////////////
 /// \brief Parses Live Communications File
@@ -23,20 +24,34 @@ void ParseLiveFile(CModel *&pModel,const optStruct &Options, const time_struct &
   //if not evenly divided by frequency, return
   if(fabs(ffmod(tt.model_time,Options.rvl_read_frequency)) > 0.5*Options.timestep){return;}
 
-  bool        ended(false);
-  CHydroUnit *pHRU;
-  CSubBasin  *pSB;
-
   ifstream    RVL;
   RVL.open(Options.rvl_filename.c_str());
   if(RVL.fail()) {
     string warn="ERROR opening model live file: "+Options.rvl_filename;
     ExitGracefully(warn.c_str(), BAD_DATA);return;
   }
+  ParseLiveCommands(pModel,Options,RVL,Options.rvl_filename);
+  RVL.close();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Parses live communication commands (.rvl format) from stream
+/// \details used for both the .rvl live file and commands received over the control channel
+///
+/// \param *&pModel [out] Reference to model object
+/// \param &Options [in] Global model options information
+/// \param &IN [in] stream of commands
+/// \param source [in] name of command source (for error messages)
+//
+void ParseLiveCommands(CModel *&pModel,const optStruct &Options, istream &IN, const string source)
+{
+  bool        ended(false);
+  CHydroUnit *pHRU;
+  CSubBasin  *pSB;
 
   int   Len,line(0),code;
   char *s[MAXINPUTITEMS];
-  CParser *pp=new CParser(RVL,Options.rvl_filename,line);
+  CParser *pp=new CParser(IN,source,line);
 
   //--Sift through file-----------------------------------------------
   bool end_of_file=pp->Tokenize(s,Len);
@@ -195,7 +210,11 @@ void ParseLiveFile(CModel *&pModel,const optStruct &Options, const time_struct &
     }
     case(10):  //----------------------------------------------
     { /*:SetStreamflow [SBID] [value]*/
+      if (Len<3){pp->ImproperFormat(s); break;}
       pSB=pModel->GetSubBasinByID(s_to_ll(s[1]));
+      if (pSB==NULL){
+        WriteWarning("ParseLiveFile: invalid subbasin ID provided in :SetStreamflow command",Options.noisy); break;
+      }
       double Q=fast_s_to_d(s[2]);
       pSB->SetQout(Q);
       //or pSB->SetCurrentOutflow(Q);
@@ -203,7 +222,11 @@ void ParseLiveFile(CModel *&pModel,const optStruct &Options, const time_struct &
     }
     case(11):  //----------------------------------------------
     { /*:SetReservoirStage [SBID] [value]*/
+      if (Len<3){pp->ImproperFormat(s); break;}
       pSB=pModel->GetSubBasinByID(s_to_ll(s[1]));
+      if ((pSB==NULL) || (pSB->GetReservoir()==NULL)){
+        WriteWarning("ParseLiveFile: invalid reservoir subbasin ID provided in :SetReservoirStage command",Options.noisy); break;
+      }
       pSB->GetReservoir()->SetReservoirStage(s_to_d(s[2]),s_to_d(s[2]));
       break;
     }
@@ -292,7 +315,6 @@ void ParseLiveFile(CModel *&pModel,const optStruct &Options, const time_struct &
     end_of_file=pp->Tokenize(s,Len);
 
   } //end while !end_of_file
-  RVL.close();
 
   delete pp;
   pp=NULL;
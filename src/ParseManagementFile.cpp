@@ -97,6 +97,9 @@ bool ParseManagementFile(CModel *&pModel,const optStruct &Options)
 
   CDemandOptimizer *pDO=pModel->GetManagementOptimizer();
 
+#ifndef _LPSOLVE_
+  ExitGracefully("Demand optimization requires compilation with lpsolve library.",RUNTIME_ERR);
+#endif
   pDO->Initialize(pModel,Options); //only requires rvh,.rvt read
 
   if(Options.noisy) {
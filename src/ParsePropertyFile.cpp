@@ -1278,12 +1278,10 @@ bool ParseClassPropertiesFile(CModel         *&pModel,
       param_override *pPO=new param_override();
       pPO->nVals=1;
       pPO->aValues=new double [1];
-      pPO->aRevertValues=new double [1];
 
       pPO->param_name  =s[1];
       pPO->SBGroup_name=s[2];
       pPO->aValues[0]  =s_to_d(s[3]);
-      pPO->aRevertValues[0]=0;
 
       pModel->AddParameterOverride(pPO);
       break;
@@ -1345,14 +1343,12 @@ bool ParseClassPropertiesFile(CModel         *&pModel,
         param_override *pPO=new param_override();
         pPO->nVals=N;
         pPO->aValues      =new double [N];
-        pPO->aRevertValues=new double [N];
-        ExitGracefullyIf(pPO->aRevertValues==NULL,"ParseClassPropertiesFile::SBGroupOverrideWeights command",OUT_OF_MEMORY);
+        ExitGracefullyIf(pPO->aValues==NULL,"ParseClassPropertiesFile::SBGroupOverrideWeights command",OUT_OF_MEMORY);
 
         pPO->param_name  =s[1];
         pPO->SBGroup_name=s[2];
         for (int i = 0; i < N; i++) {
           pPO->aValues      [i]  =wts[i];
-          pPO->aRevertValues[i]=0.0;
         }
 
         pModel->AddParameterOverride(pPO);
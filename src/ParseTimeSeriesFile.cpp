@@ -7,6 +7,7 @@
 #include "TimeSeries.h"
 #include "IrregularTimeSeries.h"
 #include "ParseLib.h"
+#include "TimeSeriesCache.h"
 
 void AllocateReservoirDemand(CModel *&pModel,const optStruct &Options,long long SBID, long long SBIDres,double pct_met,int jul_start,int jul_end);
 bool IsContinuousFlowObs2(const CTimeSeriesABC* pObs,long long SBID);
@@ -56,6 +57,8 @@ bool ParseTimeSeriesFile(CModel *&pModel, const optStruct &Options)
 
   CParser *p=new CParser(RVT,Options.rvt_filename,line);
 
+  CTimeSeriesCache::Enable(Options.use_input_cache);
+
   if (Options.noisy)
   {
     cout <<"==========================================================="<<endl;
@@ -2116,6 +2119,8 @@ bool ParseTimeSeriesFile(CModel *&pModel, const optStruct &Options)
 
   delete p; p=NULL;
 
+  CTimeSeriesCache::FinalizeAll(Options);
+
   return true;
 }
 
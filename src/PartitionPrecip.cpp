@@ -312,7 +312,7 @@ void CmvPrecipitation::GetRatesOfChange(const double             *state_vars,
         }
         if ( (pModel->StateVarExists(SNOW_DEFICIT)) && (SWE > 0.0))  //Snow deficit in model (UBCWM)
         {
-          double SWI = pModel->GetGlobalParams()->GetParams()->snow_SWI;
+          double SWI = pHRU->GetGlobalParams()->snow_SWI;
           rates[qSnowDef] = SWI*snowthru; //snowfall to snowpack
         }
       }
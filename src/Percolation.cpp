@@ -358,3 +358,96 @@ void   CmvPercolation::ApplyConstraints(const double             *state_vars,
     rates[0]=threshMin(rates[0],room/Options.timestep,0.0);
   }
 }
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns true if percolation algorithm has a batched (multi-HRU) implementation
+//
+bool CmvPercolation::SupportsBatchRates() const
+{
+  return ((type==PERC_CONSTANT) || (type==PERC_GAWSER) || (type==PERC_POWER_LAW) ||
+          (type==PERC_LINEAR)   || (type==PERC_LINEAR_ANALYTIC));
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns constrained percolation rates for a block of HRUs [mm/d]
+/// \details identical to GetRatesOfChange()+ApplyConstraints() for each HRU; parameters and storage are
+/// gathered into contiguous arrays first so that rate calculations are performed in tight loops
+///
+/// \param nHRUs [in] number of HRUs in block (<=PROCESS_BATCH_SIZE)
+/// \param state_vars [in] array of pointers to state variable arrays of each HRU in block
+/// \param pHRUs [in] array of pointers to HRUs in block
+/// \param &Options [in] Global model options information
+/// \param &tt [in] Current model time strucure
+/// \param *rates [out] percolation rate of each HRU in block [mm/d] [size: nHRUs]
+//
+void CmvPercolation::GetBatchRatesOfChange(const int          nHRUs,
+                                           const double      *const *state_vars,
+                                           const CHydroUnit  *const *pHRUs,
+                                           const optStruct   &Options,
+                                           const time_struct &tt,
+                                                 double      *rates) const
+{
+  bool   active  [PROCESS_BATCH_SIZE]; //false for lakes/water bodies
+  double stor    [PROCESS_BATCH_SIZE]; //soil layer water content [mm]
+  double max_stor[PROCESS_BATCH_SIZE]; //maximum storage of 'from' soil layer [mm]
+  double P1      [PROCESS_BATCH_SIZE]; //max perc rate [mm/d] or perc coeff [1/d]
+  double P2      [PROCESS_BATCH_SIZE]; //field capacity [-] or perc exponent [-]
+  double room    [PROCESS_BATCH_SIZE]; //room in 'to' compartment [mm]
+  const soil_struct *pSoil;
+  int    n;
+  int    m=pModel->GetStateVarLayer(iFrom[0]);
+  double tstep   =Options.timestep;
+  double min_stor=g_min_storage;
+
+  //gather
+  for (n=0;n<nHRUs;n++)
+  {
+    HRU_type typ=pHRUs[n]->GetHRUType();
+    active[n]=((typ!=HRU_LAKE) && (typ!=HRU_WATER));
+    rates [n]=0.0;
+    if (!active[n]){continue;}
+
+    pSoil      =pHRUs[n]->GetSoilProps(m);
+    stor    [n]=state_vars[n][iFrom[0]];
+    max_stor[n]=pHRUs[n]->GetSoilCapacity(m);
+    if      ((type==PERC_LINEAR) || (type==PERC_LINEAR_ANALYTIC)){P1[n]=pSoil->perc_coeff;}
+    else                                                         {P1[n]=pSoil->max_perc_rate;}
+    if      (type==PERC_GAWSER)                                  {P2[n]=pSoil->field_capacity;}
+    else                                                         {P2[n]=pSoil->perc_n;}
+    if (!Options.allow_soil_overfill){
+      room[n]=threshMax(pHRUs[n]->GetStateVarMax(iTo[0],state_vars[n],Options)-state_vars[n][iTo[0]],0.0,0.0);
+    }
+  }
+
+  //calculate rates
+  for (n=0;n<nHRUs;n++)
+  {
+    if ((!active[n]) || (max_stor[n]<=0.0)){continue;} //handles zero-thickness layers
+    if      (type==PERC_CONSTANT){
+      rates[n]=P1[n];
+    }
+    else if (type==PERC_GAWSER){
+      double field_cap=P2[n]*max_stor[n];
+      rates[n]=P1[n]*max(stor[n]-field_cap,0.0)/(max_stor[n]-field_cap);
+    }
+    else if (type==PERC_POWER_LAW){
+      rates[n]=P1[n]*pow(stor[n]/max_stor[n],P2[n]);
+    }
+    else if (type==PERC_LINEAR){
+      rates[n]=P1[n]*stor[n];
+    }
+    else if (type==PERC_LINEAR_ANALYTIC){
+      rates[n]=stor[n]*(1-exp(-P1[n]*tstep))/tstep;
+    }
+  }
+
+  //apply constraints (as in ApplyConstraints)
+  for (n=0;n<nHRUs;n++)
+  {
+    if (!active[n]){continue;}
+    rates[n]=threshMin(rates[n],max(stor[n]-min_stor,0.0)/tstep,0.0);
+    if (!Options.allow_soil_overfill){
+      rates[n]=threshMin(rates[n],room[n]/tstep,0.0);
+    }
+  }
+}
@@ -0,0 +1,212 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2025 the Raven Development Team
+  ----------------------------------------------------------------
+  Class CPluginHost
+  ----------------------------------------------------------------*/
+#include "PluginHost.h"
+#include "Model.h"
+#include "StateVariables.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+void                    *CPluginHost::_hLib         =NULL;
+CModel                  *CPluginHost::_pModel       =NULL;
+raven_host_api           CPluginHost::_api;
+raven_plugin_step_fn     CPluginHost::_StartTimeStep=NULL;
+raven_plugin_step_fn     CPluginHost::_EndTimeStep  =NULL;
+raven_plugin_finalize_fn CPluginHost::_Finalize     =NULL;
+
+//////////////////////////////////////////////////////////////////
+// Host functions exposed to plugin through raven_host_api
+// ctx is the CModel pointer; indices are not range-checked except where noted
+//////////////////////////////////////////////////////////////////
+static int HostGetNumHRUs     (void *ctx) { return static_cast<CModel*>(ctx)->GetNumHRUs(); }
+static int HostGetNumSubBasins(void *ctx) { return static_cast<CModel*>(ctx)->GetNumSubBasins(); }
+static int HostGetNumStateVars(void *ctx) { return static_cast<CModel*>(ctx)->GetNumStateVars(); }
+
+static int HostGetStateVarIndex(void *ctx, const char *name)
+{
+  CModel *pModel=static_cast<CModel*>(ctx);
+  int layer=DOESNT_EXIST;
+  if (name==NULL){return DOESNT_EXIST;}
+  sv_type typ=pModel->GetStateVarInfo()->StringToSVType(name,layer,false);
+  if (typ==UNRECOGNIZED_SVTYPE){return DOESNT_EXIST;}
+  if ((layer!=DOESNT_EXIST) && ((layer<0) || (layer>=MAX_SV_LAYERS))){return DOESNT_EXIST;}
+  return pModel->GetStateVarIndex(typ,layer);
+}
+static double HostGetStateVar(void *ctx, int k, int i)
+{
+  return static_cast<CModel*>(ctx)->GetHydroUnit(k)->GetStateVarValue(i);
+}
+static void HostSetStateVar(void *ctx, int k, int i, double value)
+{
+  static_cast<CModel*>(ctx)->GetHydroUnit(k)->SetStateVarValue(i,value);
+}
+
+static int HostGetForcingIndex(void *ctx, const char *name)
+{
+  if (name==NULL){return DOESNT_EXIST;}
+  forcing_type ftyp=GetForcingTypeFromString(name);
+  if (ftyp==F_UNRECOGNIZED){return DOESNT_EXIST;}
+  return (int)(ftyp);
+}
+static double HostGetForcing(void *ctx, int k, int f)
+{
+  return static_cast<CModel*>(ctx)->GetHydroUnit(k)->GetForcing((forcing_type)(f));
+}
+static void HostSetForcing(void *ctx, int k, int f, double value)
+{
+  static_cast<CModel*>(ctx)->GetHydroUnit(k)->SetHRUForcing((forcing_type)(f),value);
+}
+
+static double HostGetSubBasinOutflow(void *ctx, int p)
+{
+  return static_cast<CModel*>(ctx)->GetSubBasin(p)->GetOutflowRate();
+}
+static void HostSetSubBasinOutflow(void *ctx, int p, double Q)
+{
+  static_cast<CModel*>(ctx)->GetSubBasin(p)->SetQout(Q);
+}
+
+static long long HostGetHRUID     (void *ctx, int k) { return static_cast<CModel*>(ctx)->GetHydroUnit(k)->GetHRUID(); }
+static long long HostGetSubBasinID(void *ctx, int p) { return static_cast<CModel*>(ctx)->GetSubBasin(p)->GetID(); }
+static int HostGetHRUIndex(void *ctx, long long ID)
+{
+  CHydroUnit *pHRU=static_cast<CModel*>(ctx)->GetHRUByID(ID);
+  if (pHRU==NULL){return DOESNT_EXIST;}
+  return pHRU->GetGlobalIndex();
+}
+static int HostGetSubBasinIndex(void *ctx, long long ID)
+{
+  int p=static_cast<CModel*>(ctx)->GetSubBasinIndex(ID);
+  if (p<0){return DOESNT_EXIST;} //GetSubBasinIndex() returns INDEX_NOT_FOUND
+  return p;
+}
+static void HostWriteWarning(void * /*ctx*/, const char *message)
+{
+  if (message==NULL){return;}
+  string warn="Plugin: "+string(message);
+  WriteWarning(warn.c_str(),false);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief returns address of exported plugin symbol (NULL if not exported)
+/// \param name [in] symbol name
+//
+void *CPluginHost::GetSymbol(const char *name)
+{
+#if defined(_WIN32)
+  return (void*)(GetProcAddress((HMODULE)(_hLib),name));
+#else
+  return dlsym(_hLib,name);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief loads plugin shared library specified by :PluginLibrary and calls its RavenPluginInit routine
+/// \details does nothing if no plugin specified. Called once, after model initialization
+/// \param pModel [in] pointer to initialized model
+/// \param &Options [in] global model options
+//
+void CPluginHost::Load(CModel *pModel, const optStruct &Options)
+{
+  if (Options.plugin_filename==""){return;}
+  string warn;
+
+#if defined(_WIN32)
+  _hLib=(void*)(LoadLibraryA(Options.plugin_filename.c_str()));
+  if (_hLib==NULL){
+    warn="CPluginHost::Load: unable to load plugin library "+Options.plugin_filename;
+    ExitGracefully(warn.c_str(),BAD_DATA);return;
+  }
+#else
+  _hLib=dlopen(Options.plugin_filename.c_str(),RTLD_NOW | RTLD_LOCAL);
+  if (_hLib==NULL){
+    warn="CPluginHost::Load: unable to load plugin library "+Options.plugin_filename+": "+string(dlerror());
+    ExitGracefully(warn.c_str(),BAD_DATA);return;
+  }
+#endif
+
+  raven_plugin_init_fn Init=(raven_plugin_init_fn)(GetSymbol("RavenPluginInit"));
+  if (Init==NULL){
+    warn="CPluginHost::Load: plugin library "+Options.plugin_filename+" does not export RavenPluginInit";
+    ExitGracefully(warn.c_str(),BAD_DATA);return;
+  }
+  _StartTimeStep=(raven_plugin_step_fn    )(GetSymbol("RavenPluginStartTimeStep"));
+  _EndTimeStep  =(raven_plugin_step_fn    )(GetSymbol("RavenPluginEndTimeStep"));
+  _Finalize     =(raven_plugin_finalize_fn)(GetSymbol("RavenPluginFinalize"));
+
+  _pModel=pModel;
+  _api.api_version       =RAVEN_PLUGIN_API_VERSION;
+  _api.struct_size       =(int)(sizeof(raven_host_api));
+  _api.ctx               =pModel;
+  _api.GetNumHRUs        =HostGetNumHRUs;
+  _api.GetNumSubBasins   =HostGetNumSubBasins;
+  _api.GetNumStateVars   =HostGetNumStateVars;
+  _api.GetStateVarIndex  =HostGetStateVarIndex;
+  _api.GetStateVar       =HostGetStateVar;
+  _api.SetStateVar       =HostSetStateVar;
+  _api.GetForcingIndex   =HostGetForcingIndex;
+  _api.GetForcing        =HostGetForcing;
+  _api.SetForcing        =HostSetForcing;
+  _api.GetSubBasinOutflow=HostGetSubBasinOutflow;
+  _api.SetSubBasinOutflow=HostSetSubBasinOutflow;
+  _api.GetHRUID          =HostGetHRUID;
+  _api.GetSubBasinID     =HostGetSubBasinID;
+  _api.GetHRUIndex       =HostGetHRUIndex;
+  _api.GetSubBasinIndex  =HostGetSubBasinIndex;
+  _api.WriteWarning      =HostWriteWarning;
+
+  int ret=Init(&_api,Options.plugin_args.c_str());
+  if (ret!=0){
+    warn="CPluginHost::Load: plugin "+Options.plugin_filename+" failed to initialize (RavenPluginInit returned "+to_string(ret)+")";
+    ExitGracefully(warn.c_str(),BAD_DATA);return;
+  }
+  if (!Options.silent){
+    cout<<"Loaded plugin "<<Options.plugin_filename<<endl;
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief issues plugin timestep callback
+/// \param fn [in] plugin callback
+/// \param &Options [in] global model options
+/// \param &tt [in] current model time
+//
+void CPluginHost::TimeStep(raven_plugin_step_fn fn, const optStruct &Options, const time_struct &tt)
+{
+  raven_time t;
+  t.model_time  =tt.model_time;
+  t.julian_day  =tt.julian_day;
+  t.year        =tt.year;
+  t.month       =tt.month;
+  t.day_of_month=tt.day_of_month;
+  t.timestep    =Options.timestep;
+  t.date_string =tt.date_string.c_str();
+  fn(&t);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief calls plugin RavenPluginFinalize routine and unloads plugin library
+//
+void CPluginHost::Finalize()
+{
+  if (_hLib==NULL){return;}
+  if (_Finalize!=NULL){_Finalize();}
+#if defined(_WIN32)
+  FreeLibrary((HMODULE)(_hLib));
+#else
+  dlclose(_hLib);
+#endif
+  _hLib         =NULL;
+  _pModel       =NULL;
+  _StartTimeStep=NULL;
+  _EndTimeStep  =NULL;
+  _Finalize     =NULL;
+}
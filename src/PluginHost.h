@@ -0,0 +1,42 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2025 the Raven Development Team
+  ----------------------------------------------------------------
+  Class CPluginHost
+  ----------------------------------------------------------------*/
+#ifndef PLUGIN_HOST_H
+#define PLUGIN_HOST_H
+
+#include "RavenInclude.h"
+#include "RavenPlugin.h"
+
+class CModel;  // defined in Model.h
+
+////////////////////////////////////////////////////////////////////
+/// \brief Loads a shared library plugin and issues its timestep callbacks
+/// \details plugin specified using :PluginLibrary command in .rvi file; the plugin C ABI is
+/// declared in RavenPlugin.h. Only one plugin may be loaded at a time.
+//
+class CPluginHost
+{
+private:/*------------------------------------------------------*/
+  static void                    *_hLib;          ///< handle of loaded shared library (NULL if none)
+  static CModel                  *_pModel;        ///< pointer to model (host context passed to plugin)
+  static raven_host_api           _api;           ///< table of host functions passed to plugin
+  static raven_plugin_step_fn     _StartTimeStep; ///< plugin start-of-timestep callback (or NULL)
+  static raven_plugin_step_fn     _EndTimeStep;   ///< plugin end-of-timestep callback (or NULL)
+  static raven_plugin_finalize_fn _Finalize;      ///< plugin finalization routine (or NULL)
+
+  static void                    *GetSymbol(const char *name);
+  static void                     TimeStep (raven_plugin_step_fn fn, const optStruct &Options, const time_struct &tt);
+
+public:/*-------------------------------------------------------*/
+  static void        Load         (CModel *pModel, const optStruct &Options);
+  static void        Finalize     ();
+
+  static inline bool IsLoaded     () { return (_hLib!=NULL); }
+  static inline void StartTimeStep(const optStruct &Options, const time_struct &tt) { if (_StartTimeStep!=NULL){TimeStep(_StartTimeStep,Options,tt);} }
+  static inline void EndTimeStep  (const optStruct &Options, const time_struct &tt) { if (_EndTimeStep  !=NULL){TimeStep(_EndTimeStep  ,Options,tt);} }
+};
+
+#endif
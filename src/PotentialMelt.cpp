@@ -88,9 +88,12 @@ double CModel::EstimatePotentialMelt(const force_struct *F,
     ExitGracefullyIf(_PotMeltBlends_N==0,
       "EstimatePotentialMelt: POTMELT_BLENDED specified, but no weights were provided using :BlendedPotMeltWeights command",BAD_DATA);
     double melt=0;
+    const double *wts=_PotMeltBlends_wts;
+    if (pHRU->GetPotMeltBlendWeights()!=NULL){wts=pHRU->GetPotMeltBlendWeights();} //local override
+
     for(int i=0; i<_PotMeltBlends_N;i++) {
       potmelt_method etyp=_PotMeltBlends_type[i];
-      double           wt=_PotMeltBlends_wts[i];
+      double           wt=wts[i];
       melt+=wt*EstimatePotentialMelt(F,etyp,Options,pHRU,tt);
 
       if(rvn_isnan(melt)) {
@@ -175,7 +178,7 @@ double CModel::EstimatePotentialMelt(const force_struct *F,
     // Cloud Base Temperature
     double TcP; // Difference between the cloud base temp and snow surface
     double cloud_base = (TaP - TdP) * 400 / FEET_PER_METER; // Estimation of cloud base height in M
-    double lapse = this->_pGlobalParams->GetParams()->adiabatic_lapse;//[C/km]
+    double lapse = pHRU->GetGlobalParams()->adiabatic_lapse;//[C/km]
     lapse = lapse / 1000.0; //[C/m]
     TcP = TaP - cloud_base * lapse;
 
@@ -276,7 +279,7 @@ double UBC_DailyPotentialMelt(CModel* pModel,
 
   if ((pHRU->GetHRUType()==HRU_GLACIER) && (snowSWE<=0))
   {
-    double minalb = pModel->GetGlobalParams()->GetParams()->min_snow_albedo;
+    double minalb = pHRU->GetGlobalParams()->min_snow_albedo;
     albedo = 1-(1.0-albedo)*(1-minalb);//UBCWM RFS implmentation
   }
 
@@ -53,6 +53,21 @@ void CProcessGroup::Initialize()
   }
 }
 //////////////////////////////////////////////////////////////////
+/// \brief prepares all subprocesses for time step
+/// \remark subprocesses are applied wherever the group is applied
+//
+void CProcessGroup::PrepareTimeStep(const CHydroUnit  *const *pHRUs,
+                                    const bool        *aApplies,
+                                    const int          nHRUs,
+                                    const optStruct   &Options,
+                                    const time_struct &tt)
+{
+  for(int j=0;j<_nSubProcesses;j++)
+  {
+    _pSubProcesses[j]->PrepareTimeStep(pHRUs,aApplies,nHRUs,Options,tt);
+  }
+}
+//////////////////////////////////////////////////////////////////
 /// \brief Returns rates of change in all state variables modeled over time step
 /// \param *state_var [in] Array of current state variables in HRU
 /// \param *pHRU [in] Reference to pertinent HRU
@@ -37,6 +37,11 @@ public:/*-------------------------------------------------------*/
 
   //inherited functions
   void Initialize();
+  void PrepareTimeStep (const CHydroUnit  *const *pHRUs,
+                        const bool        *aApplies,
+                        const int          nHRUs,
+                        const optStruct   &Options,
+                        const time_struct &tt);
   void GetRatesOfChange(const double      *state_vars,
                         const CHydroUnit  *pHRU,
                         const optStruct   &Options,
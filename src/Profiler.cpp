@@ -0,0 +1,159 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2023 the Raven Development Team
+  ----------------------------------------------------------------
+  Run-time profiler of simulation loop
+  ----------------------------------------------------------------*/
+#include "Profiler.h"
+#include "Model.h"
+
+bool        CProfiler::_enabled=false;
+int         CProfiler::_nTimers=0;
+prof_timer *CProfiler::_aTimers=NULL;
+double      CProfiler::_start  =0.0;
+
+const double PROF_HIST_MIN=1e-8; ///< lower edge of first histogram bin [s]
+
+//////////////////////////////////////////////////////////////////
+/// \brief Initializes and enables profiler, with one timer per simulation stage and per hydrologic process
+/// \param *pModel [in] model (must be initialized)
+//
+void CProfiler::Initialize(const CModel *pModel)
+{
+  const string stage_names[NUM_PROFILE_STAGES]={
+    "ParseInputFiles",
+    "InitializeModel",
+    "UpdateTransientParams",
+    "RecalculateHRUDerivedParams",
+    "EnsembleTimeStepOps",
+    "UpdateHRUForcingFunctions",
+    "PrepareAssimilation",
+    "WriteSimpleOutput",
+    "ExternalScript/LiveFile",
+    "MassEnergyBalance",
+    "MassEnergyBalance:HRUProcesses",
+    "MassEnergyBalance:LateralProcesses",
+    "MassEnergyBalance:Groundwater",
+    "MassEnergyBalance:DemandOptimization",
+    "MassEnergyBalance:Routing",
+    "MassEnergyBalance:Routing:Reservoirs",
+    "MassEnergyBalance:Transport",
+    "IncrementCumulativeBalance",
+    "WriteMinorOutput",
+    "UpdateDiagnostics",
+    "WriteMajorOutput"
+  };
+  Destroy();
+
+  _nTimers=NUM_PROFILE_STAGES+pModel->GetNumProcesses();
+  _aTimers=new prof_timer [_nTimers];
+  ExitGracefullyIf(_aTimers==NULL,"CProfiler::Initialize",OUT_OF_MEMORY);
+
+  for (int i=0;i<_nTimers;i++)
+  {
+    if (i<NUM_PROFILE_STAGES){
+      _aTimers[i].name=stage_names[i];
+    }
+    else{
+      int j=i-NUM_PROFILE_STAGES;
+      _aTimers[i].name="MassEnergyBalance:Process["+to_string(j)+"] "+GetProcessName(pModel->GetProcess(j)->GetProcessType());
+    }
+    _aTimers[i].nCalls=0;
+    _aTimers[i].total =0.0;
+    _aTimers[i].max   =0.0;
+    for (int b=0;b<PROF_HIST_BINS;b++){_aTimers[i].hist[b]=0;}
+  }
+  _enabled=true;
+  _start  =Now();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Adds single call duration to timer
+/// \details histogram bins are logarithmic, four per factor of two, starting at PROF_HIST_MIN
+///
+/// \param timer [in] timer index (profile_stage, or NUM_PROFILE_STAGES+process index)
+/// \param dt [in] wall time of call [s]
+//
+void CProfiler::AddSample(const int timer, const double &dt)
+{
+  if ((timer<0) || (timer>=_nTimers)){return;}
+  prof_timer &T=_aTimers[timer];
+  T.nCalls++;
+  T.total+=dt;
+  T.max=max(T.max,dt);
+
+  int b=0;
+  if (dt>PROF_HIST_MIN){
+    int e;
+    double m=frexp(dt/PROF_HIST_MIN,&e); //dt/min=m*2^e, m in [0.5,1)
+    b=4*(e-1)+(int)((m-0.5)*8.0);
+    b=min(max(b,0),PROF_HIST_BINS-1);
+  }
+  T.hist[b]++;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Estimates percentile of call duration of timer from histogram [s]
+/// \param T [in] timer
+/// \param pct [in] percentile [0..1]
+/// \return call duration (centre of histogram bin containing percentile, capped by maximum) [s]
+//
+double CProfiler::Percentile(const prof_timer &T, const double &pct)
+{
+  if (T.nCalls==0){return 0.0;}
+  long long target=(long long)(ceil(pct*T.nCalls));
+  long long cum=0;
+  for (int b=0;b<PROF_HIST_BINS;b++)
+  {
+    cum+=T.hist[b];
+    if ((cum>=target) && (T.hist[b]>0))
+    {
+      double lower=PROF_HIST_MIN*pow(2.0,b/4)*(1.0+0.25*(b%4));
+      double upper=PROF_HIST_MIN*pow(2.0,b/4)*(1.0+0.25*(b%4+1));
+      return min(0.5*(lower+upper),T.max);
+    }
+  }
+  return T.max;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Writes profiling report Raven_profile.csv to output directory
+/// \details percentages are relative to total wall time since profiler initialization (i.e., excluding
+/// ParseInputFiles and InitializeModel); nested timers (parent:child) are included in their parent's time
+///
+/// \param &Options [in] Global model options information
+//
+void CProfiler::WriteReport(const optStruct &Options)
+{
+  if (!_enabled){return;}
+
+  double total=Now()-_start;
+  string tmpFilename=FilenamePrepare("Raven_profile.csv",Options);
+  ofstream PROF;
+  PROF.open(tmpFilename.c_str());
+  if (PROF.fail()){
+    ExitGracefully(("CProfiler::WriteReport: Unable to open output file "+tmpFilename+" for writing.").c_str(),FILE_OPEN_ERR);
+  }
+  PROF<<"timer,calls,total [s],percent of total,mean [us],p50 [us],p90 [us],p99 [us],max [us]"<<endl;
+  PROF<<"Total,1,"<<total<<",100.0,"<<total*1e6<<","<<total*1e6<<","<<total*1e6<<","<<total*1e6<<","<<total*1e6<<endl;
+  for (int i=0;i<_nTimers;i++)
+  {
+    const prof_timer &T=_aTimers[i];
+    if (T.nCalls==0){continue;}
+    PROF<<T.name<<","<<T.nCalls<<","<<T.total<<","<<100.0*T.total/max(total,1e-12)<<",";
+    PROF<<1e6*T.total/T.nCalls<<",";
+    PROF<<1e6*Percentile(T,0.50)<<","<<1e6*Percentile(T,0.90)<<","<<1e6*Percentile(T,0.99)<<",";
+    PROF<<1e6*T.max<<endl;
+  }
+  PROF.close();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Disables profiler and releases memory
+//
+void CProfiler::Destroy()
+{
+  _enabled=false;
+  delete [] _aTimers; _aTimers=NULL;
+  _nTimers=0;
+}
@@ -0,0 +1,111 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2023 the Raven Development Team
+  ----------------------------------------------------------------
+  Class CProfiler
+  Class CProfileScope
+  ----------------------------------------------------------------*/
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "RavenInclude.h"
+#include <chrono>
+
+class CModel;  // defined in Model.h
+
+////////////////////////////////////////////////////////////////////
+/// \brief Timed stages of the simulation loop
+/// \details hydrologic process j is timed by timer NUM_PROFILE_STAGES+j
+//
+enum profile_stage
+{
+  PROF_PARSE,               ///< ParseInputFiles (recorded once, before profiler initialization)
+  PROF_INITIALIZE,          ///< model initialization, initial conditions and .rvm parsing (recorded once)
+  PROF_TRANSIENT_PARAMS,    ///< CModel::UpdateTransientParams
+  PROF_DERIVED_PARAMS,      ///< CModel::RecalculateHRUDerivedParams
+  PROF_ENSEMBLE_OPS,        ///< CEnsemble::StartTimeStepOps/CloseTimeStepOps
+  PROF_FORCINGS,            ///< CModel::UpdateHRUForcingFunctions
+  PROF_ASSIMILATION,        ///< CModel::PrepareAssimilation
+  PROF_SIMPLE_OUTPUT,       ///< CModel::WriteSimpleOutput
+  PROF_EXTERNAL,            ///< CallExternalScript, ParseLiveFile, control channel and plugin callbacks
+  PROF_MASS_ENERGY_BALANCE, ///< MassEnergyBalance (total)
+  PROF_HRU_PROCESSES,       ///< MassEnergyBalance: vertical (HRU) processes
+  PROF_LATERAL_PROCESSES,   ///< MassEnergyBalance: lateral exchange processes
+  PROF_GROUNDWATER,         ///< MassEnergyBalance: groundwater solver
+  PROF_DEMAND_OPTIMIZATION, ///< MassEnergyBalance: management optimization
+  PROF_ROUTING,             ///< MassEnergyBalance: channel routing (including reservoirs)
+  PROF_RESERVOIRS,          ///< MassEnergyBalance: reservoir routing
+  PROF_TRANSPORT,           ///< MassEnergyBalance: constituent routing
+  PROF_CUMUL_BALANCE,       ///< CModel::IncrementCumulInput/IncrementCumOutflow
+  PROF_MINOR_OUTPUT,        ///< CModel::WriteMinorOutput and WriteProgressOutput
+  PROF_DIAGNOSTICS,         ///< CModel::UpdateDiagnostics
+  PROF_MAJOR_OUTPUT,        ///< end-of-simulation diagnostics and output
+  NUM_PROFILE_STAGES
+};
+
+const int PROF_HIST_BINS=160; ///< number of logarithmic histogram bins per timer (4 per factor of two, from 1e-8 s)
+
+////////////////////////////////////////////////////////////////////
+/// \brief Accumulated timing information for a single profiler timer
+//
+struct prof_timer
+{
+  string    name;                   ///< timer name (nested timers named parent:child)
+  long long nCalls;                 ///< number of timed calls
+  double    total;                  ///< total wall time [s]
+  double    max;                    ///< maximum wall time of single call [s]
+  long long hist[PROF_HIST_BINS];   ///< histogram of call durations (for percentiles)
+};
+
+////////////////////////////////////////////////////////////////////
+/// \brief Low-overhead run-time profiler of the simulation loop
+/// \details enabled with :Profiling command in .rvi file; writes Raven_profile.csv at end of simulation
+/// with wall time, call counts and call duration percentiles of each stage and hydrologic process
+//
+class CProfiler
+{
+private:/*------------------------------------------------------*/
+  static bool        _enabled;   ///< true if profiling is on
+  static int         _nTimers;   ///< number of timers (NUM_PROFILE_STAGES+number of processes)
+  static prof_timer *_aTimers;   ///< array of timers [size: _nTimers]
+  static double      _start;     ///< wall time at start of profiling [s]
+
+  static double      Percentile(const prof_timer &T, const double &pct);
+
+public:/*-------------------------------------------------------*/
+  static void        Initialize (const CModel *pModel);
+  static void        WriteReport(const optStruct &Options);
+  static void        Destroy    ();
+
+  static inline bool   IsEnabled() { return _enabled; }
+  static inline double Now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+  static void        AddSample  (const int timer, const double &dt);
+
+  /// start/stop pair for timing code sections not suited to a CProfileScope
+  static inline double Start() { return (_enabled) ? Now() : 0.0; }
+  static inline void   Stop (const int timer, const double &start) { if (_enabled){AddSample(timer,Now()-start);} }
+};
+
+////////////////////////////////////////////////////////////////////
+/// \brief Scoped timer: adds elapsed wall time between construction and destruction to profiler timer
+/// \details does nothing (beyond a flag check) if profiling is disabled
+//
+class CProfileScope
+{
+private:/*------------------------------------------------------*/
+  int    _timer;  ///< index of profiler timer
+  double _start;  ///< wall time at construction [s]
+
+public:/*-------------------------------------------------------*/
+  CProfileScope(const int timer) {
+    _timer=timer;
+    _start=(CProfiler::IsEnabled()) ? CProfiler::Now() : 0.0;
+  }
+  ~CProfileScope() {
+    if (CProfiler::IsEnabled()){CProfiler::AddSample(_timer,CProfiler::Now()-_start);}
+  }
+};
+
+#endif
@@ -445,10 +445,9 @@ struct param_override
 
   int     nVals;
   double *aValues;
-  double *aRevertValues;
 
   bool   *aHRUIsOverridden;
-  double *pxAddress;
+  long    offset;            ///< byte offset of overridden value within global_struct (global parameters only)
 
   param_override()  /* Constructor */
   {
@@ -457,14 +456,12 @@ struct param_override
 
     nVals=0;
     aValues=NULL;
-    aRevertValues=NULL;
     aHRUIsOverridden=NULL;
-    pxAddress=NULL;
+    offset=0;
   }
   ~param_override() /* Destructor */
   {
     delete [] aValues;
-    delete [] aRevertValues;
     delete [] aHRUIsOverridden;
   }
 };
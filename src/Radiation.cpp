@@ -48,11 +48,20 @@ double CRadiation::EstimateShortwaveRadiation(CModel* pModel,
     double solar_noon=pHRU->GetSolarNoon();
     double aspect    =pHRU->GetAspect();
 
-    double SWrad= ClearSkySolarRadiation(tt.julian_day, Options->timestep,
-                                         latrad, lateq, slope, aspect,
-                                         F->day_angle, F->day_length,
-                                         solar_noon, dew_pt, ET_rad, ET_rad_flat,
-                                         (Options->timestep >= 1.0));
+    double SWrad;
+
+    //use terms shared by all HRUs with this terrain signature, if calculated for this time step and day
+    const clear_sky_terms *pCS=pModel->GetClearSkyTerms(pHRU->GetGlobalIndex(),tt.model_time);
+    if ((pCS!=NULL) && (pCS->day_angle==F->day_angle) && (pCS->day_length==F->day_length)){
+      SWrad=ClearSkyFromTerms(*pCS,dew_pt,ET_rad,ET_rad_flat);
+    }
+    else{
+      SWrad=ClearSkySolarRadiation(tt.julian_day, Options->timestep,
+                                   latrad, lateq, slope, aspect,
+                                   F->day_angle, F->day_length,
+                                   solar_noon, dew_pt, ET_rad, ET_rad_flat,
+                                   (Options->timestep >= 1.0));
+    }
     if (Options->SW_radiation==SW_RAD_DATA){return F->SW_radia;} //ensures ET_rad still calculated!
     else                                   {return SWrad;}
 
@@ -67,8 +76,8 @@ double CRadiation::EstimateShortwaveRadiation(CModel* pModel,
     ET_rad_flat=ET_rad;
     double orient=1.0-fabs(pHRU->GetAspect()/PI-1.0);        //=0 for north, 1.0 for south
     if(pHRU->GetLatRad()<0.0) { orient=1.0-orient; }//southern hemisphere phase shift
-    double shortwave_corr_S = InterpolateMo(pModel->GetGlobalParams()->GetParams()->UBC_s_corr, tt, *Options);
-    double shortwave_corr_N = InterpolateMo(pModel->GetGlobalParams()->GetParams()->UBC_n_corr, tt, *Options);
+    double shortwave_corr_S = InterpolateMo(pHRU->GetGlobalParams()->UBC_s_corr, tt, *Options);
+    double shortwave_corr_N = InterpolateMo(pHRU->GetGlobalParams()->UBC_n_corr, tt, *Options);
     double shortwave_corr=((orient)* shortwave_corr_S + (1.0-orient)*shortwave_corr_N);
     ET_rad*=shortwave_corr;
     return solar_rad * shortwave_corr;
@@ -235,7 +244,7 @@ double CRadiation::EstimateLongwaveRadiation(const int iSnow,
     double cloud=F->cloud_cover;
     double LW_open=(1-cloud)*(-20+0.94*F->temp_daily_ave)+(cloud)*(1.24*F->temp_daily_min);//[mm/d]
 
-    double P0BLUE = pModel->GetGlobalParams()->GetParams()->UBC_LW_forest_fact;//actually P0BLUE * P0LWVF , [mm/d/K]
+    double P0BLUE = pHRU->GetGlobalParams()->UBC_LW_forest_fact;//actually P0BLUE * P0LWVF , [mm/d/K]
     double LW_forest=P0BLUE*F->temp_daily_ave; //[mm/d]
 
     double tmp=(LH_FUSION*DENSITY_WATER/MM_PER_METER); //[mm/d]-->[MJ/m2/d]
@@ -327,11 +336,13 @@ double CRadiation::EstimateLongwaveRadiation(const int iSnow,
 /// \is identical to  'cloud height' in Dingman (2008) Eq. 5-31.
 /// \param Options [in] global options structure
 /// \param F [in] forcings structure
+/// \param pHRU [in] pointer to HRU
 /// \param elev [in] elevation of HRU [masl]
 /// \return Double Cloud cover correction factor for shortwave radiation
 
 double CRadiation::SWCloudCoverCorrection(CModel* pModel,
                                           const force_struct *F,
+                                          const CHydroUnit *pHRU,
                                           const double &elev)
 {
   const optStruct *Options = pModel->GetOptStruct();
@@ -339,7 +350,7 @@ double CRadiation::SWCloudCoverCorrection(CModel* pModel,
   {
   case(SW_CLOUD_CORR_UBCWM):
   {
-    double POCAST = pModel->GetGlobalParams()->GetParams()->UBC_cloud_penet;
+    double POCAST = pHRU->GetGlobalParams()->UBC_cloud_penet;
     return 1.0 -(1.0 - POCAST) * F->cloud_cover;
   }
   case(SW_CLOUD_CORR_DINGMAN): // Dingman (2008) Eq. 5-30 (does not require parameters)
@@ -393,7 +404,7 @@ double CRadiation::SWCanopyCorrection(CModel *pModel,
   case(SW_CANOPY_CORR_UBCWM):  // A simple factor that switches on when forest cover is greater than zero
   {
     double shortwave_corr = 1.0;
-    double UBC_correction_fact = pModel->GetGlobalParams()->GetParams()->UBC_exposure_fact; //Sun exposure factor of forested areas
+    double UBC_correction_fact = pHRU->GetGlobalParams()->UBC_exposure_fact; //Sun exposure factor of forested areas
     shortwave_corr*=((Fc)*UBC_correction_fact+(1.0-Fc)*1.0);
     return shortwave_corr;
   }
@@ -1003,11 +1014,35 @@ double CRadiation::ClearSkySolarRadiation(const double &julian_day,
                                                 double &ET_radia_flat, //ET radiation on flat ground [MJ/m2/d]
                                           const bool    avg_daily) //true if average daily is to be computed
 {
-  double Ket,Ketp;          //daily solar radiation with (Ket) and without (Ketp) slope correction, [MJ/m2/d]
-  double tau;               //total atmospheric transmissivity [-]
-  double tau2;              //50% of solar beam attenuation from vapor and dust [-]
-  double Mopt;              //optical air mass [-]
-  double gamma_dust=0.025;  //attenuation due to dust
+  clear_sky_terms T;
+  ClearSkyTerms(julian_day,tstep,latrad,slope,aspect,day_angle,day_length,avg_daily,T);
+  return ClearSkyFromTerms(T,dew_pt,ET_radia,ET_radia_flat);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Calculates the dew point-independent terms of clear sky radiation (ET radiation and optical air mass)
+/// \details these depend only upon the terrain signature (latitude, slope, aspect) and time, so may be shared by all HRUs with the same signature
+///
+/// \param julian_day [in] Julian day of year (with fractional day)
+/// \param tstep [in] time step [d]
+/// \param latrad [in] latitude [rad]
+/// \param slope [in] slope [rad]
+/// \param aspect [in] aspect [rad from north]
+/// \param day_angle [in] Day angle [rad]
+/// \param day_length [in] Day length [days]
+/// \param avg_daily [in] True if average daily total incident radiation is to be computed instead
+/// \param T [out] clear sky radiation terms
+//
+void CRadiation::ClearSkyTerms(const double &julian_day,
+                               const double &tstep,
+                               const double &latrad,    //[rad]
+                               const double &slope,     //[rad]
+                               const double &aspect,    //[rad]
+                               const double &day_angle,
+                               const double &day_length,
+                               const bool    avg_daily,
+                               clear_sky_terms &T)
+{
   double declin;            //solar declination
   double ecc;               //eccentricity correction [-]
   double t_sol,t_sol2;      //time of day w.r.t. solar noon (start & end of timestep) [d]
@@ -1018,15 +1053,73 @@ double CRadiation::ClearSkySolarRadiation(const double &julian_day,
   t_sol=julian_day-floor(julian_day)-0.5;
   t_sol2=t_sol+tstep;
 
-  Mopt =OpticalAirMass(latrad,declin,day_length,t_sol,avg_daily);
-  tau  =CalcScatteringTransmissivity(dew_pt,Mopt)-gamma_dust;               //Dingman E-9
-  tau2 =0.5*(1.0-CalcDiffScatteringTransmissivity(dew_pt,Mopt)+gamma_dust); //Dingman E-15
-
   //Ketp =CalcETRadiation(latrad,lateq ,declin,ecc,slope,solar_noon,day_length,t_sol,avg_daily); //old dingman approach
   //Ket  =CalcETRadiation(latrad,latrad,declin,ecc,0.0  ,0.0,       day_length,t_sol,avg_daily);
 
-  Ketp =CalcETRadiation2(latrad,aspect,declin,ecc,slope,t_sol,t_sol2,avg_daily);
-  Ket  =CalcETRadiation2(latrad,aspect,declin,ecc,0.0  ,t_sol,t_sol2,avg_daily);
+  T.day_angle   =day_angle;
+  T.day_length  =day_length;
+  T.opt_air_mass=OpticalAirMass(latrad,declin,day_length,t_sol,avg_daily);
+  T.ET_rad      =CalcETRadiation2(latrad,aspect,declin,ecc,slope,t_sol,t_sol2,avg_daily);
+  T.ET_rad_flat =CalcETRadiation2(latrad,aspect,declin,ecc,0.0  ,t_sol,t_sol2,avg_daily);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Calculates clear sky radiation terms for an array of N terrain signatures over the same time step
+/// \details declination, eccentricity and solar time are evaluated once for all signatures
+///
+/// \param N [in] number of terrain signatures
+/// \param aLatRad, aSlope, aAspect [in] latitude, slope, and aspect of each signature [rad]
+/// \param aDayLength [in] day length of each signature [d]
+/// \param aTerms [out] clear sky radiation terms of each signature [size: N]
+//
+void CRadiation::ClearSkyTermsBatch(const int     N,
+                                    const double &julian_day,
+                                    const double &tstep,
+                                    const double &day_angle,
+                                    const double *aLatRad,
+                                    const double *aSlope,
+                                    const double *aAspect,
+                                    const double *aDayLength,
+                                    const bool    avg_daily,
+                                    clear_sky_terms *aTerms)
+{
+  double declin= SolarDeclination(day_angle);
+  double ecc   = EccentricityCorr(day_angle);
+  double t_sol = julian_day-floor(julian_day)-0.5;
+  double t_sol2= t_sol+tstep;
+
+  for (int s=0;s<N;s++)
+  {
+    aTerms[s].day_angle   =day_angle;
+    aTerms[s].day_length  =aDayLength[s];
+    aTerms[s].opt_air_mass=OpticalAirMass(aLatRad[s],declin,aDayLength[s],t_sol,avg_daily);
+    aTerms[s].ET_rad      =CalcETRadiation2(aLatRad[s],aAspect[s],declin,ecc,aSlope[s],t_sol,t_sol2,avg_daily);
+    aTerms[s].ET_rad_flat =CalcETRadiation2(aLatRad[s],aAspect[s],declin,ecc,0.0      ,t_sol,t_sol2,avg_daily);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Combines precomputed clear sky radiation terms with dew point to estimate clear sky solar radiation
+///
+/// \param T [in] clear sky radiation terms (from ClearSkyTerms())
+/// \param dew_pt [in] Dew point temperature [C]
+/// \param ET_radia [out] ET radiation on slope [MJ/m2/d]
+/// \param ET_radia_flat [out] ET radiation on flat ground [MJ/m2/d]
+/// \return Double clear sky solar radiation [MJ/m2/d]
+//
+double CRadiation::ClearSkyFromTerms(const clear_sky_terms &T,
+                                     const double &dew_pt,
+                                           double &ET_radia,
+                                           double &ET_radia_flat)
+{
+  double tau;               //total atmospheric transmissivity [-]
+  double tau2;              //50% of solar beam attenuation from vapor and dust [-]
+  double gamma_dust=0.025;  //attenuation due to dust
+  double Ketp=T.ET_rad;     //daily solar radiation with slope correction, [MJ/m2/d]
+  double Ket =T.ET_rad_flat;//daily solar radiation without slope correction, [MJ/m2/d]
+
+  tau  =CalcScatteringTransmissivity(dew_pt,T.opt_air_mass)-gamma_dust;               //Dingman E-9
+  tau2 =0.5*(1.0-CalcDiffScatteringTransmissivity(dew_pt,T.opt_air_mass)+gamma_dust); //Dingman E-15
 
   ET_radia=Ketp;
   ET_radia_flat=Ket;
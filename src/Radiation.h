@@ -11,6 +11,18 @@
 
 class CModel;  // defined in Model.h
 
+///////////////////////////////////////////////////////////////////
+/// \brief Dew point-independent clear sky radiation terms for one terrain signature (latitude, slope, aspect) over one time step
+//
+struct clear_sky_terms
+{
+  double day_angle;     ///< day angle used in calculation [rad]
+  double day_length;    ///< day length used in calculation [d]
+  double ET_rad;        ///< extraterrestrial radiation on slope [MJ/m2/d]
+  double ET_rad_flat;   ///< extraterrestrial radiation on flat ground [MJ/m2/d]
+  double opt_air_mass;  ///< optical air mass [-]
+};
+
 ///////////////////////////////////////////////////////////////////
 /// \brief Utility class for radiation calculations
 //
@@ -87,6 +99,29 @@ public:/*------------------------------------------------------*/
                                            double &ET_radia,			  //ET radiation [MJ/m2/d]
                                            double &ET_radia_flat, //ET radiation without slope correction [MJ/m2/d]
                                            const bool   avg_daily);	//true if average daily is to be computed
+  static void   ClearSkyTerms             (const double &julian_day,
+                                           const double &tstep,
+                                           const double &latrad,			//[rad]
+                                           const double &slope,			//[rad]
+                                           const double &aspect,     //[rad]
+                                           const double &day_angle,
+                                           const double &day_length,
+                                           const bool    avg_daily,
+                                           clear_sky_terms &T);
+  static void   ClearSkyTermsBatch        (const int     N,          //number of terrain signatures
+                                           const double &julian_day,
+                                           const double &tstep,
+                                           const double &day_angle,
+                                           const double *aLatRad,    //[rad] [size: N]
+                                           const double *aSlope,     //[rad] [size: N]
+                                           const double *aAspect,    //[rad] [size: N]
+                                           const double *aDayLength, //[d]   [size: N]
+                                           const bool    avg_daily,
+                                           clear_sky_terms *aTerms); //[out] [size: N]
+  static double ClearSkyFromTerms         (const clear_sky_terms &T,
+                                           const double &dew_pt,			//dew point temp, [C]
+                                           double &ET_radia,			  //ET radiation [MJ/m2/d]
+                                           double &ET_radia_flat);  //ET radiation without slope correction [MJ/m2/d]
   static double EstimateShortwaveRadiation(CModel* pModel,
                                            const force_struct *F,
                                            const CHydroUnit *pHRU,
@@ -95,6 +130,7 @@ public:/*------------------------------------------------------*/
 
   static double SWCloudCoverCorrection    (CModel* pModel,
                                            const force_struct *F,
+                                           const CHydroUnit *pHRU,
                                            const double &elev);
 
   static double SWCanopyCorrection        (CModel* pModel,
@@ -19,6 +19,9 @@
 #ifndef _LPSOLVE_
 //#define _LPSOLVE_       // uncomment if compiling lpsolve Demand Optimization version of Raven
 #endif
+#ifndef _ZLIB_
+//#define _ZLIB_          // uncomment if compiling with zlib (compressed binary checkpoints)
+#endif
 #define STANDALONE
 #ifdef netcdf
 #define _RVNETCDF_      // if Makefile is used this will be automatically be uncommented if netCDF library is available
@@ -333,6 +336,7 @@ const int     MAX_STATE_VAR_TYPES =100;         ///< Max number of *types* of st
 const int     MAX_STATE_VARS      =500;         ///< Max number of simulated state variables manipulable by one process (CAdvection worst offender)
 const int     MAX_CONNECTIONS     =650;         ///< Max number of to/from connections in any single process (CAdvection worst offender)
 const int     MAX_LAT_CONNECTIONS =4000;        ///< Max number of lateral HRU flow connections
+const int     PROCESS_BATCH_SIZE  =64;          ///< Max number of HRUs in a block for batched process rate evaluation
 const int     MAX_SOIL_PROFILES   =200;         ///< Max number of soil profiles
 const int     MAX_VEG_CLASSES     =200;         ///< Max number of vegetation classes
 const int     MAX_LULT_CLASSES    =200;         ///< Max number of lult classes
@@ -354,7 +358,8 @@ enum numerical_method
 {
   EULER,              ///< Euler's method
   ORDERED_SERIES,     ///< Conventional WB model method - processes in series
-  ITERATED_HEUN       ///< 2nd Order Convergence Method
+  ITERATED_HEUN,      ///< 2nd Order Convergence Method
+  IMPLICIT_EULER      ///< Backward Euler with Newton iteration (for stiff systems)
 };
 
 ///////////////////////////////////////////////////////////////////
@@ -804,6 +809,15 @@ enum out_format
   OUTPUT_NETCDF,         ///< Output in NetCDF format (.nc files)
   OUTPUT_NONE            ///< Output is suppressed
 };
+////////////////////////////////////////////////////////////////////
+/// \brief Format of model state (solution and :OutputDump) files
+//
+enum state_format
+{
+  STATE_RVC,             ///< Text initial conditions format (.rvc files)
+  STATE_RVB,             ///< Binary checkpoint format (.rvb files)
+  STATE_RVC_AND_RVB      ///< Both text and binary formats
+};
 
 ////////////////////////////////////////////////////////////////////
 /// \brief reservoir constraint conditions
@@ -1041,10 +1055,16 @@ struct optStruct
   numerical_method sol_method;                ///< numerical solution method
   double           convergence_crit;          ///< convergence criteria
   double           max_iterations;            ///< maximum number of iterations for iterative solver method
+  double           substep_tolerance;         ///< local error tolerance for adaptive HRU sub-stepping [mm] (0.0 if not sub-stepped)
+  int              max_substeps;              ///< maximum number of adaptive sub-steps per HRU per time step
   double           timestep;                  ///< numerical method timestep (in days)
   double           output_interval;           ///< write to output file every x number of timesteps
   ensemble_type    ensemble;                  ///< ensemble type (or ENSEMBLE_NONE if single model)
   string           external_script;           ///< call to external script/.exe once per timestep (or "" if none)
+  string           plugin_filename;           ///< shared library plugin receiving timestep callbacks (or "" if none)
+  string           plugin_args;               ///< argument string passed to plugin initialization routine
+  string           control_channel;           ///< path of control channel socket (or "" if none)
+  double           control_status_interval;   ///< interval between control channel status messages [d] (default: every timestep)
   double           rvl_read_frequency;        ///< frequency to read rvl file (in d, or 0.0 if not to be read)
   bool             use_stopfile;              ///< true if Raven should look for stopfile
 
@@ -1054,6 +1074,8 @@ struct optStruct
 
   interp_method    interpolation;             ///< Method for interpolating Met Station/Gauge data to HRUs
   string           interp_file;               ///< name of file (in working directory) which stores interpolation weights
+  int              interp_max_gauges;         ///< maximum number of nearest gauges used in inverse distance interpolation (DOESNT_EXIST=all)
+  double           interp_search_radius;      ///< [m] search radius for gauges used in inverse distance interpolation (ALMOST_INF=unlimited)
 
   string           run_name;                  ///< prefix to be used for all output files
   char             run_mode;                  ///< run mode - single character used to enable multiple model configs with if statements (default==' ')
@@ -1150,6 +1172,13 @@ struct optStruct
   bool             write_localflow;           ///< true if local flows are written to Hydrographs file (csv or nc)
   bool             write_netresinflow;        ///< true if reservoir net inflows are written to Hydrographs file (csv or nc)
   bool             benchmarking;              ///< true if benchmarking output - removes version/timestamps in output
+  bool             use_input_cache;           ///< true if parsed time series data blocks are stored in/read from binary .rvcache files
+  bool             profiling;                 ///< true if run-time profile of simulation loop is written to Raven_profile.csv
+  state_format     state_file_format;         ///< format of solution and :OutputDump state files (default: STATE_RVC)
+  double           checkpoint_interval;       ///< interval between periodic binary checkpoints [d] (0 if none)
+  bool             compress_checkpoints;      ///< true if binary checkpoints are compressed (requires zlib)
+  string           resume_filename;           ///< fully qualified filename of binary checkpoint from which simulation resumes ("" if none)
+  bool             resample_on_demand;        ///< true if forcing time series are resampled to model time step in windows as needed rather than stored for entire simulation
   bool             suppressICs;               ///< true if initial conditions are suppressed when writing output time series
   bool             period_ending;             ///< true if period ending convention should be used for reading/writing Ensim files
   bool             period_starting;           ///< true if all timestep-averaged output is reported using starttime of timestep
@@ -1157,6 +1186,8 @@ struct optStruct
   string           working_dir;               ///< working directory
   int              wateryr_mo;                ///< starting month of water year (typically 10=October)
   bool             create_rvp_template;       ///< create an rvp template file after reading the .rvi
+  bool             micro_benchmark;           ///< true if kernel micro-benchmarks are run after model initialization (-mb executable flag)
+  bool             unit_testing;              ///< true if model-based unit tests are run after model initialization (-ut executable flag)
 
   // Diagnostic options
   double           diag_start_time;           ///< Model time to start diagnostics
@@ -1620,6 +1651,7 @@ void     WriteWarning           (const string warn, bool noisy);
 void     WriteAdvisory          (const string warn, bool noisy);
 HRU_type StringToHRUType        (const string s);
 double   fast_s_to_d            (const char *s);
+double   fast_s_to_d            (const char *s, const char **end);
 double   FormatDouble           (const double &d);
 void     SubstringReplace       (string& str,const string& from,const string& to);
 
@@ -1716,13 +1748,14 @@ double TemperatureEnthalpyDerivative         (const double &hv);
 //Snow Functions---------------------------------------------------
 //defined in SnowParams.cpp and PotentialMelt.cpp
 class CModelABC;  // defined in ModelABC.h
+class CHydroUnit; // defined in HydroUnits.h
 double CalcFreshSnowDensity       (const double &air_temp);
 double GetSnowThermCond           (const double &snow_dens);
 double GetSensibleHeatSnow        (const double &air_temp,const double &surf_temp,const double &V, const double &ref_ht, const double &rough);
 double GetLatentHeatSnow          (const double &P,const double &air_temp,const double &surf_temp,const double &rel_humid,const double &V,const double &ref_ht,const double &rough);
 double GetRainHeatInput           (const double &surf_temp, const double &air_temp,const double &rain_rate,const double &rel_humid);
 double GetSnowDensity             (const double &snowSWE,const double &snow_depth);
-double CalculateSnowLiquidCapacity(const double &SWE, const double &snow_depth, const CModelABC* pModel);
+double CalculateSnowLiquidCapacity(const double &SWE, const double &snow_depth, const CHydroUnit* pHRU);
 
 //Crop Functions---------------------------------------------------
 bool   IsGrowingSeason            (const time_struct &tt, const double &CHU);
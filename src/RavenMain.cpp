@@ -6,6 +6,9 @@
 #include "RavenInclude.h"
 #include "RavenMain.h"
 #include "Model.h"
+#include "Profiler.h"
+#include "PluginHost.h"
+#include "ControlChannel.h"
 #include "UnitTesting.h"
 #ifdef STANDALONE
     #include "GracefulEndStandalone.h"
@@ -78,10 +81,12 @@ int main(int argc, char* argv[])
   WARNINGS.close();
 
   t0=clock();
+  double wall_start=CProfiler::Now();
 
   //Read input files, create model, set model options
   if (!ParseInputFiles(pModel, Options)){
     ExitGracefully("Main::Unable to read input file(s)",BAD_DATA);}
+  double wall_parsed=CProfiler::Now();
 
   CheckForErrorWarnings(true, pModel);
 
@@ -102,8 +107,24 @@ int main(int argc, char* argv[])
       ExitGracefully("Cannot find or read .rvm file",BAD_DATA);}}
   pModel->InitializePostRVM(Options);
 
+  //Binary checkpoint (.rvb) - overrides initial conditions
+  //--------------------------------------------------------------------------------
+  double t_resume=0.0;
+  if(Options.resume_filename!="") {
+    ExitGracefullyIf(pModel->GetEnsemble()->GetNumMembers()>1,
+      "Main: :ResumeFromCheckpoint cannot be used with ensemble simulations",BAD_DATA);
+    t_resume=pModel->ReadCheckpoint(Options.resume_filename,Options);
+  }
+
   CheckForErrorWarnings(false, pModel);
 
+  if (Options.micro_benchmark){RavenMicroBenchmarks(pModel,Options);}
+  if (Options.unit_testing   ){RavenModelUnitTesting(pModel,Options);}
+
+  CPluginHost::Load(pModel,Options);
+  CControlChannel::Open(Options);
+  double wall_initialized=CProfiler::Now();
+
   nEnsembleMembers=pModel->GetEnsemble()->GetNumMembers();
 
   for(int e=0;e<nEnsembleMembers; e++) //only run once in standard mode
@@ -120,7 +141,7 @@ int main(int argc, char* argv[])
     }
 
     double t_start=0.0;
-    t_start=pModel->GetEnsemble()->GetStartTime(e);
+    t_start=max(pModel->GetEnsemble()->GetStartTime(e),t_resume);
 
     //Write initial conditions-------------------------------------
     JulianConvert(t_start,Options.julian_start_day,Options.julian_start_year,Options.calendar,tt);
@@ -130,40 +151,56 @@ int main(int argc, char* argv[])
     pModel->WriteMinorOutput           (Options,tt);
 
     //Solve water/energy balance over time--------------------------------
+    if (Options.profiling){
+      CProfiler::Initialize(pModel);
+      if (e==0){
+        CProfiler::AddSample(PROF_PARSE     ,wall_parsed     -wall_start);
+        CProfiler::AddSample(PROF_INITIALIZE,wall_initialized-wall_parsed);
+      }
+    }
     t1=clock();
     int step=0;
 
     for(t=t_start; t<Options.duration-TIME_CORRECTION; t+=Options.timestep)  // in [d]
     {
-      pModel->UpdateTransientParams      (Options,tt);
-      pModel->RecalculateHRUDerivedParams(Options,tt);
-      pModel->GetEnsemble()->StartTimeStepOps(pModel,Options,tt,e);
-      pModel->UpdateHRUForcingFunctions  (Options,tt);
-      pModel->PrepareAssimilation        (Options,tt);
-      pModel->WriteSimpleOutput          (Options,tt);
-      CallExternalScript                 (Options,tt);
-      ParseLiveFile                      (pModel,Options,tt);
-
-      MassEnergyBalance(pModel,Options,tt); //where the magic happens!
-
-      pModel->IncrementCumulInput        (Options,tt);
-      pModel->IncrementCumOutflow        (Options,tt);
+      {CProfileScope P(PROF_TRANSIENT_PARAMS); pModel->UpdateTransientParams      (Options,tt);}
+      {CProfileScope P(PROF_DERIVED_PARAMS);   pModel->RecalculateHRUDerivedParams(Options,tt);}
+      {CProfileScope P(PROF_ENSEMBLE_OPS);     pModel->GetEnsemble()->StartTimeStepOps(pModel,Options,tt,e);}
+      {CProfileScope P(PROF_FORCINGS);         pModel->UpdateHRUForcingFunctions  (Options,tt);}
+      {CProfileScope P(PROF_ASSIMILATION);     pModel->PrepareAssimilation        (Options,tt);}
+      {CProfileScope P(PROF_SIMPLE_OUTPUT);    pModel->WriteSimpleOutput          (Options,tt);}
+      {CProfileScope P(PROF_EXTERNAL);         CallExternalScript                 (Options,tt);
+                                               ParseLiveFile                      (pModel,Options,tt);
+                                               CControlChannel::ProcessCommands   (pModel,Options,tt,step);
+                                               CPluginHost::StartTimeStep         (Options,tt);}
+
+      {CProfileScope P(PROF_MASS_ENERGY_BALANCE); MassEnergyBalance(pModel,Options,tt);} //where the magic happens!
+
+      {CProfileScope P(PROF_CUMUL_BALANCE);    pModel->IncrementCumulInput        (Options,tt);
+                                               pModel->IncrementCumOutflow        (Options,tt);}
 
       JulianConvert(t+Options.timestep,Options.julian_start_day,Options.julian_start_year,Options.calendar,tt);//increments time structure
-      pModel->WriteMinorOutput           (Options,tt);
-      pModel->WriteProgressOutput        (Options,clock()-t1,step,(int)ceil(Options.duration/Options.timestep));
-      pModel->UpdateDiagnostics          (Options,tt); //required to read stuff!!
-      pModel->GetEnsemble()->CloseTimeStepOps(pModel,Options,tt,e);
+      {CProfileScope P(PROF_EXTERNAL);         CPluginHost::EndTimeStep           (Options,tt);}
+      {CProfileScope P(PROF_MINOR_OUTPUT);     pModel->WriteMinorOutput           (Options,tt);
+                                               pModel->WriteProgressOutput        (Options,clock()-t1,step,(int)ceil(Options.duration/Options.timestep));}
+      {CProfileScope P(PROF_DIAGNOSTICS);      pModel->UpdateDiagnostics          (Options,tt);} //required to read stuff!!
+      {CProfileScope P(PROF_EXTERNAL);         CControlChannel::SendStatus        (pModel,Options,tt,step+1);}
+      {CProfileScope P(PROF_ENSEMBLE_OPS);     pModel->GetEnsemble()->CloseTimeStepOps(pModel,Options,tt,e);}
 
       if ((Options.use_stopfile) && (CheckForStopfile(step, tt, pModel))) { break; }
       step++;
     }
 
     //Finished Solving----------------------------------------------------
-    pModel->UpdateDiagnostics (Options,tt);
-    pModel->RunDiagnostics    (Options);
-    pModel->WriteMajorOutput  (Options,tt,"solution",true);
-    pModel->CloseOutputStreams();
+    {
+      CProfileScope P(PROF_MAJOR_OUTPUT);
+      pModel->UpdateDiagnostics (Options,tt);
+      pModel->RunDiagnostics    (Options);
+      pModel->WriteMajorOutput  (Options,tt,"solution",true);
+      pModel->CloseOutputStreams();
+    }
+    CProfiler::WriteReport(Options);
+    CProfiler::Destroy();
 
     if(!Options.silent)
     {
@@ -178,11 +215,17 @@ int main(int argc, char* argv[])
     }
     if (Options.benchmarking) {
       cout <<"                              "<< pModel->GetNumHRUs()*(Options.duration/Options.timestep)/(float(clock()-t1)/CLOCKS_PER_SEC)<<" HRU-time steps/second"<<endl;
+      long long nClassCalcs,nHRUUpdates;
+      pModel->GetDerivedParamStats(nClassCalcs,nHRUUpdates);
+      cout <<"                              "<< nClassCalcs<<" canopy parameter calculations shared by "<<nHRUUpdates<<" HRU updates"<<endl;
+      cout <<"                              "<< pModel->GetNumTerrainSignatures()<<" unique terrain signatures for radiation in "<<pModel->GetNumHRUs()<<" HRUs"<<endl;
     }
 
     pModel->GetEnsemble()->FinishEnsembleRun(pModel,Options,tt,e);
   }/* end ensemble loop*/
 
+  CPluginHost::Finalize();
+  CControlChannel::Close();
 
   ExitGracefully("Successful Simulation",SIMULATION_DONE);
   return 0;
@@ -222,6 +265,8 @@ void ProcessExecutableArguments(int argc, char* argv[], optStruct   &Options)
   Options.forecast_shift=0.0;
   Options.warm_ensemble_run="";
   Options.in_bmi_mode = false;  // "regular mode": Raven called from command line
+  Options.micro_benchmark=false;
+  Options.unit_testing=false;
 
   //Parse argument list
   while (i<=argc)
@@ -231,7 +276,7 @@ void ProcessExecutableArguments(int argc, char* argv[], optStruct   &Options)
     }
     if ((word=="-p") || (word=="-h") || (word=="-t") || (word=="-e") || (word=="-c") || (word=="-o") ||
         (word=="-s") || (word=="-r") || (word=="-n") || (word=="-l") || (word=="-m") || (word=="-v") ||
-        (word=="-we")|| (word=="-tt")|| (word=="-template") || (i==argc))
+        (word=="-we")|| (word=="-tt")|| (word=="-template") || (word=="-mb") || (word=="-ut") || (i==argc))
     {
       if      (mode==0){
         Options.rvi_filename=argument+".rvi";
@@ -259,6 +304,8 @@ void ProcessExecutableArguments(int argc, char* argv[], optStruct   &Options)
       else if (mode==12){Options.forecast_shift=s_to_d(argument.c_str()); argument=""; }
       else if (mode==13){Options.warm_ensemble_run=argument; argument=""; }
       else if (mode==14){Options.create_rvp_template=true;   argument="";}
+      else if (mode==15){Options.micro_benchmark=true;       argument="";}
+      else if (mode==16){Options.unit_testing=true;          argument="";}
 
       if      (word=="-p"){mode=1; }
       else if (word=="-h"){mode=2; }
@@ -275,6 +322,8 @@ void ProcessExecutableArguments(int argc, char* argv[], optStruct   &Options)
       else if (word=="-tt"){mode=12; }
       else if (word=="-we"){mode=13; }
       else if (word=="-template"){mode=14;}
+      else if (word=="-mb"){mode=15;}
+      else if (word=="-ut"){mode=16;}
       else if (word=="-v"){Options.pause=false; version_announce=true; mode=10;} //For PAVICS
     }
     else{
@@ -369,6 +418,9 @@ bool CheckForStopfile(const int step, const time_struct &tt, CModel *pModel)
     STOP.close();
     pModel->WriteMajorOutput(tt, "solution", true);
     pModel->CloseOutputStreams();
+    WriteSolverStatistics(pModel,*(pModel->GetOptStruct()));
+    CPluginHost::Finalize();
+    CControlChannel::Close();
     ExitGracefully("CheckForStopfile: simulation interrupted by user using stopfile",SIMULATION_DONE);
     return true;
   }
@@ -14,7 +14,9 @@ bool ParseInitialConditions(CModel*& pModel, const optStruct &Options);
 
 //Defined in Solvers.cpp
 void MassEnergyBalance     (CModel *pModel,const optStruct   &Options, const time_struct &tt);
+void WriteSolverStatistics (const CModel *pModel,const optStruct &Options);
 void ParseLiveFile         (CModel*&pModel,const optStruct   &Options, const time_struct &tt);
+void ParseLiveCommands     (CModel*&pModel,const optStruct   &Options, istream &IN, const string source);
 
 //Local functions defined below main() in RavenMain.cpp
 void ProcessExecutableArguments(int argc, char* argv[], optStruct   &Options);
@@ -0,0 +1,98 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2025 the Raven Development Team
+  ----------------------------------------------------------------
+  Raven plugin interface (C ABI)
+
+  Plugins are shared libraries (.so/.dylib/.dll) loaded once at startup
+  using the .rvi command
+     :PluginLibrary [library filename] {plugin arguments}
+  which receive start- and end-of-timestep callbacks with read/write
+  access to model states, forcings and subbasin outflows. Plugins are
+  an in-process alternative to :CallExternalScript/.rvl live files.
+
+  This header is plain C and may be included from C or C++ plugin code.
+  A plugin must export (with C linkage):
+
+    int  RavenPluginInit         (const raven_host_api *api, const char *args); //required; return 0 on success
+    void RavenPluginStartTimeStep(const raven_time *t); //optional; called after forcings are updated, before the mass/energy balance
+    void RavenPluginEndTimeStep  (const raven_time *t); //optional; called after the mass/energy balance, before output is written
+    void RavenPluginFinalize     (void);                //optional; called once at end of simulation
+
+  The api pointer remains valid until RavenPluginFinalize returns. Indices
+  are zero-based (k: HRU, p: subbasin, i: state variable, f: forcing).
+  The raven_host_api table is append-only: new members are only ever added
+  to its end and RAVEN_PLUGIN_API_VERSION is incremented, so plugins built
+  against an older header keep working with newer Raven builds.
+  ----------------------------------------------------------------*/
+#ifndef RAVEN_PLUGIN_H
+#define RAVEN_PLUGIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RAVEN_PLUGIN_API_VERSION 1
+
+#if defined(_WIN32)
+#define RAVEN_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define RAVEN_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+/* model time at which callback is issued (start of time step for RavenPluginStartTimeStep, end for RavenPluginEndTimeStep) */
+typedef struct raven_time
+{
+  double      model_time;   /* [d] time elapsed since model start time */
+  double      julian_day;   /* [d] decimal day of year */
+  int         year;         /* year */
+  int         month;        /* [1..12] month of year */
+  int         day_of_month; /* day of month */
+  double      timestep;     /* [d] model time step */
+  const char *date_string;  /* date in yyyy-mm-dd format; valid only during callback */
+} raven_time;
+
+/* table of host functions; ctx must be passed as first argument of every call */
+typedef struct raven_host_api
+{
+  int         api_version;  /* RAVEN_PLUGIN_API_VERSION of Raven build */
+  int         struct_size;  /* sizeof(raven_host_api) in Raven build */
+  void       *ctx;          /* opaque host context */
+
+  int       (*GetNumHRUs)        (void *ctx);
+  int       (*GetNumSubBasins)   (void *ctx);
+  int       (*GetNumStateVars)   (void *ctx);
+
+  /* state variables [mm] or [MJ/m2] (or [mg/m2] for constituents); name as in .rvi, e.g., "SNOW" or "SOIL[1]"; returns -1 if not in model */
+  int       (*GetStateVarIndex)  (void *ctx, const char *name);
+  double    (*GetStateVar)       (void *ctx, int k, int i);
+  void      (*SetStateVar)       (void *ctx, int k, int i, double value); /* note: not tracked in mass balance */
+
+  /* HRU forcings; name as in :CustomOutput, e.g., "PRECIP" or "TEMP_AVE"; returns -1 if unrecognized */
+  int       (*GetForcingIndex)   (void *ctx, const char *name);
+  double    (*GetForcing)        (void *ctx, int k, int f);
+  void      (*SetForcing)        (void *ctx, int k, int f, double value); /* at start of time step, overrides forcing used in mass/energy balance */
+
+  /* subbasin outflow [m3/s] */
+  double    (*GetSubBasinOutflow)(void *ctx, int p);
+  void      (*SetSubBasinOutflow)(void *ctx, int p, double Q);
+
+  /* ID <-> index conversion; index functions return -1 if ID not in model */
+  long long (*GetHRUID)          (void *ctx, int k);
+  long long (*GetSubBasinID)     (void *ctx, int p);
+  int       (*GetHRUIndex)       (void *ctx, long long ID);
+  int       (*GetSubBasinIndex)  (void *ctx, long long ID);
+
+  /* writes message to Raven_errors.txt */
+  void      (*WriteWarning)      (void *ctx, const char *message);
+} raven_host_api;
+
+typedef int  (*raven_plugin_init_fn)    (const raven_host_api *api, const char *args);
+typedef void (*raven_plugin_step_fn)    (const raven_time *t);
+typedef void (*raven_plugin_finalize_fn)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
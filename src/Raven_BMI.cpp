@@ -440,9 +440,11 @@ void CRavenBMI::GetValue(std::string name, void* dest)
 
   if ((is_HRU_SV) && (iSV!=DOESNT_EXIST))
   {
+    const double *aSV=pModel->GetStateMatrix(); //HRU-major
+    int NS=pModel->GetNumStateVars();
     out=new double [pModel->GetNumHRUs()];
     for (k = 0; k < pModel->GetNumHRUs(); k++) {
-      out[k]=pModel->GetHydroUnit(k)->GetStateVarArray()[iSV];
+      out[k]=aSV[k*NS+iSV];
     }
     memcpy(dest,out,pModel->GetNumSubBasins()*sizeof(double));
     delete [] out;
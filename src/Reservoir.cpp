@@ -4,6 +4,7 @@
   ----------------------------------------------------------------*/
 #include "Reservoir.h"
 #include "Model.h"     // needed to define CModel
+#include "Checkpoint.h"
 
 //////////////////////////////////////////////////////////////////
 /// \brief Base Constructor for reservoir called by all other constructors
@@ -1799,6 +1800,50 @@ void CReservoir::WriteToSolutionFile (ofstream &RVC) const
   }
 }
 //////////////////////////////////////////////////////////////////
+/// \brief Writes reservoir state to binary checkpoint
+/// \param &C [out] checkpoint buffer
+//
+void CReservoir::WriteToCheckpoint(CCheckpoint &C) const
+{
+  C.PutDouble(_stage);
+  C.PutDouble(_stage_last);
+  C.PutDouble(_Qout);
+  C.PutDouble(_Qout_last);
+  C.PutDouble(_MB_losses);
+  C.PutDouble(_AET);
+  C.PutDouble(_Precip);
+  C.PutDouble(_GW_seepage);
+  C.PutDouble(_DAscale);
+  C.PutDouble(_DAscale_last);
+  C.PutDouble(_Qoptimized);
+  C.PutInt   (_dry_timesteps);
+  C.PutInt   ((int)(_constraint));
+  C.PutArray (_aQstruct,     _nControlStructures);
+  C.PutArray (_aQstruct_last,_nControlStructures);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Reads reservoir state from binary checkpoint
+/// \param &C [in] checkpoint buffer
+//
+void CReservoir::ReadFromCheckpoint(CCheckpoint &C)
+{
+  _stage        =C.GetDouble();
+  _stage_last   =C.GetDouble();
+  _Qout         =C.GetDouble();
+  _Qout_last    =C.GetDouble();
+  _MB_losses    =C.GetDouble();
+  _AET          =C.GetDouble();
+  _Precip       =C.GetDouble();
+  _GW_seepage   =C.GetDouble();
+  _DAscale      =C.GetDouble();
+  _DAscale_last =C.GetDouble();
+  _Qoptimized   =C.GetDouble();
+  _dry_timesteps=C.GetInt();
+  _constraint   =(res_constraint)(C.GetInt());
+  C.GetArray(_aQstruct,     _nControlStructures,"number of control structures ("+_name+")");
+  C.GetArray(_aQstruct_last,_nControlStructures,"number of control structures ("+_name+")");
+}
+//////////////////////////////////////////////////////////////////
 /// \brief interpolates the volume from the volume-stage rating curve
 /// \param ht [in] reservoir stage
 /// \returns reservoir volume [m3] corresponding to stage ht
@@ -44,6 +44,7 @@ struct down_demand {
 class CSubBasin;
 class CDemand;
 class CControlStructure;
+class CCheckpoint;
 /*****************************************************************
    Class CReservoir
 ------------------------------------------------------------------
@@ -290,6 +291,8 @@ public:/*-------------------------------------------------------*/
                                               const optStruct   &Options,
                                               const time_struct &tt);
   void              WriteToSolutionFile      (ofstream &OUT) const;
+  void              WriteToCheckpoint        (CCheckpoint &C) const;
+  void              ReadFromCheckpoint       (CCheckpoint &C);
   void              UpdateReservoir          (const time_struct &tt, const optStruct &Options);
   void              UpdateMassBalance        (const time_struct &tt, const double &tstep, const optStruct &Options);
   double            ScaleFlow                (const double &scale, const bool overriding,const double &tstep,const double &t);
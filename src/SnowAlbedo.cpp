@@ -147,9 +147,9 @@ void CmvSnowAlbedoEvolve::GetRatesOfChange (const double *state_vars,
   {
     double snow,albedo,cum_melt,snowfall,old_albedo;
 
-    UBC_snow_par PP = pModel->GetGlobalParams()->GetParams()->UBC_snow_params;
-    double min_alb  = pModel->GetGlobalParams()->GetParams()->min_snow_albedo;
-    double max_alb  = pModel->GetGlobalParams()->GetParams()->max_snow_albedo;
+    UBC_snow_par PP = pHRU->GetGlobalParams()->UBC_snow_params;
+    double min_alb  = pHRU->GetGlobalParams()->min_snow_albedo;
+    double max_alb  = pHRU->GetGlobalParams()->max_snow_albedo;
 
     snow    =state_vars[pModel->GetStateVarIndex(SNOW)];
     albedo  =state_vars[pModel->GetStateVarIndex(SNOW_ALBEDO)];
@@ -185,12 +185,12 @@ void CmvSnowAlbedoEvolve::GetRatesOfChange (const double *state_vars,
   { //ported from CRHM (Pomeroy, 2007) routine ClassalbedoRichard::run
     double tstep=Options.timestep;
 
-    double a1          = pModel->GetGlobalParams()->GetParams()->alb_decay_cold;    //Albedo decay time constant for cold snow (~0.008/d)
-    double a2          = pModel->GetGlobalParams()->GetParams()->alb_decay_melt;    //Albedo decay time constant for melting snow (~0.12/d)
-    double albmin      = pModel->GetGlobalParams()->GetParams()->min_snow_albedo;
-    double albmax      = pModel->GetGlobalParams()->GetParams()->max_snow_albedo;
-    double albbare     = pModel->GetGlobalParams()->GetParams()->bare_ground_albedo;
-    double snowfall_th = pModel->GetGlobalParams()->GetParams()->snowfall_albthresh;//Minimum snowfall to refresh snow albedo [mm/d] (~10 mm/d)
+    double a1          = pHRU->GetGlobalParams()->alb_decay_cold;    //Albedo decay time constant for cold snow (~0.008/d)
+    double a2          = pHRU->GetGlobalParams()->alb_decay_melt;    //Albedo decay time constant for melting snow (~0.12/d)
+    double albmin      = pHRU->GetGlobalParams()->min_snow_albedo;
+    double albmax      = pHRU->GetGlobalParams()->max_snow_albedo;
+    double albbare     = pHRU->GetGlobalParams()->bare_ground_albedo;
+    double snowfall_th = pHRU->GetGlobalParams()->snowfall_albthresh;//Minimum snowfall to refresh snow albedo [mm/d] (~10 mm/d)
 
     double albedo     =state_vars[pModel->GetStateVarIndex(SNOW_ALBEDO)];
     double SWE        =state_vars[pModel->GetStateVarIndex(SNOW)];
@@ -223,8 +223,8 @@ void CmvSnowAlbedoEvolve::GetRatesOfChange (const double *state_vars,
     double albedo   = state_vars[pModel->GetStateVarIndex(SNOW_ALBEDO)];
     double snow_age = state_vars[pModel->GetStateVarIndex(SNOW_AGE)];
 
-    double snowfall_th = pModel->GetGlobalParams()->GetParams()->snowfall_albthresh;//Minimum snowfall to refresh snow albedo [mm/d] (~10 mm/d)
-    double albbare     = pModel->GetGlobalParams()->GetParams()->bare_ground_albedo;
+    double snowfall_th = pHRU->GetGlobalParams()->snowfall_albthresh;//Minimum snowfall to refresh snow albedo [mm/d] (~10 mm/d)
+    double albbare     = pHRU->GetGlobalParams()->bare_ground_albedo;
 
     double old_albedo =albedo;
     double old_snowage=snow_age;//time [d] since albedo refresh
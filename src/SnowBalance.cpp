@@ -413,7 +413,7 @@ void CmvSnowBalance::GetRatesOfChange(const double               *state_var,
   else if (type==SNOBAL_CEMA_NEIGE)
   {
     double pot_melt,snow_cov,SWE;
-    double avg_annual_snow = pModel->GetGlobalParams()->GetParams()->avg_annual_snow;
+    double avg_annual_snow = pHRU->GetGlobalParams()->avg_annual_snow;
     double snotemp=pHRU->GetSnowTemperature();
     pot_melt=0.0;
     if (snotemp==FREEZING_TEMP){
@@ -462,7 +462,7 @@ void CmvSnowBalance::GetRatesOfChange(const double               *state_var,
     refreeze=max(min(SL/tstep,refreeze),0.0);
     SL-=refreeze*tstep;
 
-    liq_cap=CalculateSnowLiquidCapacity(SWE, SD, pModel);
+    liq_cap=CalculateSnowLiquidCapacity(SWE, SD, pHRU);
     to_liq=min(melt,max(liq_cap-SL,0.0)/tstep);
     SL+=to_liq*tstep;
 
@@ -493,9 +493,9 @@ void CmvSnowBalance::GetRatesOfChange(const double               *state_var,
     double Kf     = pHRU->GetSurfaceProps()->refreeze_factor;
     double Tbf    = pHRU->GetSurfaceProps()->DD_refreeze_temp;
     double exp_fe = pHRU->GetSurfaceProps()->refreeze_exp;
-    double fcmin  = pModel->GetGlobalParams()->GetParams()->snow_SWI_min;
-    double fcmax  = pModel->GetGlobalParams()->GetParams()->snow_SWI_max;
-    double Ccum   = pModel->GetGlobalParams()->GetParams()->SWI_reduct_coeff;
+    double fcmin  = pHRU->GetGlobalParams()->snow_SWI_min;
+    double fcmax  = pHRU->GetGlobalParams()->snow_SWI_max;
+    double Ccum   = pHRU->GetGlobalParams()->SWI_reduct_coeff;
 
     double potmelt=max(pHRU->GetForcingFunctions()->potential_melt,0.0);
     double Tdiurnal=0.5*(pHRU->GetForcingFunctions()->temp_daily_ave+pHRU->GetForcingFunctions()->temp_daily_min);
@@ -640,7 +640,7 @@ void CmvSnowBalance::GetRatesOfChange(const double               *state_var,
         transfer = 0.0;
       }
       else{
-        double snDef = max(CalculateSnowLiquidCapacity(SWE, 0.0, pModel) - Sliq, 0.0);
+        double snDef = max(CalculateSnowLiquidCapacity(SWE, 0.0, pHRU) - Sliq, 0.0);
 
         if (snowmelt > snDef)
         {
@@ -739,7 +739,7 @@ void CmvSnowBalance::ColdContentBalance(const double             *state_vars,
   const double MELT_FAC = 1.5; //[MJ/m2-d-K],
   const double LAIMLT   = 0.2;
   const double SAIMLT   = 0.5;
-  const double SWI = pModel->GetGlobalParams()->GetParams()->snow_SWI;
+  const double SWI = pHRU->GetGlobalParams()->snow_SWI;
 
   double Ta         = pHRU->GetForcingFunctions()->temp_daily_ave;
   double day_length = pHRU->GetForcingFunctions()->day_length;
@@ -796,7 +796,7 @@ void CmvSnowBalance::ColdContentBalance(const double             *state_vars,
   CC_air      =(FREEZING_TEMP-Ta)*SPH_ICE*S;
   //MJ-mm/kg  =[K]               *[MJ/kg/K]*[mm]
 
-  liq_snow_cap=CalculateSnowLiquidCapacity(S, 0.0, pModel);
+  liq_snow_cap=CalculateSnowLiquidCapacity(S, 0.0, pHRU);
 
   if (pot_melt<=0) //negative energy balance - snowpack cooling
   {
@@ -899,8 +899,8 @@ void CmvSnowBalance::TwoLayerBalance(const double   *state_vars,
 
   //parameters
   //------------------------------------------------------------------------
-  double MAXLIQ     = pModel->GetGlobalParams()->GetParams()->snow_SWI;         // maximum liquid water fraction of snow, dimensionless
-  double MAXSWESURF = pModel->GetGlobalParams()->GetParams()->max_SWE_surface;  // maximum swe of surface layer of snowpack
+  double MAXLIQ     = pHRU->GetGlobalParams()->snow_SWI;         // maximum liquid water fraction of snow, dimensionless
+  double MAXSWESURF = pHRU->GetGlobalParams()->max_SWE_surface;  // maximum swe of surface layer of snowpack
 
   // forcings
   //------------------------------------------------------------------------
@@ -1114,7 +1114,7 @@ void CmvSnowBalance::GawserBalance( const double      *state_vars,
   // Constants
   double KF =  pHRU->GetSurfaceProps()->refreeze_factor;  // refreeze factor [mm/d-degC]
   double KM =  pHRU->GetSurfaceProps()->melt_factor; // melt factor [mm/d-degC] //~5.04
-  double SWI = pModel->GetGlobalParams()->GetParams()->snow_SWI; // Maximum fraction of pore space in snowpack for liquid snow
+  double SWI = pHRU->GetGlobalParams()->snow_SWI; // Maximum fraction of pore space in snowpack for liquid snow
 
   double RHOICE = DENSITY_ICE/DENSITY_WATER;  // Relative density of ice
   double MRHO   = 0.35;                       // Maximum dry density for snowpack /// \todo [funct] - enable support of user-specified MRHO,
@@ -1233,7 +1233,7 @@ void CmvSnowBalance::CRHMSnowBalance(const double *state_vars,
   double T_min    =pHRU->GetForcingFunctions()->temp_daily_min;
 
   pot_melt*=LH_FUSION*DENSITY_WATER/MM_PER_METER*Options.timestep;  //[mm/d]->[MJ/m2]
-  double snoliq_max = CalculateSnowLiquidCapacity(SWE, SWE/MAX_SNOW_DENS, pModel);
+  double snoliq_max = CalculateSnowLiquidCapacity(SWE, SWE/MAX_SNOW_DENS, pHRU);
   double t_minus    = min(T_min,0.0);
   double Umin       = SWE*(2.115+0.00779*t_minus)*t_minus;//1000.0; //[MJ/m2] minimum snow energy (negative), documentation?? JRC- 1000 factor from CRHM unknown and leading to unreasonably small values of Umin.
   double refreeze   = 0.0;;
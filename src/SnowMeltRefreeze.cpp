@@ -123,6 +123,50 @@ void   CmvSnowMelt::ApplyConstraints( const double               *state_vars,
 
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Returns true if snowmelt algorithm has a batched (multi-HRU) implementation
+//
+bool CmvSnowMelt::SupportsBatchRates() const
+{
+  return (type==MELT_POTMELT);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns constrained snowmelt rates for a block of HRUs [mm/d]
+/// \details identical to GetRatesOfChange()+ApplyConstraints() for each HRU
+///
+/// \param nHRUs [in] number of HRUs in block (<=PROCESS_BATCH_SIZE)
+/// \param state_vars [in] array of pointers to state variable arrays of each HRU in block
+/// \param pHRUs [in] array of pointers to HRUs in block
+/// \param &Options [in] Global model options information
+/// \param &tt [in] Current model time
+/// \param *rates [out] melt rate of each HRU in block [mm/d] [size: nHRUs]
+//
+void CmvSnowMelt::GetBatchRatesOfChange(const int          nHRUs,
+                                        const double      *const *state_vars,
+                                        const CHydroUnit  *const *pHRUs,
+                                        const optStruct   &Options,
+                                        const time_struct &tt,
+                                              double      *rates) const
+{
+  double snow[PROCESS_BATCH_SIZE]; //[mm]
+  double melt[PROCESS_BATCH_SIZE]; //potential melt [mm/d]
+  int    n;
+  double tstep=Options.timestep;
+
+  for (n=0;n<nHRUs;n++){
+    snow[n]=state_vars[n][iFrom[0]];
+    melt[n]=pHRUs[n]->GetForcingFunctions()->potential_melt;
+  }
+  for (n=0;n<nHRUs;n++)
+  {
+    rates[n]=threshPositive(melt[n]);
+    if (snow[n]<=0)   {rates[n]=0.0;}
+    if (rates[n]<0.0) {rates[n]=0.0;}
+    rates[n]=threshMin(rates[n],snow[n]/tstep,0.0);
+  }
+}
+
 //************************************************************************************************
 //************************************************************************************************
 //************************************************************************************************
@@ -210,7 +254,7 @@ void CmvSnowSqueeze::GetRatesOfChange( const double              *state_vars,
   if (pModel->GetStateVarIndex(SNOW_DEPTH)!=DOESNT_EXIST){
     SD=state_vars[pModel->GetStateVarIndex(SNOW_DEPTH)];
   }
-  liq_cap=CalculateSnowLiquidCapacity(S, SD, pModel);
+  liq_cap=CalculateSnowLiquidCapacity(S, SD, pHRU);
 
   rates[0]=max(SL-liq_cap,0.0)/Options.timestep;
 
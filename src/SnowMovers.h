@@ -99,6 +99,13 @@ public:/*-------------------------------------------------------*/
                         const optStruct   &Options,
                         const time_struct &tt,
                         double            *rates) const;
+  bool SupportsBatchRates   () const;
+  void GetBatchRatesOfChange(const int          nHRUs,
+                             const double      *const *state_vars,
+                             const CHydroUnit  *const *pHRUs,
+                             const optStruct   &Options,
+                             const time_struct &tt,
+                                   double      *rates) const;
 
   void        GetParticipatingParamList   (string  *aP, class_type *aPC, int &nP) const;
   static void GetParticipatingStateVarList(snowmelt_type stype,
@@ -73,17 +73,17 @@ double GetSnowDensity(const double &snowSWE,const double &snow_depth)
 /// \brief Calculates snow liquid holding capacity
 /// \param &SWE [in] Snow water equivalent [mm]
 /// \param &snow_depth [in] Depth of snow [mm]
-/// \param &Options [in] Global model options information
+/// \param pHRU [in] pointer to HRU (for HRU-specific global parameters)
 /// \return Snow liquid capacity [-]
 //
-double CalculateSnowLiquidCapacity(const double &SWE,const double &snow_depth, const CModelABC* pModel)
+double CalculateSnowLiquidCapacity(const double &SWE,const double &snow_depth, const CHydroUnit* pHRU)
 {
   double liq_cap;
   //if (snow_depth>0.0){
   //  liq_cap=CGlobalParams::GetParams()->snow_SWI*(1.0-SWE/snow_depth);
   //}
 
-  liq_cap = pModel->GetGlobalParams()->GetParams()->snow_SWI*SWE; //HBV-EC, Brook90, UBCWM, GAWSER
+  liq_cap = pHRU->GetGlobalParams()->snow_SWI*SWE; //HBV-EC, Brook90, UBCWM, GAWSER
 
   return liq_cap;
 
@@ -33,6 +33,20 @@ enum class_type{
   CLASS_UNKNOWN
 };
 
+////////////////////////////////////////////////////////////////////
+/// \brief Parameter (class, parameter name) pair resolved once for repeated updates
+/// \details created by CModel::GetParameterHandle(); used by CModel::UpdateParameter(handle,value)
+//
+struct param_handle
+{
+  class_type ctype;      ///< parameter class type
+  string     pname;      ///< parameter name
+  string     cname;      ///< parameter class name (or SBID/gauge name)
+  double    *pxAddress;  ///< address of parameter value, or NULL if parameter can only be updated by name
+
+  param_handle(){ctype=CLASS_UNKNOWN; pname=""; cname=""; pxAddress=NULL;}
+};
+
 ///////////////////////////////////////////////////////////////////
 /// \brief Data abstraction for soil classification
 //
@@ -53,11 +67,13 @@ public:/*-------------------------------------------------------*/
   const soil_struct       *GetSoilStruct() const;
   double                   GetSoilProperty(string &param_name) const;
   void                     SetSoilProperty(string param_name, const double &value);
+  double                  *GetSoilPropertyAddress(const string &param_name);
 
   //routines
   void AutoCalculateSoilProps(const soil_struct &Stmp,const soil_struct &Sdefault,const int nConstit);
 
   static void              SetSoilProperty         (soil_struct &S, string param_name, const double value);
+  static double           *GetSoilPropertyAddress  (soil_struct &S, const string &param_name);
   static double            GetSoilProperty         (const soil_struct &S, string param_name, const bool strict=true);
   static void              InitializeSoilProperties(soil_struct &S, bool is_template,int nConstits);
 
@@ -92,6 +108,7 @@ public:/*-------------------------------------------------------*/
   double                   GetParameter(const string param_name) const;//not currently used
   double                   GetVegetationProperty(string param_name) const;
   void                     SetVegetationProperty(const string &param_name, const double &value);
+  double                  *GetVegetationPropertyAddress(const string &param_name);
 
   //routines
   void AutoCalculateVegetationProps(const veg_struct    &Vtmp,
@@ -104,6 +121,7 @@ public:/*-------------------------------------------------------*/
   static void                    DestroyAllVegClasses();
 
   static void                    SetVegetationProperty(veg_struct &V, const string param_name, const double &value);
+  static double                 *GetVegetationPropertyAddress(veg_struct &V, const string &param_name);
   static void                    SetVegTransportProperty( int          constit_ind,int          constit_ind2,
                                                           veg_struct  &V,string param_name, const double value);
   static double                  GetVegetationProperty(const veg_struct &V, string param_name, const bool strict=true);
@@ -127,6 +145,11 @@ public:/*-------------------------------------------------------*/
                                               const time_struct       &tt,
                                               const optStruct         &Options);
 
+  static void   UpdateCanopyStateParams(      veg_var_struct    &VV,         //state-dependent canopy params
+                                              const CHydroUnit       *pHRU,
+                                              const CModelABC        *pModel,
+                                              const optStruct         &Options);
+
   static void     RecalculateRootParams(        veg_var_struct  &VV,
                                                 const CHydroUnit       *pHRU,
                                                 const CModelABC        *pModel,
@@ -167,6 +190,7 @@ public:/*-------------------------------------------------------*/
   const surface_struct *GetSurfaceStruct() const;
   double                GetSurfaceProperty(string param_name) const;
   void                  SetSurfaceProperty(const string &param_name, const double &value);
+  double               *GetSurfacePropertyAddress(const string &param_name);
   void                  InitializeSurfaceProperties(string name, bool is_template);
 
   //routines
@@ -178,6 +202,7 @@ public:/*-------------------------------------------------------*/
 
   static void          InitializeSurfaceProperties(string name, surface_struct &S, bool is_template);
   static void          SetSurfaceProperty         (surface_struct &S, const string param_name, const double value);
+  static double       *GetSurfacePropertyAddress  (surface_struct &S, const string &param_name);
   static double        GetSurfaceProperty         (const surface_struct &S, string param_name, const bool strict=true);
 };
 
@@ -202,6 +227,7 @@ public:/*-------------------------------------------------------*/
   const terrain_struct    *GetTerrainStruct() const;
   double                   GetTerrainProperty(string param_name) const;
   void                     SetTerrainProperty(const string &param_name, const double &value);
+  double                  *GetTerrainPropertyAddress(const string &param_name);
 
   //routines
   void AutoCalculateTerrainProps(const terrain_struct &Ttmp, const terrain_struct &Tdefault);
@@ -213,6 +239,7 @@ public:/*-------------------------------------------------------*/
 
   static void                    InitializeTerrainProperties(terrain_struct &T, bool is_template);
   static void                    SetTerrainProperty(terrain_struct &T, const string  param_name, const double value);
+  static double                 *GetTerrainPropertyAddress(terrain_struct &T, const string &param_name);
   static double                  GetTerrainProperty(const terrain_struct &T, string param_name);
 
   static void                    SummarizeToScreen();
@@ -767,3 +767,89 @@ void   CmvSoilEvap::ApplyConstraints( const double               *state_vars,
   }
   rates[_nConnections-1]-=corr;
 }
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns true if soil evaporation algorithm has a batched (multi-HRU) implementation
+//
+bool CmvSoilEvap::SupportsBatchRates() const
+{
+  return ((type==SOILEVAP_LINEAR) || (type==SOILEVAP_ALL) ||
+          (type==SOILEVAP_TOPMODEL) || (type==SOILEVAP_HBV));
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns constrained soil evaporation rates for a block of HRUs
+/// \details identical to GetRatesOfChange()+ApplyConstraints() for each HRU; forcings, parameters and storage
+/// are gathered into contiguous arrays first so that rate calculations are performed in tight loops
+///
+/// \param nHRUs [in] number of HRUs in block (<=PROCESS_BATCH_SIZE)
+/// \param state_vars [in] array of pointers to state variable arrays of each HRU in block
+/// \param pHRUs [in] array of pointers to HRUs in block
+/// \param &Options [in] Global model options information
+/// \param &tt [in] Current model time
+/// \param *rates [out] soil evaporation [mm/d] (rates[n]) and PET used [mm/d] (rates[nHRUs+n]) [size: 2*nHRUs]
+//
+void CmvSoilEvap::GetBatchRatesOfChange(const int          nHRUs,
+                                        const double      *const *state_vars,
+                                        const CHydroUnit  *const *pHRUs,
+                                        const optStruct   &Options,
+                                        const time_struct &tt,
+                                              double      *rates) const
+{
+  bool   active[PROCESS_BATCH_SIZE]; //false for lakes/glaciers
+  double PET   [PROCESS_BATCH_SIZE]; //[mm/d]
+  double stor  [PROCESS_BATCH_SIZE]; //[mm]
+  double coeff [PROCESS_BATCH_SIZE]; //AET coefficient [1/d] or tension storage [mm]
+  double snowfc[PROCESS_BATCH_SIZE]; //forest cover if snow present, 1.0 otherwise [-] (HBV only)
+  double *evap   =rates;             //SOIL->ATMOS
+  double *PETused=rates+nHRUs;       //AET
+  int    n;
+  double tstep=Options.timestep;
+  int    iAET =pModel->GetStateVarIndex(AET);
+  int    iSnow=pModel->GetStateVarIndex(SNOW);
+
+  //gather
+  for (n=0;n<nHRUs;n++)
+  {
+    active [n]=(pHRUs[n]->GetHRUType()==HRU_STANDARD);
+    evap   [n]=0.0;
+    PETused[n]=0.0;
+    if (!active[n]){continue;}
+
+    PET[n]=pHRUs[n]->GetForcingFunctions()->PET;
+    if (!Options.suppressCompetitiveET){
+      //competitive ET - reduce PET by AET
+      PET[n]-=(state_vars[n][iAET]/tstep);
+      PET[n]=max(PET[n],0.0);
+    }
+    stor[n]=state_vars[n][iFrom[0]];
+    if (type==SOILEVAP_LINEAR){coeff[n]=pHRUs[n]->GetSurfaceProps()->AET_coeff;}
+    else                      {coeff[n]=pHRUs[n]->GetSoilTensionStorageCapacity(0);}
+    snowfc[n]=1.0;
+    if ((type==SOILEVAP_HBV) && (iSnow!=DOESNT_EXIST) && (state_vars[n][iSnow]>REAL_SMALL)){
+      snowfc[n]=pHRUs[n]->GetSurfaceProps()->forest_coverage;
+    }
+  }
+
+  //calculate rates
+  for (n=0;n<nHRUs;n++)
+  {
+    if (!active[n]){continue;}
+    if      (type==SOILEVAP_LINEAR){evap[n]=min(coeff[n]*stor[n],PET[n]);}
+    else if (type==SOILEVAP_ALL   ){evap[n]=PET[n];}
+    else {
+      evap[n]=PET[n]*min(stor[n]/coeff[n],1.0);
+      if (type==SOILEVAP_HBV){evap[n]=(snowfc[n])*evap[n];}
+    }
+    PETused[n]=evap[n];
+  }
+
+  //apply constraints (as in ApplyConstraints)
+  for (n=0;n<nHRUs;n++)
+  {
+    if (!active[n]){continue;}
+    double oldrate=evap[n];
+    evap[n]=threshMin(evap[n],stor[n]/tstep,0.0);
+    PETused[n]-=(0.0+(oldrate-evap[n]));
+  }
+}
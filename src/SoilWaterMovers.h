@@ -70,6 +70,13 @@ public:/*-------------------------------------------------------*/
                         const optStruct   &Options,
                         const time_struct &tt,
                         double      *rates) const;
+  bool SupportsBatchRates   () const;
+  void GetBatchRatesOfChange(const int          nHRUs,
+                             const double      *const *state_vars,
+                             const CHydroUnit  *const *pHRUs,
+                             const optStruct   &Options,
+                             const time_struct &tt,
+                                   double      *rates) const;
 
   void        GetParticipatingParamList   (string  *aP , class_type *aPC , int &nP) const;
   static void GetParticipatingStateVarList(baseflow_type btype,
@@ -138,6 +145,13 @@ public:/*-------------------------------------------------------*/
                         const optStruct   &Options,
                         const time_struct &tt,
                         double           *rates) const;
+  bool SupportsBatchRates   () const;
+  void GetBatchRatesOfChange(const int          nHRUs,
+                             const double      *const *state_vars,
+                             const CHydroUnit  *const *pHRUs,
+                             const optStruct   &Options,
+                             const time_struct &tt,
+                                   double      *rates) const;
 
   void        GetParticipatingParamList   (string *aP ,
                                            class_type *aPC,
@@ -240,6 +254,13 @@ public:/*-------------------------------------------------------*/
                         const optStruct   &Options,
                         const time_struct &tt,
                         double      *rates) const;
+  bool SupportsBatchRates   () const;
+  void GetBatchRatesOfChange(const int          nHRUs,
+                             const double      *const *state_vars,
+                             const CHydroUnit  *const *pHRUs,
+                             const optStruct   &Options,
+                             const time_struct &tt,
+                                   double      *rates) const;
 
   void        GetParticipatingParamList   (string  *aP , class_type *aPC , int &nP) const;
   static void GetParticipatingStateVarList(perc_type    p_type,
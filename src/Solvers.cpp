@@ -5,7 +5,325 @@
 
 #include "RavenInclude.h"
 #include "Model.h"
+#include "Profiler.h"
 #include "GWRiverConnection.h"
+#include "Matrix.h"
+
+const double IMPLICIT_PERTURB=1e-7;  ///< relative perturbation used for finite difference Jacobian of implicit solver
+
+//////////////////////////////////////////////////////////////////
+/// \brief Applies rates of change of one process to the state variables of HRU k (ordered series approach)
+/// \details updates mass/energy balance tracking for connections qs..qs+nConnections-1
+///
+/// \param *pModel [in & out] Model
+/// \param *aPhinew [in & out] newest state variable array of HRU k
+/// \param k [in] global HRU index
+/// \param qs [in] index of first connection of process in balance arrays
+/// \param nConnections [in] number of connections of process
+/// \param *iFrom, *iTo [in] indices of state variables losing/gaining water or energy
+/// \param *rates_of_change [in & out] rates of change (zeroed for redirects to self)
+/// \param &tstep [in] time step [d]
+/// \param *aMoved [in & out] if not NULL, amounts moved are accumulated here (indexed by connection) rather than
+/// added to balance arrays
+//
+static void UpdateOrderedSeriesStates(CModel *pModel,double *aPhinew,const int k,const int qs,const int nConnections,
+                                      const int *iFrom,const int *iTo,double *rates_of_change,const double &tstep,
+                                      double *aMoved=NULL)
+{
+  for(int q=0;q<nConnections;q++)//each process may have multiple connections
+  {
+    sv_type typ=pModel->GetStateVarType(iFrom[q]);
+    if(iTo[q]!=iFrom[q]) {
+      aPhinew[iFrom[q]]-=rates_of_change[q]*tstep;//mass/energy balance maintained
+      aPhinew[iTo  [q]]+=rates_of_change[q]*tstep;//change is an exchange of energy or mass, which must be preserved
+    }
+    else if (CStateVariable::IsWaterStorage(typ) && (typ!=CONVOLUTION)){ //or IsWaterStorage(typ,false)
+      rates_of_change[q]=0.0;
+      aPhinew[iTo  [q]]+=0.0; //likely from redirect - water moves back to itself
+    }
+    else {
+      aPhinew[iTo  [q]]+=rates_of_change[q]*tstep;//for state vars that are not storage compartments
+    }
+    if (aMoved!=NULL){aMoved[qs+q]+=rates_of_change[q]*tstep;}
+    else             {pModel->IncrementBalance(qs+q,k,rates_of_change[q]*tstep);}   //this is only this easy for Euler/Ordered!
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Applies all processes to HRU k in series over nSub equal sub-steps of the model time step
+/// \details convolution processes, whose unit hydrographs and storage history are discretized by the model
+/// time step, are applied once, in the last sub-step, over the full time step. Surface water (routed at the
+/// end of each time step), used PET and runoff are treated as amounts accumulated within the current step:
+/// they are set aside after every sub-step and restored at its end
+///
+/// \param *pModel [in] Model
+/// \param *aPhi0 [in] state variable array of HRU k at start of timestep
+/// \param *aPhiOut [out] state variable array of HRU k at end of timestep
+/// \param *aMoved [out] amount moved through each connection over time step [size: total # of connections]
+/// \param nConnTotal [in] total number of in-HRU connections of all processes
+/// \param k [in] global HRU index
+/// \param nSub [in] number of sub-steps
+/// \param &OptSub [out] copy of model options with time step set to sub-step
+/// \param &Options [in] Global model options information
+/// \param &tt [in] current model time
+//
+static void OrderedSeriesSubsteps(CModel *pModel,const double *aPhi0,double *aPhiOut,double *aMoved,const int nConnTotal,
+                                  const int k,const int nSub,optStruct &OptSub,const optStruct &Options,const time_struct &tt)
+{
+  int    iFrom[MAX_CONNECTIONS];
+  int    iTo  [MAX_CONNECTIONS];
+  double rates_of_change[MAX_CONNECTIONS];
+  int    j,s,qs,nConnections;
+  bool   once;
+  double cumSW=0.0,cumAET=0.0,cumRO=0.0;
+
+  const CHydroUnit *pHRU=pModel->GetHydroUnit(k);
+  int iSW =pModel->GetStateVarIndex(SURFACE_WATER);
+  int iAET=pModel->GetStateVarIndex(AET);
+  int iRO =pModel->GetStateVarIndex(RUNOFF);
+  OptSub.timestep=Options.timestep/nSub;
+
+  memcpy(aPhiOut,aPhi0,pModel->GetNumStateVars()*sizeof(double));
+  for(int q=0;q<nConnTotal;q++){aMoved[q]=0.0;}
+
+  for(s=0;s<nSub;s++)
+  {
+    if(s>0)
+    {
+      cumSW +=aPhiOut[iSW]; aPhiOut[iSW]=0.0;
+      if(iAET!=DOESNT_EXIST){cumAET+=aPhiOut[iAET]; aPhiOut[iAET]=0.0;}
+      if(iRO !=DOESNT_EXIST){cumRO +=aPhiOut[iRO ]; aPhiOut[iRO ]=0.0;}
+    }
+    qs=0;
+    for(j=0;j<pModel->GetNumProcesses();j++)
+    {
+      once=(pModel->GetProcess(j)->GetProcessType()==CONVOLVE);
+      if(!once || (s==nSub-1))
+      {
+        const optStruct &Opt=(once) ? Options : OptSub;
+        if(pModel->ApplyProcess(j,aPhiOut,pHRU,Opt,tt,iFrom,iTo,nConnections,rates_of_change)){
+          UpdateOrderedSeriesStates(pModel,aPhiOut,k,qs,nConnections,iFrom,iTo,rates_of_change,Opt.timestep,aMoved);
+        }
+      }
+      qs+=pModel->GetNumConnections(j);
+    }
+  }
+  aPhiOut[iSW]+=cumSW;
+  if(iAET!=DOESNT_EXIST){aPhiOut[iAET]+=cumAET;}
+  if(iRO !=DOESNT_EXIST){aPhiOut[iRO ]+=cumRO;}
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Evaluates net rates of change of all state variables of HRU k from all processes (used by implicit solver)
+/// \details optionally returns rates of every connection (zeroed for redirects to self) and flags state variables
+/// participating in any connection
+///
+/// \param *pModel [in] Model
+/// \param *aPhik [in] state variable array of HRU k at which rates are evaluated
+/// \param *pHRU [in] HRU k
+/// \param &Options [in] Global model options information
+/// \param &tt [in] current model time
+/// \param *dPhidt [out] net rate of change of each state variable [size: NS]
+/// \param *aConnRates [out] rates of all connections, ordered as in balance arrays (or NULL) [size: total # of connections]
+/// \param *active [out] true for state variables participating in a connection (or NULL) [size: NS]
+//
+static void GetNetRatesOfChange(const CModel *pModel,const double *aPhik,const CHydroUnit *pHRU,
+                                const optStruct &Options,const time_struct &tt,
+                                double *dPhidt,double *aConnRates,bool *active)
+{
+  int    iFrom[MAX_CONNECTIONS];
+  int    iTo  [MAX_CONNECTIONS];
+  double rates_of_change[MAX_CONNECTIONS];
+  int    j,q,qs=0,nConnections;
+
+  for(int i=0;i<pModel->GetNumStateVars();i++){dPhidt[i]=0.0;}
+
+  for(j=0;j<pModel->GetNumProcesses();j++)
+  {
+    nConnections=0;
+    if(pModel->ApplyProcess(j,aPhik,pHRU,Options,tt,iFrom,iTo,nConnections,rates_of_change))
+    {
+      for(q=0;q<nConnections;q++)
+      {
+        sv_type typ=pModel->GetStateVarType(iFrom[q]);
+        if(iTo[q]!=iFrom[q]) {
+          dPhidt[iFrom[q]]-=rates_of_change[q];
+          dPhidt[iTo  [q]]+=rates_of_change[q];
+        }
+        else if(CStateVariable::IsWaterStorage(typ) && (typ!=CONVOLUTION)) {
+          rates_of_change[q]=0.0; //redirect - water moves back to itself
+        }
+        else {
+          dPhidt[iTo  [q]]+=rates_of_change[q];
+        }
+        if(aConnRates!=NULL){aConnRates[qs+q]=rates_of_change[q];}
+        if(active    !=NULL){active[iFrom[q]]=true; active[iTo[q]]=true;}
+      }
+    }
+    else
+    {
+      nConnections=pModel->GetNumConnections(j);
+      if(aConnRates!=NULL){for(q=0;q<nConnections;q++){aConnRates[qs+q]=0.0;}}
+    }
+    qs+=nConnections;
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Solves backward Euler equations Phi=Phi0+dt*f(Phi) for the state variables of HRU k with Newton's method
+/// \details The Jacobian I-dt*df/dPhi is evaluated by finite differences over only those state variables
+/// which participate in a process connection, then solved by LU decomposition; per-HRU systems are small
+/// and dense enough that this is cheaper than an iterative sparse solve. Water storage iterates are kept
+/// non-negative. The converged state is only used to evaluate rates: states and balance arrays are then
+/// updated with these end-of-step rates as in the Euler method, so that mass/energy balance is exact
+/// regardless of Newton convergence.
+///
+/// \param *pModel [in & out] Model
+/// \param *aPhi0 [in] state variable array of HRU k at start of timestep
+/// \param *aPhinew [out] state variable array of HRU k at end of timestep
+/// \param *aX [out] working storage for Newton iterate [size: NS]
+/// \param *aWork [out] working storage [size: NS*NS+4*NS]
+/// \param *aPiv [out] working storage [size: NS]
+/// \param *aIndex [out] working storage [size: NS]
+/// \param *active [out] working storage [size: NS]
+/// \param *aConnRates [out] working storage [size: nConnTotal]
+/// \param nConnTotal [in] total number of in-HRU connections of all processes
+/// \param k [in] global HRU index
+/// \param &Options [in] Global model options information
+/// \param &tt [in] current model time
+/// \returns true if Newton iteration converged
+//
+static bool ImplicitEulerHRU(CModel *pModel,const double *aPhi0,double *aPhinew,double *aX,double *aWork,
+                             int *aPiv,int *aIndex,bool *active,double *aConnRates,const int nConnTotal,
+                             const int k,const optStruct &Options,const time_struct &tt)
+{
+  int    i,ii,jj,q,iter,nA=0;
+  int    NS   =pModel->GetNumStateVars();
+  double tstep=Options.timestep;
+  double h,dxmax,xsave;
+  bool   converged=false;
+
+  CHydroUnit *pHRU=pModel->GetHydroUnit(k);
+  double *J  =aWork;            //[nA x nA] Jacobian, LU factorization
+  double *F  =aWork+NS*NS;      //[NS] rates at current iterate
+  double *Fp =aWork+NS*NS+NS;   //[NS] rates at perturbed iterate
+  double *G  =aWork+NS*NS+2*NS; //[nA] Newton residual, then update
+  double *scr=aWork+NS*NS+3*NS; //[nA] LU solve scratch
+
+  for(i=0;i<NS;i++){aX[i]=aPhi0[i]; active[i]=false;}
+
+  for(iter=0;iter<(int)(Options.max_iterations);iter++)
+  {
+    GetNetRatesOfChange(pModel,aX,pHRU,Options,tt,F,NULL,(iter==0) ? active : NULL);
+    if(iter==0){
+      for(i=0;i<NS;i++){if(active[i]){aIndex[nA]=i; nA++;}}
+      if(nA==0){converged=true;break;}
+    }
+
+    //residual G=X-Phi0-dt*f(X), Jacobian I-dt*df/dX over active state variables
+    for(ii=0;ii<nA;ii++){
+      i=aIndex[ii];
+      G[ii]=-(aX[i]-aPhi0[i]-tstep*F[i]);
+    }
+    for(jj=0;jj<nA;jj++)
+    {
+      i    =aIndex[jj];
+      xsave=aX[i];
+      h    =IMPLICIT_PERTURB*max(fabs(xsave),1.0);
+      aX[i]=xsave+h;
+      GetNetRatesOfChange(pModel,aX,pHRU,Options,tt,Fp,NULL,NULL);
+      aX[i]=xsave;
+      for(ii=0;ii<nA;ii++){
+        J[ii*nA+jj]=-tstep*(Fp[aIndex[ii]]-F[aIndex[ii]])/h;
+      }
+      J[jj*nA+jj]+=1.0;
+    }
+    if(!LUFactor(J,nA,aPiv,REAL_SMALL)){break;}
+    LUSolve(J,nA,aPiv,G,scr);
+
+    dxmax=0.0;
+    for(ii=0;ii<nA;ii++)
+    {
+      i=aIndex[ii];
+      aX[i]+=G[ii];
+      if((aX[i]<0.0) && (aPhi0[i]>=0.0) && (CStateVariable::IsWaterStorage(pModel->GetStateVarType(i)))){aX[i]=0.0;}
+      upperswap(dxmax,fabs(G[ii]));
+    }
+    if(dxmax<=Options.convergence_crit){converged=true;break;}
+  }
+
+  //update states and balance arrays using rates at converged state
+  GetNetRatesOfChange(pModel,aX,pHRU,Options,tt,F,aConnRates,NULL);
+  for(i=0;i<NS;i++){aPhinew[i]=aPhi0[i]+F[i]*tstep;}
+  for(q=0;q<nConnTotal;q++){
+    pModel->IncrementBalance(q,k,aConnRates[q]*tstep);
+  }
+  return converged;
+}
+
+//solver statistics, accumulated by MassEnergyBalance() and reported by WriteSolverStatistics()
+static int        *aNSubMax   =NULL; //maximum number of sub-steps used by each HRU [size=nHRUs]
+static double     *aNSubTotal =NULL; //total number of sub-steps used by each HRU [size=nHRUs]
+static int        *aNSubCapped=NULL; //number of time steps in which HRU reached max_substeps without meeting tolerance [size=nHRUs]
+static int         nSubSteps  =0;    //number of time steps solved with adaptive sub-stepping
+static int         nSubCapped =0;    //total number of HRU time steps which reached max_substeps without meeting tolerance
+static long long   nImplicitSteps=0; //number of HRU time steps solved with implicit Euler method
+static long long   nNotConverged =0; //number of HRU time steps in which implicit Euler Newton iteration did not converge
+
+//////////////////////////////////////////////////////////////////
+/// \brief Writes number of adaptive sub-steps used by each HRU to SubstepCounts.csv in output directory
+///
+/// \param *pModel [in] Model
+/// \param &Options [in] Global model options information
+//
+static void WriteSubstepReport(const CModel *pModel,const optStruct &Options)
+{
+  int    k,nMax=0,nEnabled=0,nCapped=0;
+  double total=0.0;
+  string tmpFilename=FilenamePrepare("SubstepCounts.csv",Options);
+  ofstream SUB;
+  SUB.open(tmpFilename.c_str());
+  if (SUB.fail()){
+    ExitGracefully(("WriteSubstepReport: Unable to open output file "+tmpFilename+" for writing.").c_str(),FILE_OPEN_ERR);
+  }
+  SUB<<"HRU ID,mean substeps per time step,max substeps per time step,time steps at max substeps without meeting tolerance"<<endl;
+  for (k=0;k<pModel->GetNumHRUs();k++)
+  {
+    if(!pModel->GetHydroUnit(k)->IsEnabled()){continue;}
+    SUB<<pModel->GetHydroUnit(k)->GetHRUID()<<","<<aNSubTotal[k]/max(nSubSteps,1)<<","<<aNSubMax[k]<<","<<aNSubCapped[k]<<endl;
+    total+=aNSubTotal[k];
+    upperswap(nMax,aNSubMax[k]);
+    nCapped+=aNSubCapped[k];
+    nEnabled++;
+  }
+  SUB.close();
+
+  if (!Options.silent){
+    cout<<"Adaptive sub-stepping: mean of "<<total/max(nSubSteps*nEnabled,1)<<" sub-steps per HRU time step (max "<<nMax<<")"<<endl;
+    if (nCapped>0){
+      cout<<"Adaptive sub-stepping: tolerance not met within "<<Options.max_substeps<<" sub-steps in "<<nCapped<<" HRU time steps"<<endl;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Writes solver statistics accumulated over simulation (e.g., SubstepCounts.csv)
+/// \details called once at end of simulation by MassEnergyBalance(), or when the simulation is
+/// stopped early (stopfile or control channel :Stop)
+///
+/// \param *pModel [in] Model
+/// \param &Options [in] Global model options information
+//
+void WriteSolverStatistics(const CModel *pModel,const optStruct &Options)
+{
+  if (aNSubTotal!=NULL){WriteSubstepReport(pModel,Options);}
+  if (nNotConverged>0)
+  {
+    string warn="MassEnergyBalance: implicit Euler Newton iteration did not converge in "+to_string(nNotConverged)+" of "+to_string(nImplicitSteps)+" HRU time steps";
+    WriteWarning(warn.c_str(),Options.noisy);
+    if (!Options.silent){cout<<"Implicit Euler: Newton iteration did not converge in "<<nNotConverged<<" of "<<nImplicitSteps<<" HRU time steps"<<endl;}
+  }
+}
 
 ///////////////////////////////////////////////////////////////////
 /// \brief Solves system of energy and mass balance ODEs/PDEs for one timestep
@@ -41,6 +359,7 @@ void MassEnergyBalance( CModel            *pModel,
   static double    **aPhi=NULL;   //[mm;C;mg/m2;MJ/m2] state variable arrays at initial, intermediate times;
   static double    **aPhinew;     //[mm;C;mg/m2;MJ/m2] state variable arrays at end of timestep; value after convergence
   static double    **aPhiPrevIter;
+  static double     *aPhiMem;     //contiguous HRU-major storage for aPhi, aPhinew, aPhiPrevIter (same layout as model state matrix)
 
   static double     *aQinnew;     //[m3/s] inflow rate to subbasin reach p at t+dt [size=_nSubBasins]
   static double     *aQoutnew;    //[m3/s] final outflow from reach segment seg at time t+dt [size=MAX_RIVER_SEGS]
@@ -51,6 +370,17 @@ void MassEnergyBalance( CModel            *pModel,
   static double     *aRoutedMass; //[mg/d] or [MJ/d] amount of mass/energy [size= _nSubBasins]
 
   static double    **rate_guess;  //need to set first array to nProcesses
+  static double     *batch_rates; //connection-major rates for a block of HRUs [size=MAX_CONNECTIONS*PROCESS_BATCH_SIZE]
+  static int         batch_size;  //number of HRUs in a block (1 if any process depends upon HRU order)
+
+  static double     *imp_work;    //working storage of implicit solver [size=NS*NS+5*NS+nConnTotal]
+  static int        *imp_iwork;   //integer working storage of implicit solver [size=2*NS]
+  static bool       *imp_active;  //state variables participating in connections [size=NS]
+  static int         nConnTotal;  //total number of in-HRU connections of all processes
+
+  static optStruct  *pOptSub=NULL;//copy of options with sub-step time step (adaptive sub-stepping)
+  static double     *sub_work;    //working storage of adaptive sub-stepping [size=2*NS+2*nConnTotal]
+  static int        *aNSub;       //number of sub-steps used by each HRU in last time step [size=nHRUs]
 
   static int        *kFrom;
   static int        *kTo;
@@ -75,12 +405,14 @@ void MassEnergyBalance( CModel            *pModel,
     aPhi        =new double *[nHRUs];
     aPhinew     =new double *[nHRUs];
     aPhiPrevIter=new double *[nHRUs];
+    aPhiMem     =new double  [3*nHRUs*NS];
+    ExitGracefullyIf(aPhiMem==NULL,"MassEnergyBalance",OUT_OF_MEMORY);
 
     for (k=0;k<nHRUs;k++)
     {
-      aPhi[k]        =new double [NS];
-      aPhinew[k]     =new double [NS];
-      aPhiPrevIter[k]=new double [NS];
+      aPhi[k]        =aPhiMem+(        k)*NS;
+      aPhinew[k]     =aPhiMem+(  nHRUs+k)*NS;
+      aPhiPrevIter[k]=aPhiMem+(2*nHRUs+k)*NS;
     }
 
     aQoutnew    =NULL;
@@ -114,12 +446,49 @@ void MassEnergyBalance( CModel            *pModel,
         rate_guess[j]=new double [NS*NS];       //maximum number of connections possible
       }
     }
+    if(Options.sol_method==ORDERED_SERIES)
+    {
+      batch_rates = new double [MAX_CONNECTIONS*PROCESS_BATCH_SIZE];
+      ExitGracefullyIf(batch_rates==NULL,"MassEnergyBalance(3)",OUT_OF_MEMORY);
+      batch_size=PROCESS_BATCH_SIZE;
+      for (j=0;j<nProcesses;j++){
+        if (pModel->GetProcess(j)->DependsOnHRUOrder()){batch_size=1;}
+      }
+    }
+    nConnTotal=0;
+    for (j=0;j<nProcesses;j++){nConnTotal+=pModel->GetNumConnections(j);}
+    if((Options.sol_method==ORDERED_SERIES) && (Options.substep_tolerance>0.0))
+    {
+      ExitGracefullyIf(nConstituents>0,
+        "MassEnergyBalance: :AdaptiveSubstepping cannot be used with transport, which requires fluxes from the full time step",BAD_DATA);
+      pOptSub   =new optStruct(Options);
+      sub_work  =new double [2*NS+2*nConnTotal];
+      aNSub     =new int    [nHRUs];
+      aNSubMax  =new int    [nHRUs];
+      aNSubTotal=new double [nHRUs];
+      aNSubCapped=new int   [nHRUs];
+      ExitGracefullyIf(aNSubCapped==NULL,"MassEnergyBalance(5)",OUT_OF_MEMORY);
+      for (k=0;k<nHRUs;k++){aNSub[k]=1; aNSubMax[k]=0; aNSubTotal[k]=0.0; aNSubCapped[k]=0;}
+      nSubSteps=0;
+    }
+    else if(Options.substep_tolerance>0.0){
+      WriteWarning("MassEnergyBalance: :AdaptiveSubstepping is only supported by the ORDERED_SERIES numerical method and will be ignored",Options.noisy);
+    }
+    if(Options.sol_method==IMPLICIT_EULER)
+    {
+      imp_work  =new double [NS*NS+5*NS+nConnTotal];
+      imp_iwork =new int    [2*NS];
+      imp_active=new bool   [NS];
+      ExitGracefullyIf(imp_active==NULL,"MassEnergyBalance(4)",OUT_OF_MEMORY);
+    }
     //For lateral flow processes
     kFrom         =new int   [MAX_LAT_CONNECTIONS];
     kTo           =new int   [MAX_LAT_CONNECTIONS];
     exchange_rates=new double[MAX_LAT_CONNECTIONS];
   }//end static memory if
 
+  pModel->PrepareProcesses(Options,tt); //e.g., regenerates parameter-dependent data before any rates are calculated
+
   if(Options.modeltype == MODELTYPE_COUPLED)
   {
     // Get pointer to GW model
@@ -133,16 +502,9 @@ void MassEnergyBalance( CModel            *pModel,
     iTo            [i]=DOESNT_EXIST;
     rates_of_change[i]=0.0;
   }
-  for (k=0;k<nHRUs;k++)
-  {
-    pHRU=pModel->GetHydroUnit(k);
-    for (i=0;i<NS ;i++)
-    {
-      aPhi        [k][i]=pHRU->GetStateVarValue(i);
-      aPhinew     [k][i]=aPhi[k][i];
-      aPhiPrevIter[k][i]=aPhi[k][i];
-    }
-  }
+  memcpy(aPhi[0],        pModel->GetStateMatrix(),nHRUs*NS*sizeof(double)); //bulk copy of contiguous state matrix
+  memcpy(aPhinew[0],     aPhi[0],                 nHRUs*NS*sizeof(double));
+  memcpy(aPhiPrevIter[0],aPhi[0],                 nHRUs*NS*sizeof(double));
 
   iSW      =pModel->GetStateVarIndex(SURFACE_WATER);
   iAtm     =pModel->GetStateVarIndex(ATMOS_PRECIP);
@@ -179,59 +541,128 @@ void MassEnergyBalance( CModel            *pModel,
     }
   }
 
+  double prof_start=CProfiler::Start();
+
   //=================================================================
-  //==Standard (in series) approach==================================
-  // -order is critical!
-  if (Options.sol_method==ORDERED_SERIES)
+  //==Standard (in series) approach with adaptive sub-stepping=======
+  // -each HRU is solved over n and 2n sub-steps (step doubling); the difference estimates the local
+  //  error of the n sub-step solution, which is accepted once within tolerance. n starts from half
+  //  that used in the previous time step, so sub-stepping relaxes once an HRU calms down
+  // -balance arrays are incremented once with the amounts moved over all accepted sub-steps
+  if ((Options.sol_method==ORDERED_SERIES) && (Options.substep_tolerance>0.0))
   {
+    int    n,jj;
+    double err;
+    bool   accepted;
+    double *aPhiC  =sub_work;                //coarse (n sub-step) solution
+    double *aPhiF  =sub_work+NS;             //fine (2n sub-step) solution
+    double *aMovedC=sub_work+2*NS;
+    double *aMovedF=sub_work+2*NS+nConnTotal;
     for (k=0;k<nHRUs;k++)
     {
-      pHRU=pModel->GetHydroUnit(k);
-      pModel->ApplyLocalParamOverrrides(k, false);
+      if(!pModel->GetHydroUnit(k)->IsEnabled()){continue;}
 
-      if(pHRU->IsEnabled())
+      n=max(aNSub[k]/2,1);
+      OrderedSeriesSubsteps(pModel,aPhi[k],aPhiC,aMovedC,nConnTotal,k,n,*pOptSub,Options,tt);
+      accepted=false;
+      while(2*n<=Options.max_substeps)
+      {
+        OrderedSeriesSubsteps(pModel,aPhi[k],aPhiF,aMovedF,nConnTotal,k,2*n,*pOptSub,Options,tt);
+        err=0.0;
+        for(i=0;i<NS;i++){
+          if(CStateVariable::IsWaterStorage(pModel->GetStateVarType(i))){upperswap(err,fabs(aPhiF[i]-aPhiC[i]));}
+        }
+        if(err<=Options.substep_tolerance){accepted=true;break;}
+        n*=2;
+        swap(aPhiC,aPhiF);
+        swap(aMovedC,aMovedF);
+      }
+      memcpy(aPhinew[k],aPhiC,NS*sizeof(double));
+      for(jj=0;jj<nConnTotal;jj++){pModel->IncrementBalance(jj,k,aMovedC[jj]);}
+
+      if(!accepted){ //max_substeps reached - n sub-step solution accepted without meeting tolerance
+        if(nSubCapped==0){
+          WriteWarning("MassEnergyBalance: :AdaptiveSubstepping tolerance not met within the maximum number of sub-steps in at least one HRU; see SubstepCounts.csv",Options.noisy);
+        }
+        aNSubCapped[k]++;
+        nSubCapped++;
+      }
+      aNSub     [k]=n;
+      aNSubTotal[k]+=n;
+      upperswap(aNSubMax[k],n);
+    }
+    nSubSteps++;
+  }
+
+  //=================================================================
+  //==Standard (in series) approach==================================
+  // -order is critical!
+  // -HRUs are processed in blocks; processes supporting batched evaluation are applied to the whole block at once,
+  //  others HRU by HRU. Since HRUs are independent here, this is equivalent to processing HRU by HRU
+  //  (blocks are a single HRU if any process depends upon HRU order)
+  else if (Options.sol_method==ORDERED_SERIES)
+  {
+    int kApplied[PROCESS_BATCH_SIZE];
+    int k0,nBlock,nApplied,n;
+    CHydroProcessABC *pProc;
+
+    for (k0=0;k0<nHRUs;k0+=batch_size)
+    {
+      nBlock=min(batch_size,nHRUs-k0);
+      qs=0;
+      for(j=0;j<nProcesses;j++)
       {
-        qs=0;
-        for(j=0;j<nProcesses;j++)
+        pProc=pModel->GetProcess(j);
+        nConnections=pProc->GetNumConnections();
+
+        if (pProc->SupportsBatchRates())
         {
-          nConnections=0;
-          if(pModel->ApplyProcess(j,aPhinew[k],pHRU,Options,tt,iFrom,iTo,nConnections,rates_of_change)) //note aPhinew is newest state variable vector
+          nApplied=pModel->ApplyProcessBatch(j,k0,nBlock,aPhinew,Options,tt,kApplied,batch_rates);
+          for(q=0;q<nConnections;q++){
+            iFrom[q]=pProc->GetFromIndices()[q];
+            iTo  [q]=pProc->GetToIndices  ()[q];
+          }
+          n=0;
+          for (k=k0;k<k0+nBlock;k++)
           {
-#ifdef _STRICTCHECK_
-            if(nConnections>MAX_CONNECTIONS) {
-              cout<<nConnections<<endl;
-              ExitGracefully("MassEnergyBalance:: Maximum number of connections exceeded. Please contact author.",RUNTIME_ERR); }
-#endif
-            for(q=0;q<nConnections;q++)//each process may have multiple connections
+            if(!pModel->GetHydroUnit(k)->IsEnabled()){continue;}
+            if ((n<nApplied) && (kApplied[n]==k))
             {
-              sv_type typ=pModel->GetStateVarType(iFrom[q]);
-              if(iTo[q]!=iFrom[q]) {
-                aPhinew[k][iFrom[q]]-=rates_of_change[q]*tstep;//mass/energy balance maintained
-                aPhinew[k][iTo  [q]]+=rates_of_change[q]*tstep;//change is an exchange of energy or mass, which must be preserved
-              }
-              else if (CStateVariable::IsWaterStorage(typ) && (typ!=CONVOLUTION)){ //or IsWaterStorage(typ,false)
-                rates_of_change[q]=0.0;
-                aPhinew[k][iTo  [q]]+=0.0; //likely from redirect - water moves back to itself
-              }
-              else {
-                aPhinew[k][iTo  [q]]+=rates_of_change[q]*tstep;//for state vars that are not storage compartments
-              }
-              pModel->IncrementBalance(qs,k,rates_of_change[q]*tstep);   //this is only this easy for Euler/Ordered!
-              qs++;
-            }//end for q=0 to nConnections
-          }// end if (pModel->ApplyProcess
-          else
+              for(q=0;q<nConnections;q++){rates_of_change[q]=batch_rates[q*nApplied+n];}
+              UpdateOrderedSeriesStates(pModel,aPhinew[k],k,qs,nConnections,iFrom,iTo,rates_of_change,tstep);
+              n++;
+            }
+            else
+            {
+              for(q=0;q<nConnections;q++){pModel->IncrementBalance(qs+q,k,0.0);}
+            }
+          }
+        }
+        else
+        {
+          for (k=k0;k<k0+nBlock;k++)
           {
-            for(q=0;q<nConnections;q++)
+            pHRU=pModel->GetHydroUnit(k);
+            if(!pHRU->IsEnabled()){continue;}
+
+            if(pModel->ApplyProcess(j,aPhinew[k],pHRU,Options,tt,iFrom,iTo,nConnections,rates_of_change)) //note aPhinew is newest state variable vector
             {
-              pModel->IncrementBalance(qs,k,0.0);
-              qs++;
+#ifdef _STRICTCHECK_
+              if(nConnections>MAX_CONNECTIONS) {
+                cout<<nConnections<<endl;
+                ExitGracefully("MassEnergyBalance:: Maximum number of connections exceeded. Please contact author.",RUNTIME_ERR); }
+#endif
+              UpdateOrderedSeriesStates(pModel,aPhinew[k],k,qs,nConnections,iFrom,iTo,rates_of_change,tstep);
+            }
+            else
+            {
+              for(q=0;q<nConnections;q++){pModel->IncrementBalance(qs+q,k,0.0);}
             }
           }
-        }//end for j=0 to nProcesses
-      }
-      pModel->ApplyLocalParamOverrrides(k, true);
-    }//end for k=0 to nHRUs
+        }
+        qs+=nConnections;
+      }//end for j=0 to nProcesses
+    }//end for k0=0 to nHRUs
 
   }//end if Options.sol_method==ORDERED_SERIES
 
@@ -388,11 +819,33 @@ void MassEnergyBalance( CModel            *pModel,
     }//end of for k=0 to nHRUs
   }//end iterated Heun
 
+  //===================================================================
+  //==Implicit (backward) Euler Method ================================
+  // -order of processes doesn't matter; stable for stiff systems at large time steps
+  else if(Options.sol_method==IMPLICIT_EULER)
+  {
+    double *aX        =imp_work+NS*NS+4*NS;
+    double *aConnRates=imp_work+NS*NS+5*NS;
+    for (k=0;k<nHRUs;k++)
+    {
+      if(!pModel->GetHydroUnit(k)->IsEnabled()){continue;}
+      nImplicitSteps++;
+      if(!ImplicitEulerHRU(pModel,aPhi[k],aPhinew[k],aX,imp_work,imp_iwork,imp_iwork+NS,imp_active,aConnRates,nConnTotal,k,Options,tt))
+      {
+        if(nNotConverged==0){
+          WriteWarning("MassEnergyBalance: implicit Euler Newton iteration did not converge in at least one HRU; consider increasing :NumericalMethod IMPLICIT_EULER maximum iterations or reducing time step",Options.noisy);
+        }
+        nNotConverged++;
+      }
+    }
+  }//end implicit Euler
+
   //==Other Methods Below ============================================
   else
   {
     ExitGracefully("MassEnergyBalance",STUB);
   }
+  CProfiler::Stop(PROF_HRU_PROCESSES,prof_start);
 
   //-----------------------------------------------------------------
   //      LATERAL EXCHANGE PROCESSES
@@ -401,6 +854,8 @@ void MassEnergyBalance( CModel            *pModel,
   int    nLatConnections;
   double Afrom,Ato;
 
+  prof_start=CProfiler::Start();
+
   for (q=0;q<MAX_LAT_CONNECTIONS;q++)
   {
     kFrom[q]=DOESNT_EXIST;
@@ -437,11 +892,13 @@ void MassEnergyBalance( CModel            *pModel,
       }
     }
   }
+  CProfiler::Stop(PROF_LATERAL_PROCESSES,prof_start);
 
   //-----------------------------------------------------------------
   //      GROUNDWATER SOLVER
   //-----------------------------------------------------------------
   // Following solution to SW system at end of timestep, solve GW system for lateral flow
+  prof_start=CProfiler::Start();
   if (Options.modeltype == MODELTYPE_COUPLED)
 	{
     // Update River water levels
@@ -463,6 +920,7 @@ void MassEnergyBalance( CModel            *pModel,
     pGW2River->UpdateRiverFlux();     // Update River Fluxes (for routing)
     pGWModel->ClearMatrix();
   } // End of Groundwater processes
+  CProfiler::Stop(PROF_GROUNDWATER,prof_start);
 
 
   //-----------------------------------------------------------------
@@ -552,12 +1010,14 @@ void MassEnergyBalance( CModel            *pModel,
   // ----------------------------------------------------------------------------------------
   if (Options.management_optimization)
   {
+    CProfileScope P(PROF_DEMAND_OPTIMIZATION);
     pModel->GetManagementOptimizer()->SolveDemandProblem(pModel, Options, aRouted, tt);
   }
 
   // Route water over timestep
   // ----------------------------------------------------------------------------------------
   // calculations performed in order from upstream (pp=0) to downstream (pp=nSubBasins-1)
+  prof_start=CProfiler::Start();
   for (pp=0;pp<NB;pp++)
   {
     p=pModel->GetOrderedSubBasinIndex(pp); //p refers to actual index of basin, pp is ordered list index upstream to down
@@ -588,6 +1048,7 @@ void MassEnergyBalance( CModel            *pModel,
       {
         double res_inflow_last = pBasin->GetOutflowArray()[pBasin->GetNumSegments()-1];
         double res_inflow =max((aQoutnew[pBasin->GetNumSegments()-1]-div_Q_total-irr_Q),0.0);
+        CProfileScope P(PROF_RESERVOIRS);
         res_ht=pBasin->GetReservoir()->RouteWater(res_inflow_last,res_inflow,pModel,Options,tt,res_outflow,res_const,res_Qstruct);
       }
 
@@ -609,6 +1070,7 @@ void MassEnergyBalance( CModel            *pModel,
       }
     }
   }//end for pp...
+  CProfiler::Stop(PROF_ROUTING,prof_start);
   delete [] res_Qstruct;
 
 
@@ -625,6 +1087,7 @@ void MassEnergyBalance( CModel            *pModel,
   double Ploading;
   int    iSWmass,m;
   CConstituentModel *pConstitModel;
+  prof_start=CProfiler::Start();
   for(c=0;c<nConstituents;c++)
   {
     pConstitModel=pModel->GetTransportModel()->GetConstituentModel(c);
@@ -679,6 +1142,7 @@ void MassEnergyBalance( CModel            *pModel,
       }
     }//end for pp...
   }//end (c=0;c<nConstituents;c++)
+  if (nConstituents>0){CProfiler::Stop(PROF_TRANSPORT,prof_start);}
 
   //update state variable values=====================================
   for (k=0;k<nHRUs;k++){
@@ -698,9 +1162,7 @@ void MassEnergyBalance( CModel            *pModel,
         }
       }
 
-      for(i=0;i<NS;i++){
-        pHRU->SetStateVarValue(i,aPhinew[k][i]);
-      }
+      memcpy(pHRU->GetStateVarArray(),aPhinew[k],NS*sizeof(double)); //HRU state is row k of model state matrix
     }
   }
 
@@ -708,13 +1170,37 @@ void MassEnergyBalance( CModel            *pModel,
   if(t>=Options.duration-Options.timestep)
   {
     if(DESTRUCTOR_DEBUG) { cout<<"DELETING STATIC ARRAYS IN MASSENERGYBALANCE"<<endl; }
-    for(k=0;k<nHRUs;k++) { delete[] aPhi[k];         } delete[] aPhi;         aPhi=NULL;
-    for(k=0;k<nHRUs;k++) { delete[] aPhinew[k];      } delete[] aPhinew;      aPhinew=NULL;
-    for(k=0;k<nHRUs;k++) { delete[] aPhiPrevIter[k]; } delete[] aPhiPrevIter; aPhiPrevIter=NULL;
+    delete[] aPhi;         aPhi=NULL;
+    delete[] aPhinew;      aPhinew=NULL;
+    delete[] aPhiPrevIter; aPhiPrevIter=NULL;
+    delete[] aPhiMem;      aPhiMem=NULL;
+    WriteSolverStatistics(pModel,Options); //(before statistics are deleted below)
     if(Options.sol_method == ITERATED_HEUN)
     {
       for(j=0;j<nProcesses;j++) { delete[] rate_guess[j]; }  delete[] rate_guess; rate_guess=NULL;
     }
+    if(Options.sol_method == ORDERED_SERIES)
+    {
+      delete[] batch_rates; batch_rates=NULL;
+    }
+    if(pOptSub!=NULL)
+    {
+      delete   pOptSub;      pOptSub    =NULL;
+      delete[] sub_work;     sub_work   =NULL;
+      delete[] aNSub;        aNSub      =NULL;
+      delete[] aNSubMax;     aNSubMax   =NULL;
+      delete[] aNSubTotal;   aNSubTotal =NULL;
+      delete[] aNSubCapped;  aNSubCapped=NULL;
+      nSubCapped=0;
+    }
+    if(Options.sol_method == IMPLICIT_EULER)
+    {
+      delete[] imp_work;   imp_work  =NULL;
+      delete[] imp_iwork;  imp_iwork =NULL;
+      delete[] imp_active; imp_active=NULL;
+      nImplicitSteps=0;
+      nNotConverged =0;
+    }
     delete[] aQinnew;      aQinnew     = NULL;
     delete[] aQoutnew;     aQoutnew    = NULL;
     delete[] aRouted;      aRouted     = NULL;
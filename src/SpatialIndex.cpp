@@ -0,0 +1,155 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2024 the Raven Development Team
+  ----------------------------------------------------------------
+  SpatialIndex.cpp
+  ----------------------------------------------------------------*/
+#include "SpatialIndex.h"
+
+//////////////////////////////////////////////////////////////////
+/// \brief Constructor - builds balanced k-d tree from point set
+/// \param x [in] array of x coordinates [N]
+/// \param y [in] array of y coordinates [N]
+/// \param index [in] array of original point indices (e.g., gauge index g) [N]
+/// \param N [in] number of points
+//
+CKDTree2D::CKDTree2D(const double *x, const double *y, const int *index, const int N)
+{
+  _nPoints=N;
+  _aX    =new double [_nPoints];
+  _aY    =new double [_nPoints];
+  _aIndex=new int    [_nPoints];
+  _aAxis =new int    [_nPoints];
+  ExitGracefullyIf(_aAxis==NULL,"CKDTree2D constructor",OUT_OF_MEMORY);
+  for (int i=0;i<_nPoints;i++){
+    _aX[i]=x[i]; _aY[i]=y[i]; _aIndex[i]=index[i]; _aAxis[i]=0;
+  }
+
+  int *perm=new int [_nPoints];
+  for (int i=0;i<_nPoints;i++){perm[i]=i;}
+
+  Build(perm,0,_nPoints);
+
+  //reorder point arrays into tree order
+  double *tmpX=new double [_nPoints];
+  double *tmpY=new double [_nPoints];
+  int    *tmpI=new int    [_nPoints];
+  for (int i=0;i<_nPoints;i++){
+    tmpX[i]=_aX[perm[i]]; tmpY[i]=_aY[perm[i]]; tmpI[i]=_aIndex[perm[i]];
+  }
+  delete [] _aX;     _aX    =tmpX;
+  delete [] _aY;     _aY    =tmpY;
+  delete [] _aIndex; _aIndex=tmpI;
+  delete [] perm;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Destructor
+//
+CKDTree2D::~CKDTree2D()
+{
+  delete [] _aX;
+  delete [] _aY;
+  delete [] _aIndex;
+  delete [] _aAxis;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief recursively partitions perm[lo..hi) about the median of the axis with largest spread
+/// \details node for range [lo,hi) is stored at m=(lo+hi)/2; left subtree is [lo,m), right is [m+1,hi)
+//
+void CKDTree2D::Build(int *perm, int lo, int hi)
+{
+  if (hi-lo<=1){return;}
+
+  double minx=ALMOST_INF,maxx=-ALMOST_INF,miny=ALMOST_INF,maxy=-ALMOST_INF;
+  for (int i=lo;i<hi;i++){
+    minx=min(minx,_aX[perm[i]]); maxx=max(maxx,_aX[perm[i]]);
+    miny=min(miny,_aY[perm[i]]); maxy=max(maxy,_aY[perm[i]]);
+  }
+  int axis=((maxy-miny)>(maxx-minx)) ? 1 : 0;
+  const double *c=(axis==0) ? _aX : _aY;
+
+  int m=(lo+hi)/2;
+  std::nth_element(perm+lo,perm+m,perm+hi,[c](int a,int b){return c[a]<c[b];});
+  _aAxis[m]=axis;
+
+  Build(perm,lo,m);
+  Build(perm,m+1,hi);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief recursive k-nearest neighbour search over tree node range [lo,hi)
+/// \details nbrs/dist2 are kept sorted by (squared distance, original index)
+//
+void CKDTree2D::SearchNearest(int lo, int hi, const double &x, const double &y, const int k, const double &maxdist2,
+                              int *nbrs, double *dist2, int &nFound) const
+{
+  if (hi<=lo){return;}
+  int    m=(lo+hi)/2;
+  double dx=x-_aX[m];
+  double dy=y-_aY[m];
+  double d2=dx*dx+dy*dy;
+
+  if (d2<=maxdist2)
+  {
+    //insertion into sorted list of k nearest, ties broken by lowest index
+    int pos=nFound;
+    while ((pos>0) && ((d2<dist2[pos-1]) || ((d2==dist2[pos-1]) && (_aIndex[m]<nbrs[pos-1])))){
+      if (pos<k){nbrs[pos]=nbrs[pos-1];dist2[pos]=dist2[pos-1];}
+      pos--;
+    }
+    if (pos<k){
+      nbrs[pos]=_aIndex[m]; dist2[pos]=d2;
+      if (nFound<k){nFound++;}
+    }
+  }
+  if (hi-lo==1){return;}
+
+  double diff=(_aAxis[m]==0) ? dx : dy;
+  int nlo=(diff<0) ? lo  : m+1; //near side
+  int nhi=(diff<0) ? m   : hi;
+  int flo=(diff<0) ? m+1 : lo;  //far side
+  int fhi=(diff<0) ? hi  : m;
+
+  SearchNearest(nlo,nhi,x,y,k,maxdist2,nbrs,dist2,nFound);
+
+  double worst=(nFound<k) ? maxdist2 : min(maxdist2,dist2[k-1]);
+  if (diff*diff<=worst){
+    SearchNearest(flo,fhi,x,y,k,maxdist2,nbrs,dist2,nFound);
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \returns number of points in tree
+//
+int CKDTree2D::GetNumPoints() const
+{
+  return _nPoints;
+}
+//////////////////////////////////////////////////////////////////
+/// \returns original index of point nearest to (x,y), or DOESNT_EXIST if tree is empty
+//
+int CKDTree2D::GetNearest(const double &x, const double &y) const
+{
+  int    nbr=DOESNT_EXIST;
+  double dist;
+  GetKNearest(x,y,1,ALMOST_INF,&nbr,&dist);
+  return nbr;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief finds up to k nearest points to (x,y) within distance max_dist
+/// \param k [in] maximum number of neighbours to return
+/// \param max_dist [in] search radius (same units as coordinates); use ALMOST_INF for unlimited
+/// \param nbrs [out] original indices of neighbours, sorted by increasing distance [k]
+/// \param dist [out] distances to neighbours [k]
+/// \returns number of neighbours found (<=k)
+//
+int CKDTree2D::GetKNearest(const double &x, const double &y, const int k, const double &max_dist,
+                           int *nbrs, double *dist) const
+{
+  if (k<=0){return 0;}
+  int    nFound=0;
+  double maxdist2=(max_dist>=ALMOST_INF) ? ALMOST_INF : max_dist*max_dist;
+
+  SearchNearest(0,_nPoints,x,y,k,maxdist2,nbrs,dist,nFound);
+
+  for (int i=0;i<nFound;i++){dist[i]=sqrt(dist[i]);}
+  return nFound;
+}
@@ -0,0 +1,39 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2024 the Raven Development Team
+  ----------------------------------------------------------------
+  SpatialIndex.h
+  ----------------------------------------------------------------*/
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include "RavenInclude.h"
+
+///////////////////////////////////////////////////////////////////
+/// \brief Static 2D k-d tree over a set of (x,y) points (e.g., gauge UTM coordinates)
+/// \details supports nearest-neighbour and k-nearest / radius-limited queries in O(log N)
+/// rather than brute-force O(N) searches. Points are referred to by their original index;
+/// ties in distance are broken in favour of the lowest index, consistent with a linear search
+//
+class CKDTree2D
+{
+ private:
+  int     _nPoints;   ///< number of points in tree
+  double *_aX;        ///< x coordinates of points [_nPoints]
+  double *_aY;        ///< y coordinates of points [_nPoints]
+  int    *_aIndex;    ///< original index of points [_nPoints], in tree order
+  int    *_aAxis;     ///< splitting axis of node (0=x, 1=y) [_nPoints]
+
+  void   Build        (int *perm, int lo, int hi);
+  void   SearchNearest(int lo, int hi, const double &x, const double &y, const int k, const double &maxdist2,
+                       int *nbrs, double *dist2, int &nFound) const;
+ public:
+  CKDTree2D(const double *x, const double *y, const int *index, const int N);
+  ~CKDTree2D();
+
+  int    GetNumPoints() const;
+  int    GetNearest  (const double &x, const double &y) const;
+  int    GetKNearest (const double &x, const double &y, const int k, const double &max_dist,
+                      int *nbrs, double *dist) const;
+};
+#endif
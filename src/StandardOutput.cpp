@@ -1309,6 +1309,15 @@ void CModel::WriteMinorOutput(const optStruct &Options,const time_struct &tt)
     WriteMajorOutput(Options,tt,tmpFilename,false);
   }
 
+  // Write periodic binary checkpoint, if necessary
+  //--------------------------------------------------------------
+  if ((Options.checkpoint_interval>0.0) && (tt.model_time>0.5*Options.timestep))
+  {
+    double n=floor(tt.model_time/Options.checkpoint_interval+0.5);
+    if (fabs(tt.model_time-n*Options.checkpoint_interval)<0.5*Options.timestep){
+      WriteCheckpoint(tt,FilenamePrepare("checkpoint.rvb",Options));
+    }
+  }
 }
 
 
@@ -1326,63 +1335,71 @@ void CModel::WriteMajorOutput(const time_struct &tt, string solfile, bool final)
 
   if (Options->output_format==OUTPUT_NONE){return;} //:SuppressOutput is on
 
-  // WRITE {RunName}_solution.rvc - final state variables file
-  ofstream RVC;
-  tmpFilename=FilenamePrepare(solfile+".rvc", *_pOptStruct);
-  RVC.open(tmpFilename.c_str());
-  if (RVC.fail()){
-    WriteWarning(("CModel::WriteMajorOutput: Unable to open output file "+tmpFilename+" for writing.").c_str(),
-                  Options->noisy);
-  }
-  RVC<<":TimeStamp "<<tt.date_string<<" "<<DecDaysToHours(tt.julian_day)<<endl;
-
-  //Header--------------------------
-  //write in blocks of 80 state variables
-  int mini,maxi;
-  int M=80;
-  for (int j=0; j<ceil(GetNumStateVars()/(double)(M)); j++){
-    mini=j*M;
-    maxi=min(GetNumStateVars(),(j+1)*M);
-    RVC<<":HRUStateVariableTable"<<endl;
-    RVC<<"  :Attributes,";
-    for (i=mini;i<maxi;i++)
-    {
-      RVC << _pStateVar->SVTypeToString(_aStateVarType[i], _aStateVarLayer[i]);
-      if (i!=GetNumStateVars()-1){RVC<<",";}
-    }
-    RVC<<endl;
-    RVC<<"  :Units,";
-    for (i=mini;i<maxi;i++)
-    {
-      RVC<<CStateVariable::GetStateVarUnits(_aStateVarType[i]);
-      if (i!=GetNumStateVars()-1){RVC<<",";}
-    }
-    RVC<<endl;
-    //Data----------------------------
-    for (k=0;k<_nHydroUnits;k++)
-    {
-      RVC<<std::fixed; RVC.precision(5);
-      RVC<<"  "<<_pHydroUnits[k]->GetHRUID()<<",";
+  // WRITE {RunName}_solution.rvb - binary checkpoint
+  if (Options->state_file_format!=STATE_RVC){
+    WriteCheckpoint(tt,FilenamePrepare(solfile+".rvb",*_pOptStruct));
+  }
+
+  if (Options->state_file_format!=STATE_RVB)
+  {
+    // WRITE {RunName}_solution.rvc - final state variables file
+    ofstream RVC;
+    tmpFilename=FilenamePrepare(solfile+".rvc", *_pOptStruct);
+    RVC.open(tmpFilename.c_str());
+    if (RVC.fail()){
+      WriteWarning(("CModel::WriteMajorOutput: Unable to open output file "+tmpFilename+" for writing.").c_str(),
+                    Options->noisy);
+    }
+    RVC<<":TimeStamp "<<tt.date_string<<" "<<DecDaysToHours(tt.julian_day)<<endl;
+
+    //Header--------------------------
+    //write in blocks of 80 state variables
+    int mini,maxi;
+    int M=80;
+    for (int j=0; j<ceil(GetNumStateVars()/(double)(M)); j++){
+      mini=j*M;
+      maxi=min(GetNumStateVars(),(j+1)*M);
+      RVC<<":HRUStateVariableTable"<<endl;
+      RVC<<"  :Attributes,";
       for (i=mini;i<maxi;i++)
       {
-        RVC<<_pHydroUnits[k]->GetStateVarValue(i);
+        RVC << _pStateVar->SVTypeToString(_aStateVarType[i], _aStateVarLayer[i]);
         if (i!=GetNumStateVars()-1){RVC<<",";}
       }
       RVC<<endl;
+      RVC<<"  :Units,";
+      for (i=mini;i<maxi;i++)
+      {
+        RVC<<CStateVariable::GetStateVarUnits(_aStateVarType[i]);
+        if (i!=GetNumStateVars()-1){RVC<<",";}
+      }
+      RVC<<endl;
+      //Data----------------------------
+      for (k=0;k<_nHydroUnits;k++)
+      {
+        RVC<<std::fixed; RVC.precision(5);
+        RVC<<"  "<<_pHydroUnits[k]->GetHRUID()<<",";
+        for (i=mini;i<maxi;i++)
+        {
+          RVC<<_pHydroUnits[k]->GetStateVarValue(i);
+          if (i!=GetNumStateVars()-1){RVC<<",";}
+        }
+        RVC<<endl;
+      }
+      RVC<<":EndHRUStateVariableTable"<<endl;
     }
-    RVC<<":EndHRUStateVariableTable"<<endl;
-  }
-  //By basin------------------------
-  RVC<<":BasinStateVariables"<<endl;
-  for (int p=0;p<_nSubBasins;p++){
-    RVC<<"  :BasinIndex "<<_pSubBasins[p]->GetID()<<",";
-    _pSubBasins[p]->WriteToSolutionFile(RVC);
-  }
-  RVC<<":EndBasinStateVariables"<<endl;
+    //By basin------------------------
+    RVC<<":BasinStateVariables"<<endl;
+    for (int p=0;p<_nSubBasins;p++){
+      RVC<<"  :BasinIndex "<<_pSubBasins[p]->GetID()<<",";
+      _pSubBasins[p]->WriteToSolutionFile(RVC);
+    }
+    RVC<<":EndBasinStateVariables"<<endl;
 
-  _pTransModel->WriteMajorOutput(RVC);
+    _pTransModel->WriteMajorOutput(RVC);
 
-  RVC.close();
+    RVC.close();
+  }
 
   // SubbasinProperties.csv
   //--------------------------------------------------------------
@@ -3,6 +3,7 @@
   Copyright (c) 2008-2024 the Raven Development Team
   ----------------------------------------------------------------*/
 #include "SubBasin.h"
+#include "Checkpoint.h"
 
 /*****************************************************************
    Constructor/Destructor
@@ -2632,6 +2633,59 @@ void CSubBasin::WriteToSolutionFile (ofstream &RVC) const
   }
 }
 //////////////////////////////////////////////////////////////////
+/// \brief Writes routing states (and reservoir states) to binary checkpoint
+/// \param &C [out] checkpoint buffer
+//
+void CSubBasin::WriteToCheckpoint(CCheckpoint &C) const
+{
+  C.PutDouble(_channel_storage);
+  C.PutDouble(_rivulet_storage);
+  C.PutArray (_aQout,    _nSegments);
+  C.PutArray (_aQlatHist,_nQlatHist);
+  C.PutArray (_aQinHist, _nQinHist);
+  C.PutDouble(_QoutLast);
+  C.PutDouble(_QlatLast);
+  C.PutDouble(_Qlocal);
+  C.PutDouble(_QlocLast);
+  C.PutDouble(_Qirr);
+  C.PutDouble(_QirrLast);
+  C.PutDouble(_Qdiverted);
+  C.PutDouble(_QdivLast);
+  C.PutDouble(_Qdelivered);
+  C.PutDouble(_Qreturn);
+  C.PutInt   (_c_hist!=NULL);
+  if (_c_hist!=NULL){C.PutArray(_c_hist,_nQinHist);}
+  C.PutInt   (_pReservoir!=NULL);
+  if (_pReservoir!=NULL){_pReservoir->WriteToCheckpoint(C);}
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Reads routing states (and reservoir states) from binary checkpoint
+/// \param &C [in] checkpoint buffer
+//
+void CSubBasin::ReadFromCheckpoint(CCheckpoint &C)
+{
+  string sb=" (subbasin "+to_string(_ID)+")";
+  _channel_storage=C.GetDouble();
+  _rivulet_storage=C.GetDouble();
+  C.GetArray(_aQout,    _nSegments,"number of channel segments"+sb);
+  C.GetArray(_aQlatHist,_nQlatHist,"lateral inflow history size"+sb);
+  C.GetArray(_aQinHist, _nQinHist, "upstream inflow history size"+sb);
+  _QoutLast  =C.GetDouble();
+  _QlatLast  =C.GetDouble();
+  _Qlocal    =C.GetDouble();
+  _QlocLast  =C.GetDouble();
+  _Qirr      =C.GetDouble();
+  _QirrLast  =C.GetDouble();
+  _Qdiverted =C.GetDouble();
+  _QdivLast  =C.GetDouble();
+  _Qdelivered=C.GetDouble();
+  _Qreturn   =C.GetDouble();
+  C.CheckValue(C.GetInt(),(_c_hist!=NULL),"celerity history"+sb);
+  if (_c_hist!=NULL){C.GetArray(_c_hist,_nQinHist,"celerity history size"+sb);}
+  C.CheckValue(C.GetInt(),(_pReservoir!=NULL),"reservoir"+sb);
+  if (_pReservoir!=NULL){_pReservoir->ReadFromCheckpoint(C);}
+}
+//////////////////////////////////////////////////////////////////
 /// \brief clears all time series data for re-read of .rvt file
 /// \remark Called only in ensemble mode
 ///
@@ -14,6 +14,7 @@
 class CReservoir;
 class CDemand;
 class CChannelXSect;  // defined in ChannelXSect.h
+class CCheckpoint;    // defined in Checkpoint.h
 enum res_constraint;
 
 ///////////////////////////////////////////////////////////////////
@@ -332,6 +333,8 @@ public:/*-------------------------------------------------------*/
                                             const time_struct &tt) const;
 
   void            WriteToSolutionFile      (ofstream &OUT) const;
+  void            WriteToCheckpoint        (CCheckpoint &C) const;
+  void            ReadFromCheckpoint       (CCheckpoint &C);
 };
 
 ///////////////////////////////////////////////////////////////////
@@ -109,7 +109,7 @@ double  SublimationRate  (const double      *state_vars,
   //-----------------------------------------------------------------
   if(type==SUBLIM_SVERDRUP)
   {
-    double roughness   = pModel->GetGlobalParams()->GetParams()->snow_roughness;  // [m]
+    double roughness   = pHRU->GetGlobalParams()->snow_roughness;  // [m]
     double air_density = pHRU->GetForcingFunctions()->air_dens;       // [kg/m3]
     double air_pres    = pHRU->GetForcingFunctions()->air_pres;       // [kPa]
     double Tsnow       = pHRU->GetSnowTemperature();
@@ -100,6 +100,35 @@ void  CTerrainClass::SetTerrainProperty(const string &param_name,
   SetTerrainProperty(T,param_name,value);
 }
 //////////////////////////////////////////////////////////////////
+/// \brief Returns address of the terrain property corresponding to param_name
+/// \details used to resolve parameter handles once, so that repeated updates (e.g., transient
+/// parameters or calibration) need not search by name
+/// \param param_name [in] Parameter identifier
+/// \returns address of parameter value, or NULL if parameter must be set by name
+//
+double *CTerrainClass::GetTerrainPropertyAddress(const string &param_name)
+{
+  return GetTerrainPropertyAddress(T,param_name);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Returns address of the terrain property corresponding to param_name within structure provided
+/// \note this is the terrain parameter name table used by SetTerrainProperty(); parameters which are not
+/// set by simple assignment are handled there as special cases
+/// \param &T [in] Terrain properties structure
+/// \param param_name [in] Parameter identifier
+/// \returns address of parameter value, or NULL if not a simple terrain parameter
+//
+double *CTerrainClass::GetTerrainPropertyAddress(terrain_struct &T,const string &param_name)
+{
+  string name;
+  name = StringToUppercase(param_name);
+
+  if      (!name.compare("HILLSLOPE_LENGTH"  )){return &(T.hillslope_length);}
+  else if (!name.compare("DRAINAGE_DENSITY"  )){return &(T.drainage_density);}
+  else if (!name.compare("TOPMODEL_LAMBDA"   )){return &(T.topmodel_lambda);}
+  return NULL;
+}
+//////////////////////////////////////////////////////////////////
 /// \brief Sets the value of the terrain property corresponding to param_name
 /// \param &T [out] Terrain properties class
 /// \param param_name [in] Parameter identifier
@@ -109,14 +138,11 @@ void  CTerrainClass::SetTerrainProperty(terrain_struct &T,
                                         const string param_name,
                                         const double value)
 {
-  string name;
-  name = StringToUppercase(param_name);
+  double *pVal=GetTerrainPropertyAddress(T,param_name);
 
-  if      (!name.compare("HILLSLOPE_LENGTH"  )){T.hillslope_length=value;}
-  else if (!name.compare("DRAINAGE_DENSITY"  )){T.drainage_density=value;}
-  else if (!name.compare("TOPMODEL_LAMBDA"   )){T.topmodel_lambda=value; }
+  if (pVal!=NULL){*pVal=value;}
   else{
-    WriteWarning("CTerrainClass::SetTerrainProperty: Unrecognized/invalid terrain parameter name ("+name+") in .rvp file",false);
+    WriteWarning("CTerrainClass::SetTerrainProperty: Unrecognized/invalid terrain parameter name ("+StringToUppercase(param_name)+") in .rvp file",false);
   }
 }
 //////////////////////////////////////////////////////////////////
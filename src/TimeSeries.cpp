@@ -5,9 +5,13 @@
 #include "TimeSeries.h"
 #include "ParseLib.h"
 #include "Forcings.h"
+#include "TimeSeriesCache.h"
 
 void GetNetCDFStationArray(const int ncid, const string filename,int &stat_dimid,int &stat_varid, long *&aStations, string *&aStat_strings,int &nStations);
 
+bool      CTimeSeries::_resample_on_demand=false;
+long long CTimeSeries::_memory_usage      =0;
+
 /*****************************************************************
    Constructor/Destructor
 ------------------------------------------------------------------
@@ -33,6 +37,11 @@ CTimeSeries::CTimeSeries(string Name, long long loc_ID, double one_value)
   _aSampVal =NULL; //generated in Resample() routine
   _nSampVal =0;    //generated in Resample() routine
   _sampInterval=1.0;
+  _sampOnDemand =false;
+  _aWindowStartT=NULL;
+  _aWindow      =NULL;
+  _winStart     =DOESNT_EXIST;
+  _memory_usage+=GetMemoryUsage();
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -81,7 +90,11 @@ CTimeSeries::CTimeSeries(string     Name,
   _aSampVal =NULL; //generated in Resample() routine
   _nSampVal =0;
   _sampInterval = 1.0;
-
+  _sampOnDemand =false;
+  _aWindowStartT=NULL;
+  _aWindow      =NULL;
+  _winStart     =DOESNT_EXIST;
+  _memory_usage+=GetMemoryUsage();
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -123,6 +136,11 @@ CTimeSeries::CTimeSeries(string     Name,
   _aSampVal =NULL; //generated in Resample() routine
   _nSampVal =0;
   _sampInterval=1.0;
+  _sampOnDemand =false;
+  _aWindowStartT=NULL;
+  _aWindow      =NULL;
+  _winStart     =DOESNT_EXIST;
+  _memory_usage+=GetMemoryUsage();
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -150,6 +168,12 @@ CTimeSeries::CTimeSeries(string Name,
 
   _aSampVal =NULL; //generated in Resample() routine
   _nSampVal =0;
+  _sampInterval=1.0;
+  _sampOnDemand =false;
+  _aWindowStartT=NULL;
+  _aWindow      =NULL;
+  _winStart     =DOESNT_EXIST;
+  _memory_usage+=GetMemoryUsage();
 }
 ///////////////////////////////////////////////////////////////////
 /// \brief Implementation of the destructor
@@ -157,8 +181,11 @@ CTimeSeries::CTimeSeries(string Name,
 CTimeSeries::~CTimeSeries()
 {
   if (DESTRUCTOR_DEBUG){cout<<"    DELETING TIME SERIES"<<endl;}
-  delete [] _aVal;     _aVal =NULL;
-  delete [] _aSampVal; _aSampVal=NULL;
+  _memory_usage-=GetMemoryUsage();
+  delete [] _aVal;          _aVal =NULL;
+  delete [] _aSampVal;      _aSampVal=NULL;
+  delete [] _aWindowStartT; _aWindowStartT=NULL;
+  delete [] _aWindow;       _aWindow=NULL;
 }
 
 /*****************************************************************
@@ -217,6 +244,38 @@ double CTimeSeries::GetValue(const int n)const{return _aVal[n];}
 //
 bool CTimeSeries::IsPulseType()  const{return _pulse;}
 
+///////////////////////////////////////////////////////////////////
+/// \brief Returns memory used by values of this time series
+/// \return memory usage (in bytes) of raw and resampled value arrays
+//
+long long CTimeSeries::GetMemoryUsage() const
+{
+  long long nVals=_nPulses;
+  if (_aSampVal!=NULL){nVals+=_nSampVal;}
+  if (_aWindow !=NULL){nVals+=TS_RESAMPLE_WINDOW+_nSampVal/TS_RESAMPLE_WINDOW+1;}
+  return nVals*(long long)(sizeof(double));
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Returns memory used by values of all regular time series
+/// \return memory usage (in bytes)
+//
+long long CTimeSeries::GetTotalMemoryUsage()
+{
+  return _memory_usage;
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Sets whether forcing time series subsequently initialized are resampled on demand
+/// \details if true, resampled values are generated in windows of TS_RESAMPLE_WINDOW time steps
+/// as they are requested rather than stored for the full model duration
+/// \param on_demand [in] true if resampling on demand (memory-lean mode)
+//
+void CTimeSeries::SetResampleOnDemand(const bool on_demand)
+{
+  _resample_on_demand=on_demand;
+}
+
 ///////////////////////////////////////////////////////////////////
 /// \brief Enables queries of time series values using model time
 /// \details Calculates _t_corr, correction to global model time, checks for overlap with model duration, resamples to model time step/day
@@ -273,6 +332,7 @@ void CTimeSeries::Initialize( const double model_start_day,   //julian day
 
   // Resample time series
   //------------------------------------------------------------------------------
+  _sampOnDemand=(_resample_on_demand && !is_observation);
   if (is_observation){Resample(timestep, model_duration+timestep);} //extra timestep needed for last observation of continuous hydrograph
   else               {Resample(timestep, model_duration);}
 }
@@ -289,6 +349,31 @@ void CTimeSeries::Resample(const double &tstep,          //days
   int nSampVal=(int)(ceil(model_duration/tstep-TIME_CORRECTION));
 
   if (!_pulse){nSampVal++;}
+
+  if (_sampOnDemand)
+  { //only store model time at start of each window; values generated in FillResampleWindow()
+    _memory_usage-=GetMemoryUsage();
+    _nSampVal=nSampVal;
+    _sampInterval=tstep;
+    ExitGracefullyIf(_nSampVal<=0,"CTimeSeries::Resample: bad # of samples",RUNTIME_ERR);
+
+    delete [] _aSampVal;      _aSampVal=NULL;
+    delete [] _aWindowStartT;
+    delete [] _aWindow;
+    _aWindowStartT=new double [_nSampVal/TS_RESAMPLE_WINDOW+1];
+    _aWindow      =new double [TS_RESAMPLE_WINDOW];
+    ExitGracefullyIf(_aWindow==NULL,"CTimeSeries::Resample",OUT_OF_MEMORY);
+    _winStart=DOESNT_EXIST;
+
+    double t=0;
+    for (int nn=0;nn<_nSampVal;nn++){
+      if (nn%TS_RESAMPLE_WINDOW==0){_aWindowStartT[nn/TS_RESAMPLE_WINDOW]=t;}
+      t+=tstep; //accumulated identically to below so that values are unchanged
+    }
+    _memory_usage+=GetMemoryUsage();
+    return;
+  }
+
   InitializeResample(nSampVal,tstep);
 
   double t=0;
@@ -311,6 +396,11 @@ void CTimeSeries::Resample(const double &tstep,          //days
 //
 void CTimeSeries::InitializeResample(const int nSampVal, const double sampInterval)
 {
+  _memory_usage-=GetMemoryUsage();
+  _sampOnDemand=false;
+  delete [] _aWindowStartT; _aWindowStartT=NULL;
+  delete [] _aWindow;       _aWindow      =NULL;
+
   _nSampVal=nSampVal;
   _sampInterval=sampInterval;
   ExitGracefullyIf(_nSampVal<=0,"CTimeSeries::InitializeResample: bad # of samples",RUNTIME_ERR);
@@ -325,6 +415,31 @@ void CTimeSeries::InitializeResample(const int nSampVal, const double sampInterv
   for (int nn=0;nn<_nSampVal;nn++){
     _aSampVal[nn] = RAV_BLANK_DATA;
   }
+  _memory_usage+=GetMemoryUsage();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Generates resampled values for window of time steps containing sample index nn
+/// \notes only used if resampling on demand; window values are identical to those generated by Resample()
+///
+/// \param nn [in] sample index (time step number)
+//
+void CTimeSeries::FillResampleWindow(const int nn) const
+{
+  int w=nn/TS_RESAMPLE_WINDOW;
+  _winStart=w*TS_RESAMPLE_WINDOW;
+  int nFill=min(TS_RESAMPLE_WINDOW,_nSampVal-_winStart);
+
+  double t=_aWindowStartT[w];
+  for (int i=0;i<nFill;i++){
+    if (_pulse){
+      _aWindow[i] = GetAvgValue(t, _sampInterval);
+    }
+    else{
+      _aWindow[i] = GetValue(t);
+    }
+    t+=_sampInterval;
+  }
 }
 
 //////////////////////////////////////////////////////////////////
@@ -487,6 +602,12 @@ double CTimeSeries::GetSampledValue(const int nn) const
   if (nn>_nSampVal-1){
     return RAV_BLANK_DATA;
   }
+  if (_sampOnDemand){
+    if ((_winStart==DOESNT_EXIST) || (nn<_winStart) || (nn>=_winStart+TS_RESAMPLE_WINDOW)){
+      FillResampleWindow(nn);
+    }
+    return _aWindow[nn-_winStart];
+  }
   return _aSampVal[nn];
 }
 ///////////////////////////////////////////////////////////////////
@@ -594,6 +715,7 @@ void CTimeSeries::SetValue(const int n, const double &val)
 //
 void CTimeSeries::SetSampledValue(const int nn, const double &val)
 {
+  ExitGracefullyIf(_sampOnDemand,"CTimeSeries::SetSampledValue: cannot overwrite values resampled on demand",RUNTIME_ERR);
 #ifdef _STRICTCHECK_
   ExitGracefullyIf(nn>=_nSampVal, "CTimeSeries::SetSampledValue: Overwriting array allocation",RUNTIME_ERR);
 #endif
@@ -1006,9 +1128,41 @@ CTimeSeries *CTimeSeries::Parse(CParser *p, bool is_pulse, string name, long lon
   }
 
   int n=0;
+
+  //use cached values if numeric data has already been parsed from unchanged file
+  int                   header_line=p->GetLineNumber();
+  CTimeSeriesCache     *pCache     =CTimeSeriesCache::GetCache(p->GetFilename());
+  const ts_cache_block *pBlock     =NULL;
+  if (pCache!=NULL){pBlock=pCache->GetBlock(header_line);}
+  bool                  from_cache =false;
+  if ((pBlock!=NULL) && (pBlock->nTS==1) && (pBlock->nVals==nMeasurements))
+  {
+    memcpy(aVal,pBlock->aVal,nMeasurements*sizeof(double));
+    n=nMeasurements;
+    streampos pos=pBlock->end_pos;
+    p->SetPosition(pos);
+    p->SetLineCounter(pBlock->end_line);
+    pCache->RecordHit();
+    from_cache=true;
+  }
+
+  double      aRow[MAXINPUTITEMS];
+  int         nRow;
+  parse_error perr;
   //cout << n << " "<<nMeasurements << " " << s[0] << " "<<Len<<" "<<strcmp(s[0],"&")<<" "<<p->Tokenize(s,Len)<<endl;
-  while ((n<nMeasurements) && (!p->Tokenize(s,Len)))
+  while ((n<nMeasurements) && ((perr=p->ParseNumericRow(aRow,MAXINPUTITEMS,nRow,s,Len))!=PARSE_EOF))
   {
+    if (perr==PARSE_GOOD) //purely numeric line - already parsed
+    {
+      if (n+nRow>nMeasurements)
+      {
+        cout << " n | nMeasurements " << n+nRow << " "<<nMeasurements<<endl;
+        ExitGracefully("CTimeSeries::Parse: Bad number of time series points",BAD_DATA);
+      }
+      memcpy(&(aVal[n]),aRow,nRow*sizeof(double));
+      n+=nRow;
+      continue;
+    }
     if (IsComment(s[0],Len)){p->Tokenize(s,Len);}//try again
     for(int i=0;i<Len;i++){
       if (n>=nMeasurements)
@@ -1035,6 +1189,9 @@ CTimeSeries *CTimeSeries::Parse(CParser *p, bool is_pulse, string name, long lon
     cout << " n | nMeasurements " << n << " "<<nMeasurements<<endl;
     ExitGracefully("CTimeSeries::Parse: Insufficient number of time series points",BAD_DATA);
   }
+  if ((pCache!=NULL) && (!from_cache)){
+    pCache->AddBlock(header_line,1,n,&aVal,p->GetPosition(),p->GetLineNumber());
+  }
 
   p->Tokenize(s,Len);//read closing term (e.g., ":EndData")
   if(string(s[0]).substr(0,4)!=":End"){
@@ -1084,6 +1241,7 @@ CTimeSeries **CTimeSeries::ParseMultiple(CParser *p, int &nTS, forcing_type *aTy
   p->Tokenize(s,Len);
   if (IsComment(s[0],Len)){p->Tokenize(s,Len);}//try again
   if (Len<4){p->ImproperFormat(s);}
+  int header_line=p->GetLineNumber();
 
   if(IsValidDateString(s[0]))
   {//in timestamp format  [yyyy-mm-dd] [hh:mm:ss.0] [timestep] [nMeasurements]
@@ -1146,8 +1304,49 @@ CTimeSeries **CTimeSeries::ParseMultiple(CParser *p, int &nTS, forcing_type *aTy
     aVal[i] =new double [nMeasurements];
   }
   int n=0;
-  while (!p->Tokenize(s,Len))
+
+  //use cached values if numeric data has already been parsed from unchanged file
+  CTimeSeriesCache     *pCache    =CTimeSeriesCache::GetCache(p->GetFilename());
+  const ts_cache_block *pBlock    =NULL;
+  bool                  from_cache=false;
+  if (pCache!=NULL){pBlock=pCache->GetBlock(header_line);}
+  if ((pBlock!=NULL) && (pBlock->nTS==nTS) && (pBlock->nVals==nMeasurements))
   {
+    for (i=0;i<nTS;i++){
+      memcpy(aVal[i],&(pBlock->aVal[i*nMeasurements]),nMeasurements*sizeof(double));
+    }
+    n=nMeasurements;
+    streampos pos=pBlock->end_pos;
+    p->SetPosition(pos);
+    p->SetLineCounter(pBlock->end_line);
+    pCache->RecordHit();
+    from_cache=true;
+  }
+
+  double      aRow[MAXINPUTITEMS];
+  int         nRow;
+  parse_error perr;
+  while ((!from_cache) && ((perr=p->ParseNumericRow(aRow,MAXINPUTITEMS,nRow,s,Len))!=PARSE_EOF))
+  {
+    if (perr==PARSE_GOOD) //purely numeric line - already parsed
+    {
+      if (nRow!=nTS)
+      {
+        cout<<"line number: "<<p->GetLineNumber()<<endl;
+        cout<<"measurement " <<n+1 << " of "<<nMeasurements<<endl;
+        string error="CTimeSeries:ParseMultiple: wrong number of columns in :MultiData data. File: "+p->GetFilename();
+        ExitGracefully(error.c_str(),BAD_DATA);
+      }
+      if (n>=nMeasurements)
+      {
+        cout<<" first val | nMeaurements: "<<aRow[0]<<" | "<<n<<" nMeasurements"<<endl;
+        string error="CTimeSeries::ParseMultiple: Bad number of time series points. File: "+p->GetFilename();
+        ExitGracefully(error.c_str(),BAD_DATA);
+      }
+      for(i=0;i<nTS;i++){aVal[i][n]=aRow[i];}
+      n++;
+      continue;
+    }
     if (!IsComment(s[0],Len))
     {
       if (!strcmp(s[0],":EndMultiData")){break;}
@@ -1183,6 +1382,9 @@ CTimeSeries **CTimeSeries::ParseMultiple(CParser *p, int &nTS, forcing_type *aTy
     string error="CTimeSeries::ParseMultiple: Insufficient number of time series points. File: "+p->GetFilename();
     ExitGracefully(error.c_str(),BAD_DATA);
   }
+  if ((pCache!=NULL) && (!from_cache)){
+    pCache->AddBlock(header_line,nTS,n,aVal,p->GetPosition(),p->GetLineNumber());
+  }
 
   // finished. Now process data --------------------------------
   pTimeSeries=new CTimeSeries *[nTS];
@@ -10,6 +10,8 @@
 #include "ParseLib.h"
 #include "Forcings.h"
 
+const int TS_RESAMPLE_WINDOW=1024; ///< number of resampled values held in memory per time series when resampling on demand
+
 ///////////////////////////////////////////////////////////////////
 /// \brief Data abstraction for a continuous time series recorded by a gauge
 /// \details Data Abstraction for time series conceptualized as a set of step
@@ -36,6 +38,14 @@ private:/*------------------------------------------------------*/
   int     _nSampVal; ///< size of aSampVal (~model_duration/timestep)
   double  _sampInterval; ///< timestep of resampled timeseries
 
+  bool    _sampOnDemand;     ///< true if resampled values are generated in windows on demand rather than stored in _aSampVal
+  double *_aWindowStartT;    ///< model time at start of each resampling window [_nSampVal/TS_RESAMPLE_WINDOW+1] (on demand only)
+  mutable double *_aWindow;  ///< resampled values in current window [TS_RESAMPLE_WINDOW] (on demand only)
+  mutable int     _winStart; ///< sample index of first value in current window, DOESNT_EXIST if not yet generated
+
+  static bool      _resample_on_demand; ///< true if forcing time series are resampled on demand (memory-lean mode)
+  static long long _memory_usage;       ///< total bytes currently allocated to values of all regular time series
+
   bool   _sub_daily; ///< true if smallest time interval is sub-daily
 
   double    _t_corr; ///< number of days between model start date and gauge start date (positive if data exists before model start date)
@@ -45,6 +55,8 @@ private:/*------------------------------------------------------*/
   ///< \remark forcing functions are all pulse-based
 
   int     GetTimeIndex(const double &t_loc) const;
+  long long GetMemoryUsage() const;
+  void    FillResampleWindow(const int nn) const;
 
   void        Resample(const double &tstep,          //days
                        const double &model_duration);//days
@@ -104,6 +116,9 @@ public:/*-------------------------------------------------------*/
   double GetSampledInterval() const;
   int    GetNumSampledValues() const;
 
+  static void      SetResampleOnDemand  (const bool on_demand);
+  static long long GetTotalMemoryUsage  ();
+
   int    GetTimeIndexFromModelTime(const double &t_mod) const;
 
   double GetDailyAvg    (const int model_day) const;
@@ -0,0 +1,233 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2024 the Raven Development Team
+  ----------------------------------------------------------------
+  TimeSeriesCache.cpp
+  ----------------------------------------------------------------*/
+#include "TimeSeriesCache.h"
+
+const char TS_CACHE_MAGIC[8]  ={'R','V','N','T','S','C','C','H'}; ///< identifies Raven time series cache files
+const int  TS_CACHE_VERSION   =1;                                 ///< increment whenever binary layout changes
+
+bool                            CTimeSeriesCache::_enabled=false;
+map<string,CTimeSeriesCache *>  CTimeSeriesCache::_mCaches;
+
+//////////////////////////////////////////////////////////////////
+/// \brief Constructor - reads existing cache file if it is consistent with the source file
+/// \param filename [in] source text input file
+//
+CTimeSeriesCache::CTimeSeriesCache(const string filename)
+{
+  _filename =filename;
+  _cachefile=filename+".rvcache";
+  _hash     =HashFile(filename);
+  _modified =false;
+  _nHits    =0;
+  if (!ReadCacheFile()){
+    _modified=true; //stale or missing - will be (re)written
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Destructor
+//
+CTimeSeriesCache::~CTimeSeriesCache()
+{
+  for (int i=0;i<(int)(_aBlocks.size());i++){
+    delete [] _aBlocks[i]->aVal;
+    delete _aBlocks[i];
+  }
+  _aBlocks.clear();
+}
+//////////////////////////////////////////////////////////////////
+/// \brief 64-bit FNV-1a hash of file contents (and length)
+/// \param filename [in] file to hash
+/// \returns hash, or 0 if file cannot be opened
+//
+unsigned long long CTimeSeriesCache::HashFile(const string filename)
+{
+  const unsigned long long FNV_OFFSET=14695981039346656037ULL;
+  const unsigned long long FNV_PRIME =1099511628211ULL;
+  const int                BUFSIZE   =1<<20;
+
+  ifstream IN(filename.c_str(),ios::binary);
+  if (IN.fail()){return 0;}
+
+  unsigned long long hash=FNV_OFFSET;
+  unsigned long long len =0;
+  char *buf=new char [BUFSIZE];
+  while (IN)
+  {
+    IN.read(buf,BUFSIZE);
+    streamsize n=IN.gcount();
+    for (streamsize i=0;i<n;i++){
+      hash^=(unsigned char)(buf[i]);
+      hash*=FNV_PRIME;
+    }
+    len+=(unsigned long long)(n);
+  }
+  delete [] buf;
+  hash^=len;
+  hash*=FNV_PRIME;
+  return hash;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief reads binary cache file
+/// \returns true if cache file exists, has correct version and matches source file hash
+//
+bool CTimeSeriesCache::ReadCacheFile()
+{
+  ifstream IN(_cachefile.c_str(),ios::binary);
+  if (IN.fail()){return false;}
+
+  char               magic[8];
+  int                version,sizeof_dbl,nBlocks;
+  unsigned long long hash;
+  IN.read(magic,8);
+  IN.read((char*)(&version)   ,sizeof(int));
+  IN.read((char*)(&sizeof_dbl),sizeof(int));
+  IN.read((char*)(&hash)      ,sizeof(unsigned long long));
+  IN.read((char*)(&nBlocks)   ,sizeof(int));
+  if ((IN.fail()) || (memcmp(magic,TS_CACHE_MAGIC,8)!=0) || (version!=TS_CACHE_VERSION) ||
+      (sizeof_dbl!=(int)(sizeof(double))) || (hash!=_hash) || (nBlocks<0)){
+    return false;
+  }
+  for (int b=0;b<nBlocks;b++)
+  {
+    ts_cache_block *pB=new ts_cache_block;
+    IN.read((char*)(&pB->line)    ,sizeof(int));
+    IN.read((char*)(&pB->nTS)     ,sizeof(int));
+    IN.read((char*)(&pB->nVals)   ,sizeof(int));
+    IN.read((char*)(&pB->end_line),sizeof(int));
+    IN.read((char*)(&pB->end_pos) ,sizeof(long long));
+    if ((IN.fail()) || (pB->nTS<0) || (pB->nVals<0)){delete pB; return false;}
+    pB->aVal=new double [pB->nTS*pB->nVals];
+    IN.read((char*)(pB->aVal),sizeof(double)*pB->nTS*pB->nVals);
+    _aBlocks.push_back(pB);
+    if (IN.fail()){return false;}
+  }
+  return true;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief writes binary cache file
+//
+void CTimeSeriesCache::WriteCacheFile(const optStruct &Options) const
+{
+  ofstream OUT(_cachefile.c_str(),ios::binary);
+  if (OUT.fail()){
+    WriteWarning("CTimeSeriesCache::WriteCacheFile: unable to write input cache file "+_cachefile,Options.noisy);
+    return;
+  }
+  int version   =TS_CACHE_VERSION;
+  int sizeof_dbl=(int)(sizeof(double));
+  int nBlocks   =(int)(_aBlocks.size());
+  OUT.write(TS_CACHE_MAGIC,8);
+  OUT.write((const char*)(&version)   ,sizeof(int));
+  OUT.write((const char*)(&sizeof_dbl),sizeof(int));
+  OUT.write((const char*)(&_hash)     ,sizeof(unsigned long long));
+  OUT.write((const char*)(&nBlocks)   ,sizeof(int));
+  for (int b=0;b<nBlocks;b++)
+  {
+    const ts_cache_block *pB=_aBlocks[b];
+    OUT.write((const char*)(&pB->line)    ,sizeof(int));
+    OUT.write((const char*)(&pB->nTS)     ,sizeof(int));
+    OUT.write((const char*)(&pB->nVals)   ,sizeof(int));
+    OUT.write((const char*)(&pB->end_line),sizeof(int));
+    OUT.write((const char*)(&pB->end_pos) ,sizeof(long long));
+    OUT.write((const char*)(pB->aVal)     ,sizeof(double)*pB->nTS*pB->nVals);
+  }
+  OUT.close();
+}
+//////////////////////////////////////////////////////////////////
+/// \brief turns caching on or off
+//
+void CTimeSeriesCache::Enable(const bool enable)
+{
+  _enabled=enable;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief returns cache associated with source file, creating (and reading) it upon first request
+/// \param filename [in] source text input file
+/// \returns pointer to cache, or NULL if caching is not enabled
+//
+CTimeSeriesCache *CTimeSeriesCache::GetCache(const string filename)
+{
+  if (!_enabled){return NULL;}
+  map<string,CTimeSeriesCache *>::iterator it=_mCaches.find(filename);
+  if (it!=_mCaches.end()){return it->second;}
+
+  CTimeSeriesCache *pCache=new CTimeSeriesCache(filename);
+  _mCaches[filename]=pCache;
+  return pCache;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief writes all modified caches, reports cache usage, deletes caches and disables caching
+//
+void CTimeSeriesCache::FinalizeAll(const optStruct &Options)
+{
+  int nBlocks=0,nHits=0;
+  for (map<string,CTimeSeriesCache *>::iterator it=_mCaches.begin(); it!=_mCaches.end(); it++)
+  {
+    CTimeSeriesCache *pCache=it->second;
+    if (pCache->_modified){pCache->WriteCacheFile(Options);}
+    nBlocks+=(int)(pCache->_aBlocks.size());
+    nHits  +=pCache->_nHits;
+    delete pCache;
+  }
+  if ((_enabled) && (!Options.silent)){
+    cout<<"  Input cache: "<<nHits<<" of "<<nBlocks<<" time series data blocks read from cache"<<endl;
+  }
+  _mCaches.clear();
+  _enabled=false;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief returns cached block with header on given line of source file, or NULL if not cached
+/// \param line [in] line number of block header
+//
+const ts_cache_block *CTimeSeriesCache::GetBlock(const int line) const
+{
+  //blocks are stored in order of appearance; binary search on line
+  int lo=0,hi=(int)(_aBlocks.size())-1;
+  while (lo<=hi){
+    int mid=(lo+hi)/2;
+    if      (_aBlocks[mid]->line==line){return _aBlocks[mid];}
+    else if (_aBlocks[mid]->line< line){lo=mid+1;}
+    else                               {hi=mid-1;}
+  }
+  return NULL;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief adds newly parsed block to cache
+/// \param line     [in] line number of block header
+/// \param nTS      [in] number of time series in block
+/// \param nVals    [in] number of values per time series
+/// \param aVal     [in] parsed values [nTS][nVals]
+/// \param end_pos  [in] stream position after numeric data
+/// \param end_line [in] line number after numeric data
+//
+void CTimeSeriesCache::AddBlock(const int line, const int nTS, const int nVals, double **aVal,
+                                const streampos &end_pos, const int end_line)
+{
+  if ((long long)(end_pos)<0){return;} //EOF reached - position unavailable
+  if (GetBlock(line)!=NULL)   {return;}
+  if ((!_aBlocks.empty()) && (_aBlocks.back()->line>line)){return;} //preserve ordering
+
+  ts_cache_block *pB=new ts_cache_block;
+  pB->line    =line;
+  pB->nTS     =nTS;
+  pB->nVals   =nVals;
+  pB->end_pos =(long long)(end_pos);
+  pB->end_line=end_line;
+  pB->aVal    =new double [nTS*nVals];
+  for (int i=0;i<nTS;i++){
+    memcpy(&(pB->aVal[i*nVals]),aVal[i],sizeof(double)*nVals);
+  }
+  _aBlocks.push_back(pB);
+  _modified=true;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief records that a block was supplied from cache (for reporting)
+//
+void CTimeSeriesCache::RecordHit()
+{
+  _nHits++;
+}
@@ -0,0 +1,67 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2024 the Raven Development Team
+  ----------------------------------------------------------------
+  TimeSeriesCache.h
+  ----------------------------------------------------------------*/
+#ifndef TIMESERIESCACHE_H
+#define TIMESERIESCACHE_H
+
+#include "RavenInclude.h"
+#include <map>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////
+/// \brief numeric block of one or more time series parsed from a text input file
+//
+struct ts_cache_block
+{
+  int        line;     ///< line number of block header in source file (unique block key)
+  int        nTS;      ///< number of time series (columns) in block
+  int        nVals;    ///< number of values per time series
+  long long  end_pos;  ///< stream position in source file immediately after numeric data
+  int        end_line; ///< line number in source file immediately after numeric data
+  double    *aVal;     ///< parsed values, stored by time series [nTS*nVals]
+};
+
+///////////////////////////////////////////////////////////////////
+/// \brief Versioned binary cache of parsed time series data blocks for a single text input file
+/// \details When :UseInputCache is specified, numeric :Data and :MultiData blocks parsed from
+/// each .rvt (or redirected) file are stored in [filename].rvcache, keyed by a hash of the
+/// source file contents. Subsequent runs with an unchanged source file copy values straight
+/// from the cache and seek the parser past the numeric data rather than re-tokenizing it.
+/// Caches are only active while ParseTimeSeriesFile() is running.
+//
+class CTimeSeriesCache
+{
+private:/*------------------------------------------------------*/
+  string                    _filename;  ///< source text input file
+  string                    _cachefile; ///< binary cache file
+  unsigned long long        _hash;      ///< hash of source file contents
+  bool                      _modified;  ///< true if blocks were added since cache was read
+  int                       _nHits;     ///< number of blocks supplied from cache
+  vector<ts_cache_block *>  _aBlocks;   ///< array of cached blocks, in order of appearance
+
+  static bool                              _enabled; ///< true if caching is currently active
+  static map<string,CTimeSeriesCache *>    _mCaches; ///< registry of caches, by source filename
+
+  CTimeSeriesCache(const string filename);
+
+  bool ReadCacheFile ();
+  void WriteCacheFile(const optStruct &Options) const;
+
+public:/*-------------------------------------------------------*/
+  ~CTimeSeriesCache();
+
+  static unsigned long long HashFile(const string filename);
+
+  static void               Enable     (const bool enable);
+  static CTimeSeriesCache  *GetCache   (const string filename);
+  static void               FinalizeAll(const optStruct &Options);
+
+  const ts_cache_block     *GetBlock   (const int line) const;
+  void                      AddBlock   (const int line, const int nTS, const int nVals, double **aVal,
+                                        const streampos &end_pos, const int end_line);
+  void                      RecordHit  ();
+};
+#endif
@@ -9,6 +9,7 @@ coordinates information about constituent storage
 #include "HydroProcessABC.h"
 #include "Model.h"
 #include "Transport.h"
+#include "Checkpoint.h"
 #include "HeatConduction.h"
 #include "EnergyTransport.h"
 #include "IsotopeTransport.h"
@@ -929,3 +930,21 @@ void  CTransportModel::WriteMajorOutput(ofstream &RVC) const
     _pConstitModels[c]->WriteMajorOutput(RVC);
   }
 }
+//////////////////////////////////////////////////////////////////
+/// \brief Writes constituent routing states to binary checkpoint
+//
+void  CTransportModel::WriteToCheckpoint(CCheckpoint &C) const
+{
+  for(int c=0;c<_nConstituents;c++) {
+    _pConstitModels[c]->WriteToCheckpoint(C);
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Reads constituent routing states from binary checkpoint
+//
+void  CTransportModel::ReadFromCheckpoint(CCheckpoint &C)
+{
+  for(int c=0;c<_nConstituents;c++) {
+    _pConstitModels[c]->ReadFromCheckpoint(C);
+  }
+}
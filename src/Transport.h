@@ -69,6 +69,7 @@ struct geochem_param
 class CModel;
 class CConstituentModel;
 class CEnthalpyModel;
+class CCheckpoint;
 
 class CTransportModel
 {
@@ -180,6 +181,8 @@ public:/*-------------------------------------------------------*/
   void   WriteOutputFileHeaders     (const optStruct &Options) const;
   void   WriteMinorOutput           (const optStruct &Options,const time_struct &tt) const;
   void   WriteMajorOutput           (ofstream& RVC) const;
+  void   WriteToCheckpoint          (CCheckpoint &C) const;
+  void   ReadFromCheckpoint         (CCheckpoint &C);
   void   CloseOutputFiles           () const;
 };
 ///////////////////////////////////////////////////////////////////
@@ -324,6 +327,8 @@ public:/*-------------------------------------------------------*/
   virtual void   WriteNetCDFOutputFileHeaders(const optStruct &Options);
   virtual void   WriteNetCDFMinorOutput      (const optStruct &Options,const time_struct& tt);
           void   WriteMajorOutput            (ofstream& RVC) const;
+  virtual void   WriteToCheckpoint           (CCheckpoint &C) const;
+  virtual void   ReadFromCheckpoint          (CCheckpoint &C);
   virtual void   CloseOutputFiles            ();
 };
 
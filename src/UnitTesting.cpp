@@ -8,6 +8,10 @@
 #include "Radiation.h"
 #include "GlobalParams.h"
 #include "UnitTesting.h"
+#include "EnKF.h"
+#include "Matrix.h"
+#include "Profiler.h"
+#include "DemandOptimization.h"
 
 void RavenUnitTesting(const optStruct &Options)
 {
@@ -35,6 +39,7 @@ void RavenUnitTesting(const optStruct &Options)
   //TestGammaSampling();
   //TestWetBulbTemps();
   //TestDateStrings();
+  //EnKFAnalysisBenchmark();
 
 }
 /////////////////////////////////////////////////////////////////
@@ -604,3 +609,478 @@ void TestWetBulbTemps() {
   cout<<T<<" ,"<<RH<<" "<<GetWetBulbTemperature(P,T,RH)<<endl;
   ExitGracefully("UnitTesting:: TestWetBulbTemps",SIMULATION_DONE);
 }
+
+/////////////////////////////////////////////////////////////////
+/// \brief reference EnKF analysis: SVD of innovation covariance for each member, naive matrix products
+/// (former implementation of CEnKFEnsemble::AssimilationCalcs(), retained for benchmarking only)
+//
+static void ReferenceEnKFAnalysis(const int N,const int M,const int Nobs,double **X,double **O_sim,double **O_obs,double **eQT)
+{
+  double **HA,**HAT,**A,**P,**eQ,**tmp,**MM,**Z,**XdT,**Xd;
+  double *ans =new double[Nobs];
+  double *diff=new double[Nobs];
+  AllocateMatrix(M,N,A);        AllocateMatrix(Nobs,N,HA);  AllocateMatrix(N,Nobs,HAT);
+  AllocateMatrix(Nobs,Nobs,P);  AllocateMatrix(Nobs,N,eQ);  AllocateMatrix(Nobs,Nobs,tmp);
+  AllocateMatrix(Nobs,N,MM);    AllocateMatrix(N,N,Z);      AllocateMatrix(M,N,XdT);
+  AllocateMatrix(N,M,Xd);
+  for(int j=0;j<Nobs;j++) {
+    double mean=0; for(int i=0;i<N;i++) { mean+=O_sim[i][j]/N; }
+    for(int i=0;i<N;i++) { HA[j][i]=O_sim[i][j]-mean; }
+  }
+  for(int k=0;k<M;k++) {
+    double mean=0; for(int i=0;i<N;i++) { mean+=X[i][k]/N; }
+    for(int i=0;i<N;i++) { A[k][i]=X[i][k]-mean; }
+  }
+  TransposeMat(HA,Nobs,N,HAT);
+  MatMult(HA,HAT,Nobs,N,Nobs,P);
+  TransposeMat(eQT,N,Nobs,eQ);
+  MatMult(eQ,eQT,Nobs,N,Nobs,tmp);
+  MatAdd(P,tmp,Nobs,Nobs,P);
+  ScalarMatMult(P,1.0/(N-1),Nobs,Nobs,P);
+  for(int i=0;i<N;i++) {
+    for(int j=0;j<Nobs;j++) { diff[j]=O_obs[i][j]-O_sim[i][j]; }
+    SVD(P,diff,ans,Nobs,1e-8);
+    for(int j=0;j<Nobs;j++) { MM[j][i]=ans[j]; }
+  }
+  MatMult(HAT,MM,N,Nobs,N,Z);
+  MatMult(A,Z,M,N,N,XdT);
+  ScalarMatMult(XdT,1.0/(N-1),M,N,XdT);
+  TransposeMat(XdT,M,N,Xd);
+  MatAdd(X,Xd,N,M,X);
+  delete[] ans; delete[] diff;
+  DeleteMatrix(M,N,A);       DeleteMatrix(Nobs,N,HA); DeleteMatrix(N,Nobs,HAT);
+  DeleteMatrix(Nobs,Nobs,P); DeleteMatrix(Nobs,N,eQ); DeleteMatrix(Nobs,Nobs,tmp);
+  DeleteMatrix(Nobs,N,MM);   DeleteMatrix(N,N,Z);     DeleteMatrix(M,N,XdT);
+  DeleteMatrix(N,M,Xd);
+}
+/////////////////////////////////////////////////////////////////
+/// \brief Benchmarks EnKF analysis time vs. ensemble size (N) and number of observations (Nobs)
+/// \details writes EnKFAnalysisBenchmark.csv; reference (per-member SVD) timings only for Nobs<=200.
+/// If Nobs>=N, P is rank-deficient and both methods use truncated SVD; differences then reflect truncation of
+/// singular values near the tolerance rather than error
+//
+void EnKFAnalysisBenchmark()
+{
+  const int nNs=4;   const int aN   [nNs]={25,50,100,200};
+  const int nNobs=4; const int aNobs[nNobs]={50,100,200,800};
+  const int M=500;   //number of assimilated state variables
+
+  ofstream BENCH;
+  BENCH.open("EnKFAnalysisBenchmark.csv");
+  BENCH<<"N,Nobs,M,analysis time [s],reference time [s],speedup,max abs state difference"<<endl;
+  srand(42);
+  for(int a=0;a<nNs;a++) {
+    for(int b=0;b<nNobs;b++)
+    {
+      int N=aN[a]; int Nobs=aNobs[b];
+      double **X,**Xref,**O_sim,**O_obs,**eQT;
+      AllocateMatrix(N,M,X); AllocateMatrix(N,M,Xref);
+      AllocateMatrix(N,Nobs,O_sim); AllocateMatrix(N,Nobs,O_obs); AllocateMatrix(N,Nobs,eQT);
+      for(int i=0;i<N;i++) {
+        for(int k=0;k<M;k++) { X[i][k]=Xref[i][k]=10.0*rand()/RAND_MAX; }
+        for(int j=0;j<Nobs;j++) {
+          O_sim[i][j]=10.0*rand()/RAND_MAX;
+          eQT  [i][j]=0.5*(rand()/(double)RAND_MAX-0.5);
+          O_obs[i][j]=5.0+eQT[i][j];
+        }
+      }
+      clock_t t0=clock();
+      CEnKFEnsemble::EnKFAnalysis(N,M,Nobs,X,O_sim,O_obs,eQT);
+      double tnew=float(clock()-t0)/CLOCKS_PER_SEC;
+
+      double tref=0,maxdiff=0;
+      if(Nobs<=200) {
+        t0=clock();
+        ReferenceEnKFAnalysis(N,M,Nobs,Xref,O_sim,O_obs,eQT);
+        tref=float(clock()-t0)/CLOCKS_PER_SEC;
+        for(int i=0;i<N;i++) {
+          for(int k=0;k<M;k++) { upperswap(maxdiff,fabs(X[i][k]-Xref[i][k])); }
+        }
+      }
+      BENCH<<N<<","<<Nobs<<","<<M<<","<<tnew<<",";
+      if(Nobs<=200) { BENCH<<tref<<","<<tref/max(tnew,1e-6)<<","<<maxdiff<<endl; }
+      else          { BENCH<<",,"<<endl; }
+      cout<<"EnKF analysis N="<<N<<" Nobs="<<Nobs<<": "<<tnew<<" s (reference: "<<tref<<" s)"<<endl;
+
+      DeleteMatrix(N,M,X); DeleteMatrix(N,M,Xref);
+      DeleteMatrix(N,Nobs,O_sim); DeleteMatrix(N,Nobs,O_obs); DeleteMatrix(N,Nobs,eQT);
+    }
+  }
+  BENCH.close();
+  ExitGracefully("EnKFAnalysisBenchmark",SIMULATION_DONE);
+}
+
+/////////////////////////////////////////////////////////////////
+// Kernel micro-benchmarks
+/////////////////////////////////////////////////////////////////
+static volatile double bench_sink=0.0; //keeps benchmarked results live so kernels are not optimized away
+
+//////////////////////////////////////////////////////////////////
+/// \brief times a single kernel and writes ns/call statistics to screen and BENCH
+/// \details the number of calls per trial is doubled until one trial takes at least MIN_TRIAL_TIME;
+/// NTRIALS trials are then timed and the median, min, max and interquartile range of the time per
+/// call reported. kernel(n) is passed the call index n so inputs may vary from call to call
+///
+/// \param group [in] kernel group (e.g., routing)
+/// \param name [in] kernel name/configuration
+/// \param kernel [in] functor double(long) evaluating kernel once
+/// \param &BENCH [out] MicroBenchmarks.csv output stream
+/// \param &Options [in] global model options
+//
+template<class KERNEL> static void TimeKernel(const string group, const string name, KERNEL kernel, ofstream &BENCH, const optStruct &Options)
+{
+  const int    NTRIALS       =11;
+  const double MIN_TRIAL_TIME=0.02; //[s]
+  const long   MAX_CALLS     =1L<<28;
+
+  long   n,ncalls=1;
+  double t0,dt,sum=0.0;
+  do {
+    t0=CProfiler::Now();
+    for(n=0;n<ncalls;n++) { sum+=kernel(n); }
+    dt=CProfiler::Now()-t0;
+    if(dt<MIN_TRIAL_TIME) { ncalls*=2; }
+  } while((dt<MIN_TRIAL_TIME) && (ncalls<MAX_CALLS));
+
+  vector<double> aTime(NTRIALS); //[ns/call]
+  for(int k=0;k<NTRIALS;k++) {
+    t0=CProfiler::Now();
+    for(n=0;n<ncalls;n++) { sum+=kernel(n); }
+    aTime[k]=(CProfiler::Now()-t0)/ncalls*1e9;
+  }
+  bench_sink=sum;
+  sort(aTime.begin(),aTime.end());
+
+  double med=aTime[NTRIALS/2];
+  double iqr=aTime[(3*NTRIALS)/4]-aTime[NTRIALS/4];
+  BENCH<<group<<","<<name<<","<<ncalls<<","<<NTRIALS<<","<<med<<","<<aTime[0]<<","<<aTime[NTRIALS-1]<<","<<iqr<<endl;
+  if(!Options.silent) {
+    printf("  %-12s %-44s %12.1f ns/call (min %10.1f, max %10.1f)\n",group.c_str(),name.c_str(),med,aTime[0],aTime[NTRIALS-1]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Times computational kernels in isolation (run with -mb executable flag)
+/// \details called after model initialization; kernels which require model structure (subbasin routing)
+/// are set up synthetically using the model's global parameters, so results are independent of the
+/// model being run. Writes MicroBenchmarks.csv (ns per call; median, min, max and interquartile range
+/// over repeated trials), then exits.
+///
+/// \param pModel [in] initialized model
+/// \param &Options [in] global model options
+//
+void RavenMicroBenchmarks(CModel *pModel,const optStruct &Options)
+{
+  ofstream BENCH;
+  string filename=FilenamePrepare("MicroBenchmarks.csv",Options);
+  BENCH.open(filename.c_str());
+  if(BENCH.fail()) {
+    ExitGracefully(("RavenMicroBenchmarks: unable to open file "+filename).c_str(),FILE_OPEN_ERR);
+  }
+  BENCH<<"group,kernel,calls per trial,trials,median [ns/call],min [ns/call],max [ns/call],interquartile range [ns/call]"<<endl;
+  if(!Options.silent) { cout<<"RAVEN MICRO-BENCHMARKS"<<endl; }
+
+  srand(42);
+
+  // numerical utilities
+  //----------------------------------------------------------------
+  const int nv=20;
+  double v[nv];
+  for(int j=0;j<nv;j++) { v[j]=1.0+5.0*((double)(rand())/RAND_MAX); }
+  TimeKernel("utility","TimeVaryingADRCumDist (nv=20)",[&](long n) {
+    return TimeVaryingADRCumDist(0.5+(double)(n%19),5.0,v,nv,0.3,1.0);
+  },BENCH,Options);
+
+  const int NI=50;
+  double xx[NI],yy[NI];
+  for(int i=0;i<NI;i++) { xx[i]=(double)(i)*(double)(i); yy[i]=sqrt(xx[i]); }
+  TimeKernel("utility","InterpolateCurve (N=50)",[&](long n) {
+    return InterpolateCurve((double)(n%2600),xx,yy,NI,false);
+  },BENCH,Options);
+
+  // radiation
+  //----------------------------------------------------------------
+  TimeKernel("radiation","CalcETRadiation2 (daily)",[](long n) {
+    double lat   =(-60.0+(double)(n%120))*PI/180.0;
+    double declin=0.409*sin(2*PI/365*(double)(n%365)-1.39);
+    return CRadiation::CalcETRadiation2(lat,lat,declin,1.0,0.0,-0.5,0.5,true);
+  },BENCH,Options);
+  TimeKernel("radiation","CalcETRadiation2 (sloped, hourly)",[](long n) {
+    double lat   =(-60.0+(double)(n%120))*PI/180.0;
+    double declin=0.409*sin(2*PI/365*(double)(n%365)-1.39);
+    double t1    =-0.5+(double)(n%24)/24.0;
+    return CRadiation::CalcETRadiation2(lat,lat+0.1,declin,1.0,0.2,t1,t1+1.0/24.0,false);
+  },BENCH,Options);
+
+  // time series and forcing grids
+  //----------------------------------------------------------------
+  const int nDays=3650;
+  double *aVals=new double[24*nDays];
+  for(int i=0;i<24*nDays;i++) { aVals[i]=10.0*rand()/RAND_MAX; }
+  CTimeSeries *pDaily =new CTimeSeries("BENCH_DAILY" ,DOESNT_EXIST,"",Options.julian_start_day,Options.julian_start_year,1.0     ,aVals,nDays   ,true);
+  CTimeSeries *pHourly=new CTimeSeries("BENCH_HOURLY",DOESNT_EXIST,"",Options.julian_start_day,Options.julian_start_year,1.0/24.0,aVals,24*nDays,true);
+  delete [] aVals;
+  pDaily ->Initialize(Options.julian_start_day,Options.julian_start_year,nDays,1.0,false,Options.calendar);
+  pHourly->Initialize(Options.julian_start_day,Options.julian_start_year,nDays,1.0,false,Options.calendar);
+  TimeKernel("timeseries","CTimeSeries::GetAvgValue (daily data)",[&](long n) {
+    return pDaily->GetAvgValue((double)(n%(nDays-1)),1.0);
+  },BENCH,Options);
+  TimeKernel("timeseries","CTimeSeries::GetAvgValue (hourly data)",[&](long n) {
+    return pHourly->GetAvgValue((double)(n%(nDays-1)),1.0);
+  },BENCH,Options);
+  delete pDaily;
+  delete pHourly;
+
+  const int nCols=100,nRows=100,nSteps=365,nGridHRUs=1000;
+  string aDimNames[3]={"lon","lat","time"};
+  int    aGridDims[3]={nCols,nRows,nSteps};
+  CForcingGrid *pGrid=new CForcingGrid("PRECIP","none","none",aDimNames,true);
+  pGrid->SetGridDims(aGridDims);
+  pGrid->SetInterval(1.0);
+  pGrid->SetChunkSize(nSteps);
+  pGrid->SetnHydroUnits(nGridHRUs);
+  pGrid->AllocateWeightArray(nGridHRUs,nCols*nRows);
+  for(int k=0;k<nGridHRUs;k++) {
+    int c=rand()%(nCols*nRows-nCols-1);
+    pGrid->SetWeightVal(k,c        ,0.4);
+    pGrid->SetWeightVal(k,c+1      ,0.3);
+    pGrid->SetWeightVal(k,c+nCols  ,0.2);
+    pGrid->SetWeightVal(k,c+nCols+1,0.1);
+  }
+  pGrid->SetIdxNonZeroGridCells(nGridHRUs,nCols*nRows,Options);
+  pGrid->ReallocateArraysInForcingGrid();
+  for(int it=0;it<nSteps;it++) {
+    for(int ic=0;ic<pGrid->GetNumberNonZeroGridCells();ic++) { pGrid->SetValue(ic,it,10.0*rand()/RAND_MAX); }
+  }
+  TimeKernel("forcinggrid","CForcingGrid::GetWeightedValue (4 cells)",[&](long n) {
+    return pGrid->GetWeightedValue((int)(n%nGridHRUs),(double)((n/nGridHRUs)%nSteps),1.0);
+  },BENCH,Options);
+  delete pGrid;
+
+  // channel routing
+  //----------------------------------------------------------------
+  const int nMethods=8; //ROUTE_TVD excluded (writes debug output every iteration)
+  const routing_method aMethods[nMethods]={ROUTE_NONE,ROUTE_PLUG_FLOW,ROUTE_DIFFUSIVE_WAVE,ROUTE_DIFFUSIVE_VARY,ROUTE_MUSKINGUM,
+                                         ROUTE_MUSKINGUM_CUNGE,ROUTE_STORAGECOEFF,ROUTE_HYDROLOGIC};
+  const string       aNames  [nMethods]={"ROUTE_NONE","ROUTE_PLUG_FLOW","ROUTE_DIFFUSIVE_WAVE","ROUTE_DIFFUSIVE_VARY","ROUTE_MUSKINGUM",
+                                         "ROUTE_MUSKINGUM_CUNGE","ROUTE_STORAGECOEFF","ROUTE_HYDROLOGIC"};
+  const double Qavg=50.0; //[m3/s]
+  time_struct tt;
+  JulianConvert(0.0,Options.julian_start_day,Options.julian_start_year,Options.calendar,tt);
+
+  //channel is owned (and deleted) by model
+  CChannelXSect *pChan=new CChannelXSect("BENCH_TRAPEZOID",20.0,2.0,0.0,0.035,0.001,pModel);
+  for(int m=0;m<nMethods;m++)
+  {
+    optStruct RouteOptions=Options;
+    RouteOptions.routing=aMethods[m];
+    CSubBasin *pBasin=new CSubBasin(DOESNT_EXIST,"BENCH_REACH",pModel,DOESNT_EXIST,pChan,10000.0,Qavg,false,true);
+    pBasin->SetAsNonHeadwater();
+    pBasin->Initialize(Qavg,0.0,1000.0,RouteOptions);
+    double aQout[MAX_RIVER_SEGS];
+    TimeKernel("routing","CSubBasin::RouteWater "+aNames[m],[&](long n) {
+      pBasin->UpdateInflow(Qavg*(1.0+0.5*sin(0.1*(double)(n%63))));
+      pBasin->RouteWater(aQout,RouteOptions,tt);
+      return aQout[0];
+    },BENCH,Options);
+    delete pBasin;
+  }
+
+  CReservoir *pRes=new CReservoir("BENCH_LAKE",DOESNT_EXIST,0.6,50.0,0.0,1.0e7,10.0);
+  pRes->Initialize(Options);
+  pRes->SetReservoirStage(0.5,0.5);
+  double aQstruct[1];
+  TimeKernel("routing","CReservoir::RouteWater (lake)",[&](long n) {
+    double Qin=Qavg*(1.0+0.5*sin(0.1*(double)(n%63)));
+    double res_outflow;
+    res_constraint constraint;
+    double stage=pRes->RouteWater(Qin,Qin,pModel,Options,tt,res_outflow,constraint,aQstruct);
+    return stage+res_outflow;
+  },BENCH,Options);
+  delete pRes;
+
+  // linear algebra
+  //----------------------------------------------------------------
+  const int nSVD=3;    const int aSVDSize[nSVD]={10,50,100};
+  for(int s=0;s<nSVD;s++)
+  {
+    int N=aSVDSize[s];
+    double **A,*b=new double[N],*x=new double[N];
+    AllocateMatrix(N,N,A);
+    for(int i=0;i<N;i++) {
+      b[i]=rand()/(double)(RAND_MAX);
+      for(int j=0;j<N;j++) { A[i][j]=rand()/(double)(RAND_MAX)+((i==j)?N:0.0); }
+    }
+    TimeKernel("matrix","SVD (n="+to_string(N)+")",[&](long n) {
+      SVD(A,b,x,N,1e-8);
+      return x[n%N];
+    },BENCH,Options);
+    DeleteMatrix(N,N,A);
+    delete [] b;
+    delete [] x;
+  }
+  const int nMult=2;   const int aMultSize[nMult]={50,200};
+  for(int s=0;s<nMult;s++)
+  {
+    int N=aMultSize[s];
+    double **A,**B,**C;
+    double *Ac=new double[N*N],*Bc=new double[N*N],*Cc=new double[N*N];
+    AllocateMatrix(N,N,A); AllocateMatrix(N,N,B); AllocateMatrix(N,N,C);
+    for(int i=0;i<N;i++) {
+      for(int j=0;j<N;j++) {
+        A[i][j]=Ac[i*N+j]=rand()/(double)(RAND_MAX);
+        B[i][j]=Bc[i*N+j]=rand()/(double)(RAND_MAX);
+      }
+    }
+    TimeKernel("matrix","MatMult (n="+to_string(N)+")",[&](long n) {
+      MatMult(A,B,N,N,N,C);
+      return C[n%N][0];
+    },BENCH,Options);
+    TimeKernel("matrix","MatMultBlocked (n="+to_string(N)+")",[&](long n) {
+      MatMultBlocked(Ac,Bc,N,N,N,Cc);
+      return Cc[n%N];
+    },BENCH,Options);
+    DeleteMatrix(N,N,A); DeleteMatrix(N,N,B); DeleteMatrix(N,N,C);
+    delete [] Ac; delete [] Bc; delete [] Cc;
+  }
+
+  BENCH.close();
+  if(!Options.silent) { cout<<"...micro-benchmark results written to "<<filename<<endl; }
+  ExitGracefully("RavenMicroBenchmarks",SIMULATION_DONE);
+}
+
+/////////////////////////////////////////////////////////////////
+// Model-based unit tests
+/////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////
+/// \brief Runs unit tests which require an initialized model (run with -ut executable flag)
+/// \details writes PASS/FAIL for each check to screen, then exits; any failure is reported as an error in Raven_errors.txt
+///
+/// \param pModel [in] initialized model
+/// \param &Options [in] global model options
+//
+void RavenModelUnitTesting(CModel *pModel,const optStruct &Options)
+{
+  int nFailed=0;
+  cout<<"RAVEN MODEL UNIT TESTING MODE"<<endl;
+
+  DemandExpressionTest(pModel,Options,nFailed);
+
+  if (nFailed>0){
+    string msg="RavenModelUnitTesting: "+to_string(nFailed)+" check(s) failed";
+    ExitGracefully(msg.c_str(),RUNTIME_ERR);
+  }
+  cout<<"...all model unit tests passed"<<endl;
+  ExitGracefully("RavenModelUnitTesting",SIMULATION_DONE);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief compares value to expected value, reports result and increments nFailed on failure
+//
+static void CheckValue(const string name,const double &val,const double &expected,int &nFailed)
+{
+  bool pass=(fabs(val-expected)<=REAL_SMALL*max(1.0,fabs(expected)));
+  cout<<"  "<<(pass ? "PASS" : "FAIL")<<": "<<name<<" = "<<val<<" (expected "<<expected<<")"<<endl;
+  if (!pass){nFailed++;}
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief parses expression string exactly as :DemandExpression command, then evaluates it via the CDemand path
+/// \returns current demand calculated from expression (0 if any term is blank), or RAV_BLANK_DATA if expression is invalid
+//
+static double EvaluateTestDemandExpression(CModel *pModel,const string exp_string,const long long SBID,const optStruct &Options,const time_struct &tt)
+{
+  istringstream   ss(":DemandExpression "+exp_string);
+  vector<string>  aTokens;
+  const char     *s[MAXINPUTITEMS];
+  string          tok;
+  while (ss>>tok){aTokens.push_back(tok);}
+  for (int i=0;i<(int)(aTokens.size());i++){s[i]=aTokens[i].c_str();}
+
+  expressionStruct *pExp=pModel->GetManagementOptimizer()->ParseExpression(s,(int)(aTokens.size()),0,"DemandExpressionTest");
+  if (pExp==NULL){return RAV_BLANK_DATA;}
+
+  CDemand *pDemand=new CDemand(DOESNT_EXIST,"UNIT_TEST",SBID,false,pModel);
+  pDemand->SetDemandExpression(pExp); //demand owns expression
+  pDemand->Initialize(Options);       //compiles expression
+  pDemand->UpdateDemand(Options,tt);
+  double val=pDemand->GetDemand();
+  delete pDemand;
+  return val;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Tests compiled management expressions: functions with nested arguments, lookup tables, flow history,
+/// reciprocal terms and blank time series
+/// \details requires model without management optimization (.rvm file); a demand optimizer is attached to the model
+/// and initialized without lp_solve. Expressions refer to the first enabled subbasin with non-zero initial outflow
+///
+/// \param pModel [in] initialized model
+/// \param &Options [in] global model options
+/// \param &nFailed [out] incremented for each failed check
+//
+void DemandExpressionTest(CModel *pModel,const optStruct &Options,int &nFailed)
+{
+  cout<<"Demand expression test:"<<endl;
+  ExitGracefullyIf(pModel->GetManagementOptimizer()!=NULL,
+    "DemandExpressionTest: must be run using model without management optimization",BAD_DATA);
+
+  CSubBasin *pSB=NULL;
+  for (int p=0;p<pModel->GetNumSubBasins();p++){
+    if ((pModel->GetSubBasin(p)->IsEnabled()) && (pModel->GetSubBasin(p)->GetOutflowRate()>0.0)){
+      pSB=pModel->GetSubBasin(p); break;
+    }
+  }
+  ExitGracefullyIf(pSB==NULL,"DemandExpressionTest: requires model with non-zero initial subbasin outflow",BAD_DATA);
+
+  CDemandOptimizer *pDO=new CDemandOptimizer(pModel);
+  pModel->AddDemandOptimization(pDO); //model owns optimizer
+
+  const int N=4;
+  double aX[N]={0.0,10.0,100.0,1000.0};
+  double aY[N]={2.0, 3.0,  8.0,  20.0};
+  CLookupTable *pLT=new CLookupTable("TEST_TABLE",aX,aY,N);
+  pDO->AddUserLookupTable(pLT);
+
+  int     nVals=(int)(Options.duration)+2;
+  double *aVals=new double[nVals];
+  for (int i=0;i<nVals;i++){aVals[i]=3.0;}
+  pDO->AddUserTimeSeries(new CTimeSeries("TEST_TS"   ,DOESNT_EXIST,"",Options.julian_start_day,Options.julian_start_year,1.0,aVals,nVals,true));
+  for (int i=0;i<nVals;i++){aVals[i]=RAV_BLANK_DATA;}
+  pDO->AddUserTimeSeries(new CTimeSeries("TEST_BLANK",DOESNT_EXIST,"",Options.julian_start_day,Options.julian_start_year,1.0,aVals,nVals,true));
+  delete [] aVals;
+
+  pDO->SetHistoryLength(3);
+  pDO->Initialize           (pModel,Options);
+  pDO->InitializePostRVMRead(pModel,Options);
+
+  time_struct tt;
+  JulianConvert(0.0,Options.julian_start_day,Options.julian_start_year,Options.calendar,tt);
+  pDO->PrepDemandProblem(pModel,Options,tt); //history: !Q[-1]=current outflow, !Q[-2]=0
+
+  long long SBID=pSB->GetID();
+  double    Q1=pSB->GetOutflowRate();
+  string    h1="!Q"+to_string(SBID)+"[-1]";
+  string    h2="!Q"+to_string(SBID)+"[-2]";
+  string    LHS="!Q"+to_string(SBID)+" = ";
+  double    val;
+
+  val=EvaluateTestDemandExpression(pModel,LHS+h1+" + 2.0 * "+h2,SBID,Options,tt);
+  CheckValue("history",val,Q1,nFailed);
+
+  val=EvaluateTestDemandExpression(pModel,LHS+"@max(1.5,"+h1+") * @lookup(TEST_TABLE,"+h1+")",SBID,Options,tt);
+  CheckValue("max and lookup of history",val,max(1.5,Q1)*pLT->GetValue(Q1),nFailed);
+
+  val=EvaluateTestDemandExpression(pModel,LHS+"@min("+h1+",-1.0) + @lookup(TEST_TABLE,"+h2+") - @max("+h2+",55.0)",SBID,Options,tt);
+  CheckValue("min, lookup and max in separate groups",val,-1.0+2.0-55.0,nFailed);
+
+  val=EvaluateTestDemandExpression(pModel,LHS+"10.0 / @lookup(TEST_TABLE,"+h2+") - 3.0 / 4.0 / 2.0",SBID,Options,tt);
+  CheckValue("reciprocal terms",val,10.0/2.0-0.375,nFailed);
+
+  val=EvaluateTestDemandExpression(pModel,LHS+"5.0 + 2.0 * @ts(TEST_TS,0)",SBID,Options,tt);
+  CheckValue("time series",val,11.0,nFailed);
+
+  val=EvaluateTestDemandExpression(pModel,LHS+"5.0 + 2.0 * @ts(TEST_BLANK,0)",SBID,Options,tt);
+  CheckValue("blank time series (demand is zero)",val,0.0,nFailed);
+}
@@ -7,6 +7,8 @@
 
 #include "RavenInclude.h"
 
+class CModel;
+
 void DateTest();
 void OpticalAirMassTest();
 void ClearSkyTest();
@@ -25,4 +27,8 @@ void ADRCumDistTest();
 void TestGammaSampling();
 void TestWetBulbTemps();
 void TestDateStrings();
+void EnKFAnalysisBenchmark();
+void RavenMicroBenchmarks(CModel *pModel,const optStruct &Options);
+void RavenModelUnitTesting(CModel *pModel,const optStruct &Options);
+void DemandExpressionTest(CModel *pModel,const optStruct &Options,int &nFailed);
 #endif
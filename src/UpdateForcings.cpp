@@ -152,6 +152,27 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
   }
   if (_nGauges > 0) {g_debug_vars[4]=_pGauges[0]->GetElevation(); }//UBCWM RFS Emulation cheat
 
+  //Day angle/day length and clear sky radiation terms, calculated once per unique terrain signature
+  //---------------------------------------------------------------------
+  if(tt.day_changed)
+  {
+    _sigDayAngle=CRadiation::DayAngle(mid_day,yr,Options.calendar);
+    double declin=CRadiation::SolarDeclination(_sigDayAngle);
+    for (int s=0;s<_nTerrainSigs;s++){
+      if ((s>0) && (_aSigLatRad[s]==_aSigLatRad[s-1])){_aSigDayLength[s]=_aSigDayLength[s-1];} //signatures ordered by latitude
+      else                                           {_aSigDayLength[s]=CRadiation::DayLength(_aSigLatRad[s],declin);}
+    }
+  }
+  _clearSkyTime=RAV_BLANK_DATA;
+  if ((_sigDayAngle!=RAV_BLANK_DATA) &&
+      ((Options.SW_radiation==SW_RAD_DEFAULT) || (Options.SW_radiation==SW_RAD_DATA)))
+  {
+    CRadiation::ClearSkyTermsBatch(_nTerrainSigs,tt.julian_day,Options.timestep,_sigDayAngle,
+                                   _aSigLatRad,_aSigSlope,_aSigAspect,_aSigDayLength,
+                                   (Options.timestep>=1.0),_aClearSkyTerms);
+    _clearSkyTime=tt.model_time;
+  }
+
   //Generate HRU-specific forcings from gauge data
   //---------------------------------------------------------------------
   double ref_elev_temp;
@@ -168,14 +189,12 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
     //not gauge-based
     if(tt.day_changed)
     {
-      F.day_angle  = CRadiation::DayAngle(mid_day,yr,Options.calendar);
-      F.day_length = CRadiation::DayLength(_pHydroUnits[k]->GetLatRad(),CRadiation::SolarDeclination(F.day_angle));
+      F.day_angle  = _sigDayAngle;
+      F.day_length = _aSigDayLength[_aTerrainSig[k]];
     }
 
     if(_pHydroUnits[k]->IsEnabled())
     {
-      ApplyLocalParamOverrrides(k,false);
-
       //interpolate forcing values from gauges
       //-------------------------------------------------------------------
       for(g = 0; g < _nGauges; g++)
@@ -460,7 +479,7 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
       F.temp_min_unc = F.temp_daily_min;
       F.temp_max_unc = F.temp_daily_max;
 
-      CorrectTemp(Options,F,elev,ref_elev_temp,tt);
+      CorrectTemp(Options,F,elev,ref_elev_temp,k,tt);
 
       ApplyForcingPerturbation(F_TEMP_AVE, F, k, Options, tt);
 
@@ -563,7 +582,7 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
 
       F.SW_radia = CRadiation::EstimateShortwaveRadiation(this, &F, _pHydroUnits[k], tt, F.ET_radia, F.ET_radia_flat);
       F.SW_radia_unc = F.SW_radia;
-      F.SW_radia *= CRadiation::SWCloudCoverCorrection(this, &F, elev);
+      F.SW_radia *= CRadiation::SWCloudCoverCorrection(this, &F, _pHydroUnits[k], elev);
 
       F.SW_radia_subcan = F.SW_radia * CRadiation::SWCanopyCorrection(this, _pHydroUnits[k]);
 
@@ -615,8 +634,6 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
         F.PET       -=reduce*rainfrac;
         F.irrigation-=reduce*(1.0-rainfrac);
       }
-
-      ApplyLocalParamOverrrides(k,true);
     }//end if (!_pHydroUnits[k]->IsDisabled())
 
     //-------------------------------------------------------------------
@@ -735,8 +752,8 @@ double CModel::EstimateWindVelocity(const optStruct    &Options,
   //---------------------------------------------------------------------
   else if(Options.wind_velocity==WINDVEL_SQRT)
   {
-    double b = this->_pGlobalParams->GetParams()->windvel_icept;
-    double m = this->_pGlobalParams->GetParams()->windvel_scale;
+    double b = pHRU->GetGlobalParams()->windvel_icept;
+    double m = pHRU->GetGlobalParams()->windvel_scale;
     double Tmin =F.temp_daily_min;
     double Tmax =F.temp_daily_max;
 
@@ -745,8 +762,8 @@ double CModel::EstimateWindVelocity(const optStruct    &Options,
   //---------------------------------------------------------------------
   else if(Options.wind_velocity==WINDVEL_LOG)
   {
-    double b = this->_pGlobalParams->GetParams()->windvel_icept;
-    double m = this->_pGlobalParams->GetParams()->windvel_scale;
+    double b = pHRU->GetGlobalParams()->windvel_icept;
+    double m = pHRU->GetGlobalParams()->windvel_scale;
     double Tmin = F.temp_daily_min;
     double Tmax = F.temp_daily_max;
 
@@ -761,9 +778,9 @@ double CModel::EstimateWindVelocity(const optStruct    &Options,
     const double rf_elev=2000;
     double elev = _pHydroUnits[k]->GetElevation();
     double Fc   = _pHydroUnits[k]->GetSurfaceProps()->forest_coverage;
-    double P0TEDL = this->_pGlobalParams->GetParams()->UBC_lapse_params.P0TEDL;
-    double P0TEDU = this->_pGlobalParams->GetParams()->UBC_lapse_params.P0TEDU;
-    double A0term = this->_pGlobalParams->GetParams()->UBC_lapse_params.max_range_temp;
+    double P0TEDL = pHRU->GetGlobalParams()->UBC_lapse_params.P0TEDL;
+    double P0TEDU = pHRU->GetGlobalParams()->UBC_lapse_params.P0TEDU;
+    double A0term = pHRU->GetGlobalParams()->UBC_lapse_params.max_range_temp;
     if (elev>=rf_elev)
     {
       A1term=25.0-P0TEDL*0.001*rf_elev-P0TEDU*0.001*(elev-rf_elev);
@@ -981,7 +998,7 @@ double CModel::CalculateSubDailyCorrection(const force_struct &F,
         Ftmp.temp_daily_max  +=_aGaugeWtTemp[k][g]*_pGauges[g]->GetForcingValue(F_TEMP_DAILY_MAX,nnn);
         Ftmp.temp_daily_min  +=_aGaugeWtTemp[k][g]*_pGauges[g]->GetForcingValue(F_TEMP_DAILY_MIN,nnn);
       }
-      CorrectTemp(Options,Ftmp,elev,ref_elev_temp,tt_tmp);
+      CorrectTemp(Options,Ftmp,elev,ref_elev_temp,k,tt_tmp);
       sum+=max(Ftmp.temp_ave,0.0);
     }
 
@@ -1045,7 +1062,7 @@ double CModel::EstimateSnowFraction(const rainsnow_method method,
 	//-----------------------------------------------------------
 	else if (method == RAINSNOW_DINGMAN)
 	{ //from Brook90 model, Dingman pg 109
-	    double temp = this->_pGlobalParams->GetParams()->rainsnow_temp;
+	    double temp = pHRU->GetGlobalParams()->rainsnow_temp;
 	    if (F->temp_daily_max <= temp) { return 1.0; }
 	    if (F->temp_daily_min >= temp) { return 0.0; }
 	    return (temp - F->temp_daily_min) / (F->temp_daily_max - F->temp_daily_min);
@@ -1053,7 +1070,7 @@ double CModel::EstimateSnowFraction(const rainsnow_method method,
 	//-----------------------------------------------------------
 	else if (method == RAINSNOW_THRESHOLD)
 	{ //abrupt threshold temperature (e.g., HYMOD)
-	  double temp = this->_pGlobalParams->GetParams()->rainsnow_temp;
+	  double temp = pHRU->GetGlobalParams()->rainsnow_temp;
 	  if (F->temp_ave <= temp) { return 1.0; }
 	  else                     { return 0.0; }
 	}
@@ -1061,8 +1078,8 @@ double CModel::EstimateSnowFraction(const rainsnow_method method,
   else if ((method == RAINSNOW_HBV) || (method == RAINSNOW_UBCWM))
   {//linear variation based upon daily average temperature
       double frac;
-      double delta = this->_pGlobalParams->GetParams()->rainsnow_delta;
-      double temp  = this->_pGlobalParams->GetParams()->rainsnow_temp;
+      double delta = pHRU->GetGlobalParams()->rainsnow_delta;
+      double temp  = pHRU->GetGlobalParams()->rainsnow_temp;
 
       if      (F->temp_daily_ave <= (temp - 0.5 * delta)) { frac = 1.0; }
       else if (F->temp_daily_ave >= (temp + 0.5 * delta)) { frac = 0.0; }//assumes only daily avg. temp is included
@@ -1076,7 +1093,7 @@ double CModel::EstimateSnowFraction(const rainsnow_method method,
   //-----------------------------------------------------------
   else if (method == RAINSNOW_HSPF) // Also, from HydroComp (1969)
   {
-      double temp = this->_pGlobalParams->GetParams()->rainsnow_temp;
+      double temp = pHRU->GetGlobalParams()->rainsnow_temp;
       double snowtemp;
       double dewpt = GetDewPointTemp(F->temp_ave, F->rel_humidity);
 
@@ -335,6 +335,64 @@ void CVegetationClass::SetVegetationProperty(const string &param_name, const dou
 {
   SetVegetationProperty(V,param_name,value);
 }
+//////////////////////////////////////////////////////////////////
+/// \brief Returns address of the vegetation property corresponding to param_name
+/// \details used to resolve parameter handles once, so that repeated updates (e.g., transient
+/// parameters or calibration) need not search by name
+/// \param param_name [in] Parameter identifier
+/// \returns address of parameter value, or NULL if parameter must be set by name
+//
+double *CVegetationClass::GetVegetationPropertyAddress(const string &param_name)
+{
+  return GetVegetationPropertyAddress(V,param_name);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Returns address of the vegetation property corresponding to param_name within structure provided
+/// \note this is the vegetation parameter name table used by SetVegetationProperty(); parameters which are not
+/// set by simple assignment are handled there as special cases
+/// \param &V [in] Vegetation properties structure
+/// \param param_name [in] Parameter identifier
+/// \returns address of parameter value, or NULL if not a simple vegetation parameter
+//
+double *CVegetationClass::GetVegetationPropertyAddress(veg_struct &V,const string &param_name)
+{
+  string name;
+  name = StringToUppercase(param_name);
+
+  if      (!name.compare("MAX_HEIGHT"           )){return &(V.max_height);}
+  else if (!name.compare("MAX_LEAF_COND"        )){return &(V.max_leaf_cond);}
+  else if (!name.compare("MAX_LAI"              )){return &(V.max_LAI);}
+  else if (!name.compare("SVF_EXTINCTION"       )){return &(V.svf_extinction);}
+  else if (!name.compare("ALBEDO"               )){return &(V.albedo);}
+  else if (!name.compare("ALBEDO_WET"           )){return &(V.albedo_wet);}
+  else if (!name.compare("RAIN_ICEPT_FACT"      )){return &(V.rain_icept_fact);}
+  else if (!name.compare("SNOW_ICEPT_FACT"      )){return &(V.snow_icept_fact);}
+  else if (!name.compare("TRUNK_FRACTION"       )){return &(V.trunk_fraction);}
+  else if (!name.compare("STEMFLOW_FRAC"        )){return &(V.stemflow_frac);}
+  else if (!name.compare("SAI_HT_RATIO"         )){return &(V.SAI_ht_ratio);}
+  else if (!name.compare("MAX_CAPACITY"         )){return &(V.max_capacity);}
+  else if (!name.compare("MAX_SNOW_CAPACITY"    )){return &(V.max_snow_capacity);}
+  else if (!name.compare("MAX_SNOW_LOAD"        )){return &(V.max_snow_load);}
+  else if (!name.compare("RAIN_ICEPT_PCT"       )){return &(V.rain_icept_pct);}
+  else if (!name.compare("SNOW_ICEPT_PCT"       )){return &(V.snow_icept_pct);}
+  else if (!name.compare("DRIP_PROPORTION"      )){return &(V.drip_proportion);}
+  else if (!name.compare("MAX_INTERCEPT_RATE"   )){return &(V.max_intercept_rate);}
+  else if (!name.compare("CHU_MATURITY"         )){return &(V.CHU_maturity);}
+  else if (!name.compare("VEG_DIAM"             )){return &(V.veg_diam);}
+  else if (!name.compare("VEG_MBETA"            )){return &(V.veg_mBeta);}
+  else if (!name.compare("VEG_DENS"             )){return &(V.veg_dens);}
+  else if (!name.compare("PET_VEG_CORR"         )){return &(V.PET_veg_corr);}
+  else if (!name.compare("CAP_LAI_RATIO"        )){return &(V.Cap_LAI_ratio);}
+  else if (!name.compare("SNOCAP_LAI_RATIO"     )){return &(V.SnoCap_LAI_ratio);}
+  else if (!name.compare("VEG_CONV_COEFF"       )){return &(V.veg_conv_coeff);}
+  else if (!name.compare("MAX_ROOT_LENGTH"      )){return &(V.max_root_length);}
+  else if (!name.compare("MIN_RESISTIVITY"      )){return &(V.min_resistivity);}
+  else if (!name.compare("XYLEM_FRAC"           )){return &(V.xylem_frac);}
+  else if (!name.compare("ROOTRADIUS"           )){return &(V.rootradius);}
+  else if (!name.compare("PSI_CRITICAL"         )){return &(V.psi_critical);}
+  else if (!name.compare("ROOT_EXTINCT"         )){return &(V.root_extinct);}
+  return NULL;
+}
 
 ////////////////////////////////////////////////////////////////////
 /// \brief Sets vegetation property
@@ -350,44 +408,11 @@ void  CVegetationClass::SetVegetationProperty(veg_struct  &V,
   string name;
   name = StringToUppercase(param_name);
 
-  //Canopy params
-  if      (!name.compare("MAX_HEIGHT"           )){V.max_height=value;}
-  else if (!name.compare("MAX_LEAF_COND"        )){V.max_leaf_cond=value;}
-  else if (!name.compare("MAX_LAI"              )){V.max_LAI=value;}
-
-  else if (!name.compare("SVF_EXTINCTION"       )){V.svf_extinction=value;}
-  else if (!name.compare("ALBEDO"               )){V.albedo=value;}
-  else if (!name.compare("ALBEDO_WET"           )){V.albedo_wet=value;}
-  else if (!name.compare("RAIN_ICEPT_FACT"      )){V.rain_icept_fact=value;}
-  else if (!name.compare("SNOW_ICEPT_FACT"      )){V.snow_icept_fact=value;}
-  else if (!name.compare("TRUNK_FRACTION"       )){V.trunk_fraction=value;}
-  else if (!name.compare("STEMFLOW_FRAC"        )){V.stemflow_frac=value;}
-  else if (!name.compare("SAI_HT_RATIO"         )){V.SAI_ht_ratio=value;}
-  else if (!name.compare("MAX_CAPACITY"         )){V.max_capacity=value;}
-  else if (!name.compare("MAX_SNOW_CAPACITY"    )){V.max_snow_capacity=value;}
-  else if (!name.compare("MAX_SNOW_LOAD"        )){V.max_snow_load=value;}
+  double *pVal=GetVegetationPropertyAddress(V,name);
+
+  if      (pVal!=NULL)                          {*pVal=value;}
   else if (!name.compare("TFRAIN"               )){V.rain_icept_pct=1.0-value;}
   else if (!name.compare("TFSNOW"               )){V.snow_icept_pct=1.0-value;}
-  else if (!name.compare("RAIN_ICEPT_PCT"       )){V.rain_icept_pct=value;}
-  else if (!name.compare("SNOW_ICEPT_PCT"       )){V.snow_icept_pct=value;}
-  else if (!name.compare("DRIP_PROPORTION"      )){V.drip_proportion=value;}
-  else if (!name.compare("MAX_INTERCEPT_RATE"   )){V.max_intercept_rate=value;}
-  else if (!name.compare("CHU_MATURITY"         )){V.CHU_maturity=value;}
-  else if (!name.compare("VEG_DIAM"             )){V.veg_diam=value;}
-  else if (!name.compare("VEG_MBETA"            )){V.veg_mBeta=value;}
-  else if (!name.compare("VEG_DENS"             )){V.veg_dens=value;}
-  else if (!name.compare("PET_VEG_CORR"         )){V.PET_veg_corr=value;}
-  else if (!name.compare("CAP_LAI_RATIO"        )){V.Cap_LAI_ratio=value;}
-  else if (!name.compare("SNOCAP_LAI_RATIO"     )){V.SnoCap_LAI_ratio=value;}
-  else if (!name.compare("VEG_CONV_COEFF"       )){V.veg_conv_coeff=value;}
-
-  else if (!name.compare("MAX_ROOT_LENGTH"      )){V.max_root_length=value;}
-  else if (!name.compare("MIN_RESISTIVITY"      )){V.min_resistivity=value;}
-  else if (!name.compare("XYLEM_FRAC"           )){V.xylem_frac=value;}
-  else if (!name.compare("ROOTRADIUS"           )){V.rootradius=value;}
-  else if (!name.compare("PSI_CRITICAL"         )){V.psi_critical=value;}
-  else if (!name.compare("ROOT_EXTINCT"         )){V.root_extinct=value;}
-
   else if (!name.compare("RELATIVE_HT"          )){for (int mon=0;mon<12;mon++){V.relative_ht [mon]=value;}}//special case
   else if (!name.compare("RELATIVE_LAI"         )){for (int mon=0;mon<12;mon++){V.relative_LAI[mon]=value;}}//special case
   else{
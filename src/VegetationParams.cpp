@@ -73,8 +73,10 @@ inline double CalculateLeafConductance( const double       &max_leaf_cond,     /
 }
 
 //////////////////////////////////////////////////////////////////
-/// \brief Sets canopy properties based upon meteorological conditions and time of year
-/// \remark Called at the start of each time step for each HRU
+/// \brief Sets canopy properties based upon vegetation and land use class properties and time of year
+/// \remark Depends only upon vegetation/land use class and date; called once per day for each unique
+/// vegetation/land use class combination, with results shared between HRUs (see CModel::RecalculateHRUDerivedParams).
+/// State- and forcing-dependent properties are set in UpdateCanopyStateParams()
 ///
 /// \param &VV [out] Vegetation properties strcture
 /// \param *pHRU [in] HRU class object
@@ -160,12 +162,71 @@ void CVegetationClass::RecalculateCanopyParams (      veg_var_struct    &VV,
   else if(Options.interception_factor==PRECIP_ICEPT_NONE) {
     VV.rain_icept_pct=VV.snow_icept_pct=0.0;
   }
+  else if ((Options.interception_factor == PRECIP_ICEPT_HEDSTROM) ||
+           (Options.interception_factor == PRECIP_ICEPT_STICKY))
+  {
+    VV.rain_icept_pct=(1.0-exp(-0.5*(VV.LAI+VV.SAI)));
+    VV.snow_icept_pct=0.0; //state-dependent; see UpdateCanopyStateParams()
+  }
+
+  if ((Options.orocorr_precip==OROCORR_UBCWM) || (Options.orocorr_precip==OROCORR_UBCWM2))
+  {
+    //interception is (inelegantly, but necessarily) handled in the precipitation correction routine in UBCWM
+    VV.rain_icept_pct=0;
+    VV.snow_icept_pct=0;
+  }
+
+  // Canopy Roughness parameters (\ref from Brook90 ROUGH routine)
+  //------------------------------------------------------------
+  double ratio,xx;
+
+  //find figures for closed canopy
+  double closed_roughness;//[m]       roughness length for closed canopy
+  double closed_zerodisp; //[m]       zero-plane displacement for closed canopy
+  closed_roughness=CVegetationClass::CalcClosedRoughness    (VV.height);
+  closed_zerodisp =CVegetationClass::CalcClosedZeroPlaneDisp(VV.height,closed_roughness);
+  upperswap(closed_roughness,pHRU->GetSurfaceProps()->roughness);
+
+  ratio=(VV.LAI+VV.SAI)/(CLOSED_LAI+SAI_ht_ratio*VV.height); //(LAI + SAI) / (LAI + SAI)_closed canopy
+
+  if (ratio>=1.0)
+  {//closed canopy
+    VV.zero_pln_disp =closed_zerodisp;
+    VV.roughness     =closed_roughness;
+  }
+  else
+  {///< Sparse canopy - \ref use Shuttleworth & Gurney, 1990 \cite shuttleworth1990QURMS
+    xx=0.0;
+    if (VV.height>REAL_SMALL){
+      xx=ratio*pow(-1.0+exp(0.909-3.03*closed_zerodisp/VV.height),4);
+    }
+    VV.zero_pln_disp =1.1*VV.height*log(1.0+pow(xx,0.25));
+    VV.roughness     =min(0.3*(VV.height-VV.zero_pln_disp),pHRU->GetSurfaceProps()->roughness+0.3*VV.height*sqrt(xx));
+  }
+  VV.reference_height = VV.height + Z_REF_ADJUST;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Sets canopy properties based upon meteorological conditions and HRU state
+/// \remark Called at the start of each time step for each HRU, after class-based canopy
+/// properties have been set by RecalculateCanopyParams()
+///
+/// \param &VV [in/out] Vegetation properties strcture
+/// \param *pHRU [in] HRU class object
+/// \param *pModel [in] pointer to model object
+/// \param &Options [in] Options structure
+//
+void CVegetationClass::UpdateCanopyStateParams (      veg_var_struct    &VV,
+                                                      const CHydroUnit       *pHRU,
+                                                      const CModelABC        *pModel,
+                                                      const optStruct        &Options)
+{
+  double sparseness  =pHRU->GetSurfaceProps()->forest_sparseness;
 
   int iCanSnow = pModel->GetStateVarIndex(CANOPY_SNOW);
 
   if (Options.interception_factor == PRECIP_ICEPT_HEDSTROM)
   {
-    VV.rain_icept_pct=(1.0-exp(-0.5*(VV.LAI+VV.SAI)));
     if(iCanSnow != DOESNT_EXIST)
     { ///< \ref from Hedstrom & Pomeroy, 1998
       double max_snow_load= pHRU->GetVegetationProps()->max_snow_load; //[kg/m2] ~5.9-6.6
@@ -188,8 +249,6 @@ void CVegetationClass::RecalculateCanopyParams (      veg_var_struct    &VV,
   }
   else if(Options.interception_factor == PRECIP_ICEPT_STICKY)
   {
-    VV.rain_icept_pct=(1.0-exp(-0.5*(VV.LAI+VV.SAI)));
-
     if(iCanSnow != DOESNT_EXIST)
     {///< \ref from SUMMA
       double gamma;
@@ -234,35 +293,6 @@ void CVegetationClass::RecalculateCanopyParams (      veg_var_struct    &VV,
   VV.roughness     = 0.123 * VV.height;     /// momentum roughness length [m] ( \ref 0.1 for Dingman eqn. 7-49)
   double vap_rough_ht = 0.1 * VV.roughness; /// vapor roughness length [m] (\ref 1.0 for Dingman eqn. 7-49)
   */
-
-  // Canopy Roughness parameters (\ref from Brook90 ROUGH routine)
-  //------------------------------------------------------------
-  double ratio,xx;
-
-  //find figures for closed canopy
-  double closed_roughness;//[m]       roughness length for closed canopy
-  double closed_zerodisp; //[m]       zero-plane displacement for closed canopy
-  closed_roughness=CVegetationClass::CalcClosedRoughness    (VV.height);
-  closed_zerodisp =CVegetationClass::CalcClosedZeroPlaneDisp(VV.height,closed_roughness);
-  upperswap(closed_roughness,pHRU->GetSurfaceProps()->roughness);
-
-  ratio=(VV.LAI+VV.SAI)/(CLOSED_LAI+SAI_ht_ratio*VV.height); //(LAI + SAI) / (LAI + SAI)_closed canopy
-
-  if (ratio>=1.0)
-  {//closed canopy
-    VV.zero_pln_disp =closed_zerodisp;
-    VV.roughness     =closed_roughness;
-  }
-  else
-  {///< Sparse canopy - \ref use Shuttleworth & Gurney, 1990 \cite shuttleworth1990QURMS
-    xx=0.0;
-    if (VV.height>REAL_SMALL){
-      xx=ratio*pow(-1.0+exp(0.909-3.03*closed_zerodisp/VV.height),4);
-    }
-    VV.zero_pln_disp =1.1*VV.height*log(1.0+pow(xx,0.25));
-    VV.roughness     =min(0.3*(VV.height-VV.zero_pln_disp),pHRU->GetSurfaceProps()->roughness+0.3*VV.height*sqrt(xx));
-  }
-  VV.reference_height = VV.height + Z_REF_ADJUST;
 }
 
 //////////////////////////////////////////////////////////////
@@ -195,6 +195,9 @@ void    CDemand::Initialize(const optStruct &Options)
   if (_pReturnTS != NULL) {
     _pReturnTS->Initialize(Options.julian_start_day,Options.julian_start_year,Options.duration,Options.timestep,false,Options.calendar);
   }
+  if (_pDemandExp != NULL) {
+    _pModel->GetManagementOptimizer()->CompileExpression(_pDemandExp);
+  }
 }
 //////////////////////////////////////////////////////////////////
 /// \brief re-calculates current demand magnitude (_currentDemand) - called at start of time step
@@ -0,0 +1,884 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2025 the Raven Development Team
+  ----------------------------------------------------------------
+  RavenModelGenerator
+  Standalone utility which writes a synthetic but internally consistent
+  Raven model (.rvi/.rvh/.rvp/.rvt/.rvc) of a requested size, for
+  scaling and performance tests of the model engine
+  ----------------------------------------------------------------*/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <direct.h>
+#define MAKE_DIR(d) _mkdir(d)
+#else
+#include <sys/stat.h>
+#define MAKE_DIR(d) mkdir(d,0755)
+#endif
+
+using namespace std;
+
+const double PI          =3.14159265358979;
+const double KM_PER_DEG  =111.2;          ///< [km/deg] length of one degree of latitude
+const double LAT_ORIGIN  =50.0;           ///< [deg] latitude of south-west corner of synthetic domain
+const double LON_ORIGIN  =-100.0;         ///< [deg] longitude of south-west corner of synthetic domain
+const double LAPSE_RATE  =0.0065;         ///< [C/m] temperature lapse rate used for synthetic forcings
+
+////////////////////////////////////////////////////////////////////
+/// \brief model template (process list and parameters) used for generated model
+//
+enum model_template
+{
+  TEMPLATE_GR4J,   ///< GR4J with CemaNeige snow, from Salmon River benchmark
+  TEMPLATE_HBV     ///< HBV-EC, from Salmon River benchmark
+};
+
+////////////////////////////////////////////////////////////////////
+/// \brief generator options (command line arguments)
+//
+struct gen_options
+{
+  string         outdir;          ///< output directory
+  string         name;            ///< model run name (file base name)
+  int            nHRUs;           ///< number of HRUs
+  int            nSubBasins;      ///< number of subbasins
+  int            branching;       ///< number of upstream subbasins of each subbasin (1=single chain)
+  int            nGauges;         ///< number of forcing gauges (gauged forcing)
+  bool           gridded;         ///< true if NetCDF gridded forcing is written instead of gauges
+  int            gridNX;          ///< number of grid cells in longitude direction (gridded forcing)
+  int            gridNY;          ///< number of grid cells in latitude direction (gridded forcing)
+  int            nReservoirs;     ///< number of lake-type reservoirs
+  int            nConstituents;   ///< number of tracer constituents
+  int            nGaugedBasins;   ///< number of gauged subbasins (hydrographs written)
+  int            nDays;           ///< simulation duration [d]
+  double         timestep;        ///< model time step [d]
+  double         HRUArea;         ///< HRU area [km2]
+  model_template templ;           ///< process template
+  unsigned       seed;            ///< random seed
+};
+
+////////////////////////////////////////////////////////////////////
+/// \brief generated spatial layout of the synthetic watershed
+//
+struct gen_layout
+{
+  vector<int>    downstream;      ///< index of downstream subbasin (-1 for outlet) [size: nSubBasins]
+  vector<int>    depth;           ///< number of reaches between subbasin and outlet [size: nSubBasins]
+  vector<int>    nUpstream;       ///< number of subbasins upstream of (and including) subbasin [size: nSubBasins]
+  vector<double> sbLat,sbLon;     ///< subbasin centroid [deg] [size: nSubBasins]
+  vector<double> sbElev;          ///< subbasin mean elevation [m] [size: nSubBasins]
+  vector<int>    HRUBasin;        ///< subbasin index of HRU [size: nHRUs]
+  vector<double> HRULat,HRULon;   ///< HRU centroid [deg] [size: nHRUs]
+  vector<double> HRUElev;         ///< HRU elevation [m] [size: nHRUs]
+  vector<double> HRUSlope;        ///< HRU slope [deg] [size: nHRUs]
+  vector<double> HRUAspect;       ///< HRU aspect [deg] [size: nHRUs]
+  vector<int>    reservoirs;      ///< indices of subbasins with reservoirs [size: nReservoirs]
+  double         lat_size;        ///< domain extent in latitude direction [deg]
+  double         lon_size;        ///< domain extent in longitude direction [deg]
+  int            maxDepth;        ///< maximum subbasin depth
+};
+
+////////////////////////////////////////////////////////////////////
+/// \brief deterministic (platform-independent) random number source
+//
+class CRandom
+{
+private:
+  mt19937 _gen;
+public:
+  CRandom(const unsigned seed) : _gen(seed) {}
+  double Uniform    ()                                 { return (_gen()+0.5)/4294967296.0; }
+  double Uniform    (const double a,const double b)    { return a+(b-a)*Uniform(); }
+  double Exponential(const double mean)                { return -mean*log(Uniform()); }
+  double Normal     ()                                 { return sqrt(-2.0*log(Uniform()))*cos(2.0*PI*Uniform()); }
+};
+
+//////////////////////////////////////////////////////////////////
+/// \brief prints usage and exits
+//
+static void Usage()
+{
+  cout<<"RavenModelGenerator: writes a synthetic Raven model of requested size for scaling tests"<<endl;
+  cout<<"usage: RavenModelGenerator [options]"<<endl;
+  cout<<"  -o  {dir}            output directory                                 (default: synthetic)"<<endl;
+  cout<<"  -n  {name}           model run name                                   (default: synthetic)"<<endl;
+  cout<<"  -hrus {N}            number of HRUs                                   (default: 1000)"<<endl;
+  cout<<"  -subbasins {N}       number of subbasins                              (default: HRUs/10)"<<endl;
+  cout<<"  -branching {N}       upstream subbasins per subbasin; 1=single chain  (default: 2)"<<endl;
+  cout<<"  -gauges {N}          number of forcing gauges                         (default: 10)"<<endl;
+  cout<<"  -gridded {NX} {NY}   NetCDF gridded forcing on NX x NY grid instead of gauges"<<endl;
+  cout<<"  -reservoirs {N}      number of lake reservoirs                        (default: 0)"<<endl;
+  cout<<"  -constituents {N}    number of tracer constituents                    (default: 0)"<<endl;
+  cout<<"  -gauged {N}          number of gauged subbasins (hydrographs)         (default: 1)"<<endl;
+  cout<<"  -days {N}            simulation duration [d]                          (default: 365)"<<endl;
+  cout<<"  -timestep {dt}       model time step [d]                              (default: 1.0)"<<endl;
+  cout<<"  -area {A}            HRU area [km2]                                   (default: 10.0)"<<endl;
+  cout<<"  -template {GR4J|HBV} process template                                 (default: GR4J)"<<endl;
+  cout<<"  -seed {N}            random seed                                      (default: 1)"<<endl;
+  exit(1);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief exits with error message
+//
+static void Fail(const string &msg)
+{
+  cerr<<"RavenModelGenerator: "<<msg<<endl;
+  exit(1);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief parses command line arguments into generator options
+//
+static gen_options ParseArguments(int argc, char *argv[])
+{
+  gen_options G;
+  G.outdir       ="synthetic";
+  G.name         ="synthetic";
+  G.nHRUs        =1000;
+  G.nSubBasins   =-1;
+  G.branching    =2;
+  G.nGauges      =10;
+  G.gridded      =false;
+  G.gridNX       =10;
+  G.gridNY       =10;
+  G.nReservoirs  =0;
+  G.nConstituents=0;
+  G.nGaugedBasins=1;
+  G.nDays        =365;
+  G.timestep     =1.0;
+  G.HRUArea      =10.0;
+  G.templ        =TEMPLATE_GR4J;
+  G.seed         =1;
+
+  for (int i=1;i<argc;i++)
+  {
+    string arg=argv[i];
+    bool   has_next=(i+1<argc);
+    if      ((arg=="-h") || (arg=="--help"))         {Usage();}
+    else if ((arg=="-o"           ) && (has_next))   {G.outdir       =argv[++i];}
+    else if ((arg=="-n"           ) && (has_next))   {G.name         =argv[++i];}
+    else if ((arg=="-hrus"        ) && (has_next))   {G.nHRUs        =atoi(argv[++i]);}
+    else if ((arg=="-subbasins"   ) && (has_next))   {G.nSubBasins   =atoi(argv[++i]);}
+    else if ((arg=="-branching"   ) && (has_next))   {G.branching    =atoi(argv[++i]);}
+    else if ((arg=="-gauges"      ) && (has_next))   {G.nGauges      =atoi(argv[++i]);}
+    else if ((arg=="-gridded"     ) && (i+2<argc))   {G.gridded=true; G.gridNX=atoi(argv[++i]); G.gridNY=atoi(argv[++i]);}
+    else if ((arg=="-reservoirs"  ) && (has_next))   {G.nReservoirs  =atoi(argv[++i]);}
+    else if ((arg=="-constituents") && (has_next))   {G.nConstituents=atoi(argv[++i]);}
+    else if ((arg=="-gauged"      ) && (has_next))   {G.nGaugedBasins=atoi(argv[++i]);}
+    else if ((arg=="-days"        ) && (has_next))   {G.nDays        =atoi(argv[++i]);}
+    else if ((arg=="-timestep"    ) && (has_next))   {G.timestep     =atof(argv[++i]);}
+    else if ((arg=="-area"        ) && (has_next))   {G.HRUArea      =atof(argv[++i]);}
+    else if ((arg=="-seed"        ) && (has_next))   {G.seed         =(unsigned)(atoi(argv[++i]));}
+    else if ((arg=="-template"    ) && (has_next))
+    {
+      string t=argv[++i];
+      if      (t=="GR4J"){G.templ=TEMPLATE_GR4J;}
+      else if (t=="HBV" ){G.templ=TEMPLATE_HBV;}
+      else               {Fail("unrecognized template "+t+" (must be GR4J or HBV)");}
+    }
+    else {cerr<<"RavenModelGenerator: unrecognized or incomplete argument "<<arg<<endl; Usage();}
+  }
+  if (G.nSubBasins<0){G.nSubBasins=max(1,G.nHRUs/10);}
+
+  if (G.nHRUs<1)                   {Fail("number of HRUs must be positive");}
+  if (G.nSubBasins<1)              {Fail("number of subbasins must be positive");}
+  if (G.nSubBasins>G.nHRUs)        {Fail("number of subbasins cannot exceed number of HRUs");}
+  if (G.branching<1)               {Fail("branching must be at least 1");}
+  if ((!G.gridded) && (G.nGauges<1)){Fail("number of gauges must be positive");}
+  if ((G.gridNX<1) || (G.gridNY<1)){Fail("grid dimensions must be positive");}
+  if (G.nReservoirs<0)             {Fail("number of reservoirs cannot be negative");}
+  if (G.nReservoirs>G.nSubBasins)  {Fail("number of reservoirs cannot exceed number of subbasins");}
+  if (G.nConstituents<0)           {Fail("number of constituents cannot be negative");}
+  if ((G.templ==TEMPLATE_GR4J) && (G.nConstituents>1)){
+    //GR4J convolution stores have many internal storage layers, each of which is a transported water compartment
+    Fail("GR4J template supports at most one constituent (Raven limit on state variable layers); use -template HBV");
+  }
+  if ((G.nGaugedBasins<1) || (G.nGaugedBasins>G.nSubBasins)){Fail("number of gauged subbasins must be between 1 and the number of subbasins");}
+  if (G.nDays<1)                   {Fail("duration must be positive");}
+  if ((G.timestep<=0) || (G.timestep>1.0)){Fail("time step must be in (0,1] days");}
+  if (G.HRUArea<=0)                {Fail("HRU area must be positive");}
+  return G;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief builds subbasin network and HRU layout
+/// \details subbasins form a tree in which subbasin p drains to (p-1)/branching, so that the
+/// outlet is subbasin 0 and every subbasin has at most [branching] upstream neighbours. Subbasins are
+/// placed on a square grid; elevation increases with distance (in reaches) from the outlet.
+/// HRUs are distributed evenly among subbasins. Reservoirs are placed on the subbasins with the
+/// largest upstream area (excluding headwaters where possible).
+//
+static gen_layout BuildLayout(const gen_options &G, CRandom &rnd)
+{
+  gen_layout L;
+  int nP=G.nSubBasins;
+  int nK=G.nHRUs;
+
+  L.downstream.resize(nP);
+  L.depth     .resize(nP);
+  L.nUpstream .assign(nP,1);
+  L.maxDepth=0;
+  for (int p=0;p<nP;p++){
+    L.downstream[p]=(p==0) ? -1 : (p-1)/G.branching;
+    L.depth[p]     =(p==0) ?  0 : L.depth[L.downstream[p]]+1;
+    L.maxDepth     =max(L.maxDepth,L.depth[p]);
+  }
+  for (int p=nP-1;p>0;p--){L.nUpstream[L.downstream[p]]+=L.nUpstream[p];} //downstream index always smaller
+
+  //subbasins on square grid of cells of size (subbasin area)^1/2
+  int    ncols  =(int)(ceil(sqrt((double)(nP))));
+  int    nrows  =(nP+ncols-1)/ncols;
+  double sb_km  =sqrt(G.HRUArea*(double)(nK)/(double)(nP));
+  double dlat   =sb_km/KM_PER_DEG;
+  double dlon   =sb_km/(KM_PER_DEG*cos(LAT_ORIGIN*PI/180.0));
+  L.lat_size=nrows*dlat;
+  L.lon_size=ncols*dlon;
+  L.sbLat .resize(nP);
+  L.sbLon .resize(nP);
+  L.sbElev.resize(nP);
+  for (int p=0;p<nP;p++){
+    L.sbLat [p]=LAT_ORIGIN+((p/ncols)+0.5)*dlat;
+    L.sbLon [p]=LON_ORIGIN+((p%ncols)+0.5)*dlon;
+    L.sbElev[p]=200.0+1500.0*(double)(L.depth[p])/max(L.maxDepth,1)+rnd.Uniform(0.0,50.0);
+  }
+
+  //HRUs distributed evenly among subbasins, randomly placed within subbasin
+  L.HRUBasin .resize(nK);
+  L.HRULat   .resize(nK);
+  L.HRULon   .resize(nK);
+  L.HRUElev  .resize(nK);
+  L.HRUSlope .resize(nK);
+  L.HRUAspect.resize(nK);
+  for (int k=0;k<nK;k++){
+    int p=(int)(((long long)(k)*nP)/nK);
+    L.HRUBasin [k]=p;
+    L.HRULat   [k]=L.sbLat[p]+rnd.Uniform(-0.45,0.45)*dlat;
+    L.HRULon   [k]=L.sbLon[p]+rnd.Uniform(-0.45,0.45)*dlon;
+    L.HRUElev  [k]=L.sbElev[p]+rnd.Uniform(-100.0,100.0);
+    L.HRUSlope [k]=rnd.Uniform(0.0,20.0);
+    L.HRUAspect[k]=rnd.Uniform(0.0,360.0);
+  }
+
+  //reservoirs on subbasins with largest upstream area (stable ordering by index)
+  vector<int> order(nP);
+  for (int p=0;p<nP;p++){order[p]=p;}
+  stable_sort(order.begin(),order.end(),[&L](int a,int b){return L.nUpstream[a]>L.nUpstream[b];});
+  L.reservoirs.assign(order.begin(),order.begin()+G.nReservoirs);
+  return L;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief opens output file, exiting on failure
+//
+static void OpenFile(ofstream &OUT, const string &filename)
+{
+  OUT.open(filename.c_str());
+  if (OUT.fail()){Fail("unable to open output file "+filename);}
+  OUT<<fixed;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief writes standard Raven input file header
+//
+static void WriteHeader(ofstream &OUT, const string &filetype, const gen_options &G)
+{
+  OUT<<":FileType          "<<filetype<<" ASCII Raven"<<endl;
+  OUT<<":WrittenBy         RavenModelGenerator"<<endl;
+  OUT<<"#"<<endl;
+  OUT<<"# synthetic model: "<<G.nHRUs<<" HRUs, "<<G.nSubBasins<<" subbasins (branching "<<G.branching<<"), ";
+  if (G.gridded){OUT<<G.gridNX<<"x"<<G.gridNY<<" forcing grid, ";}
+  else          {OUT<<G.nGauges<<" gauges, ";}
+  OUT<<G.nReservoirs<<" reservoirs, "<<G.nConstituents<<" constituents, seed "<<G.seed<<endl;
+  OUT<<"#"<<endl;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief writes .rvi file
+//
+static void WriteRVI(const gen_options &G, const string &filename)
+{
+  ofstream RVI;
+  OpenFile(RVI,filename);
+  WriteHeader(RVI,"rvi",G);
+  RVI<<setprecision(6);
+  RVI<<":StartDate             2000-01-01 00:00:00"<<endl;
+  RVI<<":Duration              "<<G.nDays<<endl;
+  RVI<<":TimeStep              "<<G.timestep<<endl;
+  RVI<<":Method                ORDERED_SERIES"<<endl;
+  RVI<<endl;
+  RVI<<":Routing               ROUTE_DIFFUSIVE_WAVE"<<endl;
+  RVI<<":CatchmentRoute        TRIANGULAR_UH"<<endl;
+  RVI<<":Evaporation           PET_HARGREAVES_1985"<<endl;
+  RVI<<":OW_Evaporation        PET_HARGREAVES_1985"<<endl;
+  if (!G.gridded){
+    RVI<<":Interpolation         INTERP_NEAREST_NEIGHBOR"<<endl;
+  }
+  if (G.templ==TEMPLATE_GR4J)
+  {
+    RVI<<":SoilModel             SOIL_MULTILAYER  4"<<endl;
+    RVI<<":RainSnowFraction      RAINSNOW_DINGMAN"<<endl;
+    RVI<<":PotentialMeltMethod   POTMELT_DEGREE_DAY"<<endl;
+    RVI<<endl;
+    RVI<<":Alias PRODUCT_STORE      SOIL[0]"<<endl;
+    RVI<<":Alias ROUTING_STORE      SOIL[1]"<<endl;
+    RVI<<":Alias TEMP_STORE         SOIL[2]"<<endl;
+    RVI<<":Alias GW_STORE           SOIL[3]"<<endl;
+    RVI<<endl;
+    RVI<<":HydrologicProcesses"<<endl;
+    RVI<<" :Precipitation            PRECIP_RAVEN       ATMOS_PRECIP    MULTIPLE"<<endl;
+    RVI<<" :SnowTempEvolve           SNOTEMP_NEWTONS    SNOW_TEMP"<<endl;
+    RVI<<" :SnowBalance              SNOBAL_CEMA_NIEGE  SNOW            PONDED_WATER"<<endl;
+    RVI<<" :OpenWaterEvaporation     OPEN_WATER_EVAP    PONDED_WATER    ATMOSPHERE"<<endl;
+    RVI<<" :Infiltration             INF_GR4J           PONDED_WATER    MULTIPLE"<<endl;
+    RVI<<" :SoilEvaporation          SOILEVAP_GR4J      PRODUCT_STORE   ATMOSPHERE"<<endl;
+    RVI<<" :Percolation              PERC_GR4J          PRODUCT_STORE   TEMP_STORE"<<endl;
+    RVI<<" :Flush                    RAVEN_DEFAULT      SURFACE_WATER   TEMP_STORE"<<endl;
+    RVI<<" :Split                    RAVEN_DEFAULT      TEMP_STORE      CONVOLUTION[0] CONVOLUTION[1] 0.9"<<endl;
+    RVI<<" :Convolve                 CONVOL_GR4J_1      CONVOLUTION[0]  ROUTING_STORE"<<endl;
+    RVI<<" :Convolve                 CONVOL_GR4J_2      CONVOLUTION[1]  TEMP_STORE"<<endl;
+    RVI<<" :Percolation              PERC_GR4JEXCH      ROUTING_STORE   GW_STORE"<<endl;
+    RVI<<" :Percolation              PERC_GR4JEXCH2     TEMP_STORE      GW_STORE"<<endl;
+    RVI<<" :Flush                    RAVEN_DEFAULT      TEMP_STORE      SURFACE_WATER"<<endl;
+    RVI<<" :Baseflow                 BASE_GR4J          ROUTING_STORE   SURFACE_WATER"<<endl;
+    RVI<<":EndHydrologicProcesses"<<endl;
+  }
+  else if (G.templ==TEMPLATE_HBV)
+  {
+    RVI<<":SoilModel             SOIL_MULTILAYER 3"<<endl;
+    RVI<<":RainSnowFraction      RAINSNOW_HBV"<<endl;
+    RVI<<":PotentialMeltMethod   POTMELT_HBV"<<endl;
+    RVI<<":PrecipIceptFract      PRECIP_ICEPT_USER"<<endl;
+    RVI<<endl;
+    RVI<<":Alias       FAST_RESERVOIR SOIL[1]"<<endl;
+    RVI<<":Alias       SLOW_RESERVOIR SOIL[2]"<<endl;
+    RVI<<":LakeStorage SLOW_RESERVOIR"<<endl;
+    RVI<<endl;
+    RVI<<":HydrologicProcesses"<<endl;
+    RVI<<"  :SnowRefreeze      FREEZE_DEGREE_DAY  SNOW_LIQ        SNOW"<<endl;
+    RVI<<"  :Precipitation     PRECIP_RAVEN       ATMOS_PRECIP    MULTIPLE"<<endl;
+    RVI<<"  :CanopyEvaporation CANEVP_ALL         CANOPY          ATMOSPHERE"<<endl;
+    RVI<<"  :CanopySnowEvap    CANEVP_ALL         CANOPY_SNOW     ATMOSPHERE"<<endl;
+    RVI<<"  :SnowBalance       SNOBAL_SIMPLE_MELT SNOW            SNOW_LIQ"<<endl;
+    RVI<<"    :-->Overflow     RAVEN_DEFAULT      SNOW_LIQ        PONDED_WATER"<<endl;
+    RVI<<"  :Infiltration      INF_HBV            PONDED_WATER    MULTIPLE"<<endl;
+    RVI<<"  :Flush             RAVEN_DEFAULT      SURFACE_WATER   FAST_RESERVOIR"<<endl;
+    RVI<<"  :SoilEvaporation   SOILEVAP_HBV       SOIL[0]         ATMOSPHERE"<<endl;
+    RVI<<"  :CapillaryRise     RISE_HBV           FAST_RESERVOIR  SOIL[0]"<<endl;
+    RVI<<"  :LakeEvaporation   LAKE_EVAP_BASIC    SLOW_RESERVOIR  ATMOSPHERE"<<endl;
+    RVI<<"  :Percolation       PERC_CONSTANT      FAST_RESERVOIR  SLOW_RESERVOIR"<<endl;
+    RVI<<"  :Baseflow          BASE_POWER_LAW     FAST_RESERVOIR  SURFACE_WATER"<<endl;
+    RVI<<"  :Baseflow          BASE_LINEAR        SLOW_RESERVOIR  SURFACE_WATER"<<endl;
+    RVI<<":EndHydrologicProcesses"<<endl;
+  }
+  for (int c=0;c<G.nConstituents;c++){
+    RVI<<endl;
+    RVI<<":Transport TRACER"<<c+1<<endl;
+    RVI<<":FixedConcentration TRACER"<<c+1<<" SOIL[0] "<<1.0+c<<endl;
+  }
+  RVI<<endl;
+  RVI<<":EvaluationMetrics NASH_SUTCLIFFE RMSE"<<endl;
+  RVI.close();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief writes .rvp file
+//
+static void WriteRVP(const gen_options &G, const string &filename)
+{
+  ofstream RVP;
+  OpenFile(RVP,filename);
+  WriteHeader(RVP,"rvp",G);
+  if (G.templ==TEMPLATE_GR4J)
+  {
+    RVP<<":SoilClasses"<<endl;
+    RVP<<"  :Attributes"<<endl;
+    RVP<<"  :Units"<<endl;
+    RVP<<"   SOIL_PROD"<<endl;
+    RVP<<"   SOIL_ROUT"<<endl;
+    RVP<<"   SOIL_TEMP"<<endl;
+    RVP<<"   SOIL_GW"<<endl;
+    RVP<<":EndSoilClasses"<<endl;
+    RVP<<":SoilProfiles"<<endl;
+    RVP<<"  DEFAULT_P, 4, SOIL_PROD, 0.529, SOIL_ROUT, 0.300, SOIL_TEMP, 1.000, SOIL_GW, 1.000"<<endl;
+    RVP<<":EndSoilProfiles"<<endl;
+    RVP<<":VegetationClasses"<<endl;
+    RVP<<"  :Attributes, MAX_HT, MAX_LAI, MAX_LEAF_COND"<<endl;
+    RVP<<"  :Units,           m,    none,      mm_per_s"<<endl;
+    RVP<<"  VEG_ALL,        0.0,     0.0,           0.0"<<endl;
+    RVP<<":EndVegetationClasses"<<endl;
+    RVP<<":LandUseClasses"<<endl;
+    RVP<<"  :Attributes, IMPERM, FOREST_COV"<<endl;
+    RVP<<"  :Units,        frac,       frac"<<endl;
+    RVP<<"  LU_ALL,         0.0,        0.0"<<endl;
+    RVP<<":EndLandUseClasses"<<endl;
+    RVP<<":GlobalParameter RAINSNOW_TEMP       0.0"<<endl;
+    RVP<<":GlobalParameter RAINSNOW_DELTA      1.0"<<endl;
+    RVP<<":GlobalParameter AIRSNOW_COEFF     0.053"<<endl;
+    RVP<<":GlobalParameter AVG_ANNUAL_SNOW    16.9"<<endl;
+    RVP<<":SoilParameterList"<<endl;
+    RVP<<"  :Parameters, POROSITY, GR4J_X3, GR4J_X2"<<endl;
+    RVP<<"  :Units,          none,      mm,    mm/d"<<endl;
+    RVP<<"  [DEFAULT],        1.0,  407.29,  -3.396"<<endl;
+    RVP<<":EndSoilParameterList"<<endl;
+    RVP<<":LandUseParameterList"<<endl;
+    RVP<<"  :Parameters, GR4J_X4, MELT_FACTOR"<<endl;
+    RVP<<"  :Units,            d,      mm/d/C"<<endl;
+    RVP<<"  [DEFAULT],     1.072,        7.73"<<endl;
+    RVP<<":EndLandUseParameterList"<<endl;
+  }
+  else if (G.templ==TEMPLATE_HBV)
+  {
+    RVP<<":SoilClasses"<<endl;
+    RVP<<"  :Attributes"<<endl;
+    RVP<<"  :Units"<<endl;
+    RVP<<"   TOPSOIL"<<endl;
+    RVP<<"   SLOW_RES"<<endl;
+    RVP<<"   FAST_RES"<<endl;
+    RVP<<":EndSoilClasses"<<endl;
+    RVP<<":SoilProfiles"<<endl;
+    RVP<<"  DEFAULT_P, 3, TOPSOIL, 2.036937, FAST_RES, 100.0, SLOW_RES, 100.0"<<endl;
+    RVP<<":EndSoilProfiles"<<endl;
+    RVP<<":VegetationClasses"<<endl;
+    RVP<<"  :Attributes, MAX_HT, MAX_LAI, MAX_LEAF_COND"<<endl;
+    RVP<<"  :Units,           m,    none,      mm_per_s"<<endl;
+    RVP<<"  VEG_ALL,         25,     6.0,           5.3"<<endl;
+    RVP<<":EndVegetationClasses"<<endl;
+    RVP<<":VegetationParameterList"<<endl;
+    RVP<<"  :Parameters, MAX_CAPACITY, MAX_SNOW_CAPACITY, TFRAIN, TFSNOW"<<endl;
+    RVP<<"  :Units,                mm,                mm,   frac,   frac"<<endl;
+    RVP<<"  VEG_ALL,            10000,             10000,   0.88,   0.88"<<endl;
+    RVP<<":EndVegetationParameterList"<<endl;
+    RVP<<":LandUseClasses"<<endl;
+    RVP<<"  :Attributes, IMPERM, FOREST_COV"<<endl;
+    RVP<<"  :Units,        frac,       frac"<<endl;
+    RVP<<"  LU_ALL,         0.0,          1"<<endl;
+    RVP<<":EndLandUseClasses"<<endl;
+    RVP<<":GlobalParameter RAINSNOW_TEMP       0.05984519"<<endl;
+    RVP<<":GlobalParameter RAINSNOW_DELTA      2.0"<<endl;
+    RVP<<":GlobalParameter SNOW_SWI            0.03473693"<<endl;
+    RVP<<":LandUseParameterList"<<endl;
+    RVP<<"  :Parameters, MELT_FACTOR, MIN_MELT_FACTOR, HBV_MELT_FOR_CORR, REFREEZE_FACTOR, HBV_MELT_ASP_CORR"<<endl;
+    RVP<<"  :Units,           mm/d/K,          mm/d/K,              none,          mm/d/K,              none"<<endl;
+    RVP<<"  [DEFAULT],      4.072232,             2.2,         0.4452843,        2.001574,              0.48"<<endl;
+    RVP<<":EndLandUseParameterList"<<endl;
+    RVP<<":SoilParameterList"<<endl;
+    RVP<<"  :Parameters, POROSITY, FIELD_CAPACITY, SAT_WILT, HBV_BETA, MAX_CAP_RISE_RATE, MAX_PERC_RATE, BASEFLOW_COEFF, BASEFLOW_N"<<endl;
+    RVP<<"  :Units,          none,           none,     none,     none,              mm/d,          mm/d,            1/d,       none"<<endl;
+    RVP<<"  [DEFAULT], 0.09985144,      0.5060520, 0.04505643, 3.438486,         18.94145,           0.0,            0.0,        0.0"<<endl;
+    RVP<<"  FAST_RES,    _DEFAULT,       _DEFAULT,       0.0, _DEFAULT,          _DEFAULT,      38.32455,      0.4606565,   1.877607"<<endl;
+    RVP<<"  SLOW_RES,    _DEFAULT,       _DEFAULT,       0.0, _DEFAULT,          _DEFAULT,      _DEFAULT,     0.06303738,        1.0"<<endl;
+    RVP<<":EndSoilParameterList"<<endl;
+  }
+  RVP<<":GlobalParameter PRECIP_LAPSE     0.0004"<<endl;
+  RVP<<":AvgAnnualRunoff  300"<<endl;
+  RVP<<":GlobalParameter ADIABATIC_LAPSE  0.0065"<<endl;
+  RVP<<endl;
+  RVP<<"# generic channel with floodplain shared by all reaches (deep enough for large networks)"<<endl;
+  RVP<<":ChannelProfile CHANNEL_SYN"<<endl;
+  RVP<<"  :Bedslope 0.001"<<endl;
+  RVP<<"  :SurveyPoints"<<endl;
+  RVP<<"    0    60"<<endl;
+  RVP<<"    100   5"<<endl;
+  RVP<<"    120   0"<<endl;
+  RVP<<"    220   0"<<endl;
+  RVP<<"    240   5"<<endl;
+  RVP<<"    340  60"<<endl;
+  RVP<<"  :EndSurveyPoints"<<endl;
+  RVP<<"  :RoughnessZones"<<endl;
+  RVP<<"    0  0.035"<<endl;
+  RVP<<"  :EndRoughnessZones"<<endl;
+  RVP<<":EndChannelProfile"<<endl;
+  RVP.close();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief writes .rvh file
+//
+static void WriteRVH(const gen_options &G, const gen_layout &L, const string &filename)
+{
+  ofstream RVH;
+  OpenFile(RVH,filename);
+  WriteHeader(RVH,"rvh",G);
+  double sb_area=G.HRUArea*(double)(G.nHRUs)/(double)(G.nSubBasins);
+
+  RVH<<":SubBasins"<<endl;
+  RVH<<"  :Attributes,   NAME, DOWNSTREAM_ID,      PROFILE, REACH_LENGTH, GAUGED"<<endl;
+  RVH<<"  :Units,        none,          none,         none,           km,   none"<<endl;
+  RVH<<setprecision(3);
+  for (int p=0;p<G.nSubBasins;p++){
+    int down=(L.downstream[p]==-1) ? -1 : L.downstream[p]+1;
+    RVH<<"  "<<p+1<<", sub"<<p+1<<", "<<down<<", CHANNEL_SYN, "<<sqrt(sb_area)<<", "<<((p<G.nGaugedBasins) ? 1 : 0)<<endl;
+  }
+  RVH<<":EndSubBasins"<<endl;
+  RVH<<endl;
+
+  RVH<<":HRUs"<<endl;
+  RVH<<"  :Attributes, AREA, ELEVATION, LATITUDE, LONGITUDE, BASIN_ID, LAND_USE_CLASS, VEG_CLASS, SOIL_PROFILE, AQUIFER_PROFILE, TERRAIN_CLASS, SLOPE, ASPECT"<<endl;
+  RVH<<"  :Units,       km2,         m,      deg,       deg,     none,           none,      none,         none,            none,          none,   deg,    deg"<<endl;
+  for (int k=0;k<G.nHRUs;k++){
+    RVH<<"  "<<k+1<<", "<<setprecision(4)<<G.HRUArea<<", "<<setprecision(1)<<L.HRUElev[k]<<", ";
+    RVH<<setprecision(5)<<L.HRULat[k]<<", "<<L.HRULon[k]<<", "<<L.HRUBasin[k]+1<<", LU_ALL, VEG_ALL, DEFAULT_P, [NONE], [NONE], ";
+    RVH<<setprecision(1)<<L.HRUSlope[k]<<", "<<L.HRUAspect[k]<<endl;
+  }
+  RVH<<":EndHRUs"<<endl;
+  RVH<<endl;
+
+  //time of concentration scales with square root of subbasin area (Kirpich-type)
+  RVH<<":SubBasinProperties"<<endl;
+  RVH<<"  :Parameters, TIME_CONC, TIME_TO_PEAK"<<endl;
+  RVH<<"  :Units,              d,            d"<<endl;
+  RVH<<setprecision(3);
+  double tc=max(0.5,0.1*sqrt(sb_area));
+  for (int p=0;p<G.nSubBasins;p++){
+    RVH<<"  "<<p+1<<", "<<tc<<", "<<0.4*tc<<endl;
+  }
+  RVH<<":EndSubBasinProperties"<<endl;
+
+  for (size_t r=0;r<L.reservoirs.size();r++){
+    int    p     =L.reservoirs[r];
+    double area  =min(0.02*L.nUpstream[p],0.5)*sb_area; //[km2] 2% of upstream area, at most half of subbasin
+    RVH<<endl;
+    RVH<<":Reservoir Lake"<<r+1<<endl;
+    RVH<<"  :SubBasinID "<<p+1<<endl;
+    RVH<<"  :WeirCoefficient 0.6"<<endl;
+    RVH<<"  :CrestWidth "<<setprecision(1)<<max(5.0,2.0*sqrt(area))<<endl;
+    RVH<<"  :MaxDepth 5.0"<<endl;
+    RVH<<"  :LakeArea "<<setprecision(0)<<area*1e6<<endl;
+    RVH<<":EndReservoir"<<endl;
+  }
+  RVH.close();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief writes .rvc file
+//
+static void WriteRVC(const gen_options &G, const gen_layout &L, const string &filename)
+{
+  ofstream RVC;
+  OpenFile(RVC,filename);
+  WriteHeader(RVC,"rvc",G);
+  RVC<<setprecision(1);
+  RVC<<":HRUStateVariableTable"<<endl;
+  if (G.templ==TEMPLATE_GR4J){
+    RVC<<"  :Attributes SOIL[0] SOIL[1]"<<endl;
+    RVC<<"  :Units      mm      mm"<<endl;
+    for (int k=0;k<G.nHRUs;k++){RVC<<"  "<<k+1<<" 264.5 15.0"<<endl;}
+  }
+  else if (G.templ==TEMPLATE_HBV){
+    RVC<<"  :Attributes SOIL[0] SOIL[1] SOIL[2]"<<endl;
+    RVC<<"  :Units      mm      mm      mm"<<endl;
+    for (int k=0;k<G.nHRUs;k++){RVC<<"  "<<k+1<<" 100.0 5.0 50.0"<<endl;}
+  }
+  RVC<<":EndHRUStateVariableTable"<<endl;
+
+  //non-zero initial flows avoid long spin-up of large networks
+  RVC<<endl;
+  RVC<<setprecision(3);
+  RVC<<":BasinInitialConditions"<<endl;
+  RVC<<"  :Attributes, ID, Q"<<endl;
+  RVC<<"  :Units,    none, m3/s"<<endl;
+  for (int p=0;p<G.nSubBasins;p++){
+    RVC<<"  "<<p+1<<", "<<0.01*G.HRUArea*L.nUpstream[p]*(double)(G.nHRUs)/(double)(G.nSubBasins)<<endl;
+  }
+  RVC<<":EndBasinInitialConditions"<<endl;
+  RVC.close();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief generates synthetic daily weather at a set of locations
+/// \details precipitation is a regional intermittent (exponential) storm series modulated
+/// per location; temperature is a seasonal cycle plus regional AR(1) anomaly, lapsed with elevation
+/// \param elev [in] location elevations [m] [size: nLoc]
+/// \param lat [in] location latitudes [deg] [size: nLoc]
+/// \param precip [out] precipitation [mm/d] [size: nDays*nLoc]
+/// \param tmin [out] daily minimum temperature [C] [size: nDays*nLoc]
+/// \param tmax [out] daily maximum temperature [C] [size: nDays*nLoc]
+//
+static void GenerateWeather(const gen_options &G, const vector<double> &elev, const vector<double> &lat, CRandom &rnd,
+                            vector<float> &precip, vector<float> &tmin, vector<float> &tmax)
+{
+  size_t nLoc=elev.size();
+  precip.resize(G.nDays*nLoc);
+  tmin  .resize(G.nDays*nLoc);
+  tmax  .resize(G.nDays*nLoc);
+  double anomaly=0.0;
+  for (int d=0;d<G.nDays;d++)
+  {
+    double storm=(rnd.Uniform()<0.45) ? rnd.Exponential(7.0) : 0.0;
+    anomaly=0.7*anomaly+2.0*rnd.Normal();
+    double Tseason=8.0-14.0*cos(2.0*PI*((d%365)-15)/365.0);
+    for (size_t i=0;i<nLoc;i++){
+      size_t n=d*nLoc+i;
+      double T=Tseason+anomaly-LAPSE_RATE*(elev[i]-200.0)-0.5*(lat[i]-LAT_ORIGIN);
+      double range=8.0+2.0*rnd.Uniform();
+      precip[n]=(float)((storm>0) ? storm*rnd.Uniform(0.5,1.5) : 0.0);
+      tmin  [n]=(float)(T-0.5*range);
+      tmax  [n]=(float)(T+0.5*range);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief rounds to 2 decimals, avoiding negative zero (written as "-0.00", which Raven does not parse)
+//
+static double Round2(const double x)
+{
+  return floor(x*100.0+0.5)/100.0+0.0;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief writes .rvt file and per-gauge forcing files (gauged forcing)
+/// \details gauges are placed on a regular grid covering the domain, each with its own
+/// :MultiData time series file in the forcing/ subdirectory
+//
+static void WriteGaugedRVT(const gen_options &G, const gen_layout &L, CRandom &rnd, const string &filename)
+{
+  int ncols=(int)(ceil(sqrt((double)(G.nGauges))));
+  int nrows=(G.nGauges+ncols-1)/ncols;
+  vector<double> glat(G.nGauges),glon(G.nGauges),gelev(G.nGauges);
+  double avg_elev=0.0;
+  for (int k=0;k<G.nHRUs;k++){avg_elev+=L.HRUElev[k]/G.nHRUs;}
+  for (int g=0;g<G.nGauges;g++){
+    glat [g]=LAT_ORIGIN+((g/ncols)+0.5)*L.lat_size/nrows;
+    glon [g]=LON_ORIGIN+((g%ncols)+0.5)*L.lon_size/ncols;
+    gelev[g]=avg_elev+rnd.Uniform(-200.0,200.0);
+  }
+  vector<float> precip,tmin,tmax;
+  GenerateWeather(G,gelev,glat,rnd,precip,tmin,tmax);
+
+  string dir=G.outdir+"/forcing";
+  MAKE_DIR(dir.c_str());
+
+  ofstream RVT;
+  OpenFile(RVT,filename);
+  WriteHeader(RVT,"rvt",G);
+  for (int g=0;g<G.nGauges;g++)
+  {
+    string gname="G"+to_string(g+1);
+    RVT<<":Gauge "<<gname<<endl;
+    RVT<<setprecision(5);
+    RVT<<"  :Latitude  "<<glat[g]<<endl;
+    RVT<<"  :Longitude "<<glon[g]<<endl;
+    RVT<<setprecision(1);
+    RVT<<"  :Elevation "<<gelev[g]<<endl;
+    RVT<<"  :RedirectToFile forcing/"<<gname<<".rvt"<<endl;
+    RVT<<":EndGauge"<<endl;
+
+    ofstream DAT;
+    OpenFile(DAT,dir+"/"+gname+".rvt");
+    DAT<<setprecision(2);
+    DAT<<":MultiData"<<endl;
+    DAT<<"  2000-01-01 00:00:00 1.0 "<<G.nDays<<" 3"<<endl;
+    DAT<<"  :Parameters PRECIP TEMP_DAILY_MIN TEMP_DAILY_MAX"<<endl;
+    DAT<<"  :Units      mm/d   C              C"<<endl;
+    for (int d=0;d<G.nDays;d++){
+      size_t n=d*G.nGauges+g;
+      DAT<<"  "<<Round2(precip[n])<<" "<<Round2(tmin[n])<<" "<<Round2(tmax[n])<<endl;
+    }
+    DAT<<":EndMultiData"<<endl;
+    DAT.close();
+  }
+  RVT.close();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief minimal writer of NetCDF classic (64-bit offset, CDF-2) files with fixed-size variables
+/// \details avoids dependence of the generator on the NetCDF library; see the NetCDF classic
+/// format specification. All multi-byte values are big-endian.
+//
+class CNetCDFWriter
+{
+private:
+  struct nc_att {string name; string text;};
+  struct nc_var {string name; vector<int> dims; int type; vector<nc_att> atts; size_t size; uint64_t begin;};
+
+  vector<string> _dimNames;
+  vector<size_t> _dimLens;
+  vector<nc_var> _vars;
+  string         _header;
+
+  static const int NC_CHAR=2, NC_FLOAT=5, NC_DOUBLE=6;
+  static const int NC_DIMENSION=10, NC_VARIABLE=11, NC_ATTRIBUTE=12;
+
+  void PutInt   (string &s, const uint32_t v){for (int b=3;b>=0;b--){s+=(char)((v>>(8*b))&0xFF);}}
+  void PutInt64 (string &s, const uint64_t v){for (int b=7;b>=0;b--){s+=(char)((v>>(8*b))&0xFF);}}
+  void PutName  (string &s, const string &n) {PutInt(s,(uint32_t)(n.size())); s+=n; while (s.size()%4){s+='\0';}}
+
+  string Header(const bool with_offsets)
+  {
+    string h="CDF";
+    h+=(char)(2);
+    PutInt(h,0); //numrecs (no record dimension)
+    PutInt(h,NC_DIMENSION); PutInt(h,(uint32_t)(_dimNames.size()));
+    for (size_t i=0;i<_dimNames.size();i++){PutName(h,_dimNames[i]); PutInt(h,(uint32_t)(_dimLens[i]));}
+    PutInt(h,0); PutInt(h,0); //no global attributes
+    PutInt(h,NC_VARIABLE); PutInt(h,(uint32_t)(_vars.size()));
+    for (size_t v=0;v<_vars.size();v++){
+      const nc_var &V=_vars[v];
+      PutName(h,V.name);
+      PutInt(h,(uint32_t)(V.dims.size()));
+      for (size_t i=0;i<V.dims.size();i++){PutInt(h,(uint32_t)(V.dims[i]));}
+      if (V.atts.size()==0){PutInt(h,0); PutInt(h,0);}
+      else {
+        PutInt(h,NC_ATTRIBUTE); PutInt(h,(uint32_t)(V.atts.size()));
+        for (size_t a=0;a<V.atts.size();a++){
+          PutName(h,V.atts[a].name);
+          PutInt(h,NC_CHAR);
+          PutName(h,V.atts[a].text);
+        }
+      }
+      PutInt(h,(uint32_t)(V.type));
+      PutInt(h,(uint32_t)(min(V.size,(size_t)(0xFFFFFFFF))));
+      PutInt64(h,with_offsets ? V.begin : 0);
+    }
+    return h;
+  }
+
+public:
+  int AddDim(const string &name, const size_t len){_dimNames.push_back(name); _dimLens.push_back(len); return (int)(_dimNames.size())-1;}
+
+  void AddVar(const string &name, const vector<int> &dims, const bool is_double, const vector<pair<string,string> > &atts)
+  {
+    nc_var V;
+    V.name=name; V.dims=dims; V.type=is_double ? NC_DOUBLE : NC_FLOAT; V.begin=0;
+    V.size=is_double ? 8 : 4;
+    for (size_t i=0;i<dims.size();i++){V.size*=_dimLens[dims[i]];}
+    V.size=(V.size+3)/4*4;
+    for (size_t a=0;a<atts.size();a++){nc_att A; A.name=atts[a].first; A.text=atts[a].second; V.atts.push_back(A);}
+    _vars.push_back(V);
+  }
+
+  /// \brief writes header and data; data[v] holds values of variable v (doubles for double variables, else floats)
+  void Write(const string &filename, const vector<const double*> &ddata, const vector<const float*> &fdata)
+  {
+    uint64_t offset=Header(false).size();
+    for (size_t v=0;v<_vars.size();v++){_vars[v].begin=offset; offset+=_vars[v].size;}
+    _header=Header(true);
+
+    ofstream NC(filename.c_str(),ios::binary);
+    if (NC.fail()){Fail("unable to open output file "+filename);}
+    NC.write(_header.data(),_header.size());
+    string buf;
+    for (size_t v=0;v<_vars.size();v++)
+    {
+      size_t n=_vars[v].size/((_vars[v].type==NC_DOUBLE) ? 8 : 4);
+      buf.clear();
+      buf.reserve(_vars[v].size);
+      for (size_t i=0;i<n;i++){
+        if (_vars[v].type==NC_DOUBLE){uint64_t u; memcpy(&u,&ddata[v][i],8); PutInt64(buf,u);}
+        else                         {uint32_t u; memcpy(&u,&fdata[v][i],4); PutInt  (buf,u);}
+      }
+      NC.write(buf.data(),buf.size());
+    }
+    if (NC.fail()){Fail("error writing "+filename);}
+    NC.close();
+  }
+};
+
+//////////////////////////////////////////////////////////////////
+/// \brief writes .rvt file, NetCDF forcing file and grid weights file (gridded forcing)
+/// \details the grid covers the domain; each HRU takes its forcing from the cell containing its centroid
+//
+static void WriteGriddedRVT(const gen_options &G, const gen_layout &L, CRandom &rnd, const string &filename)
+{
+  int    NX=G.gridNX, NY=G.gridNY;
+  size_t nCells=(size_t)(NX)*NY;
+  if ((double)(nCells)*G.nDays*3*4>2.0e9*3){Fail("gridded forcing file would be too large; reduce grid size or duration");}
+
+  vector<double> lon(NX),lat(NY),time(G.nDays);
+  for (int i=0;i<NX;i++){lon[i]=LON_ORIGIN+(i+0.5)*L.lon_size/NX;}
+  for (int j=0;j<NY;j++){lat[j]=LAT_ORIGIN+(j+0.5)*L.lat_size/NY;}
+  for (int d=0;d<G.nDays;d++){time[d]=d;}
+
+  //cell elevation is mean elevation of HRUs within cell (for temperature lapse)
+  vector<double> celev(nCells,0.0),clat(nCells),cnt(nCells,0.0);
+  vector<int>    HRUcell(G.nHRUs);
+  for (int k=0;k<G.nHRUs;k++){
+    int i=min(NX-1,max(0,(int)((L.HRULon[k]-LON_ORIGIN)/L.lon_size*NX)));
+    int j=min(NY-1,max(0,(int)((L.HRULat[k]-LAT_ORIGIN)/L.lat_size*NY)));
+    HRUcell[k]=j*NX+i;
+    celev[HRUcell[k]]+=L.HRUElev[k];
+    cnt  [HRUcell[k]]+=1.0;
+  }
+  for (size_t c=0;c<nCells;c++){
+    celev[c]=(cnt[c]>0) ? celev[c]/cnt[c] : 500.0;
+    clat [c]=lat[c/NX];
+  }
+  vector<float> precip,tmin,tmax;
+  GenerateWeather(G,celev,clat,rnd,precip,tmin,tmax); //[time][lat][lon] ordering
+
+  CNetCDFWriter NC;
+  int dt=NC.AddDim("time",G.nDays);
+  int dy=NC.AddDim("lat" ,NY);
+  int dx=NC.AddDim("lon" ,NX);
+  typedef vector<pair<string,string> > att_list;
+  NC.AddVar("lon" ,vector<int>(1,dx),true,att_list{{"units","degrees_east"}});
+  NC.AddVar("lat" ,vector<int>(1,dy),true,att_list{{"units","degrees_north"}});
+  NC.AddVar("time",vector<int>(1,dt),true,att_list{{"units","days since 2000-01-01 00:00:00"},{"calendar","gregorian"}});
+  NC.AddVar("pr"  ,vector<int>{dt,dy,dx},false,att_list{{"long_name","precipitation"},{"units","mm/d"}});
+  NC.AddVar("tmin",vector<int>{dt,dy,dx},false,att_list{{"long_name","daily minimum temperature"},{"units","C"}});
+  NC.AddVar("tmax",vector<int>{dt,dy,dx},false,att_list{{"long_name","daily maximum temperature"},{"units","C"}});
+  vector<const double*> ddata={lon.data(),lat.data(),time.data(),NULL,NULL,NULL};
+  vector<const float*>  fdata={NULL,NULL,NULL,precip.data(),tmin.data(),tmax.data()};
+  NC.Write(G.outdir+"/"+G.name+"_forcing.nc",ddata,fdata);
+
+  ofstream GW;
+  OpenFile(GW,G.outdir+"/GridWeights.txt");
+  GW<<":GridWeights"<<endl;
+  GW<<"  :NumberHRUs      "<<G.nHRUs<<endl;
+  GW<<"  :NumberGridCells "<<nCells<<endl;
+  GW<<"  # [HRU ID] [Cell #] [w_kl]"<<endl;
+  for (int k=0;k<G.nHRUs;k++){GW<<"  "<<k+1<<" "<<HRUcell[k]<<" 1.0"<<endl;}
+  GW<<":EndGridWeights"<<endl;
+  GW.close();
+
+  const char *fnames[3][3]={{"PRECIP","PRECIP","pr"},{"MIN_TEMP","TEMP_DAILY_MIN","tmin"},{"MAX_TEMP","TEMP_DAILY_MAX","tmax"}};
+  ofstream RVT;
+  OpenFile(RVT,filename);
+  WriteHeader(RVT,"rvt",G);
+  for (int f=0;f<3;f++){
+    RVT<<":GriddedForcing "<<fnames[f][0]<<endl;
+    RVT<<"  :ForcingType "<<fnames[f][1]<<endl;
+    RVT<<"  :FileNameNC  "<<G.name<<"_forcing.nc"<<endl;
+    RVT<<"  :VarNameNC   "<<fnames[f][2]<<endl;
+    RVT<<"  :DimNamesNC  lon lat time"<<endl;
+    RVT<<"  :RedirectToFile GridWeights.txt"<<endl;
+    RVT<<":EndGriddedForcing"<<endl;
+  }
+  RVT.close();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief RavenModelGenerator main program
+//
+int main(int argc, char *argv[])
+{
+  gen_options G=ParseArguments(argc,argv);
+  CRandom     rnd(G.seed);
+
+  MAKE_DIR(G.outdir.c_str());
+  gen_layout L=BuildLayout(G,rnd);
+
+  string base=G.outdir+"/"+G.name;
+  WriteRVI(G,base+".rvi");
+  WriteRVP(G,base+".rvp");
+  WriteRVH(G,L,base+".rvh");
+  WriteRVC(G,L,base+".rvc");
+  if (G.gridded){WriteGriddedRVT(G,L,rnd,base+".rvt");}
+  else          {WriteGaugedRVT (G,L,rnd,base+".rvt");}
+
+  cout<<"RavenModelGenerator: wrote "<<base<<".rv* ("<<G.nHRUs<<" HRUs, "<<G.nSubBasins<<" subbasins, network depth "<<L.maxDepth<<")"<<endl;
+  return 0;
+}